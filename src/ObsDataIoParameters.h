@@ -16,6 +16,7 @@
 #include "ioda/Engines/EngineUtils.h"
 #include "ioda/Engines/ReaderBase.h"
 #include "ioda/Engines/WriterBase.h"
+#include "ioda/Io/IoPoolParameters.h"
 
 namespace ioda {
 
@@ -85,6 +86,14 @@ class ObsDataInParameters : public oops::Parameters {
 
     /// maximum frame size
     oops::Parameter<int> maxFrameSize{"max frame size", DefaultFrameSize, this};
+
+    /// skip reading blocks of locations that lie outside the timing window, according
+    /// to the block statistics of the input file (when it has them and they still match
+    /// the first and last dateTime of each block). Only the first and last dateTime of a
+    /// block are checked, so statistics gone stale through an edit of an interior
+    /// dateTime go undetected and can drop in-window locations: switch this on only for
+    /// files whose dateTimes are not edited after the statistics are written.
+    oops::Parameter<bool> useBlockStatistics{"use block statistics", false, this};
 };
 
 class ObsDataOutParameters : public oops::Parameters {
@@ -93,6 +102,9 @@ class ObsDataOutParameters : public oops::Parameters {
  public:
     /// option controlling the creation of the backend
     oops::RequiredParameter<Engines::WriterParametersWrapper> engine{"engine", this};
+
+    /// compression of the output file variables, by group or variable
+    oops::Parameter<OutputCompressionParameters> compression{"compression", { }, this};
 };
 
 }  // namespace ioda
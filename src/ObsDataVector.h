@@ -8,10 +8,18 @@
 #ifndef OBSDATAVECTOR_H_
 #define OBSDATAVECTOR_H_
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <map>
+#include <memory>
 #include <ostream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <boost/math/special_functions/fpclassify.hpp>
@@ -34,7 +42,108 @@ namespace ioda {
 
 //-----------------------------------------------------------------------------
 
-template <typename DATATYPE> using ObsDataRow = std::vector<DATATYPE>;
+/// \brief One row of an ObsDataVector: the values of one variable at every location.
+/// \details A view of part of the ObsDataVector's storage, which holds all rows in one
+///          contiguous [nvars][nlocs] buffer. Copying a row copies the view, but assigning
+///          to a row (from another row or from a vector of the same length) copies values,
+///          as it did when rows were separate vectors. Element access is unchecked except
+///          through at().
+///
+///          ObsDataVector::operator[] used to return a reference to a std::vector. Code that
+///          reads a row, compares it with a vector, or passes it to a function taking a
+///          `const std::vector &` still compiles: the row converts to a (copied) vector.
+///          Code that binds a row to a non-const `std::vector &`, or resizes it, does not;
+///          it must use ObsDataRow (or auto) instead, and cannot change the row's length.
+template <typename DATATYPE>
+class ObsDataRow {
+ public:
+  typedef typename std::remove_const<DATATYPE>::type value_type;
+  typedef std::size_t size_type;
+  typedef DATATYPE * iterator;
+  typedef const DATATYPE * const_iterator;
+
+  ObsDataRow() : data_(nullptr), size_(0) {}
+  ObsDataRow(DATATYPE * data, size_t size) : data_(data), size_(size) {}
+  ObsDataRow(const ObsDataRow &) = default;
+  /// A row of a non-const ObsDataVector converts to a read-only row.
+  template <typename T, typename = typename std::enable_if<
+              std::is_same<const T, DATATYPE>::value && !std::is_same<T, DATATYPE>::value>::type>
+  ObsDataRow(const ObsDataRow<T> & other) : data_(other.data()), size_(other.size()) {}
+
+  /// Copies the values of \p other, which must have the same length.
+  ObsDataRow & operator=(const ObsDataRow & other) {
+    checkSize(other.size());
+    std::copy(other.begin(), other.end(), data_);
+    return *this;
+  }
+  /// Copies \p values, which must have the same length as the row.
+  ObsDataRow & operator=(const std::vector<value_type> & values) {
+    checkSize(values.size());
+    std::copy(values.begin(), values.end(), data_);
+    return *this;
+  }
+
+  /// Copies the values out, e.g. for functions that take a std::vector.
+  operator std::vector<value_type>() const {return std::vector<value_type>(begin(), end());}
+
+  size_t size() const {return size_;}
+  bool empty() const {return size_ == 0;}
+  DATATYPE * data() const {return data_;}
+
+  DATATYPE & operator[](const size_t jj) const {return data_[jj];}
+  DATATYPE & at(const size_t jj) const {
+    if (jj >= size_) throw std::out_of_range("ObsDataRow::at: index out of range");
+    return data_[jj];
+  }
+  DATATYPE & front() const {return data_[0];}
+  DATATYPE & back() const {return data_[size_ - 1];}
+
+  iterator begin() const {return data_;}
+  iterator end() const {return data_ + size_;}
+  const_iterator cbegin() const {return data_;}
+  const_iterator cend() const {return data_ + size_;}
+
+ private:
+  void checkSize(const size_t size) const {
+    if (size != size_) {
+      std::ostringstream msg;
+      msg << "ObsDataRow: cannot assign " << size << " values to a row of " << size_;
+      throw eckit::BadParameter(msg.str(), Here());
+    }
+  }
+
+  DATATYPE * data_;
+  size_t size_;
+};
+
+/// Rows compare equal to rows and vectors holding the same values, as the vectors they
+/// replaced did.
+template <typename T, typename U>
+bool operator==(const ObsDataRow<T> & lhs, const ObsDataRow<U> & rhs) {
+  return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+template <typename T>
+bool operator==(const ObsDataRow<T> & lhs,
+                const std::vector<typename ObsDataRow<T>::value_type> & rhs) {
+  return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+template <typename T>
+bool operator==(const std::vector<typename ObsDataRow<T>::value_type> & lhs,
+                const ObsDataRow<T> & rhs) {
+  return rhs == lhs;
+}
+template <typename T, typename U>
+bool operator!=(const ObsDataRow<T> & lhs, const ObsDataRow<U> & rhs) {return !(lhs == rhs);}
+template <typename T>
+bool operator!=(const ObsDataRow<T> & lhs,
+                const std::vector<typename ObsDataRow<T>::value_type> & rhs) {
+  return !(lhs == rhs);
+}
+template <typename T>
+bool operator!=(const std::vector<typename ObsDataRow<T>::value_type> & lhs,
+                const ObsDataRow<T> & rhs) {
+  return !(rhs == lhs);
+}
 
 //-----------------------------------------------------------------------------
 //! ObsDataVector<DATATYPE> handles vectors of data of type DATATYPE in observation space
@@ -77,26 +186,52 @@ class ObsDataVector: public util::Printable,
   const ObsSpace & space() const {return obsdb_;}
   size_t nvars() const {return nvars_;}  // Size in (local) memory
   size_t nlocs() const {return nlocs_;}  // Size in (local) memory
-  bool has(const std::string & vargrp) const {return obsvars_.has(vargrp);}
+  bool has(const std::string & vargrp) const {return varIndex_.count(vargrp) > 0;}
+
+  ObsDataRow<const DATATYPE> operator[](const size_t ii) const {
+    ASSERT(ii < nvars_);
+    return ObsDataRow<const DATATYPE>(values_.get() + ii * nlocs_, nlocs_);
+  }
+  ObsDataRow<DATATYPE> operator[](const size_t ii) {
+    ASSERT(ii < nvars_);
+    return ObsDataRow<DATATYPE>(values_.get() + ii * nlocs_, nlocs_);
+  }
+
+  ObsDataRow<const DATATYPE> operator[](const std::string & var) const {
+    return (*this)[varIndex(var)];
+  }
+  ObsDataRow<DATATYPE> operator[](const std::string & var) {return (*this)[varIndex(var)];}
 
-  const ObsDataRow<DATATYPE> & operator[](const size_t ii) const {return rows_.at(ii);}
-  ObsDataRow<DATATYPE> & operator[](const size_t ii) {return rows_.at(ii);}
+  /// Unchecked access to the value of variable \p jv at location \p jl.
+  const DATATYPE & operator()(const size_t jv, const size_t jl) const {
+    return values_[jv * nlocs_ + jl];
+  }
+  DATATYPE & operator()(const size_t jv, const size_t jl) {return values_[jv * nlocs_ + jl];}
 
-  const ObsDataRow<DATATYPE> & operator[](const std::string var) const
-    {return rows_.at(obsvars_.find(var));}
-  ObsDataRow<DATATYPE> & operator[](const std::string var) {return rows_.at(obsvars_.find(var));}
+  /// All values, variable by variable: nvars() rows of nlocs() values each.
+  const DATATYPE * data() const {return values_.get();}
+  DATATYPE * data() {return values_.get();}
 
   const std::string & obstype() const {return obsdb_.obsname();}
   const oops::Variables & varnames() const {return obsvars_;}
 
  private:
   void print(std::ostream &) const;
+  /// Variables that are channels of the same (location, channel) variable of group \p grp,
+  /// keyed by the name of that variable: their channel numbers and their rows.
+  std::map<std::string, std::pair<std::vector<int>, std::vector<size_t>>>
+    channelGroups(const std::string & grp, const bool skipDerived) const;
+  void indexVariables();
+  size_t varIndex(const std::string &) const;
 
   ObsSpace & obsdb_;
   oops::Variables obsvars_;
   size_t nvars_;
   size_t nlocs_;
-  std::vector<ObsDataRow<DATATYPE> > rows_;
+  /// nvars_ rows of nlocs_ values. Not a std::vector, which would pack ObsDataVector<bool>
+  /// into bits that rows could not point to.
+  std::unique_ptr<DATATYPE[]> values_;
+  std::unordered_map<std::string, size_t> varIndex_;
   const DATATYPE missing_;
 };
 
@@ -106,13 +241,11 @@ ObsDataVector<DATATYPE>::ObsDataVector(ObsSpace & obsdb, const oops::Variables &
                                        const std::string & grp, const bool fail,
                                        const bool skipDerived)
   : obsdb_(obsdb), obsvars_(vars), nvars_(obsvars_.size()),
-    nlocs_(obsdb_.nlocs()), rows_(nvars_),
+    nlocs_(obsdb_.nlocs()), values_(new DATATYPE[nvars_ * nlocs_]()),
     missing_(util::missingValue(DATATYPE()))
 {
   oops::Log::trace() << "ObsDataVector::ObsDataVector start" << std::endl;
-  for (size_t jj = 0; jj < nvars_; ++jj) {
-    rows_[jj].resize(nlocs_);
-  }
+  indexVariables();
   if (!grp.empty()) this->read(grp, fail, skipDerived);
   oops::Log::trace() << "ObsDataVector::ObsDataVector done" << std::endl;
 }
@@ -122,11 +255,11 @@ ObsDataVector<DATATYPE>::ObsDataVector(ObsSpace & obsdb, const std::string & var
                                        const std::string & grp, const bool fail,
                                        const bool skipDerived)
   : obsdb_(obsdb), obsvars_(std::vector<std::string>(1, var)), nvars_(1),
-    nlocs_(obsdb_.nlocs()), rows_(1),
+    nlocs_(obsdb_.nlocs()), values_(new DATATYPE[nlocs_]()),
     missing_(util::missingValue(DATATYPE()))
 {
   oops::Log::trace() << "ObsDataVector::ObsDataVector start" << std::endl;
-  rows_[0].resize(nlocs_);
+  indexVariables();
   if (!grp.empty()) this->read(grp, fail, skipDerived);
   oops::Log::trace() << "ObsDataVector::ObsDataVector done" << std::endl;
 }
@@ -134,22 +267,17 @@ ObsDataVector<DATATYPE>::ObsDataVector(ObsSpace & obsdb, const std::string & var
 template <typename DATATYPE>
 ObsDataVector<DATATYPE>::ObsDataVector(ObsVector & vect)
   : obsdb_(vect.space()), obsvars_(vect.varnames()), nvars_(vect.nvars()), nlocs_(vect.nlocs()),
-    rows_(nvars_), missing_(util::missingValue(DATATYPE()))
+    values_(new DATATYPE[nvars_ * nlocs_]()), missing_(util::missingValue(DATATYPE()))
 {
   oops::Log::trace() << "ObsDataVector::ObsDataVector ObsVector start" << std::endl;
   const double dmiss = util::missingValue(dmiss);
-  for (size_t jv = 0; jv < nvars_; ++jv) {
-    rows_[jv].resize(nlocs_);
-  }
+  indexVariables();
+  // vect is ordered location by location; transpose it into rows.
   size_t ii = 0;
   for (size_t jl = 0; jl < nlocs_; ++jl) {
     for (size_t jv = 0; jv < nvars_; ++jv) {
-       if (vect[ii] == dmiss) {
-         rows_[jv][jl] = missing_;
-       } else {
-         rows_[jv][jl] = static_cast<DATATYPE>(vect[ii]);
-       }
-       ++ii;
+       const double value = vect[ii++];
+       (*this)(jv, jl) = (value == dmiss) ? missing_ : static_cast<DATATYPE>(value);
     }
   }
   oops::Log::trace() << "ObsDataVector::ObsDataVector ObsVector done" << std::endl;
@@ -158,7 +286,9 @@ ObsDataVector<DATATYPE>::ObsDataVector(ObsVector & vect)
 template <typename DATATYPE>
 ObsDataVector<DATATYPE>::ObsDataVector(const ObsDataVector & other)
   : obsdb_(other.obsdb_), obsvars_(other.obsvars_), nvars_(other.nvars_),
-    nlocs_(other.nlocs_), rows_(other.rows_), missing_(util::missingValue(DATATYPE())) {
+    nlocs_(other.nlocs_), values_(new DATATYPE[nvars_ * nlocs_]),
+    varIndex_(other.varIndex_), missing_(util::missingValue(DATATYPE())) {
+  std::copy(other.values_.get(), other.values_.get() + nvars_ * nlocs_, values_.get());
   oops::Log::trace() << "ObsDataVector copied" << std::endl;
 }
 // -----------------------------------------------------------------------------
@@ -169,31 +299,32 @@ template <typename DATATYPE>
 ObsDataVector<DATATYPE> & ObsDataVector<DATATYPE>::operator= (const ObsDataVector<DATATYPE> & rhs) {
   oops::Log::trace() << "ObsDataVector::operator= start" << std::endl;
   ASSERT(&obsdb_ == &rhs.obsdb_);
+  if (&rhs == this) return *this;
+  if (nvars_ * nlocs_ != rhs.nvars_ * rhs.nlocs_)
+    values_.reset(new DATATYPE[rhs.nvars_ * rhs.nlocs_]);
   obsvars_ = rhs.obsvars_;
   nvars_ = rhs.nvars_;
   nlocs_ = rhs.nlocs_;
-  rows_ = rhs.rows_;
+  varIndex_ = rhs.varIndex_;
+  std::copy(rhs.values_.get(), rhs.values_.get() + nvars_ * nlocs_, values_.get());
   oops::Log::trace() << "ObsDataVector::operator= done" << std::endl;
   return *this;
 }
 // -----------------------------------------------------------------------------
 template <typename DATATYPE>
 void ObsDataVector<DATATYPE>::zero() {
-  for (size_t jv = 0; jv < nvars_; ++jv) {
-    for (size_t jj = 0; jj < nlocs_; ++jj) {
-      rows_.at(jv).at(jj) = static_cast<DATATYPE>(0);
-    }
-  }
+  std::fill(values_.get(), values_.get() + nvars_ * nlocs_, static_cast<DATATYPE>(0));
 }
 // -----------------------------------------------------------------------------
 template <typename DATATYPE>
 void ObsDataVector<DATATYPE>::mask(const ObsDataVector<int> & flags) {
   ASSERT(nvars_ == flags.nvars());
   ASSERT(nlocs_ == flags.nlocs());
-  for (size_t jv = 0; jv < nvars_; ++jv) {
-    for (size_t jj = 0; jj < nlocs_; ++jj) {
-      if (flags[jv][jj] > 0) rows_.at(jv).at(jj) = missing_;
-    }
+  const int * flag = flags.data();
+  DATATYPE * value = values_.get();
+  const size_t nn = nvars_ * nlocs_;
+  for (size_t jj = 0; jj < nn; ++jj) {
+    if (flag[jj] > 0) value[jj] = missing_;
   }
 }
 // -----------------------------------------------------------------------------
@@ -206,14 +337,23 @@ void ObsDataVector<DATATYPE>::read(const std::string & name, const bool fail,
   // Only need to read data when nlocs_ is greater than 0.
   // e.g. if there is no obs. on current MPI task, no read needed.
   if ( nlocs_ > 0 ) {
-    std::vector<DATATYPE> tmp(nlocs_);
+    // Channels of the same (location, channel) variable are read in one go.
+    std::vector<bool> done(nvars_, false);
+    for (const auto & chanVar : channelGroups(name, skipDerived)) {
+      const std::vector<size_t> & jvs = chanVar.second.second;
+      std::vector<DATATYPE *> rows;
+      for (size_t jv : jvs) rows.push_back(values_.get() + jv * nlocs_);
+      if (obsdb_.get_db_channels(name, chanVar.first, chanVar.second.first, rows, skipDerived))
+        for (size_t jv : jvs) done[jv] = true;
+    }
 
+    std::vector<DATATYPE> tmp(nlocs_);
     for (size_t jv = 0; jv < nvars_; ++jv) {
+      if (done[jv]) continue;
       if (fail || obsdb_.has(name, obsvars_.variables()[jv])) {
         obsdb_.get_db(name, obsvars_.variables()[jv], tmp, {}, skipDerived);
-        for (size_t jj = 0; jj < nlocs_; ++jj) {
-          rows_.at(jv).at(jj) = tmp.at(jj);
-        }
+        ASSERT(tmp.size() == nlocs_);
+        std::copy(tmp.begin(), tmp.end(), values_.get() + jv * nlocs_);
       }
     }
   }
@@ -222,11 +362,21 @@ void ObsDataVector<DATATYPE>::read(const std::string & name, const bool fail,
 template <typename DATATYPE>
 void ObsDataVector<DATATYPE>::save(const std::string & name) const {
   oops::Log::trace() << "ObsDataVector::save, name = " << name << std::endl;
+  // Channels of the same (location, channel) variable are written in one go.
+  std::vector<bool> done(nvars_, false);
+  for (const auto & chanVar : channelGroups(name, false)) {
+    const std::vector<size_t> & jvs = chanVar.second.second;
+    std::vector<const DATATYPE *> rows;
+    for (size_t jv : jvs) rows.push_back(values_.get() + jv * nlocs_);
+    if (obsdb_.put_db_channels(name, chanVar.first, chanVar.second.first, rows))
+      for (size_t jv : jvs) done[jv] = true;
+  }
+
   std::vector<DATATYPE> tmp(nlocs_);
   for (size_t jv = 0; jv < nvars_; ++jv) {
-    for (std::size_t jj = 0; jj < tmp.size(); ++jj) {
-      tmp.at(jj) = rows_.at(jv).at(jj);
-    }
+    if (done[jv]) continue;
+    const DATATYPE * row = values_.get() + jv * nlocs_;
+    std::copy(row, row + nlocs_, tmp.begin());
     obsdb_.put_db(name, obsvars_.variables()[jv], tmp);
   }
 }
@@ -237,7 +387,6 @@ void ObsDataVector<DATATYPE>::assignToExistingVariables(const ObsVector & vect)
   const double dmiss = util::missingValue(dmiss);
   std::vector<size_t> inds(nvars_);
   for (size_t jv = 0; jv < nvars_; ++jv) {
-    rows_[jv].resize(nlocs_);
     if (vect.varnames().has(obsvars_[jv])) {
       inds[jv] = vect.varnames().find(obsvars_[jv]);
     } else {
@@ -247,19 +396,54 @@ void ObsDataVector<DATATYPE>::assignToExistingVariables(const ObsVector & vect)
                             " not found in ObsVector", Here());
     }
   }
+  const size_t vectnvars = vect.nvars();
   for (size_t jv = 0; jv < nvars_; ++jv) {
+    DATATYPE * row = values_.get() + jv * nlocs_;
     for (size_t jl = 0; jl < nlocs_; ++jl) {
-      size_t vectindex = jl*vect.nvars()+inds[jv];
-      if (vect[vectindex] == dmiss) {
-        rows_[jv][jl] = missing_;
-      } else {
-        rows_[jv][jl] = static_cast<DATATYPE>(vect[vectindex]);
-      }
+      const double value = vect[jl * vectnvars + inds[jv]];
+      row[jl] = (value == dmiss) ? missing_ : static_cast<DATATYPE>(value);
     }
   }
   oops::Log::trace() << "ObsDataVector::assignToExistingVariables done" << std::endl;
 }
 // -----------------------------------------------------------------------------
+template <typename DATATYPE>
+std::map<std::string, std::pair<std::vector<int>, std::vector<size_t>>>
+ObsDataVector<DATATYPE>::channelGroups(const std::string & grp, const bool skipDerived) const {
+  std::map<std::string, std::pair<std::vector<int>, std::vector<size_t>>> groups;
+  std::string varName;
+  int channel;
+  for (size_t jv = 0; jv < nvars_; ++jv) {
+    if (obsdb_.splitChannelName(grp, obsvars_.variables()[jv], varName, channel, skipDerived)) {
+      groups[varName].first.push_back(channel);
+      groups[varName].second.push_back(jv);
+    }
+  }
+  // A lone channel gains nothing from a 2-D transfer.
+  for (auto it = groups.begin(); it != groups.end(); ) {
+    if (it->second.second.size() < 2)
+      it = groups.erase(it);
+    else
+      ++it;
+  }
+  return groups;
+}
+// -----------------------------------------------------------------------------
+template <typename DATATYPE>
+void ObsDataVector<DATATYPE>::indexVariables() {
+  varIndex_.clear();
+  // Keep the first of any repeated names, as oops::Variables::find does.
+  for (size_t jv = 0; jv < nvars_; ++jv) varIndex_.emplace(obsvars_[jv], jv);
+}
+// -----------------------------------------------------------------------------
+template <typename DATATYPE>
+size_t ObsDataVector<DATATYPE>::varIndex(const std::string & var) const {
+  const auto found = varIndex_.find(var);
+  if (found == varIndex_.end())
+    throw eckit::BadParameter("ObsDataVector has no variable " + var, Here());
+  return found->second;
+}
+// -----------------------------------------------------------------------------
 /// Print statistics describing a vector \p obsdatavector of observations taken from \p obsdb
 /// to the stream \p os.
 ///
@@ -275,7 +459,8 @@ void printNonnumericObsDataVectorStats(const ObsDataVector<DATATYPE> &obsdatavec
     int nloc = obsdb.globalNumLocs();
     // collect nobs on all processors
     int nobs = globalNumNonMissingObs(*obsdb.distribution(),
-                                      obsdatavector.nvars(), obsdatavector[jv]);
+                                      obsdatavector.nvars(),
+                                      std::vector<DATATYPE>(obsdatavector[jv]));
 
     os << obsdb.obsname() << " " << obsdatavector.varnames()[jv] << " nlocs = " << nloc
        << ", nobs = " << nobs << std::endl;
@@ -301,9 +486,9 @@ void printNumericObsDataVectorStats(const ObsDataVector<DATATYPE> &obsdatavector
         obsdb.distribution()->createAccumulator<DATATYPE>();
     int nloc = obsdb.globalNumLocs();
 
-    const std::vector<DATATYPE> &vector = obsdatavector[jv];
+    const ObsDataRow<const DATATYPE> row = obsdatavector[jv];
     for (size_t jj = 0; jj < obsdatavector.nlocs(); ++jj) {
-      DATATYPE zz = vector.at(jj);
+      DATATYPE zz = row[jj];
       if (zz != missing) {
         if (zz < zmin) zmin = zz;
         if (zz > zmax) zmax = zz;
@@ -314,7 +499,7 @@ void printNumericObsDataVectorStats(const ObsDataVector<DATATYPE> &obsdatavector
     obsdb.distribution()->min(zmin);
     obsdb.distribution()->max(zmax);
     DATATYPE zsum = accumulator->computeResult();
-    int nobs = globalNumNonMissingObs(*obsdb.distribution(), 1, vector);
+    int nobs = globalNumNonMissingObs(*obsdb.distribution(), 1, std::vector<DATATYPE>(row));
 
     os << std::endl << obsdb.obsname() << " " << obsdatavector.varnames()[jv]
        << " nlocs = " << nloc << ", nobs = " << nobs;
@@ -7,6 +7,9 @@
 
 #include "ioda/ObsSpace.h"
 
+#include <glob.h>
+#include <sys/stat.h>
+
 #include <algorithm>
 #include <cmath>
 #include <fstream>
@@ -14,12 +17,16 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "eckit/config/Configuration.h"
+#include "eckit/config/LocalConfiguration.h"
 #include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/geometry/Point2.h"
 
 #include "oops/mpi/mpi.h"
 #include "oops/util/abor1_cpp.h"
@@ -31,12 +38,14 @@
 #include "oops/util/stringFunctions.h"
 
 #include "ioda/Copying.h"
+#include "ioda/core/Snapshot.h"
 #include "ioda/distribution/Accumulator.h"
 #include "ioda/distribution/DistributionFactory.h"
 #include "ioda/distribution/DistributionUtils.h"
 #include "ioda/distribution/PairOfDistributions.h"
 #include "ioda/Engines/EngineUtils.h"
 #include "ioda/Engines/HH.h"
+#include "ioda/Engines/ObsStore.h"
 #include "ioda/Exception.h"
 #include "ioda/Io/IoPool.h"
 #include "ioda/io/ObsFrameRead.h"
@@ -61,6 +70,41 @@ bool extractChannelSuffixIfPresent(const std::string &name,
     return false;
 }
 
+// Write the name, size and modification time of each input file named in the obsdatain
+// engine configuration \p engineConf to \p os. File names holding glob wildcards are
+// expanded, so a file that starts or stops matching the pattern is noticed too.
+void writeInputFileStats(const eckit::Configuration &engineConf, std::ostream &os) {
+    std::vector<std::string> patterns;
+    for (const std::string key : {"obsfile", "mapping file", "query file"}) {
+        if (engineConf.has(key)) patterns.push_back(engineConf.getString(key));
+    }
+    if (engineConf.has("obsfiles")) {
+        const std::vector<std::string> names = engineConf.getStringVector("obsfiles");
+        patterns.insert(patterns.end(), names.begin(), names.end());
+    }
+
+    for (const std::string &pattern : patterns) {
+        std::vector<std::string> fileNames;
+        glob_t matches;
+        if (glob(pattern.c_str(), GLOB_NOCHECK, nullptr, &matches) == 0) {
+            fileNames.assign(matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+        } else {
+            fileNames.push_back(pattern);
+        }
+        globfree(&matches);
+
+        for (const std::string &fileName : fileNames) {
+            struct stat fileStat;
+            os << "\n" << fileName << " ";
+            if (stat(fileName.c_str(), &fileStat) == 0) {
+                os << fileStat.st_size << " " << fileStat.st_mtime;
+            } else {
+                os << "missing";
+            }
+        }
+    }
+}
+
 }  // namespace
 
 // ----------------------------- public functions ------------------------------
@@ -116,20 +160,31 @@ ObsSpace::ObsSpace(const Parameters_ & params, const eckit::mpi::Comm & comm,
                    const eckit::mpi::Comm & timeComm)
                      : oops::ObsSpaceBase(params, comm, bgn, end),
                        winbgn_(bgn), winend_(end), commMPI_(comm),
-                       gnlocs_(0), nrecs_(0), obsvars_(),
-                       obs_group_(), obs_params_(params, bgn, end, comm, timeComm)
+                       gnlocs_(0), gnlocs_skipped_(0), nrecs_(0), obsvars_(),
+                       obs_group_(), obs_params_(params, bgn, end, comm, timeComm),
+                       recidx_is_sorted_(false), restored_from_snapshot_(false)
 {
     // Read the obs space name
     obsname_ = obs_params_.top_level_.obsSpaceName;
 
-    // Open the source (ObsFrame) of the data for initializing the obs_group_ (ObsGroup)
-    ObsFrameRead obsFrame(obs_params_);
+    restored_from_snapshot_ = restoreSnapshot();
+    if (!restored_from_snapshot_) {
+        // Open the source (ObsFrame) of the data for initializing the obs_group_ (ObsGroup)
+        ObsFrameRead obsFrame(obs_params_);
 
-    // Retrieve the MPI distribution object
-    dist_ = obsFrame.distribution();
+        // Retrieve the MPI distribution object
+        dist_ = obsFrame.distribution();
 
-    createObsGroupFromObsFrame(obsFrame);
-    initFromObsSource(obsFrame);
+        createObsGroupFromObsFrame(obsFrame);
+        initFromObsSource(obsFrame);
+
+        // After walking through all the frames, gnlocs_ and gnlocs_outside_timewindow_
+        // are set representing the entire file. This is because they are calculated
+        // before doing the MPI distribution.
+        gnlocs_ = obsFrame.globalNumLocs();
+        gnlocs_outside_timewindow_ = obsFrame.globalNumLocsOutsideTimeWindow();
+        gnlocs_skipped_ = obsFrame.numLocsSkipped();
+    }
 
     // Get list of observed variables
     // Either read from yaml list, use all variables in input file if 'obsdatain' is specified
@@ -189,39 +244,47 @@ ObsSpace::ObsSpace(const Parameters_ & params, const eckit::mpi::Comm & comm,
       }
     }
 
-    // After walking through all the frames, gnlocs_ and gnlocs_outside_timewindow_
-    // are set representing the entire file. This is because they are calculated
-    // before doing the MPI distribution.
-    gnlocs_ = obsFrame.globalNumLocs();
-    gnlocs_outside_timewindow_ = obsFrame.globalNumLocsOutsideTimeWindow();
-
-    if (this->obs_sort_var() != "") {
-      buildSortedObsGroups();
-      recidx_is_sorted_ = true;
-    } else {
-      // Fill the recidx_ map with indices that represent each group, but are not
-      // sorted. This is done so the recidx_ structure can be used to walk
-      // through the individual groups. For example, this can be used to calculate
-      // RMS values for each group.
-      buildRecIdxUnsorted();
-      recidx_is_sorted_ = false;
-    }
+    // A snapshot already holds the indices and variables set up below.
+    if (!restored_from_snapshot_) {
+        if (this->obs_sort_var() != "") {
+          buildSortedObsGroups();
+          recidx_is_sorted_ = true;
+        } else {
+          // Fill the recidx_ map with indices that represent each group, but are not
+          // sorted. This is done so the recidx_ structure can be used to walk
+          // through the individual groups. For example, this can be used to calculate
+          // RMS values for each group.
+          buildRecIdxUnsorted();
+          recidx_is_sorted_ = false;
+        }
 
-    fillChanNumToIndexMap();
+        fillChanNumToIndexMap();
 
-    if (obs_params_.top_level_.obsExtend.value() != boost::none) {
-        extendObsSpace(*(obs_params_.top_level_.obsExtend.value()));
-    }
+        if (obs_params_.top_level_.obsExtend.value() != boost::none) {
+            extendObsSpace(*(obs_params_.top_level_.obsExtend.value()));
+        }
 
-    const auto & distParams = obs_params_.top_level_.distribution.value().params.value();
+        createMissingObsErrors();
 
-    createMissingObsErrors();
+        const auto & snapshotParams = obs_params_.top_level_.snapshot.value();
+        if ((snapshotParams != boost::none) && snapshotParams->write) {
+            writeSnapshot();
+        }
+    }
 
     oops::Log::debug() << obsname() << ": " << globalNumLocsOutsideTimeWindow()
       << " observations are outside of time window out of "
       << (globalNumLocsOutsideTimeWindow() + globalNumLocs())
       << std::endl;
 
+    // The variables are loaded: compress the ones stored compressed.
+    Engines::ObsStore::compactGroup(obs_group_);
+    chargeIndexMemory();
+    Engines::ObsStore::MemoryStatistics memoryStats;
+    if (Engines::ObsStore::getMemoryStatistics(obs_group_, memoryStats)) {
+        oops::Log::info() << obsname() << ": ObsStore memory " << memoryStats << std::endl;
+    }
+
     oops::Log::trace() << "ObsSpace::ObsSpace constructed name = " << obsname() << std::endl;
 }
 
@@ -231,6 +294,7 @@ void ObsSpace::save() {
         // Write the output file
         IoPool obsPool(obs_params_.top_level_.ioPool,
             obs_params_.top_level_.obsDataOut.value()->engine.value().engineParameters,
+            obs_params_.top_level_.obsDataOut.value()->compression,
             obs_params_.comm(), obs_params_.timeComm() ,
             obs_params_.windowStart(), obs_params_.windowEnd(), nlocs());
         obsPool.save(obs_group_);
@@ -242,6 +306,39 @@ void ObsSpace::save() {
     } else {
         oops::Log::info() << obsname() << " :  no output" << std::endl;
     }
+
+    Engines::ObsStore::ArenaStatistics arenaStats;
+    if (Engines::ObsStore::getArenaStatistics(obs_group_, arenaStats)) {
+        oops::Log::info() << obsname() << ": ObsStore arena " << arenaStats << std::endl;
+    }
+    Engines::ObsStore::MemoryStatistics memoryStats;
+    if (Engines::ObsStore::getMemoryStatistics(obs_group_, memoryStats)) {
+        oops::Log::info() << obsname() << ": ObsStore memory " << memoryStats << std::endl;
+    }
+}
+
+// -----------------------------------------------------------------------------
+Engines::ObsStore::MemoryStatistics ObsSpace::memoryStatistics() const {
+    Engines::ObsStore::MemoryStatistics memoryStats;
+    Engines::ObsStore::getMemoryStatistics(obs_group_, memoryStats);
+    return memoryStats;
+}
+
+// -----------------------------------------------------------------------------
+void ObsSpace::chargeIndexMemory() {
+    // Estimates from the container sizes; a map node holds three pointers and a color
+    // besides its value.
+    const std::size_t mapNodeOverhead = 4 * sizeof(void *);
+    std::size_t indexBytes = (indx_.capacity() + recnums_.capacity()) * sizeof(std::size_t);
+    for (const auto & rec : recidx_) {
+        indexBytes += mapNodeOverhead + sizeof(RecIdxMap::value_type) +
+                      rec.second.capacity() * sizeof(std::size_t);
+    }
+    indexBytes += chan_num_to_index_.size() *
+                  (mapNodeOverhead + sizeof(std::map<int, int>::value_type));
+    Engines::ObsStore::setExternalBytes(obs_group_, "index", indexBytes);
+    Engines::ObsStore::setExternalBytes(obs_group_, "distribution",
+                                        dist_ ? dist_->memoryBytes() : 0);
 }
 
 // -----------------------------------------------------------------------------
@@ -473,6 +570,64 @@ void ObsSpace::put_db(const std::string & group, const std::string & name,
     saveVar(group, name, boolsAsBytes, dimList);
 }
 
+// -----------------------------------------------------------------------------
+bool ObsSpace::splitChannelName(const std::string & group, const std::string & name,
+                                std::string & varName, int & channel, bool skipDerived) const {
+    std::vector<int> channels;
+    splitChanSuffix(group, name, { }, varName, channels, skipDerived);
+    if (channels.size() != 1 || chan_num_to_index_.count(channels[0]) == 0) return false;
+    channel = channels[0];
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ObsSpace::get_db_channels(const std::string & group, const std::string & name,
+                               const std::vector<int> & channels,
+                               const std::vector<int *> & rows, bool skipDerived) const {
+    Variable var;
+    if (!openChannelVar(group, name, skipDerived, var)) return false;
+    loadChannels<int>(var, channels, rows);
+    return true;
+}
+
+bool ObsSpace::get_db_channels(const std::string & group, const std::string & name,
+                               const std::vector<int> & channels,
+                               const std::vector<float *> & rows, bool skipDerived) const {
+    Variable var;
+    if (!openChannelVar(group, name, skipDerived, var)) return false;
+    loadChannels<float>(var, channels, rows);
+    return true;
+}
+
+bool ObsSpace::get_db_channels(const std::string & group, const std::string & name,
+                               const std::vector<int> & channels,
+                               const std::vector<double *> & rows, bool skipDerived) const {
+    // As in get_db, doubles are held as floats.
+    Variable var;
+    if (!openChannelVar(group, name, skipDerived, var)) return false;
+    loadChannels<float>(var, channels, rows);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool ObsSpace::put_db_channels(const std::string & group, const std::string & name,
+                               const std::vector<int> & channels,
+                               const std::vector<const int *> & rows) {
+    return saveChannels<int>(group, name, channels, rows);
+}
+
+bool ObsSpace::put_db_channels(const std::string & group, const std::string & name,
+                               const std::vector<int> & channels,
+                               const std::vector<const float *> & rows) {
+    return saveChannels<float>(group, name, channels, rows);
+}
+
+bool ObsSpace::put_db_channels(const std::string & group, const std::string & name,
+                               const std::vector<int> & channels,
+                               const std::vector<const double *> & rows) {
+    return saveChannels<float>(group, name, channels, rows);
+}
+
 // -----------------------------------------------------------------------------
 const ObsSpace::RecIdxIter ObsSpace::recidx_begin() const {
   return recidx_.begin();
@@ -573,18 +728,8 @@ void ObsSpace::createObsGroupFromObsFrame(ObsFrameRead & obsFrame) {
         }
     }
 
-    // Create the backend for obs_group_
-    Engines::BackendNames backendName = Engines::BackendNames::ObsStore;  // Hdf5Mem; ObsStore;
-    Engines::BackendCreationParameters backendParams;
-    // These parameters only matter if Hdf5Mem is the engine selected. ObsStore ignores.
-    backendParams.action = Engines::BackendFileActions::Create;
-    backendParams.createMode = Engines::BackendCreateModes::Truncate_If_Exists;
-    backendParams.fileName = ioda::Engines::HH::genUniqueName();
-    backendParams.allocBytes = 1024*1024*50;
-    backendParams.flush = false;
-    Group backend = constructBackend(backendName, backendParams);
-
     // Create the ObsGroup and attach the backend.
+    Group backend = createObsStoreBackend();
     obs_group_ = ObsGroup::generate(backend, newDims);
 
     // fill in dimension coordinate values
@@ -621,6 +766,213 @@ void ObsSpace::createObsGroupFromObsFrame(ObsFrameRead & obsFrame) {
     }
 }
 
+// -----------------------------------------------------------------------------
+Group ObsSpace::createObsStoreBackend() const {
+    Engines::BackendNames backendName = Engines::BackendNames::ObsStore;  // Hdf5Mem; ObsStore;
+    Engines::BackendCreationParameters backendParams;
+    // These parameters only matter if Hdf5Mem is the engine selected. ObsStore ignores.
+    backendParams.action = Engines::BackendFileActions::Create;
+    backendParams.createMode = Engines::BackendCreateModes::Truncate_If_Exists;
+    backendParams.fileName = ioda::Engines::HH::genUniqueName();
+    backendParams.allocBytes = 1024*1024*50;
+    backendParams.flush = false;
+    // Only ObsStore uses this: which groups are kept in memory-mapped scratch files.
+    backendParams.obsStoreStorage =
+        obs_params_.top_level_.obsStoreStorage.value().toStorageParameters();
+    return constructBackend(backendName, backendParams);
+}
+
+// -----------------------------------------------------------------------------
+bool ObsSpace::snapshotSupported() const {
+    // The distribution is rebuilt by assigning the records kept on each task again.
+    // The Atlas distribution needs to see every record, and an extended obs space
+    // holds records that the distribution never saw.
+    const std::string distName =
+        obs_params_.top_level_.distribution.value().params.value().name.value();
+    return (obs_params_.top_level_.obsExtend.value() == boost::none) &&
+           ((distName == "RoundRobin") || (distName == "InefficientDistribution") ||
+            (distName == "Halo"));
+}
+
+// -----------------------------------------------------------------------------
+std::string ObsSpace::snapshotFileName() const {
+    std::ostringstream fileName;
+    fileName << obs_params_.top_level_.snapshot.value()->directory.value() << "/" << obsname_;
+    if (obs_params_.timeComm().size() > 1) {
+        fileName << "_" << std::setw(4) << std::setfill('0') << obs_params_.timeComm().rank();
+    }
+    fileName << "_" << std::setw(4) << std::setfill('0') << obs_params_.comm().rank()
+             << ".snapshot";
+    return fileName.str();
+}
+
+// -----------------------------------------------------------------------------
+std::uint64_t ObsSpace::snapshotConfigHash() const {
+    // Only the settings that determine what ends up in the obs space count, so that
+    // for example changing the output file does not invalidate the snapshot. The size and
+    // modification time of the input files stand in for their contents.
+    const ObsTopLevelParameters & params = obs_params_.top_level_;
+    eckit::LocalConfiguration conf;
+    params.obsSpaceName.serialize(conf);
+    params.distribution.serialize(conf);
+    params.simVars.serialize(conf);
+    params.derivedSimVars.serialize(conf);
+    params.ObservedVars.serialize(conf);
+    params.epochDateTime.serialize(conf);
+    params.obsDataIn.serialize(conf);
+
+    std::ostringstream text;
+    text << conf << "\n" << winbgn_ << " " << winend_ << "\n"
+         << obs_params_.comm().rank() << " " << obs_params_.comm().size() << " "
+         << obs_params_.timeComm().rank() << " " << obs_params_.timeComm().size();
+    const eckit::LocalConfiguration obsDataInConf(conf, "obsdatain");
+    if (obsDataInConf.has("engine")) {
+        writeInputFileStats(eckit::LocalConfiguration(obsDataInConf, "engine"), text);
+    }
+    return snapshotHash(text.str());
+}
+
+// -----------------------------------------------------------------------------
+void ObsSpace::writeSnapshot() const {
+    if (!snapshotSupported()) {
+        if (this->comm().rank() == 0) {
+            oops::Log::warning() << "WARNING: " << obsname() << ": no snapshot is written for "
+                                 << "an extended obs space or the "
+                                 << distname() << " distribution" << std::endl;
+        }
+        return;
+    }
+
+    eckit::PathName(obs_params_.top_level_.snapshot.value()->directory.value()).mkdir();
+    SnapshotWriter writer(snapshotFileName(), snapshotConfigHash());
+
+    writer.putValue<std::uint64_t>(gnlocs_);
+    writer.putValue<std::uint64_t>(gnlocs_outside_timewindow_);
+    writer.putValue<std::uint64_t>(gnlocs_skipped_);
+    writer.putValue<std::uint64_t>(nrecs_);
+    writer.putValue<std::uint64_t>(dim_info_.get_dim_size(ObsDimensionId::Nlocs));
+    writer.putValue<std::uint64_t>(dim_info_.get_dim_size(ObsDimensionId::Nchans));
+    writer.putVector(indx_);
+    writer.putVector(recnums_);
+
+    // recidx_ is written as its record numbers, the offsets of each record in a single
+    // array of locations, and that array.
+    writer.putValue<std::uint64_t>(recidx_is_sorted_);
+    std::vector<std::size_t> recidxRecNums;
+    std::vector<std::size_t> recidxOffsets(1, 0);
+    std::vector<std::size_t> recidxLocs;
+    recidxRecNums.reserve(recidx_.size());
+    recidxOffsets.reserve(recidx_.size() + 1);
+    recidxLocs.reserve(this->nlocs());
+    for (const auto & rec : recidx_) {
+        recidxRecNums.push_back(rec.first);
+        recidxLocs.insert(recidxLocs.end(), rec.second.begin(), rec.second.end());
+        recidxOffsets.push_back(recidxLocs.size());
+    }
+    writer.putVector(recidxRecNums);
+    writer.putVector(recidxOffsets);
+    writer.putVector(recidxLocs);
+
+    std::vector<int> chanNumbers;
+    std::vector<int> chanIndices;
+    for (const auto & chan : chan_num_to_index_) {
+        chanNumbers.push_back(chan.first);
+        chanIndices.push_back(chan.second);
+    }
+    writer.putVector(chanNumbers);
+    writer.putVector(chanIndices);
+
+    writer.putGroup(obs_group_);
+    writer.close();
+    oops::Log::info() << obsname() << ": snapshot written to " << snapshotFileName() << std::endl;
+}
+
+// -----------------------------------------------------------------------------
+bool ObsSpace::restoreSnapshot() {
+    const auto & snapshotParams = obs_params_.top_level_.snapshot.value();
+    if ((snapshotParams == boost::none) || !snapshotParams->restore || !snapshotSupported()) {
+        return false;
+    }
+
+    // Rebuilding the distribution is collective, so either every task restores from
+    // its snapshot or none does.
+    const std::string fileName = snapshotFileName();
+    std::unique_ptr<SnapshotReader> reader;
+    int valid = 0;
+    try {
+        reader.reset(new SnapshotReader(fileName));
+        valid = reader->isValid(snapshotConfigHash());
+    } catch (const eckit::Exception &) {
+        valid = 0;
+    }
+    obs_params_.comm().allReduceInPlace(valid, eckit::mpi::min());
+    if (!valid) {
+        oops::Log::info() << obsname() << ": no valid snapshot in "
+                          << snapshotParams->directory.value()
+                          << ", reading the obs source" << std::endl;
+        return false;
+    }
+
+    gnlocs_ = reader->getValue<std::uint64_t>();
+    gnlocs_outside_timewindow_ = reader->getValue<std::uint64_t>();
+    gnlocs_skipped_ = reader->getValue<std::uint64_t>();
+    nrecs_ = reader->getValue<std::uint64_t>();
+    dim_info_.set_dim_size(ObsDimensionId::Nlocs, reader->getValue<std::uint64_t>());
+    dim_info_.set_dim_size(ObsDimensionId::Nchans, reader->getValue<std::uint64_t>());
+    indx_ = reader->getVector<std::size_t>();
+    recnums_ = reader->getVector<std::size_t>();
+
+    recidx_is_sorted_ = reader->getValue<std::uint64_t>();
+    const gsl::span<const std::size_t> recidxRecNums = reader->getArray<std::size_t>();
+    const gsl::span<const std::size_t> recidxOffsets = reader->getArray<std::size_t>();
+    const gsl::span<const std::size_t> recidxLocs = reader->getArray<std::size_t>();
+    for (std::size_t i = 0; i < recidxRecNums.size(); ++i) {
+        recidx_[recidxRecNums[i]].assign(recidxLocs.begin() + recidxOffsets[i],
+                                         recidxLocs.begin() + recidxOffsets[i + 1]);
+    }
+
+    const gsl::span<const int> chanNumbers = reader->getArray<int>();
+    const gsl::span<const int> chanIndices = reader->getArray<int>();
+    for (std::size_t i = 0; i < chanNumbers.size(); ++i) {
+        chan_num_to_index_[chanNumbers[i]] = chanIndices[i];
+    }
+
+    Group backend = createObsStoreBackend();
+    reader->getGroup(backend);
+    obs_group_ = ObsGroup(backend);
+
+    // Assign the records kept on this task to a new distribution, at the locations
+    // they were assigned from.
+    const auto & distParams = obs_params_.top_level_.distribution.value().params.value();
+    std::shared_ptr<Distribution> dist = DistributionFactory::create(obs_params_.comm(),
+                                                                     distParams);
+    std::vector<float> lats;
+    std::vector<float> lons;
+    obs_group_.vars.open("MetaData/latitude").read<float>(lats);
+    obs_group_.vars.open("MetaData/longitude").read<float>(lons);
+    for (std::size_t i = 0; i < indx_.size(); ++i) {
+        dist->assignRecord(recnums_[i], indx_[i], eckit::geometry::Point2(lons[i], lats[i]));
+    }
+    int consistent = std::all_of(recnums_.begin(), recnums_.end(),
+                                 [&dist](std::size_t recNum) { return dist->isMyRecord(recNum); });
+    obs_params_.comm().allReduceInPlace(consistent, eckit::mpi::min());
+    if (!consistent) {
+        oops::Log::warning() << "WARNING: " << obsname() << ": the distribution cannot be "
+                             << "rebuilt from the snapshot, reading the obs source" << std::endl;
+        obs_group_ = ObsGroup();
+        indx_.clear();
+        recnums_.clear();
+        recidx_.clear();
+        chan_num_to_index_.clear();
+        return false;
+    }
+    dist->computePatchLocs();
+    dist_ = dist;
+
+    oops::Log::info() << obsname() << ": restored from snapshot " << fileName << std::endl;
+    return true;
+}
+
 // -----------------------------------------------------------------------------
 template<typename VarType>
 bool ObsSpace::readObsSource(ObsFrameRead & obsFrame,
@@ -872,6 +1224,95 @@ void ObsSpace::saveVar(const std::string & group, std::string name,
 
 // -----------------------------------------------------------------------------
 
+bool ObsSpace::openChannelVar(const std::string & group, const std::string & name,
+                              bool skipDerived, Variable & var) const {
+    // Prefer variables from Derived* groups, as loadVar does.
+    std::string groupToUse = "Derived" + group;
+    if (skipDerived || !obs_group_.vars.exists(fullVarName(groupToUse, name)))
+      groupToUse = group;
+    const std::string nchansVarName = this->get_dim_name(ObsDimensionId::Nchans);
+    if (!obs_group_.vars.exists(fullVarName(groupToUse, name)) ||
+        !obs_group_.vars.exists(nchansVarName))
+        return false;
+
+    // As in loadVar, the channel dimension must be the second of two.
+    var = obs_group_.vars.open(fullVarName(groupToUse, name));
+    return var.getDimensions().dimensionality == 2 &&
+           var.isDimensionScaleAttached(1, obs_group_.vars.open(nchansVarName));
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename FileType, typename VarType>
+void ObsSpace::loadChannels(Variable & var, const std::vector<int> & channels,
+                            const std::vector<VarType *> & rows) const {
+    ASSERT(rows.size() == channels.size());
+    Selection memSelect;
+    Selection obsGroupSelect;
+    const std::size_t numElements =
+        createChannelSelections(var, 1, channels, memSelect, obsGroupSelect);
+    std::vector<FileType> values(numElements);
+    var.read<FileType>(gsl::make_span(values), memSelect, obsGroupSelect);
+
+    // values holds the channels of each location in turn; transpose them into rows.
+    // Missing values are switched over as ConvertVarType does.
+    const FileType fileMissing = util::missingValue(fileMissing);
+    const VarType missing = util::missingValue(missing);
+    const std::size_t nchans = channels.size();
+    const std::size_t nlocs = (nchans == 0) ? 0 : numElements / nchans;
+    for (std::size_t jl = 0; jl < nlocs; ++jl) {
+        const FileType * locValues = values.data() + jl * nchans;
+        for (std::size_t jc = 0; jc < nchans; ++jc) {
+            rows[jc][jl] = (locValues[jc] == fileMissing) ? missing
+                                                          : static_cast<VarType>(locValues[jc]);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+template<typename FileType, typename VarType>
+bool ObsSpace::saveChannels(const std::string & group, const std::string & name,
+                            const std::vector<int> & channels,
+                            const std::vector<const VarType *> & rows) {
+    ASSERT(rows.size() == channels.size());
+    const std::string nchansVarName = this->get_dim_name(ObsDimensionId::Nchans);
+    const std::string fullName = fullVarName(group, name);
+    // saveVar does not split channel suffixes in MetaData either.
+    if (group == "MetaData" || !obs_group_.vars.exists(nchansVarName)) return false;
+    for (int channel : channels)
+        if (chan_num_to_index_.count(channel) == 0) return false;
+
+    Variable nchansVar = obs_group_.vars.open(nchansVarName);
+    Variable var = openCreateVar<FileType>(
+          fullName, {this->get_dim_name(ObsDimensionId::Nlocs), nchansVarName});
+    if (var.getDimensions().dimensionality != 2 || !var.isDimensionScaleAttached(1, nchansVar))
+        return false;
+
+    Selection memSelect;
+    Selection obsGroupSelect;
+    const std::size_t numElements =
+        createChannelSelections(var, 1, channels, memSelect, obsGroupSelect);
+
+    // Transpose the rows into the channels of each location in turn.
+    const FileType fileMissing = util::missingValue(fileMissing);
+    const VarType missing = util::missingValue(missing);
+    const std::size_t nchans = channels.size();
+    const std::size_t nlocs = (nchans == 0) ? 0 : numElements / nchans;
+    std::vector<FileType> values(numElements);
+    for (std::size_t jl = 0; jl < nlocs; ++jl) {
+        FileType * locValues = values.data() + jl * nchans;
+        for (std::size_t jc = 0; jc < nchans; ++jc) {
+            const VarType value = rows[jc][jl];
+            locValues[jc] = (value == missing) ? fileMissing : static_cast<FileType>(value);
+        }
+    }
+    var.write<FileType>(gsl::make_span(values), memSelect, obsGroupSelect);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
 std::size_t ObsSpace::createChannelSelections(const Variable & variable,
                                              std::size_t nchansDimIndex,
                                              const std::vector<int> & channels,
@@ -891,9 +1332,11 @@ std::size_t ObsSpace::createChannelSelections(const Variable & variable,
         }
     }
 
-    // Form index style selection for selecting channels
+    // Form index style selection for selecting channels. The other dimensions are
+    // selected in full with a single start/count pair rather than a list of every index.
     std::vector<Dimensions_t> varDims = variable.getDimensions().dimsCur;
     std::vector<std::vector<Dimensions_t>> dimSelects(varDims.size());
+    std::vector<std::vector<Dimensions_t>> dimCounts(varDims.size());
     Dimensions_t numElements = 1;
     for (std::size_t i = 0; i < varDims.size(); ++i) {
         if (i == nchansDimIndex) {
@@ -902,9 +1345,8 @@ std::size_t ObsSpace::createChannelSelections(const Variable & variable,
             dimSelects[i] = chanIndices;
         } else {
             numElements *= varDims[i];
-            std::vector<Dimensions_t> allIndices(varDims[i]);
-            std::iota(allIndices.begin(), allIndices.end(), 0);
-            dimSelects[i] = allIndices;
+            dimSelects[i] = std::vector<Dimensions_t>(1, 0);
+            dimCounts[i] = std::vector<Dimensions_t>(1, varDims[i]);
         }
     }
 
@@ -926,9 +1368,9 @@ std::size_t ObsSpace::createChannelSelections(const Variable & variable,
     } else {
         // dimension style selection
         obsGroupSelect.extent(varDims)
-                      .select({SelectionOperator::SET, 0, dimSelects[0]});
+                      .select({SelectionOperator::SET, 0, dimSelects[0], dimCounts[0]});
         for (std::size_t i = 1; i < dimSelects.size(); ++i) {
-            obsGroupSelect.select({SelectionOperator::AND, i, dimSelects[i]});
+            obsGroupSelect.select({SelectionOperator::AND, i, dimSelects[i], dimCounts[i]});
         }
     }
 
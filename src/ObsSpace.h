@@ -16,6 +16,7 @@
 #ifndef OBSSPACE_H_
 #define OBSSPACE_H_
 
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -36,6 +37,7 @@
 #include "oops/util/Logger.h"
 #include "ioda/core/IodaUtils.h"
 #include "ioda/distribution/Distribution.h"
+#include "ioda/Engines/ObsStore.h"
 #include "ioda/Misc/Dimensions.h"
 #include "ioda/ObsGroup.h"
 #include "ioda/ObsSpaceParameters.h"
@@ -199,6 +201,11 @@ namespace ioda {
         /// \brief return number of locations from obs source that were outside the time window
         std::size_t globalNumLocsOutsideTimeWindow() const {return gnlocs_outside_timewindow_;}
 
+        /// \brief return number of locations from obs source that were not read at all, since
+        /// the block statistics place them outside the time window
+        /// \details These are among the locations counted by globalNumLocsOutsideTimeWindow().
+        std::size_t globalNumLocsSkipped() const {return gnlocs_skipped_;}
+
         /// \brief return the number of locations in the obs space.
         /// Note that nlocs may be smaller than global unique nlocs due to distribution of obs
         /// across multiple process elements.
@@ -213,6 +220,11 @@ namespace ioda {
         /// optional grouping.
         std::size_t nrecs() const {return nrecs_;}
 
+        /// \brief return the memory held by the obs space on this MPI task
+        /// \details The statistics of the ObsStore backend, with the location indices and
+        ///          the distribution counted as external memory. All zero for other backends.
+        Engines::ObsStore::MemoryStatistics memoryStatistics() const;
+
         /// \brief return the number of variables in the obs space container.
         /// "Variables" refers to the quantities that can be assimilated as opposed to meta data.
         std::size_t nvars() const;
@@ -393,6 +405,79 @@ namespace ioda {
                     const std::vector<bool> & vdata,
                     const std::vector<std::string> & dimList = { "nlocs" });
 
+        /// \brief split a channel suffixed variable name (e.g. "brightnessTemperature_7")
+        ///
+        /// \details Succeeds if \p name is not itself a variable of \p group, but ends with
+        /// an underscore and one of the channel numbers of this ObsSpace. This is how
+        /// get_db and put_db interpret such names.
+        ///
+        /// \param group Name of container group
+        /// \param name Name of container variable, possibly with a channel suffix
+        /// \param varName Set to the name without the channel suffix
+        /// \param channel Set to the channel number
+        /// \param skipDerived See get_db
+        bool splitChannelName(const std::string & group, const std::string & name,
+                              std::string & varName, int & channel,
+                              bool skipDerived = false) const;
+
+        /// \brief transfer several channels of a (location, channel) variable from the
+        /// obs container in one 2-D read
+        ///
+        /// \details Reading channel by channel with get_db resolves the variable name,
+        /// builds a selection and reads once per channel. This reads all of \p channels
+        /// at once and scatters them straight into \p rows.
+        ///
+        /// \param group Name of container group
+        /// \param name Name of container variable, without a channel suffix
+        /// \param channels Channel numbers
+        /// \param rows rows[i] receives nlocs values of channel channels[i]
+        /// \param skipDerived See get_db
+        /// \return false, with \p rows untouched, if \p name is not a variable with a
+        /// channel dimension or its values are not of a numeric type. The caller should then
+        /// fall back to get_db.
+        bool get_db_channels(const std::string & group, const std::string & name,
+                             const std::vector<int> & channels,
+                             const std::vector<int *> & rows, bool skipDerived = false) const;
+        bool get_db_channels(const std::string & group, const std::string & name,
+                             const std::vector<int> & channels,
+                             const std::vector<float *> & rows, bool skipDerived = false) const;
+        bool get_db_channels(const std::string & group, const std::string & name,
+                             const std::vector<int> & channels,
+                             const std::vector<double *> & rows, bool skipDerived = false) const;
+        template <typename VarType>
+        bool get_db_channels(const std::string &, const std::string &, const std::vector<int> &,
+                             const std::vector<VarType *> &, bool = false) const {
+            return false;
+        }
+
+        /// \brief transfer several channels of a (location, channel) variable to the obs
+        /// container in one 2-D write
+        ///
+        /// \details The counterpart of get_db_channels. The variable is created, with the
+        /// location and channel dimensions, if it does not exist yet.
+        ///
+        /// \param group Name of container group
+        /// \param name Name of container variable, without a channel suffix
+        /// \param channels Channel numbers
+        /// \param rows rows[i] holds nlocs values of channel channels[i]
+        /// \return false, with nothing written, if the variable cannot hold the channels
+        /// (no channel dimension, MetaData group, or a type that is not numeric). The caller
+        /// should then fall back to put_db.
+        bool put_db_channels(const std::string & group, const std::string & name,
+                             const std::vector<int> & channels,
+                             const std::vector<const int *> & rows);
+        bool put_db_channels(const std::string & group, const std::string & name,
+                             const std::vector<int> & channels,
+                             const std::vector<const float *> & rows);
+        bool put_db_channels(const std::string & group, const std::string & name,
+                             const std::vector<int> & channels,
+                             const std::vector<const double *> & rows);
+        template <typename VarType>
+        bool put_db_channels(const std::string &, const std::string &, const std::vector<int> &,
+                             const std::vector<const VarType *> &) {
+            return false;
+        }
+
         /// @}
         /// @name Record index and sorting functions
         /// @{
@@ -410,6 +495,9 @@ namespace ioda {
         /// \brief true if the groups in the recidx data member are sorted
         bool obsAreSorted() const { return recidx_is_sorted_; }
 
+        /// \brief true if the obs space was constructed from a snapshot instead of its source
+        bool restoredFromSnapshot() const { return restored_from_snapshot_; }
+
         /// \brief return record number pointed to by the given iterator
         /// \param irec Iterator into the recidx_ data member
         std::size_t recidx_recnum(const RecIdxIter & irec) const;
@@ -445,6 +533,9 @@ namespace ioda {
         /// \brief number of nlocs from the obs source that are outside the time window
         std::size_t gnlocs_outside_timewindow_;
 
+        /// \brief number of nlocs from the obs source skipped by way of the block statistics
+        std::size_t gnlocs_skipped_;
+
         /// \brief number of records
         std::size_t nrecs_;
 
@@ -493,6 +584,9 @@ namespace ioda {
         /// \brief indicator whether the data in recidx_ is sorted
         bool recidx_is_sorted_;
 
+        /// \brief true if the obs space was constructed from a snapshot
+        bool restored_from_snapshot_;
+
         /// \brief map showing association of dim names with each variable name
         VarUtils::VarDimMap dims_attached_to_vars_;
 
@@ -514,6 +608,33 @@ namespace ioda {
         /// \param obsFrame obs source object
         void createObsGroupFromObsFrame(ObsFrameRead & obsFrame);
 
+        /// \brief create an empty ObsStore backend with the configured storage policies
+        Group createObsStoreBackend() const;
+
+        /// \brief true if this obs space can be written to and restored from a snapshot
+        /// \details The distribution is rebuilt from the locations kept on each task,
+        /// which is not possible for all distributions or for extended obs spaces.
+        bool snapshotSupported() const;
+
+        /// \brief name of the snapshot file of this MPI task
+        std::string snapshotFileName() const;
+
+        /// \brief hash of the settings that determine the contents of the obs space on
+        /// this MPI task
+        std::uint64_t snapshotConfigHash() const;
+
+        /// \brief write the obs space to its snapshot file
+        void writeSnapshot() const;
+
+        /// \brief construct the obs space from its snapshot file
+        /// \details All tasks restore, or none do.
+        /// \returns false, leaving the obs space empty, if any task has no valid snapshot
+        bool restoreSnapshot();
+
+        /// \brief record the memory held by the location indices and the distribution
+        /// with the ObsStore backend
+        void chargeIndexMemory();
+
         /// \brief Extend the ObsSpace according to the method requested in
         ///  the configuration file.
         /// \param params object containing specs for extending the ObsSpace
@@ -604,6 +725,24 @@ namespace ioda {
                      const std::vector<VarType> & varValues,
                      const std::vector<std::string> & dimList);
 
+        /// \brief open the variable read by get_db_channels
+        /// \return false if \p name is not a (location, channel) variable
+        bool openChannelVar(const std::string & group, const std::string & name,
+                            bool skipDerived, Variable & var) const;
+
+        /// \brief read channels of a (location, channel) variable stored as FileType,
+        /// transposing them into rows of VarType
+        template<typename FileType, typename VarType>
+        void loadChannels(Variable & var, const std::vector<int> & channels,
+                          const std::vector<VarType *> & rows) const;
+
+        /// \brief write rows of VarType into channels of a (location, channel) variable
+        /// stored as FileType
+        template<typename FileType, typename VarType>
+        bool saveChannels(const std::string & group, const std::string & name,
+                          const std::vector<int> & channels,
+                          const std::vector<const VarType *> & rows);
+
         /// \brief Create selections of slices of the variable \p variable along dimension
         /// \p nchansDimIndex corresponding to channels \p channels.
         ///
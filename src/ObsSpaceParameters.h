@@ -11,6 +11,7 @@
 
 #include "ioda/core/FileFormat.h"
 #include "ioda/core/ParameterTraitsFileFormat.h"
+#include "ioda/core/ParameterTraitsObsStoreStorage.h"
 #include "ioda/distribution/DistributionFactory.h"
 #include "ioda/Io/IoPoolParameters.h"
 #include "ioda/Misc/DimensionScales.h"
@@ -54,6 +55,92 @@ class ObsExtendParameters : public oops::Parameters {
             this};
 };
 
+class ObsStoreStoragePolicyParameters : public oops::Parameters {
+    OOPS_CONCRETE_PARAMETERS(ObsStoreStoragePolicyParameters, oops::Parameters)
+
+ public:
+    /// Group (e.g. "MetaData") or variable (e.g. "ObsValue/brightnessTemperature")
+    /// that the policy applies to.
+    oops::RequiredParameter<std::string> name{"name", this};
+
+    /// Where the data is kept: "memory", "mapped file", "compressed" or "chunked".
+    oops::RequiredParameter<Engines::ObsStore::StorageKind> storage{"storage", this};
+};
+
+class ObsStoreArenaParameters : public oops::Parameters {
+    OOPS_CONCRETE_PARAMETERS(ObsStoreArenaParameters, oops::Parameters)
+
+ public:
+    /// Take the buffers of in-memory numeric variables from a per-ObsSpace arena.
+    oops::Parameter<bool> enabled{"enabled", false, this};
+
+    /// Ask the kernel to back large buffers with transparent huge pages.
+    oops::Parameter<bool> hugePages{"huge pages", true, this};
+
+    /// Bytes of released buffers kept by the arena for reuse.
+    oops::Parameter<std::size_t> cacheSize{"cache size", 64 * 1024 * 1024, this};
+};
+
+class ObsStoreStorageParameters : public oops::Parameters {
+    OOPS_CONCRETE_PARAMETERS(ObsStoreStorageParameters, oops::Parameters)
+
+ public:
+    /// Storage for variables that none of the policies apply to.
+    oops::Parameter<Engines::ObsStore::StorageKind> defaultStorage{"default",
+        Engines::ObsStore::StorageKind::Memory, this};
+
+    /// Directory holding the files of "mapped file" variables. It should be on
+    /// node-local storage. Defaults to $TMPDIR, or /tmp if that is not set.
+    oops::Parameter<std::string> scratchDirectory{"scratch directory", "", this};
+
+    /// Number of reads after which a "compressed" variable counts as frequently accessed
+    /// and is kept uncompressed from then on. 0 keeps it compressed regardless.
+    oops::Parameter<std::size_t> compressedHotAccesses{"compressed hot access count", 4, this};
+
+    /// Number of locations in each block of a "chunked" variable. Growing a chunked
+    /// variable only allocates new blocks instead of copying the existing values.
+    oops::Parameter<std::size_t> chunkLocations{"chunk locations", 10000, this};
+
+    /// Per group or per variable storage. A policy for a variable overrides the
+    /// policy for its group. String variables are never placed in "mapped file" storage;
+    /// "compressed" string variables are dictionary encoded.
+    oops::Parameter<std::vector<ObsStoreStoragePolicyParameters>> policies{
+        "policies", {}, this};
+
+    /// Allocator used for in-memory numeric variables.
+    oops::Parameter<ObsStoreArenaParameters> arena{"arena", {}, this};
+
+    /// \brief convert to the form taken by the ObsStore engine
+    Engines::ObsStore::StorageParameters toStorageParameters() const {
+        Engines::ObsStore::StorageParameters storage;
+        storage.defaultKind = defaultStorage;
+        storage.scratchDirectory = scratchDirectory;
+        storage.compressedHotAccesses = compressedHotAccesses;
+        storage.chunkLocations = chunkLocations;
+        for (const ObsStoreStoragePolicyParameters & policy : policies.value()) {
+            storage.policies[policy.name] = policy.storage;
+        }
+        storage.arena.enabled = arena.value().enabled;
+        storage.arena.hugePages = arena.value().hugePages;
+        storage.arena.cacheBytes = arena.value().cacheSize;
+        return storage;
+    }
+};
+
+class ObsSpaceSnapshotParameters : public oops::Parameters {
+    OOPS_CONCRETE_PARAMETERS(ObsSpaceSnapshotParameters, oops::Parameters)
+
+ public:
+    /// directory holding the snapshot files (one per MPI task)
+    oops::RequiredParameter<std::string> directory{"directory", this};
+
+    /// write a snapshot once the obs space has been constructed from its source
+    oops::Parameter<bool> write{"write", true, this};
+
+    /// construct the obs space from its snapshot when there is a valid one
+    oops::Parameter<bool> restore{"restore", true, this};
+};
+
 class ObsTopLevelParameters : public oops::ObsSpaceParametersBase {
     OOPS_CONCRETE_PARAMETERS(ObsTopLevelParameters, ObsSpaceParametersBase)
 
@@ -90,6 +177,16 @@ class ObsTopLevelParameters : public oops::ObsSpaceParametersBase {
 
     /// output specification by writing to a file
     oops::OptionalParameter<ObsDataOutParameters> obsDataOut{"obsdataout", this};
+
+    /// where the ObsSpace keeps its variables in memory
+    oops::Parameter<ObsStoreStorageParameters> obsStoreStorage{"obs store storage", {}, this};
+
+    /// \brief binary snapshot of the constructed obs space, to speed up restarts
+    /// \details The snapshot holds the obs space variables and the indices built while
+    /// reading (records, sort order, channels). It is only used when the settings that
+    /// determine the obs space contents, the timing window and the MPI layout all match,
+    /// and the input files have kept their size and modification time.
+    oops::OptionalParameter<ObsSpaceSnapshotParameters> snapshot{"snapshot", this};
 };
 
 class ObsSpaceParameters {
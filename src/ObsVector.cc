@@ -262,14 +262,14 @@ ObsVector & ObsVector::operator=(const ObsDataVector<float> & rhs) {
   ASSERT(rhs.nlocs() == nlocs_);
   const float  fmiss = util::missingValue(fmiss);
   const double dmiss = util::missingValue(dmiss);
+  // Look each variable up once, not once per location.
+  std::vector<const float *> rows(nvars_);
+  for (size_t jv = 0; jv < nvars_; ++jv) rows[jv] = rhs[this->obsvars_[jv]].data();
   size_t ii = 0;
   for (size_t jl = 0; jl < nlocs_; ++jl) {
     for (size_t jv = 0; jv < nvars_; ++jv) {
-       if (rhs[this->obsvars_[jv]][jl] == fmiss) {
-         values_[ii] = dmiss;
-       } else {
-         values_[ii] = static_cast<double>(rhs[this->obsvars_[jv]][jl]);
-       }
+       const float value = rows[jv][jl];
+       values_[ii] = (value == fmiss) ? dmiss : static_cast<double>(value);
        ++ii;
     }
   }
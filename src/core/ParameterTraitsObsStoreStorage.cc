@@ -0,0 +1,16 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include "ioda/core/ParameterTraitsObsStoreStorage.h"
+
+namespace ioda {
+
+constexpr char ObsStoreStorageKindParameterTraitsHelper::enumTypeName[];
+constexpr util::NamedEnumerator<Engines::ObsStore::StorageKind>
+    ObsStoreStorageKindParameterTraitsHelper::namedValues[];
+
+}  // namespace ioda
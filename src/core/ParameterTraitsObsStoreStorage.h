@@ -0,0 +1,45 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef CORE_PARAMETERTRAITSOBSSTORESTORAGE_H_
+#define CORE_PARAMETERTRAITSOBSSTORESTORAGE_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ioda/Engines/ObsStore.h"
+
+#include "oops/util/parameters/ParameterTraits.h"
+
+namespace ioda {
+
+/// Helps with the conversion of ObsStore StorageKind values to/from strings.
+struct ObsStoreStorageKindParameterTraitsHelper {
+  typedef Engines::ObsStore::StorageKind EnumType;
+  static constexpr char enumTypeName[] = "StorageKind";
+  static constexpr util::NamedEnumerator<EnumType> namedValues[] = {
+    { EnumType::Memory, "memory" },
+    { EnumType::MappedFile, "mapped file" },
+    { EnumType::Compressed, "compressed" },
+    { EnumType::Chunked, "chunked" }
+  };
+};
+
+}  // namespace ioda
+
+namespace oops {
+
+/// Specialization of ParameterTraits for ObsStore StorageKind.
+template <>
+struct ParameterTraits<ioda::Engines::ObsStore::StorageKind> :
+    public EnumParameterTraits<ioda::ObsStoreStorageKindParameterTraitsHelper>
+{};
+
+}  // namespace oops
+
+#endif  // CORE_PARAMETERTRAITSOBSSTORESTORAGE_H_
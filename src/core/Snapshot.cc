@@ -0,0 +1,534 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <set>
+#include <utility>
+
+#include "eckit/exception/Exceptions.h"
+
+#include "ioda/core/Snapshot.h"
+#include "ioda/Variables/Fill.h"
+#include "ioda/Variables/VarUtils.h"
+
+namespace ioda {
+
+namespace {
+
+// Marks the start and the end of a snapshot file.
+const char snapshotMagic[8] = {'I', 'O', 'D', 'A', 'S', 'N', 'A', 'P'};
+
+// Increment when the layout of the file changes.
+const std::uint64_t snapshotVersion = 2;
+
+// Size of the header: magic, version and configuration hash.
+const std::size_t snapshotHeaderSize = sizeof(snapshotMagic) + 2 * sizeof(std::uint64_t);
+
+// Arrays start on multiples of this many bytes.
+const std::size_t snapshotAlignment = 8;
+
+// Data types of attributes and variables in a snapshot file.
+enum class SnapshotType : std::uint64_t {
+    Int,
+    Long,
+    Float,
+    Double,
+    String,
+    Char,
+    Int64
+};
+
+// Attributes that describe dimension scales or fill values. Those are set up again
+// from the variable information instead of being copied.
+const std::set<std::string> & skippedAttributes() {
+    static const std::set<std::string> names{
+        "CLASS", "DIMENSION_LIST", "NAME", "REFERENCE_LIST", "_FillValue"};
+    return names;
+}
+
+template <typename T>
+void putAttributeData(SnapshotWriter & writer, const Attribute & attr) {
+    std::vector<T> data(attr.getDimensions().numElements);
+    attr.read<T>(gsl::span<T>(data));
+    writer.putVector(data);
+}
+
+template <>
+void putAttributeData<std::string>(SnapshotWriter & writer, const Attribute & attr) {
+    std::vector<std::string> data(attr.getDimensions().numElements);
+    attr.read<std::string>(gsl::span<std::string>(data));
+    writer.putStrings(data);
+}
+
+template <typename T>
+void getAttributeData(SnapshotReader & reader, Has_Attributes & atts, const std::string & name,
+                      const std::vector<Dimensions_t> & dims) {
+    const gsl::span<const T> data = reader.getArray<T>();
+    if (!atts.exists(name)) {
+        atts.add<T>(name, data, dims);
+    }
+}
+
+template <>
+void getAttributeData<std::string>(SnapshotReader & reader, Has_Attributes & atts,
+                                   const std::string & name,
+                                   const std::vector<Dimensions_t> & dims) {
+    const std::vector<std::string> data = reader.getStrings();
+    if (!atts.exists(name)) {
+        atts.add<std::string>(name, gsl::span<const std::string>(data), dims);
+    }
+}
+
+template <typename T>
+SnapshotType snapshotTypeOf();
+template <> SnapshotType snapshotTypeOf<int>() { return SnapshotType::Int; }
+template <> SnapshotType snapshotTypeOf<int64_t>() { return SnapshotType::Int64; }
+template <> SnapshotType snapshotTypeOf<float>() { return SnapshotType::Float; }
+template <> SnapshotType snapshotTypeOf<std::string>() { return SnapshotType::String; }
+template <> SnapshotType snapshotTypeOf<char>() { return SnapshotType::Char; }
+
+template <typename T>
+void putFillValue(SnapshotWriter & writer, const Variable & var) {
+    writer.putValue<std::uint64_t>(var.hasFillValue());
+    if (var.hasFillValue()) {
+        writer.putValue<T>(detail::getFillValue<T>(var.getFillValue()));
+    }
+}
+
+template <>
+void putFillValue<std::string>(SnapshotWriter & writer, const Variable & var) {
+    writer.putValue<std::uint64_t>(var.hasFillValue());
+    if (var.hasFillValue()) {
+        writer.putString(detail::getFillValue<std::string>(var.getFillValue()));
+    }
+}
+
+template <typename T>
+void putVariableData(SnapshotWriter & writer, const Variable & var) {
+    std::vector<T> data;
+    var.read<T>(data);
+    writer.putVector(data);
+}
+
+// Strings are written as a table of the distinct values plus one code per element
+// when the backend keeps them that way.
+template <>
+void putVariableData<std::string>(SnapshotWriter & writer, const Variable & var) {
+    std::vector<int> codes;
+    std::vector<std::string> dictionary;
+    if (var.readDictionaryEncoded(codes, dictionary)) {
+        writer.putValue<std::uint64_t>(1);
+        writer.putStrings(dictionary);
+        writer.putVector(codes);
+    } else {
+        std::vector<std::string> data;
+        var.read<std::string>(data);
+        writer.putValue<std::uint64_t>(0);
+        writer.putStrings(data);
+    }
+}
+
+template <typename T>
+void readFillValue(SnapshotReader & reader, VariableCreationParameters & params) {
+    if (reader.getValue<std::uint64_t>()) {
+        params.setFillValue<T>(reader.getValue<T>());
+    }
+}
+
+template <>
+void readFillValue<std::string>(SnapshotReader & reader, VariableCreationParameters & params) {
+    if (reader.getValue<std::uint64_t>()) {
+        params.setFillValue<std::string>(reader.getString());
+    }
+}
+
+// The values are written to the variable straight from the mapped file.
+template <typename T>
+void getVariableData(SnapshotReader & reader, Variable & var) {
+    var.write<T>(reader.getArray<T>());
+}
+
+template <>
+void getVariableData<std::string>(SnapshotReader & reader, Variable & var) {
+    std::vector<std::string> data;
+    if (reader.getValue<std::uint64_t>()) {
+        const std::vector<std::string> dictionary = reader.getStrings();
+        const gsl::span<const int> codes = reader.getArray<int>();
+        data.reserve(codes.size());
+        for (const int code : codes) {
+            data.push_back(dictionary.at(code));
+        }
+    } else {
+        data = reader.getStrings();
+    }
+    var.write<std::string>(data);
+}
+
+// Calls action with a value of the C++ type of a variable in a snapshot file.
+template <typename Action>
+void forSnapshotVariableType(const SnapshotType type, const std::string & varName,
+                             const Action & action) {
+    switch (type) {
+        case SnapshotType::Int:
+            action(int());
+            break;
+        case SnapshotType::Int64:
+            action(int64_t());
+            break;
+        case SnapshotType::Float:
+            action(float());
+            break;
+        case SnapshotType::String:
+            action(std::string());
+            break;
+        case SnapshotType::Char:
+            action(char());
+            break;
+        default:
+            throw eckit::BadValue("Snapshot variable " + varName + " has an unsupported type",
+                                  Here());
+    }
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------------
+std::uint64_t snapshotHash(const std::string & text) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// -----------------------------------------------------------------------------
+SnapshotWriter::SnapshotWriter(const std::string & fileName, const std::uint64_t configHash)
+    : fileName_(fileName), tempFileName_(fileName + ".tmp"), offset_(0), closed_(false) {
+    stream_.open(tempFileName_, std::ios::binary | std::ios::trunc);
+    if (!stream_) {
+        throw eckit::CantOpenFile(tempFileName_);
+    }
+    putBytes(snapshotMagic, sizeof(snapshotMagic));
+    putValue<std::uint64_t>(snapshotVersion);
+    putValue<std::uint64_t>(configHash);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    if (!closed_) {
+        stream_.close();
+        std::remove(tempFileName_.c_str());
+    }
+}
+
+void SnapshotWriter::putBytes(const void * data, const std::size_t size) {
+    stream_.write(static_cast<const char *>(data), size);
+    offset_ += size;
+}
+
+void SnapshotWriter::align() {
+    static const char padding[snapshotAlignment] = {};
+    const std::size_t remainder = offset_ % snapshotAlignment;
+    if (remainder != 0) {
+        putBytes(padding, snapshotAlignment - remainder);
+    }
+}
+
+void SnapshotWriter::putString(const std::string & value) {
+    putArray(value.data(), value.size());
+}
+
+void SnapshotWriter::putStrings(const std::vector<std::string> & values) {
+    putValue<std::uint64_t>(values.size());
+    for (const std::string & value : values) {
+        putString(value);
+    }
+}
+
+void SnapshotWriter::putAttributes(const Has_Attributes & atts) {
+    std::vector<std::pair<std::string, Attribute>> namedAtts;
+    for (auto & namedAtt : atts.openAll()) {
+        if (skippedAttributes().count(namedAtt.first) == 0) {
+            namedAtts.push_back(namedAtt);
+        }
+    }
+
+    putValue<std::uint64_t>(namedAtts.size());
+    for (const auto & namedAtt : namedAtts) {
+        const std::string & attrName = namedAtt.first;
+        const Attribute & attr = namedAtt.second;
+        putString(attrName);
+        putVector(attr.getDimensions().dimsCur);
+        if (attr.isA<int>()) {
+            putValue(SnapshotType::Int);
+            putAttributeData<int>(*this, attr);
+        } else if (attr.isA<long>()) {                      // NOLINT
+            putValue(SnapshotType::Long);
+            putAttributeData<long>(*this, attr);            // NOLINT
+        } else if (attr.isA<float>()) {
+            putValue(SnapshotType::Float);
+            putAttributeData<float>(*this, attr);
+        } else if (attr.isA<double>()) {
+            putValue(SnapshotType::Double);
+            putAttributeData<double>(*this, attr);
+        } else if (attr.isA<std::string>()) {
+            putValue(SnapshotType::String);
+            putAttributeData<std::string>(*this, attr);
+        } else if (attr.isA<char>()) {
+            putValue(SnapshotType::Char);
+            putAttributeData<char>(*this, attr);
+        } else {
+            throw eckit::BadValue("Attribute " + attrName +
+                                  " cannot be written to a snapshot: unsupported type", Here());
+        }
+    }
+}
+
+void SnapshotWriter::putVariable(const std::string & varName, const Variable & var) {
+    // Everything needed to create the variable comes first, then its attributes and values.
+    putString(varName);
+    const Dimensions dims = var.getDimensions();
+    putVector(dims.dimsCur);
+    putVector(dims.dimsMax);
+    const VariableCreationParameters params = var.getCreationParameters(false, false);
+    putValue<std::uint64_t>(params.chunk);
+    putVector(params.chunks);
+    VarUtils::forAnySupportedVariableType(
+          var,
+          [&](auto typeDiscriminator) {
+              typedef decltype(typeDiscriminator) T;
+              putValue(snapshotTypeOf<T>());
+              putFillValue<T>(*this, var);
+              putAttributes(var.atts);
+              putVariableData<T>(*this, var);
+          },
+          VarUtils::ThrowIfVariableIsOfUnsupportedType(varName));
+}
+
+void SnapshotWriter::putGroup(const Group & group) {
+    // Groups, in the order in which they have to be created.
+    putAttributes(group.atts);
+    const std::vector<std::string> childGroupNames = group.listObjects<ObjectType::Group>(true);
+    putValue<std::uint64_t>(childGroupNames.size());
+    for (const std::string & childGroupName : childGroupNames) {
+        putString(childGroupName);
+        putAttributes(group.open(childGroupName).atts);
+    }
+
+    // Variables, dimension scales first.
+    VarUtils::Vec_Named_Variable varList, dimVarList;
+    VarUtils::VarDimMap dimsAttachedToVars;
+    Dimensions_t maxVarSize0;
+    VarUtils::collectVarDimInfo(group, varList, dimVarList, dimsAttachedToVars, maxVarSize0);
+
+    putValue<std::uint64_t>(dimVarList.size());
+    for (const auto & namedVar : dimVarList) {
+        putVariable(namedVar.name, namedVar.var);
+        putString(namedVar.var.getDimensionScaleName());
+    }
+    putValue<std::uint64_t>(varList.size());
+    for (const auto & namedVar : varList) {
+        putVariable(namedVar.name, namedVar.var);
+    }
+
+    // Dimension scales attached to each variable.
+    putValue<std::uint64_t>(dimsAttachedToVars.size());
+    for (const auto & attachment : dimsAttachedToVars) {
+        putString(attachment.first.name);
+        std::vector<std::string> dimNames;
+        for (const auto & dimVar : attachment.second) {
+            dimNames.push_back(dimVar.name);
+        }
+        putStrings(dimNames);
+    }
+}
+
+void SnapshotWriter::close() {
+    putBytes(snapshotMagic, sizeof(snapshotMagic));
+    stream_.close();
+    if (!stream_) {
+        throw eckit::WriteError(tempFileName_);
+    }
+    if (std::rename(tempFileName_.c_str(), fileName_.c_str()) != 0) {
+        throw eckit::WriteError(fileName_);
+    }
+    closed_ = true;
+}
+
+// -----------------------------------------------------------------------------
+SnapshotReader::SnapshotReader(const std::string & fileName)
+    : fileName_(fileName), data_(nullptr), size_(0), offset_(0) {
+    const int fd = ::open(fileName_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw eckit::CantOpenFile(fileName_);
+    }
+    struct stat fileStat;
+    if (::fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        throw eckit::CantOpenFile(fileName_);
+    }
+    size_ = fileStat.st_size;
+    if (size_ > 0) {
+        void * addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw eckit::CantOpenFile(fileName_);
+        }
+        // The file is read from start to end, once.
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char *>(addr);
+    }
+    ::close(fd);
+    offset_ = snapshotHeaderSize;
+}
+
+SnapshotReader::~SnapshotReader() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char *>(data_), size_);
+    }
+}
+
+bool SnapshotReader::isValid(const std::uint64_t configHash) const {
+    if (size_ < snapshotHeaderSize + sizeof(snapshotMagic)) {
+        return false;
+    }
+    std::uint64_t version;
+    std::uint64_t hash;
+    std::memcpy(&version, data_ + sizeof(snapshotMagic), sizeof(version));
+    std::memcpy(&hash, data_ + sizeof(snapshotMagic) + sizeof(version), sizeof(hash));
+    return (std::memcmp(data_, snapshotMagic, sizeof(snapshotMagic)) == 0) &&
+           (std::memcmp(data_ + size_ - sizeof(snapshotMagic), snapshotMagic,
+                        sizeof(snapshotMagic)) == 0) &&
+           (version == snapshotVersion) && (hash == configHash);
+}
+
+const char * SnapshotReader::take(const std::size_t size) {
+    // Nothing is read from the trailer.
+    if ((size_ < offset_ + sizeof(snapshotMagic)) ||
+        (size > size_ - sizeof(snapshotMagic) - offset_)) {
+        throw eckit::ShortFile(fileName_);
+    }
+    const char * ptr = data_ + offset_;
+    offset_ += size;
+    return ptr;
+}
+
+void SnapshotReader::align() {
+    const std::size_t remainder = offset_ % snapshotAlignment;
+    if (remainder != 0) {
+        take(snapshotAlignment - remainder);
+    }
+}
+
+std::string SnapshotReader::getString() {
+    const gsl::span<const char> chars = getArray<char>();
+    return std::string(chars.data(), chars.size());
+}
+
+std::vector<std::string> SnapshotReader::getStrings() {
+    const std::size_t count = getValue<std::uint64_t>();
+    std::vector<std::string> values;
+    values.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        values.push_back(getString());
+    }
+    return values;
+}
+
+void SnapshotReader::getAttributes(Has_Attributes & atts) {
+    const std::size_t numAtts = getValue<std::uint64_t>();
+    for (std::size_t i = 0; i < numAtts; ++i) {
+        const std::string attrName = getString();
+        const std::vector<Dimensions_t> dims = getVector<Dimensions_t>();
+        const SnapshotType type = getValue<SnapshotType>();
+        // Attributes made along with the variable (e.g. by the backend) are left alone.
+        switch (type) {
+            case SnapshotType::Int:
+                getAttributeData<int>(*this, atts, attrName, dims);
+                break;
+            case SnapshotType::Long:
+                getAttributeData<long>(*this, atts, attrName, dims);   // NOLINT
+                break;
+            case SnapshotType::Float:
+                getAttributeData<float>(*this, atts, attrName, dims);
+                break;
+            case SnapshotType::Double:
+                getAttributeData<double>(*this, atts, attrName, dims);
+                break;
+            case SnapshotType::String:
+                getAttributeData<std::string>(*this, atts, attrName, dims);
+                break;
+            case SnapshotType::Char:
+                getAttributeData<char>(*this, atts, attrName, dims);
+                break;
+            default:
+                throw eckit::BadValue("Snapshot attribute " + attrName +
+                                      " has an unsupported type", Here());
+        }
+    }
+}
+
+Variable SnapshotReader::getVariable(Group & group) {
+    const std::string varName = getString();
+    const std::vector<Dimensions_t> dimsCur = getVector<Dimensions_t>();
+    const std::vector<Dimensions_t> dimsMax = getVector<Dimensions_t>();
+    VariableCreationParameters params;
+    params.chunk = getValue<std::uint64_t>();
+    params.chunks = getVector<Dimensions_t>();
+
+    Variable var;
+    forSnapshotVariableType(getValue<SnapshotType>(), varName, [&](auto typeDiscriminator) {
+        typedef decltype(typeDiscriminator) T;
+        // Pass the type explicitly so that no fill value policy is applied: the variable
+        // gets exactly the fill value it had.
+        readFillValue<T>(*this, params);
+        var = group.vars.create(varName, Types::GetType<T>(group.vars.getTypeProvider()),
+                                dimsCur, dimsMax, params);
+        getAttributes(var.atts);
+        getVariableData<T>(*this, var);
+    });
+    return var;
+}
+
+void SnapshotReader::getGroup(Group & group) {
+    getAttributes(group.atts);
+    const std::size_t numGroups = getValue<std::uint64_t>();
+    for (std::size_t i = 0; i < numGroups; ++i) {
+        Group childGroup = group.create(getString());
+        getAttributes(childGroup.atts);
+    }
+
+    const std::size_t numDimVars = getValue<std::uint64_t>();
+    for (std::size_t i = 0; i < numDimVars; ++i) {
+        Variable dimVar = getVariable(group);
+        dimVar.setIsDimensionScale(getString());
+    }
+    const std::size_t numVars = getValue<std::uint64_t>();
+    for (std::size_t i = 0; i < numVars; ++i) {
+        getVariable(group);
+    }
+
+    // Attach the dimension scales with one collective call, as in copyGroup.
+    std::vector<std::pair<Variable, std::vector<Variable>>> dimsAttachedToVars;
+    const std::size_t numAttachments = getValue<std::uint64_t>();
+    for (std::size_t i = 0; i < numAttachments; ++i) {
+        Variable var = group.vars.open(getString());
+        std::vector<Variable> dimVars;
+        for (const std::string & dimName : getStrings()) {
+            dimVars.push_back(group.vars.open(dimName));
+        }
+        dimsAttachedToVars.push_back(std::make_pair(var, std::move(dimVars)));
+    }
+    group.vars.attachDimensionScales(dimsAttachedToVars);
+}
+
+}  // namespace ioda
@@ -0,0 +1,180 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef CORE_SNAPSHOT_H_
+#define CORE_SNAPSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "ioda/Attributes/Has_Attributes.h"
+#include "ioda/Group.h"
+#include "ioda/Variables/Variable.h"
+
+namespace ioda {
+
+  /// \brief hash of a text (64 bit FNV-1a)
+  /// \details Unlike std::hash, the value does not depend on the compiler or the library,
+  /// so it can be stored in a file and checked by another build.
+  std::uint64_t snapshotHash(const std::string & text);
+
+  /// \brief Writes a binary snapshot file
+  /// \details A snapshot file starts with a header holding a format version and a hash
+  /// of the configuration that produced the data, and ends with a trailer. Arrays are
+  /// aligned on 8 byte boundaries so that SnapshotReader can hand them out straight
+  /// from the mapped file. The data go to a temporary file that replaces the snapshot
+  /// file when close is called, so that an interrupted write never leaves a file that
+  /// looks complete.
+  class SnapshotWriter {
+   public:
+      /// \param fileName name of the snapshot file
+      /// \param configHash hash of the configuration (see snapshotHash)
+      SnapshotWriter(const std::string & fileName, const std::uint64_t configHash);
+      ~SnapshotWriter();
+
+      SnapshotWriter(const SnapshotWriter &) = delete;
+      SnapshotWriter & operator=(const SnapshotWriter &) = delete;
+
+      /// \brief write a single value of a trivially copyable type
+      template <typename T>
+      void putValue(const T & value) {
+          static_assert(std::is_trivially_copyable<T>::value, "type must be trivially copyable");
+          putBytes(&value, sizeof(T));
+      }
+
+      /// \brief write an array of values of a trivially copyable type
+      template <typename T>
+      void putArray(const T * values, const std::size_t count) {
+          static_assert(std::is_trivially_copyable<T>::value, "type must be trivially copyable");
+          putValue<std::uint64_t>(count);
+          putBytes(values, count * sizeof(T));
+          align();
+      }
+
+      /// \brief write a vector of values of a trivially copyable type
+      template <typename T>
+      void putVector(const std::vector<T> & values) {
+          putArray(values.data(), values.size());
+      }
+
+      /// \brief write a string
+      void putString(const std::string & value);
+
+      /// \brief write a vector of strings
+      void putStrings(const std::vector<std::string> & values);
+
+      /// \brief write a group and everything below it
+      /// \details Writes the attributes, child groups and variables of the group, along
+      /// with the fill values and the dimension scales attached to the variables.
+      void putGroup(const Group & group);
+
+      /// \brief write the trailer and move the file into place
+      void close();
+
+   private:
+      void putBytes(const void * data, const std::size_t size);
+      void align();
+      void putAttributes(const Has_Attributes & atts);
+      void putVariable(const std::string & varName, const Variable & var);
+
+      /// \brief name of the snapshot file
+      std::string fileName_;
+
+      /// \brief name of the file being written
+      std::string tempFileName_;
+
+      /// \brief stream on the file being written
+      std::ofstream stream_;
+
+      /// \brief number of bytes written so far
+      std::size_t offset_;
+
+      /// \brief true after close has been called
+      bool closed_;
+  };
+
+  /// \brief Reads a binary snapshot file written by SnapshotWriter
+  /// \details The file is mapped into memory. The values have to be read in the same
+  /// order as they were written.
+  class SnapshotReader {
+   public:
+      /// \param fileName name of the snapshot file
+      /// \throws eckit::CantOpenFile if the file cannot be opened or mapped
+      explicit SnapshotReader(const std::string & fileName);
+      ~SnapshotReader();
+
+      SnapshotReader(const SnapshotReader &) = delete;
+      SnapshotReader & operator=(const SnapshotReader &) = delete;
+
+      /// \brief true if the file is a complete snapshot written, with the current format
+      /// version, for the configuration with the given hash
+      bool isValid(const std::uint64_t configHash) const;
+
+      /// \brief read a single value of a trivially copyable type
+      template <typename T>
+      T getValue() {
+          static_assert(std::is_trivially_copyable<T>::value, "type must be trivially copyable");
+          T value;
+          std::memcpy(&value, take(sizeof(T)), sizeof(T));
+          return value;
+      }
+
+      /// \brief read an array of values of a trivially copyable type
+      /// \details The span points into the mapped file, so it is only valid while
+      /// the reader exists.
+      template <typename T>
+      gsl::span<const T> getArray() {
+          static_assert(std::is_trivially_copyable<T>::value, "type must be trivially copyable");
+          const std::size_t count = getValue<std::uint64_t>();
+          const T * values = reinterpret_cast<const T *>(take(count * sizeof(T)));
+          align();
+          return gsl::span<const T>(values, count);
+      }
+
+      /// \brief read a vector of values of a trivially copyable type
+      template <typename T>
+      std::vector<T> getVector() {
+          const gsl::span<const T> values = getArray<T>();
+          return std::vector<T>(values.begin(), values.end());
+      }
+
+      /// \brief read a string
+      std::string getString();
+
+      /// \brief read a vector of strings
+      std::vector<std::string> getStrings();
+
+      /// \brief read a group written by SnapshotWriter::putGroup into an empty group
+      void getGroup(Group & group);
+
+   private:
+      const char * take(const std::size_t size);
+      void align();
+      void getAttributes(Has_Attributes & atts);
+      Variable getVariable(Group & group);
+
+      /// \brief name of the snapshot file
+      std::string fileName_;
+
+      /// \brief start of the mapped file
+      const char * data_;
+
+      /// \brief size of the mapped file
+      std::size_t size_;
+
+      /// \brief position of the next value
+      std::size_t offset_;
+  };
+
+}  // namespace ioda
+
+#endif  // CORE_SNAPSHOT_H_
@@ -12,6 +12,8 @@
 
 namespace ioda {
 
+class ReductionBatch;
+
 /// \brief Calculates the sum of a location-dependent quantity of type `T` over locations held on
 /// all PEs, each taken into account only once even if it's held on multiple PEs.
 ///
@@ -35,6 +37,14 @@ class Accumulator {
     /// \brief Return the sum of contributions associated with locations held on all PEs
     /// (each taken into account only once).
     virtual T computeResult() const = 0;
+
+    /// \brief Add the computation of the sum to `batch`, to be stored in `result` once the batch
+    /// has completed (see ReductionBatch::sum()).
+    ///
+    /// The default implementation calls computeResult() straight away.
+    virtual void addToBatch(ReductionBatch & /*batch*/, T & result) const {
+        result = computeResult();
+    }
 };
 
 /// \brief Calculates the sums of multiple location-dependent quantities of type `T` over locations
@@ -58,6 +68,14 @@ class Accumulator<std::vector<T>> {
     /// \brief Return the sums of contributions associated with locations held on all
     /// PEs (each taken into account only once).
     virtual std::vector<T> computeResult() const = 0;
+
+    /// \brief Add the computation of the sums to `batch`, to be stored in `result` once the
+    /// batch has completed (see ReductionBatch::sum()).
+    ///
+    /// The default implementation calls computeResult() straight away.
+    virtual void addToBatch(ReductionBatch & /*batch*/, std::vector<T> & result) const {
+        result = computeResult();
+    }
 };
 
 }  // namespace ioda
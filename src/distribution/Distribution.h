@@ -18,6 +18,8 @@
 #include "oops/util/missingValues.h"
 #include "oops/util/TypeTraits.h"
 
+#include "ioda/distribution/ReductionBatch.h"
+
 namespace util {
 class DateTime;
 }
@@ -161,6 +163,53 @@ class Distribution {
     virtual void max(std::vector<float> & x) const = 0;
     virtual void max(std::vector<double> & x) const = 0;
 
+    /*!
+     * \brief Start a nonblocking min().
+     *
+     * \details `x` holds the result once the returned request has completed (see
+     * ReductionRequest); until then it must not be used. To combine several reductions into one
+     * message, use a ReductionBatch instead.
+     *
+     * \tparam T
+     *   Must be either `int`, `size_t`, `float` or `double`, or a vector of one of these.
+     */
+    template <typename T>
+    ReductionRequest iMin(T & x) const {
+        ReductionBatch batch(*this);
+        batch.min(x);
+        return batch.start();
+    }
+
+    /*!
+     * \brief Start a nonblocking max(). See iMin().
+     */
+    template <typename T>
+    ReductionRequest iMax(T & x) const {
+        ReductionBatch batch(*this);
+        batch.max(x);
+        return batch.start();
+    }
+
+    /*!
+     * \brief Start a nonblocking computation of `result = accumulator.computeResult()`.
+     * See iMin().
+     *
+     * \param accumulator
+     *   An accumulator created by createAccumulator() of this distribution.
+     */
+    template <typename T>
+    ReductionRequest iComputeResult(const Accumulator<T> & accumulator, T & result) const {
+        ReductionBatch batch(*this);
+        batch.sum(accumulator, result);
+        return batch.start();
+    }
+
+    /*!
+     * \brief Return false if every process already holds the results of min() and max(), so
+     * that they need no communication (as for the InefficientDistribution).
+     */
+    virtual bool reductionsNeedCommunication() const { return true; }
+
     /*!
      * \brief Create an object that can be used to calculate the sum of a location-dependent
      * quantity over locations held on all PEs, each taken into account only once even if it's
@@ -224,6 +273,14 @@ class Distribution {
     // return the name of the distribution
     virtual std::string name() const = 0;
 
+    /*!
+     * \brief Estimate of the memory (in bytes) held by the indices of the distribution.
+     *
+     * Used by ObsSpace to report its memory footprint; distributions computing everything on
+     * the fly hold none.
+     */
+    virtual std::size_t memoryBytes() const { return 0; }
+
     /// Accessor to MPI rank
     size_t rank() const {return comm_.rank();}
 
@@ -264,6 +321,8 @@ class Distribution {
       createAccumulatorImpl(const std::vector<double> & init) const = 0;
 
  protected:
+     friend class ReductionBatch;
+
      /*! \brief Local MPI communicator */
      const eckit::mpi::Comm & comm_;
 };
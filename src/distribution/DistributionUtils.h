@@ -96,6 +96,26 @@ std::shared_ptr<Distribution> createReplicaDistribution(
     std::shared_ptr<const Distribution> master,
     const std::vector<std::size_t> &masterRecordNums);
 
+/// \brief Estimates the memory held by the elements of a vector.
+template <typename T>
+std::size_t vectorMemoryBytes(const std::vector<T> &v) {
+  return v.capacity() * sizeof(T);
+}
+
+inline std::size_t vectorMemoryBytes(const std::vector<bool> &v) {
+  return v.capacity() / 8;
+}
+
+/// \brief Estimates the memory held by the buckets and nodes of an unordered set or map.
+///
+/// Each node is assumed to hold a pointer to the next node and the value; the container is not
+/// traversed.
+template <typename Container>
+std::size_t hashContainerMemoryBytes(const Container &c) {
+  return c.bucket_count() * sizeof(void *) +
+         c.size() * (sizeof(void *) + sizeof(typename Container::value_type));
+}
+
 }  // namespace ioda
 
 #endif  // DISTRIBUTION_DISTRIBUTIONUTILS_H_
@@ -13,6 +13,7 @@
 
 #include "eckit/mpi/Comm.h"
 #include "ioda/distribution/Accumulator.h"
+#include "ioda/distribution/ReductionBatch.h"
 
 namespace ioda {
 
@@ -37,6 +38,11 @@ class GeneralDistributionAccumulator : public Accumulator<T> {
     return result;
   }
 
+  void addToBatch(ReductionBatch &batch, T &result) const override {
+    result = localResult_;
+    batch.allReduceSum(result);
+  }
+
  private:
   T localResult_;
   const eckit::mpi::Comm &comm_;
@@ -74,6 +80,11 @@ class GeneralDistributionAccumulator<std::vector<T>> : public Accumulator<std::v
     return result;
   }
 
+  void addToBatch(ReductionBatch &batch, std::vector<T> &result) const override {
+    result = localResult_;
+    batch.allReduceSum(result);
+  }
+
  private:
   std::vector<T> localResult_;
   const eckit::mpi::Comm &comm_;
@@ -20,6 +20,7 @@
 #include "oops/util/Logger.h"
 
 #include "ioda/distribution/DistributionFactory.h"
+#include "ioda/distribution/DistributionUtils.h"
 #include "ioda/distribution/GeneralDistributionAccumulator.h"
 #include "eckit/exception/Exceptions.h"
 
@@ -423,4 +424,14 @@ size_t Halo::globalUniqueConsecutiveLocationIndex(size_t loc) const {
 
 // -----------------------------------------------------------------------------
 
+std::size_t Halo::memoryBytes() const {
+  return hashContainerMemoryBytes(recordsInHalo_) + vectorMemoryBytes(patchObsBool_) +
+         vectorMemoryBytes(globalUniqueConsecutiveLocIndices_) +
+         hashContainerMemoryBytes(recordsOutsideHalo_) +
+         hashContainerMemoryBytes(recordDistancesFromCenter_) +
+         vectorMemoryBytes(haloLocRecords_) + vectorMemoryBytes(haloLocVector_);
+}
+
+// -----------------------------------------------------------------------------
+
 }  // namespace ioda
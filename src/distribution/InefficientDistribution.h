@@ -41,6 +41,8 @@ class InefficientDistribution: public Distribution {
 
      void patchObs(std::vector<bool> &) const override;
 
+     bool reductionsNeedCommunication() const override { return false; }
+
      // The min and max reductions do nothing for the inefficient distribution. Each processor has
      // all observations, so the local reduction is equal to the global reduction.
 
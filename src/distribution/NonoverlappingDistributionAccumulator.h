@@ -13,6 +13,7 @@
 
 #include "eckit/mpi/Comm.h"
 #include "ioda/distribution/Accumulator.h"
+#include "ioda/distribution/ReductionBatch.h"
 
 namespace ioda {
 
@@ -34,6 +35,11 @@ class NonoverlappingDistributionAccumulator : public Accumulator<T> {
     return result;
   }
 
+  void addToBatch(ReductionBatch &batch, T &result) const override {
+    result = localResult_;
+    batch.allReduceSum(result);
+  }
+
  private:
   T localResult_;
   const eckit::mpi::Comm &comm_;
@@ -65,6 +71,11 @@ class NonoverlappingDistributionAccumulator<std::vector<T>> : public Accumulator
     return result;
   }
 
+  void addToBatch(ReductionBatch &batch, std::vector<T> &result) const override {
+    result = localResult_;
+    batch.allReduceSum(result);
+  }
+
  private:
   std::vector<T> localResult_;
   const eckit::mpi::Comm &comm_;
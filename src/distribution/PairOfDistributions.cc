@@ -265,4 +265,10 @@ size_t PairOfDistributions::globalUniqueConsecutiveLocationIndex(size_t loc) con
 
 // -----------------------------------------------------------------------------
 
+std::size_t PairOfDistributions::memoryBytes() const {
+  return first_->memoryBytes() + second_->memoryBytes();
+}
+
+// -----------------------------------------------------------------------------
+
 }  // namespace ioda
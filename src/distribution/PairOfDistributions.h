@@ -73,6 +73,11 @@ class PairOfDistributions : public Distribution {
   void allGatherv(std::vector<std::string> &x) const override;
 
   size_t globalUniqueConsecutiveLocationIndex(size_t loc) const override;
+  std::size_t memoryBytes() const override;
+
+  bool reductionsNeedCommunication() const override {
+    return first_->reductionsNeedCommunication() || second_->reductionsNeedCommunication();
+  }
 
   std::string name() const override { return "PairOfDistributions"; }
 
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "ioda/distribution/Accumulator.h"
+#include "ioda/distribution/ReductionBatch.h"
 
 namespace ioda {
 
@@ -39,6 +40,14 @@ class PairOfDistributionsAccumulator : public Accumulator<T> {
     return firstAccumulator_->computeResult() + secondAccumulator_->computeResult();
   }
 
+  void addToBatch(ReductionBatch &batch, T &result) const override {
+    // The second partial result is owned by the completion step, which adds it to the first.
+    std::shared_ptr<T> secondResult = std::make_shared<T>();
+    firstAccumulator_->addToBatch(batch, result);
+    secondAccumulator_->addToBatch(batch, *secondResult);
+    batch.onCompletion([&result, secondResult]() { result = result + *secondResult; });
+  }
+
  private:
   std::unique_ptr<Accumulator<T>> firstAccumulator_;
   std::unique_ptr<Accumulator<T>> secondAccumulator_;
@@ -79,6 +88,17 @@ class PairOfDistributionsAccumulator<std::vector<T>> : public Accumulator<std::v
     return result;
   }
 
+  void addToBatch(ReductionBatch &batch, std::vector<T> &result) const override {
+    // The second partial results are owned by the completion step, which adds them to the first.
+    auto secondResult = std::make_shared<std::vector<T>>();
+    firstAccumulator_->addToBatch(batch, result);
+    secondAccumulator_->addToBatch(batch, *secondResult);
+    batch.onCompletion([&result, secondResult]() {
+      for (std::size_t i = 0, n = result.size(); i < n; ++i)
+        result[i] += (*secondResult)[i];
+    });
+  }
+
  private:
   std::unique_ptr<Accumulator<std::vector<T>>> firstAccumulator_;
   std::unique_ptr<Accumulator<std::vector<T>>> secondAccumulator_;
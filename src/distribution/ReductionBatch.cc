@@ -0,0 +1,200 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include "ioda/distribution/ReductionBatch.h"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <type_traits>
+
+#include "eckit/mpi/Comm.h"
+
+#include "ioda/distribution/Distribution.h"
+
+namespace ioda {
+
+namespace detail {
+
+// -----------------------------------------------------------------------------
+/// Requests of the started reductions and the steps storing their results.
+struct ReductionState {
+  std::vector<MPI_Request> requests;
+  std::vector<std::function<void()>> completions;
+};
+
+// -----------------------------------------------------------------------------
+/// Reductions of one type with one operation, packed into one buffer.
+struct ReductionGroup {
+  virtual ~ReductionGroup() {}
+
+  /// Start the reduction of the packed values (if communicate is true) and add the step
+  /// unpacking the results to state.
+  virtual void start(MPI_Comm comm, bool communicate, ReductionState & state) = 0;
+};
+
+}  // namespace detail
+
+namespace {
+
+template <typename T> MPI_Datatype mpiDatatype();
+template <> MPI_Datatype mpiDatatype<int>() { return MPI_INT; }
+template <> MPI_Datatype mpiDatatype<float>() { return MPI_FLOAT; }
+template <> MPI_Datatype mpiDatatype<double>() { return MPI_DOUBLE; }
+template <> MPI_Datatype mpiDatatype<std::size_t>() {
+  static_assert(sizeof(std::size_t) == sizeof(unsigned long) ||            // NOLINT
+                sizeof(std::size_t) == sizeof(unsigned long long),       // NOLINT
+                "no MPI datatype matches size_t");
+  return sizeof(std::size_t) == sizeof(unsigned long) ? MPI_UNSIGNED_LONG    // NOLINT
+                                                      : MPI_UNSIGNED_LONG_LONG;
+}
+
+template <typename T>
+class TypedReductionGroup : public detail::ReductionGroup {
+ public:
+  explicit TypedReductionGroup(MPI_Op op) : op_(op) {}
+
+  void add(T * x, std::size_t n) {
+    targets_.emplace_back(x, n);
+  }
+
+  void start(MPI_Comm comm, bool communicate, detail::ReductionState & state) override {
+    // The buffer is shared with the unpacking step, so it stays at the same address until the
+    // reduction has completed.
+    auto buffer = std::make_shared<std::vector<T>>();
+    for (const auto & target : targets_)
+      buffer->insert(buffer->end(), target.first, target.first + target.second);
+    if (communicate) {
+      MPI_Request request;
+      MPI_Iallreduce(MPI_IN_PLACE, buffer->data(), static_cast<int>(buffer->size()),
+                     mpiDatatype<T>(), op_, comm, &request);
+      state.requests.push_back(request);
+    }
+    std::vector<std::pair<T *, std::size_t>> targets = std::move(targets_);
+    state.completions.push_back([buffer, targets]() {
+      const T * result = buffer->data();
+      for (const auto & target : targets) {
+        std::copy(result, result + target.second, target.first);
+        result += target.second;
+      }
+    });
+  }
+
+ private:
+  MPI_Op op_;
+  std::vector<std::pair<T *, std::size_t>> targets_;
+};
+
+}  // namespace
+
+// -----------------------------------------------------------------------------
+ReductionRequest::ReductionRequest() {}
+
+ReductionRequest::ReductionRequest(std::unique_ptr<detail::ReductionState> state)
+  : state_(std::move(state)) {
+  if (state_ && state_->requests.empty())
+    finish();
+}
+
+ReductionRequest::ReductionRequest(ReductionRequest && other) noexcept
+  : state_(std::move(other.state_)) {}
+
+ReductionRequest & ReductionRequest::operator=(ReductionRequest && other) {
+  if (this != &other) {
+    wait();
+    state_ = std::move(other.state_);
+  }
+  return *this;
+}
+
+ReductionRequest::~ReductionRequest() {
+  wait();
+}
+
+void ReductionRequest::wait() {
+  if (!state_)
+    return;
+  MPI_Waitall(static_cast<int>(state_->requests.size()), state_->requests.data(),
+              MPI_STATUSES_IGNORE);
+  finish();
+}
+
+bool ReductionRequest::test() {
+  if (!state_)
+    return true;
+  int flag = 0;
+  MPI_Testall(static_cast<int>(state_->requests.size()), state_->requests.data(), &flag,
+              MPI_STATUSES_IGNORE);
+  if (flag)
+    finish();
+  return flag != 0;
+}
+
+void ReductionRequest::finish() {
+  std::unique_ptr<detail::ReductionState> state = std::move(state_);
+  for (const auto & completion : state->completions)
+    completion();
+}
+
+// -----------------------------------------------------------------------------
+ReductionBatch::ReductionBatch(const Distribution & dist)
+  : comm_(dist.comm_), reduceMinMax_(dist.reductionsNeedCommunication()) {}
+
+ReductionBatch::~ReductionBatch() {}
+
+void ReductionBatch::add(int * x, std::size_t n, Operation op) {
+  addImpl(x, n, op);
+}
+
+void ReductionBatch::add(std::size_t * x, std::size_t n, Operation op) {
+  addImpl(x, n, op);
+}
+
+void ReductionBatch::add(float * x, std::size_t n, Operation op) {
+  addImpl(x, n, op);
+}
+
+void ReductionBatch::add(double * x, std::size_t n, Operation op) {
+  addImpl(x, n, op);
+}
+
+template <typename T>
+void ReductionBatch::addImpl(T * x, std::size_t n, Operation op) {
+  const int typeIndex = std::is_same<T, int>::value ? 0
+                      : std::is_same<T, std::size_t>::value ? 1
+                      : std::is_same<T, float>::value ? 2 : 3;
+  std::unique_ptr<detail::ReductionGroup> & group = groups_[std::make_pair(typeIndex, op)];
+  if (!group) {
+    MPI_Op mpiOp = (op == Operation::Sum) ? MPI_SUM : (op == Operation::Min) ? MPI_MIN : MPI_MAX;
+    group.reset(new TypedReductionGroup<T>(mpiOp));
+  }
+  static_cast<TypedReductionGroup<T> &>(*group).add(x, n);
+}
+
+void ReductionBatch::onCompletion(std::function<void()> func) {
+  completions_.push_back(std::move(func));
+}
+
+ReductionRequest ReductionBatch::start() {
+  std::unique_ptr<detail::ReductionState> state(new detail::ReductionState);
+  // A reduction over a single process leaves the values unchanged, so no message is sent.
+  // This also covers serial communicators, which have no MPI counterpart.
+  const bool communicate = comm_.size() > 1;
+  const MPI_Comm comm = communicate ? MPI_Comm_f2c(comm_.communicator()) : MPI_COMM_NULL;
+  // The groups are started in the same order (by type, then operation) on all processes.
+  for (auto & group : groups_)
+    group.second->start(comm, communicate, *state);
+  groups_.clear();
+  for (auto & completion : completions_)
+    state->completions.push_back(std::move(completion));
+  completions_.clear();
+  return ReductionRequest(std::move(state));
+}
+
+// -----------------------------------------------------------------------------
+
+}  // namespace ioda
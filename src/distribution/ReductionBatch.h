@@ -0,0 +1,186 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef DISTRIBUTION_REDUCTIONBATCH_H_
+#define DISTRIBUTION_REDUCTIONBATCH_H_
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "oops/util/TypeTraits.h"
+
+#include "ioda/distribution/Accumulator.h"
+
+namespace eckit {
+namespace mpi {
+class Comm;
+}
+}
+
+namespace ioda {
+
+class Distribution;
+
+namespace detail {
+struct ReductionState;
+struct ReductionGroup;
+}
+
+// ---------------------------------------------------------------------
+/*!
+ * \brief Handle to nonblocking reductions started by ReductionBatch::start() or by
+ * Distribution::iMin(), Distribution::iMax() and Distribution::iComputeResult().
+ *
+ * \details The values passed to the reductions hold their results once the request has
+ * completed, i.e. once wait() has returned or test() has returned true. Until then they must
+ * stay alive and must not be read, written or resized. Destroying a request that has not
+ * completed waits for it.
+ */
+class ReductionRequest {
+ public:
+    /// Create a request that has already completed.
+    ReductionRequest();
+    explicit ReductionRequest(std::unique_ptr<detail::ReductionState> state);
+    ReductionRequest(ReductionRequest && other) noexcept;
+    ReductionRequest & operator=(ReductionRequest && other);
+    ~ReductionRequest();
+
+    /// Block until the reductions have completed.
+    void wait();
+
+    /// Complete the request, without blocking, if the reductions have completed.
+    /// \returns true if the request has completed.
+    bool test();
+
+    /// Return true if the request has completed.
+    bool completed() const { return !state_; }
+
+ private:
+    /// Store the results of the reductions and release the state.
+    void finish();
+
+    std::unique_ptr<detail::ReductionState> state_;
+};
+
+// ---------------------------------------------------------------------
+/*!
+ * \brief Fuses several reductions over the processes of a Distribution into as few messages as
+ * possible.
+ *
+ * \details The intended usage is as follows:
+ * 1. Create a batch for a distribution.
+ * 2. Add reductions with min(), max() and sum(). They give the same results as
+ *    Distribution::min(), Distribution::max() and Accumulator::computeResult(), but nothing
+ *    is communicated yet.
+ * 3. Call start() and later wait() on the returned request, or call execute() to do both.
+ *
+ * All reductions of the same type and operation are packed into one buffer, reduced by a single
+ * nonblocking allreduce. As for the blocking reductions, all processes must add the same
+ * reductions, with vectors of the same lengths, in the same order.
+ */
+class ReductionBatch {
+ public:
+    explicit ReductionBatch(const Distribution & dist);
+    ~ReductionBatch();
+
+    ReductionBatch(const ReductionBatch &) = delete;
+    ReductionBatch & operator=(const ReductionBatch &) = delete;
+
+    /// \brief Add the equivalent of Distribution::min(x).
+    template <typename T>
+    void min(T & x) {
+        checkType<T>();
+        if (reduceMinMax_) add(&x, 1, Operation::Min);
+    }
+
+    template <typename T>
+    void min(std::vector<T> & x) {
+        checkType<T>();
+        if (reduceMinMax_) add(x.data(), x.size(), Operation::Min);
+    }
+
+    /// \brief Add the equivalent of Distribution::max(x).
+    template <typename T>
+    void max(T & x) {
+        checkType<T>();
+        if (reduceMinMax_) add(&x, 1, Operation::Max);
+    }
+
+    template <typename T>
+    void max(std::vector<T> & x) {
+        checkType<T>();
+        if (reduceMinMax_) add(x.data(), x.size(), Operation::Max);
+    }
+
+    /// \brief Add the equivalent of `result = accumulator.computeResult()`.
+    ///
+    /// \param accumulator
+    ///   An accumulator created by the distribution of the batch.
+    template <typename T>
+    void sum(const Accumulator<T> & accumulator, T & result) {
+        accumulator.addToBatch(*this, result);
+    }
+
+    /// \brief Add the sum of `x` over all processes, for implementations of
+    /// Accumulator::addToBatch().
+    template <typename T>
+    void allReduceSum(T & x) {
+        checkType<T>();
+        add(&x, 1, Operation::Sum);
+    }
+
+    template <typename T>
+    void allReduceSum(std::vector<T> & x) {
+        checkType<T>();
+        add(x.data(), x.size(), Operation::Sum);
+    }
+
+    /// \brief Call `func` when the reductions added so far have completed, for implementations of
+    /// Accumulator::addToBatch() combining several results.
+    ///
+    /// Functions are called in the order they were added.
+    void onCompletion(std::function<void()> func);
+
+    /// \brief Start all reductions added since the last call and return the request handle.
+    ReductionRequest start();
+
+    /// \brief Perform all reductions added since the last call, blocking until they complete.
+    void execute() { start().wait(); }
+
+ private:
+    enum class Operation { Sum, Min, Max };
+
+    template <typename T>
+    static void checkType() {
+        static_assert(util::any_is_same<T, int, std::size_t, float, double>::value,
+                      "reductions are only supported for int, size_t, float and double");
+    }
+
+    void add(int * x, std::size_t n, Operation op);
+    void add(std::size_t * x, std::size_t n, Operation op);
+    void add(float * x, std::size_t n, Operation op);
+    void add(double * x, std::size_t n, Operation op);
+
+    template <typename T>
+    void addImpl(T * x, std::size_t n, Operation op);
+
+    /// Communicator of the distribution
+    const eckit::mpi::Comm & comm_;
+    /// False if min() and max() need no communication for the distribution
+    bool reduceMinMax_;
+    /// Pending reductions, by type and operation
+    std::map<std::pair<int, Operation>, std::unique_ptr<detail::ReductionGroup>> groups_;
+    /// Functions to call on completion
+    std::vector<std::function<void()>> completions_;
+};
+
+}  // namespace ioda
+
+#endif  // DISTRIBUTION_REDUCTIONBATCH_H_
@@ -13,6 +13,7 @@
 #include "oops/util/DateTime.h"
 #include "oops/util/Logger.h"
 
+#include "ioda/distribution/DistributionUtils.h"
 #include "ioda/distribution/GeneralDistributionAccumulator.h"
 #include "eckit/exception/Exceptions.h"
 
@@ -285,4 +286,12 @@ size_t ReplicaOfGeneralDistribution::globalUniqueConsecutiveLocationIndex(size_t
 
 // -----------------------------------------------------------------------------
 
+std::size_t ReplicaOfGeneralDistribution::memoryBytes() const {
+  return hashContainerMemoryBytes(masterPatchRecords_) + hashContainerMemoryBytes(myRecords_) +
+         vectorMemoryBytes(myGlobalLocs_) + vectorMemoryBytes(isMyPatchObs_) +
+         vectorMemoryBytes(globalUniqueConsecutiveLocIndices_);
+}
+
+// -----------------------------------------------------------------------------
+
 }  // namespace ioda
@@ -54,6 +54,7 @@ class ReplicaOfGeneralDistribution : public Distribution {
   void allGatherv(std::vector<std::string> &x) const override;
 
   size_t globalUniqueConsecutiveLocationIndex(size_t loc) const override;
+  std::size_t memoryBytes() const override;
 
   std::string name() const override { return "ReplicaOfGeneralDistribution"; }
 
@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "../defs.h"
+#include "ObsStore.h"
 
 #include "oops/util/parameters/ParameterTraits.h"
 
@@ -81,6 +82,10 @@ public:
   std::size_t allocBytes;
   bool flush;
   /// @}
+  /// @name ObsStore
+  /// @{
+  ObsStore::StorageParameters obsStoreStorage;
+  /// @}
 
   BackendCreationParameters() { }
 };
@@ -14,10 +14,12 @@
  * \brief HDF5 engine
  */
 
+#include <cstddef>
 #include <iostream>
 #include <mpi.h>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "../defs.h"
 #include "Capabilities.h"
@@ -142,6 +144,76 @@ IODA_DL Capabilities getCapabilitiesFileEngine();
 /// \ingroup ioda_cxx_engines_pub_HH
 IODA_DL Capabilities getCapabilitiesInMemoryEngine();
 
+/// \brief Can the HDF5 engines be used from more than one thread at a time?
+/// \ingroup ioda_cxx_engines_pub_HH
+/// \details True only if the HDF5 library was built thread-safe. Each thread must still
+///   work on its own files.
+IODA_DL bool isThreadSafe();
+
+/// \brief Set the number of threads used to compress and decompress chunks.
+/// \ingroup ioda_cxx_engines_pub_HH
+/// \details Whole-variable writes of deflate compressed variables compress their chunks
+///   on a pool of threads instead of in the (serial) HDF5 filter pipeline. Whole-variable
+///   and contiguous hyperslab reads of such variables decompress their chunks the same way.
+/// \param numThreads is the number of threads. One (the default) turns the multithreaded
+///   path off; zero means one per hardware thread. The setting applies to the whole process;
+///   the "chunk threads" options of the H5File reader and the io pool change it only when set.
+IODA_DL void setChunkThreads(std::size_t numThreads);
+
+/// \brief Work done by the multithreaded chunk path (see setChunkThreads)
+/// \ingroup ioda_cxx_engines_pub_HH
+struct ChunkThreadStatistics {
+  /// \brief number of chunks compressed on the chunk threads and written to files
+  std::size_t chunksWritten = 0;
+  /// \brief number of chunks read from files and decompressed on the chunk threads
+  std::size_t chunksRead = 0;
+};
+
+/// \brief Get the work done by the multithreaded chunk path since the program started.
+/// \ingroup ioda_cxx_engines_pub_HH
+IODA_DL ChunkThreadStatistics getChunkThreadStatistics();
+
+/// \brief Create a file that presents a set of ioda files as one, without copying their data.
+/// \ingroup ioda_cxx_engines_pub_HH
+/// \details The files must hold the same groups and variables. Variables along the location
+///   dimension become HDF5 virtual datasets that stack the pieces from each file in order.
+///   Every other variable, and the group and variable attributes, are copied from the first
+///   file, and the dimension scales are set up again. Files in the directory of the new file
+///   are referred to by their bare name, so the set of files can be moved together.
+/// \param fileName is the name of the file to create. An existing file is overwritten.
+/// \param sourceNames are the names of the files to combine, in location order.
+/// \param excludeGroups are top-level groups of the files that are left out.
+/// \param locationDimName is the name of the location dimension.
+/// \throws ioda::Exception if the files cannot be combined.
+IODA_DL void createVirtualFile(const std::string& fileName,
+                               const std::vector<std::string>& sourceNames,
+                               const std::vector<std::string>& excludeGroups = {},
+                               const std::string& locationDimName = "nlocs");
+
+/// \brief Open a set of ioda files as one ioda::Group, without copying their data.
+/// \ingroup ioda_cxx_engines_pub_HH
+/// \details Like createVirtualFile, except that the combined file lives in memory only.
+///   HDF5 opens a file of the set when data from it is first read.
+/// \param sourceNames are the names of the files to combine, in location order.
+/// \param excludeGroups are top-level groups of the files that are left out.
+/// \param locationDimName is the name of the location dimension.
+/// \throws ioda::Exception if the files cannot be combined.
+IODA_DL Group openVirtualFile(const std::vector<std::string>& sourceNames,
+                              const std::vector<std::string>& excludeGroups = {},
+                              const std::string& locationDimName = "nlocs");
+
+/// \brief Open a ioda file as a ioda::Group with the same variables but no locations.
+/// \ingroup ioda_cxx_engines_pub_HH
+/// \details Like openVirtualFile, except that the variables along the location dimension
+///   are empty. No data are read from the file.
+/// \param templateName is the name of the file whose layout is copied.
+/// \param excludeGroups are top-level groups of the file that are left out.
+/// \param locationDimName is the name of the location dimension.
+/// \throws ioda::Exception if the file cannot be opened.
+IODA_DL Group openEmptyVirtualFile(const std::string& templateName,
+                                   const std::vector<std::string>& excludeGroups = {},
+                                   const std::string& locationDimName = "nlocs");
+
 /// stream operator
 IODA_DL std::ostream& operator<<(std::ostream& os, const HDF5_Version& ver);
 /// stream operator
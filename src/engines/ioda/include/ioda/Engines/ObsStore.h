@@ -8,11 +8,65 @@
  * \brief ObsStore Engine
  * \ingroup ioda_cxx_engines_pub
  *
+ * \par Thread safety
+ * Any number of threads may concurrently read from, open, list and test for the
+ * existence of groups, variables and attributes in the same ObsStore tree, including
+ * reads of the same variable with the same (shared) ioda::Selection objects. Operations
+ * that modify the tree (create, remove, rename, write, resize, attaching dimension
+ * scales) must not run concurrently with each other or with any reads; callers are
+ * responsible for that synchronization, e.g. by doing all writes outside of a
+ * parallel region.
+ *
+ * \par Storage policies
+ * By default every variable is held in process memory. A StorageParameters object
+ * passed to createRootGroup can instead place the numeric variables of selected groups
+ * (or individual variables) in memory-mapped files on local scratch, so that the
+ * operating system may page out columns that are rarely touched, or keep them compressed
+ * in memory. Numeric variables are compressed with a byte shuffle and zlib once they
+ * are written in full, or when the tree is compacted (see compactGroup, which ObsSpace
+ * calls once it is loaded), and are left uncompressed again once they are read often.
+ * Compression pays off mainly for low-entropy columns such as QC flags and repeated
+ * metadata; real-valued observations shrink far less.
+ * Chunked variables are held in memory as a table of fixed-size blocks of locations, so
+ * that appending locations allocates new blocks instead of reallocating and copying the
+ * whole variable.
+ * These variables behave exactly like in-memory variables; only their backing store
+ * differs.
+ *
+ * \par String variables
+ * String variables are always kept in memory. While most of the values of a variable are
+ * repeats, it is dictionary encoded: a table of the distinct values plus one integer code
+ * per element. ioda::Variable::readDictionaryEncoded hands out the codes and the table
+ * without creating a std::string per element. A variable whose values are mostly distinct
+ * is switched to one string per element, for good, and is then read with read() only.
+ *
+ * \par Arena
+ * When ArenaParameters::enabled is set, the in-memory numeric variables of the tree take
+ * their buffers from an arena owned by the tree. Large buffers get their own anonymous
+ * mappings, aligned for (and optionally advised to use) transparent huge pages, whose
+ * pages are placed on the NUMA node of the thread that first writes them. Released
+ * mappings are cached for reuse. getArenaStatistics reports what the arena holds.
+ *
+ * \par Memory accounting
+ * Every tree keeps running totals of the memory held by its variables and attributes,
+ * by group and by variable, along with their high-water mark. The totals are updated
+ * whenever a variable allocates or releases memory, so getMemoryStatistics is cheap.
+ * The owner of a tree can add the memory it holds alongside the tree (indices and the
+ * like) with setExternalBytes.
+ *
+ * \par Cloning
+ * cloneGroup copies a group, and everything below it, into a new tree. Variable values
+ * are shared by the source and the copy until one of them modifies them, so a clone costs
+ * time proportional to the number of objects, not to the amount of data.
+ *
  * @{
  * \file ObsStore.h
  * \brief ObsStore engine
  */
 #pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <map>
 #include <string>
 
 #include "../defs.h"
@@ -23,10 +77,167 @@ class Group;
 
 namespace Engines {
 namespace ObsStore {
+/// \brief Backing store for the data of an ObsStore variable
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+enum class StorageKind {
+  Memory,      ///< process memory (the default)
+  MappedFile,  ///< memory-mapped file in the scratch directory
+  Compressed,  ///< compressed in memory while rarely accessed
+  Chunked      ///< process memory, in blocks of locations that are allocated as needed
+};
+
+/// \brief Settings of the allocator used for the in-memory variables of an ObsStore tree
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+struct ArenaParameters {
+  /// \brief use an arena (otherwise buffers come from the heap)
+  bool enabled = false;
+  /// \brief advise the kernel to back large buffers with transparent huge pages
+  bool hugePages = true;
+  /// \brief buffers of at least this size (in bytes) get their own mapping
+  std::size_t minMappedBytes = 1024 * 1024;
+  /// \brief released mappings of up to this many bytes in total are kept for reuse
+  std::size_t cacheBytes = 64 * 1024 * 1024;
+};
+
+/// \brief Allocation statistics of an ObsStore arena
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+struct ArenaStatistics {
+  /// \brief number of allocations not yet released
+  std::size_t liveAllocations = 0;
+  /// \brief number of allocations made so far
+  std::size_t totalAllocations = 0;
+  /// \brief number of mapped allocations served from the cache
+  std::size_t cacheHits = 0;
+  /// \brief bytes requested by live allocations
+  std::size_t bytesInUse = 0;
+  /// \brief bytes requested by live allocations served from the heap
+  std::size_t heapBytes = 0;
+  /// \brief bytes currently mapped (live and cached mappings)
+  std::size_t mappedBytes = 0;
+  /// \brief highest value reached by mappedBytes
+  std::size_t peakMappedBytes = 0;
+  /// \brief bytes of mappedBytes advised to use huge pages
+  std::size_t hugePageBytes = 0;
+  /// \brief bytes of mappedBytes held in the cache
+  std::size_t cachedBytes = 0;
+};
+
+/// \brief Print arena statistics on one line
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+IODA_DL std::ostream& operator<<(std::ostream& os, const ArenaStatistics& stats);
+
+/// \brief Memory held by an ObsStore tree
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+/// \details Values shared by a clone and its source are counted once, by the tree that
+///   allocated them, for as long as either of them holds them.
+struct MemoryStatistics {
+  /// \brief bytes of process memory held (everything below except mappedBytes)
+  std::size_t bytes = 0;
+  /// \brief highest value reached by bytes
+  std::size_t peakBytes = 0;
+  /// \brief bytes of numeric variable values in process memory
+  std::size_t valueBytes = 0;
+  /// \brief bytes of string variables (tables of distinct values and codes)
+  std::size_t stringBytes = 0;
+  /// \brief bytes of attribute values
+  std::size_t attributeBytes = 0;
+  /// \brief bytes held alongside the tree by its owner (see setExternalBytes)
+  std::size_t externalBytes = 0;
+  /// \brief bytes of numeric variable values in mapped scratch files (not part of bytes)
+  std::size_t mappedBytes = 0;
+  /// \brief process memory held by the variables and attributes of each group, by group
+  ///        path ("" for the root group; subgroups are not included)
+  std::map<std::string, std::size_t> groupBytes;
+  /// \brief process memory held by the values and attributes of each variable, by path
+  std::map<std::string, std::size_t> variableBytes;
+  /// \brief externalBytes by the name given to setExternalBytes
+  std::map<std::string, std::size_t> externalBytesByName;
+};
+
+/// \brief Print the totals and the bytes of each group of memory statistics on one line
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+IODA_DL std::ostream& operator<<(std::ostream& os, const MemoryStatistics& stats);
+
+/// \brief Storage policies for the variables of an ObsStore tree
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+struct IODA_DL StorageParameters {
+  /// \brief storage used by variables that no policy applies to
+  StorageKind defaultKind = StorageKind::Memory;
+  /// \brief directory holding the files of mapped variables (empty: $TMPDIR, else /tmp)
+  std::string scratchDirectory;
+  /// \brief storage by group path (e.g. "MetaData") or variable path
+  ///        (e.g. "ObsValue/brightnessTemperature")
+  std::map<std::string, StorageKind> policies;
+  /// \brief number of reads of compressed data after which a Compressed variable is
+  ///        considered hot and is kept uncompressed (0: always keep compressed)
+  std::size_t compressedHotAccesses = 4;
+  /// \brief number of locations (entries along the leading dimension) in a block of a
+  ///        Chunked variable
+  std::size_t chunkLocations = 10000;
+  /// \brief allocator settings for the in-memory numeric variables
+  ArenaParameters arena;
+
+  /// \brief storage for a variable
+  /// \param varPath full path of the variable, without a leading '/'
+  /// \details An entry for the variable itself wins, then the entry for the nearest
+  ///          enclosing group, then defaultKind.
+  StorageKind lookup(const std::string& varPath) const;
+
+  /// \brief the scratch directory to use, with the defaults applied
+  std::string scratchPath() const;
+};
+
 /// \brief Create a ioda::Group backed by an OsbStore Group object.
 /// \ingroup ioda_cxx_engines_pub_ObsStore
 IODA_DL Group createRootGroup();
 
+/// \brief Create a ioda::Group backed by an OsbStore Group object.
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+/// \param storage storage policies applied to every variable created in the tree
+/// \throws ioda::Exception if a policy maps variables and no file can be mapped in the
+///         scratch directory
+IODA_DL Group createRootGroup(const StorageParameters& storage);
+
+/// \brief Copy an ObsStore group into a new ObsStore tree
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+/// \param group the group to copy; it becomes the root group of the new tree
+/// \details The new tree uses the storage policies of the source tree. Variable values are
+///          shared copy-on-write. A group from another engine is copied with copyGroup into
+///          a new default ObsStore tree.
+IODA_DL Group cloneGroup(const Group& group);
+
+/// \brief Get the statistics of the arena of an ObsStore tree
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+/// \param group any group of the tree
+/// \param[out] stats the statistics
+/// \returns false (leaving stats alone) if group is not from an ObsStore tree or the tree
+///          does not use an arena
+IODA_DL bool getArenaStatistics(const Group& group, ArenaStatistics& stats);
+
+/// \brief Get the memory statistics of an ObsStore tree
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+/// \param group any group of the tree
+/// \param[out] stats the statistics
+/// \returns false (leaving stats alone) if group is not from an ObsStore tree
+IODA_DL bool getMemoryStatistics(const Group& group, MemoryStatistics& stats);
+
+/// \brief Compress the Compressed variables of an ObsStore group and of everything below it
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+/// \details Call this once the variables are loaded, so that variables written piece by
+///          piece are held compressed until they are next read or written.
+/// \param group the group
+/// \returns false if group is not from an ObsStore tree
+IODA_DL bool compactGroup(const Group& group);
+
+/// \brief Record the size of memory held alongside an ObsStore tree by its owner
+/// \ingroup ioda_cxx_engines_pub_ObsStore
+/// \details The bytes count towards MemoryStatistics::bytes and its high-water mark.
+/// \param group any group of the tree
+/// \param name name of the memory; a later call with the same name replaces the size
+/// \param bytes size in bytes (0 removes the entry)
+/// \returns false if group is not from an ObsStore tree
+IODA_DL bool setExternalBytes(const Group& group, const std::string& name, std::size_t bytes);
+
 /// \brief Get capabilities of the ObsStore engine
 /// \ingroup ioda_cxx_engines_pub_ObsStore
 IODA_DL Capabilities getCapabilities();
@@ -24,8 +24,27 @@ class ReadH5FileParameters : public ReaderParametersBase {
     OOPS_CONCRETE_PARAMETERS(ReadH5FileParameters, ReaderParametersBase)
 
   public:
-    /// \brief Path to input file
-    oops::RequiredParameter<std::string> fileName{"obsfile", this};
+    /// \brief Path to input file, or a glob pattern matching a set of input files
+    oops::OptionalParameter<std::string> fileName{"obsfile", this};
+
+    /// \brief Paths to (or glob patterns matching) a set of input files
+    /// \details The files are read as one obs source, stacked along nlocs in the order
+    /// given (matches of a pattern in name order). Use either this or obsfile.
+    oops::OptionalParameter<std::vector<std::string>> fileNames{"obsfiles", this};
+
+    /// \brief Give each MPI task its own share of a set of input files
+    /// \details Each task reads a run of whole files, balanced by their number of
+    /// locations, and opens no other file of the set. The locations stay on the task
+    /// that read them, which needs the RoundRobin distribution, and records are not
+    /// formed across files read by different tasks, so switch it on only with the
+    /// RoundRobin distribution and no obs grouping spanning files. Has no effect on a
+    /// single file.
+    oops::Parameter<bool> distributeFiles{"distribute files", false, this};
+
+    /// \brief Number of threads used to decompress the chunks of the input variables
+    /// \details See ioda::Engines::HH::setChunkThreads; 0 means one per hardware thread.
+    ///          The setting is process wide: when not set, the current setting is kept.
+    oops::OptionalParameter<std::size_t> chunkThreads{"chunk threads", this};
 };
 
 // Classes
@@ -41,8 +60,30 @@ class ReadH5File: public ReaderBase {
 
   void print(std::ostream & os) const override;
 
+  bool eachProcessReadsSeparateObs() const override { return separateObs_; }
+
+  std::size_t globalLocationOffset() const override { return locationOffset_; }
+
  private:
-  std::string fileName_;
+  /// \brief names of the input files, after expanding glob patterns
+  std::vector<std::string> fileNames_;
+
+  /// \brief true if this task reads its own share of the input files
+  bool separateObs_ = false;
+
+  /// \brief index in the whole set of files of the first location read by this task
+  std::size_t locationOffset_ = 0;
+
+  /// \brief check that a set of input files hold the same variables
+  /// \details The files are shared out between the MPI tasks, so that each file is opened
+  /// by one task only. Mismatches are gathered and reported together, before anything
+  /// is read.
+  /// \returns the number of locations in each file
+  std::vector<Dimensions_t> checkFileSet();
+
+  /// \brief names of the files read by this task when the files are distributed
+  /// \param fileNlocs is the number of locations in each file
+  std::vector<std::string> assignFiles(const std::vector<Dimensions_t> & fileNlocs);
 };
 
 }  // namespace Engines
@@ -87,6 +87,16 @@ class ReaderBase : public util::Printable {
     /// for generator backends. The default is true (enabled).
     virtual bool applyLocationsCheck() const { return true; }
 
+    /// \brief return true if each task reads a different part of the obs source
+    /// \details The locations read by a task are then kept on that task: record numbers
+    /// are interleaved between the tasks, which the RoundRobin distribution keeps where
+    /// they were read. The default is false (every task reads the whole obs source).
+    virtual bool eachProcessReadsSeparateObs() const { return false; }
+
+    /// \brief return the index in the whole obs source of the first location read
+    /// by this task (zero unless eachProcessReadsSeparateObs is true)
+    virtual std::size_t globalLocationOffset() const { return 0; }
+
  protected:
     //------------------ protected functions ----------------------------------
     /// \brief print() for oops::Printable base class
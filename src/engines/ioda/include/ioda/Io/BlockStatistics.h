@@ -0,0 +1,97 @@
+#pragma once
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/// \file BlockStatistics.h
+/// \brief Per block ranges of the location metadata of a ioda file
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ioda/defs.h"
+
+namespace ioda {
+    class Group;
+
+/// \brief name of the group that holds the block statistics in a file
+constexpr char blockStatisticsGroupName[] = "BlockStatistics";
+
+/// \brief Ranges of MetaData/dateTime, MetaData/latitude and MetaData/longitude over
+/// consecutive blocks of locations
+/// \details Block i holds locations [i * blockSize, (i + 1) * blockSize), the last block
+/// may be shorter. Missing values are left out of the ranges. A block that holds a missing
+/// dateTime gets a dateTime range covering every int64 value, so that it is never taken
+/// to lie outside a timing window. A block with no valid latitude (longitude) holds the
+/// missing value for both ends of the latitude (longitude) range.
+///
+/// The first and last dateTime of each block are kept as well, so that statistics gone
+/// stale through an edit of the block endpoints of MetaData/dateTime can be told apart
+/// from valid ones by reading two values per block rather than the whole variable. An
+/// edit of an interior dateTime is not detected.
+struct IODA_DL BlockStatistics {
+    /// number of locations in a block
+    Dimensions_t blockSize = 0;
+
+    /// number of locations the blocks cover
+    Dimensions_t nlocs = 0;
+
+    /// units of the dateTime ranges (those of MetaData/dateTime)
+    std::string dateTimeUnits;
+
+    std::vector<int64_t> dateTimeMin;
+    std::vector<int64_t> dateTimeMax;
+    std::vector<int64_t> dateTimeFirst;
+    std::vector<int64_t> dateTimeLast;
+    std::vector<float> latitudeMin;
+    std::vector<float> latitudeMax;
+    std::vector<float> longitudeMin;
+    std::vector<float> longitudeMax;
+
+    /// \brief number of blocks
+    std::size_t numBlocks() const { return dateTimeMin.size(); }
+
+    /// \brief index of the first location in block i
+    Dimensions_t blockStart(std::size_t i) const {
+        return static_cast<Dimensions_t>(i) * blockSize;
+    }
+
+    /// \brief number of locations in block i
+    Dimensions_t blockCount(std::size_t i) const;
+};
+
+/// @brief Compute the block statistics of an obs group from its location metadata
+/// @param obsGroup is a group holding MetaData/dateTime (epoch style), MetaData/latitude
+///   and MetaData/longitude
+/// @param blockSize is the number of locations in a block. When zero, the chunk size of
+///   MetaData/dateTime along nlocs is used, so that a block is read with whole chunks.
+/// @param stats receives the statistics
+/// @return false if the group lacks one of the metadata variables
+IODA_DL bool computeBlockStatistics(const Group & obsGroup, Dimensions_t blockSize,
+                                    BlockStatistics & stats);
+
+/// @brief Compute the block statistics of an obs group and store them in the group
+/// @details The statistics go in the blockStatisticsGroupName group, replacing any
+///   that are there already.
+/// @param obsGroup is the group, typically the top level group of a file
+/// @param blockSize is the number of locations in a block (see computeBlockStatistics)
+/// @return false if nothing was written because the group lacks one of the metadata
+///   variables
+IODA_DL bool writeBlockStatistics(Group & obsGroup, Dimensions_t blockSize = 0);
+
+/// @brief Read the block statistics stored in an obs group
+/// @param obsGroup is the group, typically the top level group of a file
+/// @param stats receives the statistics
+/// @return false if the group holds no block statistics, or holds some that do not match
+///   its nlocs dimension or the first and last MetaData/dateTime of each block
+IODA_DL bool readBlockStatistics(const Group & obsGroup, BlockStatistics & stats);
+
+/// @brief true if a variable path names a variable of the block statistics group
+/// @details Readers and copiers skip these, since the statistics describe one
+///   particular file and go stale as soon as its locations change.
+IODA_DL bool isBlockStatisticsVariable(const std::string & varName);
+
+}  // namespace ioda
@@ -48,6 +48,7 @@ public:
   /// \brief construct an IoPool object
   /// \param ioPoolParams Parameters for this io pool
   /// \param writerParams Parameters for the associated backend writer engine
+  /// \param compressionParams Compression settings for the variables in the output file
   /// \param commAll MPI "all" communicator group (all tasks in DA run)
   /// \param commTime MPI "time" communicator group (tasks in current time bin for 4DEnVar)
   /// \param winStart DA timing window start
@@ -56,6 +57,7 @@ public:
   IoPool(const oops::Parameter<IoPoolParameters> & ioPoolParams,
          const oops::RequiredPolymorphicParameter
              <Engines::WriterParametersBase, Engines::WriterFactory> & writerParams,
+         const oops::Parameter<OutputCompressionParameters> & compressionParams,
          const eckit::mpi::Comm & commAll, const eckit::mpi::Comm & commTime,
          const util::DateTime & winStart, const util::DateTime & winEnd, std::size_t nlocs);
   ~IoPool();
@@ -100,6 +102,14 @@ public:
   /// \brief return the rank assignment for this object.
   const std::vector<std::pair<int, int>> & rank_assignment() const { return rank_assignment_; }
 
+  /// \brief return the compression settings for the output file variables
+  const OutputCompressionParameters & compression_params() const {
+      return compression_params_.value();
+  }
+
+  /// \brief return the target chunk size, in bytes, for the output file variables
+  std::size_t chunk_target_bytes() const;
+
   /// \brief save obs data to output file
   /// \param srcGroup source ioda group to be saved into the output file
   void save(const Group & srcGroup);
@@ -123,6 +133,9 @@ private:
   const oops::RequiredPolymorphicParameter
       <Engines::WriterParametersBase, Engines::WriterFactory> & writer_params_;
 
+  /// \brief output compression parameters
+  const oops::Parameter<OutputCompressionParameters> & compression_params_;
+
   /// \brief DA timing window start
   util::DateTime win_start_;
 
@@ -246,6 +259,10 @@ private:
   /// \brief create file names for the fixed length string workaround
   void workaroundFixToVarLenStrings(const std::string & finalFileName,
                                     const std::string & tempFileName);
+
+  /// \brief add the block statistics group to a finished output file
+  /// \param fileName output file name
+  void saveBlockStatistics(const std::string & fileName);
 };
 
 class WorkaroundReaderParameters : public oops::Parameters {
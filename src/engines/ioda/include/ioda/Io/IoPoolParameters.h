@@ -20,8 +20,10 @@
 #include "eckit/exception/Exceptions.h"
 #include "eckit/mpi/Comm.h"
 
+#include "oops/util/parameters/NumericConstraints.h"
 #include "oops/util/parameters/OptionalParameter.h"
 #include "oops/util/parameters/Parameter.h"
+#include "oops/util/parameters/ParameterTraits.h"
 #include "oops/util/parameters/Parameters.h"
 #include "oops/util/parameters/RequiredParameter.h"
 
@@ -32,6 +34,84 @@ namespace eckit {
 
 namespace ioda {
 
+/// \brief compression codecs for variables written to an output file
+enum class OutputCodec {
+  None, Deflate, Szip
+};
+
+struct OutputCodecParameterTraitsHelper {
+  typedef OutputCodec EnumType;
+  static constexpr char enumTypeName[] = "OutputCodec";
+  static constexpr util::NamedEnumerator<OutputCodec> namedValues[] = {
+    { OutputCodec::None, "none" },
+    { OutputCodec::Deflate, "deflate" },
+    { OutputCodec::Szip, "szip" }
+  };
+};
+
+}  // namespace ioda
+
+namespace oops {
+
+template <>
+struct ParameterTraits<ioda::OutputCodec> :
+    public EnumParameterTraits<ioda::OutputCodecParameterTraitsHelper>
+{};
+
+}  // namespace oops
+
+namespace ioda {
+
+class OutputCompressionSpecParameters : public oops::Parameters {
+     OOPS_CONCRETE_PARAMETERS(OutputCompressionSpecParameters, oops::Parameters)
+
+ public:
+    /// compression codec
+    oops::Parameter<OutputCodec> codec{"codec", OutputCodec::Deflate, this};
+
+    /// deflate level, 1 (fastest) to 9 (smallest)
+    oops::Parameter<int> level{"level", 6, this,
+                               {oops::minConstraint(1), oops::maxConstraint(9)}};
+
+    /// byte shuffle the values before compressing them
+    oops::Parameter<bool> shuffle{"shuffle", false, this};
+
+    /// szip pixels per block (even, at most 32)
+    oops::Parameter<int> pixelsPerBlock{"pixels per block", 16, this,
+                                        {oops::minConstraint(2), oops::maxConstraint(32)}};
+
+    /// Round floating point values to this many mantissa bits before compressing them
+    /// (lossy; the relative error is at most 2^-(bits+1)). When not set, values are
+    /// written exactly.
+    oops::OptionalParameter<int> keepMantissaBits{"keep mantissa bits", this,
+                                                  {oops::minConstraint(0)}};
+};
+
+class OutputCompressionPolicyParameters : public OutputCompressionSpecParameters {
+     OOPS_CONCRETE_PARAMETERS(OutputCompressionPolicyParameters,
+                              OutputCompressionSpecParameters)
+
+ public:
+    /// Group or variable the policy applies to. This is a pattern ('*' matches any
+    /// sequence of characters, '?' any single character) that is matched against the
+    /// variable path (eg, "ObsValue/brightnessTemperature") and against the path of
+    /// the group holding the variable (eg, "ObsValue").
+    oops::RequiredParameter<std::string> name{"name", this};
+};
+
+class OutputCompressionParameters : public oops::Parameters {
+     OOPS_CONCRETE_PARAMETERS(OutputCompressionParameters, oops::Parameters)
+
+ public:
+    /// compression for variables that match none of the policies (when not set, these
+    /// variables keep the compression they were created with)
+    oops::OptionalParameter<OutputCompressionSpecParameters> defaultSpec{"default", this};
+
+    /// per group or per variable compression, the first matching policy is used
+    oops::Parameter<std::vector<OutputCompressionPolicyParameters>> policies{
+        "policies", {}, this};
+};
+
 class IoPoolParameters : public oops::Parameters {
      OOPS_CONCRETE_PARAMETERS(IoPoolParameters, oops::Parameters)
 
@@ -39,18 +119,33 @@ class IoPoolParameters : public oops::Parameters {
     /// maximum pool size in number of MPI processes
     oops::Parameter<int> maxPoolSize{"max pool size", -1, this};
 
-    /// chunk size in bytes
+    /// target chunk size in bytes for the output file variables (when not set,
+    /// chunking::defaultChunkBytes)
     oops::OptionalParameter<std::size_t> chunkSize{"chunk size", this};
 
     /// chunk cache size in bytes
     oops::OptionalParameter<std::size_t> chunkCacheSize{"chunk cache size", this};
 
+    /// number of threads used to compress the chunks of the output file variables
+    /// (see ioda::Engines::HH::setChunkThreads; 0 means one per hardware thread). The
+    /// setting is process wide: when not set, the current setting is kept.
+    oops::OptionalParameter<std::size_t> chunkThreads{"chunk threads", this};
+
     /// maximum file size in megabytes
     oops::OptionalParameter<std::size_t> maxFileSize{"max file size", this};
 
     /// write multiple files (write one file per io pool task)
     /// default is false meaning a single output file will be written
     oops::Parameter<bool> writeMultipleFiles{"write multiple files", false, this};
+
+    /// store per block ranges of MetaData/dateTime, latitude and longitude in the output
+    /// file (see ioda::BlockStatistics), which readers use to skip blocks of locations
+    /// that lie outside their timing window
+    oops::Parameter<bool> writeBlockStatistics{"write block statistics", false, this};
+
+    /// with write multiple files, also write a file under the plain output file name that
+    /// presents the set of files as one, through HDF5 virtual datasets
+    oops::Parameter<bool> writeMasterFile{"write master file", false, this};
 };
 
 }  // namespace ioda
@@ -0,0 +1,43 @@
+#pragma once
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_cxx_api
+ *
+ * @{
+ * \file BitRounding.h
+ * \brief Lossy precision trimming of floating point data
+ */
+
+#include "gsl/gsl-lite.hpp"
+
+#include "ioda/defs.h"
+
+namespace ioda {
+/// @brief Name of the variable attribute recording the number of mantissa bits kept.
+/// @details This is the attribute NetCDF uses for its BitRound quantization, so that
+///   NetCDF tools recognize the rounded variables.
+constexpr char bitRoundingAttrName[] = "_QuantizeBitRoundNumberOfBits";
+
+/// @brief Round floating point values to keep only the leading bits of their mantissas.
+/// @ingroup ioda_cxx_api
+/// @details Values are rounded to the nearest value representable with keepBits mantissa
+///   bits (ties to even), which bounds the relative error of each value by 2^-(keepBits+1).
+///   The trailing mantissa bits become zero, so the data compresses much better. NaN,
+///   infinite values and values equal to the fill value are left unchanged. A keepBits
+///   of at least the number of stored mantissa bits (23 for float, 52 for double) leaves
+///   all values unchanged.
+/// @param values are the values to round, in place.
+/// @param keepBits is the number of mantissa bits to keep (at least zero).
+/// @param fillValue points to the fill value, or is nullptr if there is none.
+IODA_DL void bitRoundMantissa(gsl::span<float> values, int keepBits,
+                              const float* fillValue = nullptr);
+/// @copydoc bitRoundMantissa(gsl::span<float>, int, const float*)
+IODA_DL void bitRoundMantissa(gsl::span<double> values, int keepBits,
+                              const double* fillValue = nullptr);
+}  // namespace ioda
+
+/// @}
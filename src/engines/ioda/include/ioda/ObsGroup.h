@@ -68,6 +68,12 @@ public:
   ///
   void resize(const std::vector<std::pair<Variable, ioda::Dimensions_t>>& newDims);
 
+  /// \brief Make an independent copy of this ObsGroup in a new in-memory (ObsStore) tree.
+  /// \details If this ObsGroup is backed by ObsStore, the copy shares the variable values
+  ///   with the original until either of them modifies them, so this is cheap. Otherwise
+  ///   the contents are copied. See Engines::ObsStore::cloneGroup.
+  ObsGroup clone() const;
+
 private:
   /// \brief recusively visit all groups and resize variables according
   /// to newDims.
@@ -39,6 +39,8 @@ public:
 
 class UnitsInterface;
 
+/// Units may be parsed, compared and converted from several threads at once: every call
+/// into UDUNITS-2 is serialized.
 class Units {
 private:
   std::shared_ptr<detail::udunits_units_impl> impl_;
@@ -50,6 +50,26 @@ inline bool Chunking_Max(const std::vector<Dimensions_t>& in, std::vector<Dimens
   out = in;
   return true;
 }
+
+/// \brief Default target size of a chunk, in bytes.
+/// \details This matches the size of the default HDF5 chunk cache. Larger chunks bypass the
+///   cache, so every partial read of them decompresses the whole chunk again.
+constexpr std::size_t defaultChunkBytes = 1024 * 1024;
+
+/// \brief Pick chunk sizes that hold about targetBytes of data.
+/// \details Observation data are accessed by location (frames, MPI distribution) or by
+///   channel (one channel of every location), so the chunks keep the trailing dimensions
+///   whole and cut the leading (location) dimension into blocks of rows. The trailing
+///   dimensions are only halved, largest first, when a single row is over the target.
+/// \param shape is the largest chunk wanted along each dimension: usually the variable
+///   dimensions or a chunking hint. Returned unchanged if any entry is not positive, or
+///   if targetBytes is zero.
+/// \param elementSize is the size of one value, in bytes.
+/// \param targetBytes is the wanted chunk size, in bytes.
+/// \returns chunk sizes no larger than shape along any dimension.
+IODA_DL std::vector<Dimensions_t> sizeTargetedChunks(const std::vector<Dimensions_t>& shape,
+                                                     std::size_t elementSize,
+                                                     std::size_t targetBytes = defaultChunkBytes);
 }  // namespace chunking
 
 /// \brief Used to specify Variable creation-time properties.
@@ -96,16 +116,30 @@ public:
     if (fChunkingStrategy(cur_dims, res)) return res;
     throw Exception("Cannot figure out an appropriate chunking size.", ioda_Here());
   }
+  /// \brief Target chunk size in bytes (zero: use the chunks from getChunks as they are).
+  /// \details Backends that store chunks shrink chunks larger than this.
+  /// \see chunking::sizeTargetedChunks
+  std::size_t chunkTargetBytes = chunking::defaultChunkBytes;
 
   bool gzip_                        = false;
   bool szip_                        = false;
   int gzip_level_                   = 6;  // 1 (fastest) - 9 (most compression)
   unsigned int szip_PixelsPerBlock_ = 16;
   unsigned int szip_options_        = 4;  // Defined as H5_SZIP_EC_OPTION_MASK in hdf5.h;
+  /// Byte shuffle before compression (groups the bytes of each value by significance).
+  bool shuffle_                     = false;
 
   void noCompress();
   void compressWithGZIP(int level = 6);
   void compressWithSZIP(unsigned PixelsPerBlock = 16, unsigned options = 4);
+  void setShuffle(bool shuffle = true);
+
+  /// Number of mantissa bits kept when writing floating point data (negative: all).
+  /// \see bitRoundMantissa
+  int keepMantissaBits_ = -1;
+  /// Round floating point data to keepBits mantissa bits when it is written. This is
+  /// lossy, but makes the data far more compressible. Ignored for other types.
+  void keepMantissaBits(int keepBits);
 
   /// @}
   /// @name General Functions
@@ -504,6 +504,21 @@ public:
                         const Selection& mem_selection  = Selection::all,
                         const Selection& file_selection = Selection::all) const;
 
+  /// \brief Read a string variable as integer codes plus a table of its distinct values.
+  /// \details Backends that keep strings dictionary encoded (ObsStore) hand these out
+  ///   without creating a std::string per element. Equal strings have equal codes, so
+  ///   the codes may be compared and grouped on directly; dictionary[code] is the value.
+  ///   The dictionary may contain values that are not referenced by any code.
+  /// \param[out] codes one code per selected element, in row-major order.
+  /// \param[out] dictionary the distinct values, indexed by code.
+  /// \param file_selection is the backend's memory layout representing the
+  ///   location where the data are read from.
+  /// \returns false, leaving codes and dictionary untouched, if the backend does not
+  ///   store this variable dictionary encoded. Use read() in that case.
+  virtual bool readDictionaryEncoded(std::vector<int>& codes,
+                                     std::vector<std::string>& dictionary,
+                                     const Selection& file_selection = Selection::all) const;
+
   /// \brief Read the variable into a span (range) or memory. Ordering is row-major.
   /// \tparam DataType is the type of the data to be written.
   /// \tparam Marshaller is a class that serializes / deserializes data.
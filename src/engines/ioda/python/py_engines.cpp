@@ -68,6 +68,7 @@ void setupEngines(pybind11::module& m) {
 
   auto mEnginesObsStore  = mEngines.def_submodule("ObsStore");
   mEnginesObsStore.doc() = "Default in-memory engine. MPI capable.";
-  mEnginesObsStore.def("createRootGroup", ioda::Engines::ObsStore::createRootGroup,
+  mEnginesObsStore.def("createRootGroup",
+                       static_cast<ioda::Group (*)()>(ioda::Engines::ObsStore::createRootGroup),
                        "Create a new ObsStore-backed group.");
 }
@@ -44,12 +44,19 @@ void setupVCPs(pybind11::module& m, pybind11::module& mDetail, pybind11::module&
   vcps.def(py::init<>())
     .def_readwrite("chunk", &VariableCreationParameters::chunk, "Use chunking")
     .def_readwrite("chunks", &VariableCreationParameters::chunks, "Chunk sizes")
+    .def_readwrite("chunkTargetBytes", &VariableCreationParameters::chunkTargetBytes,
+                   "Shrink chunks holding more than this many bytes (0: never)")
     .def("noCompress", &VariableCreationParameters::noCompress, "Do not compress")
     .def("compressWithGZIP", &VariableCreationParameters::compressWithGZIP, "Use GZIP compression",
          py::arg("level") = 6)
     .def("compressWithSZIP", &VariableCreationParameters::compressWithSZIP,
          "Use SZIP compression (see H5_SZIP_EC_OPTION_MASK in hdf5.h)",
          py::arg("PixelsPerBlock") = 16, py::arg("options") = 4)
+    .def("setShuffle", &VariableCreationParameters::setShuffle,
+         "Byte shuffle the data before compressing it", py::arg("shuffle") = true)
+    .def("keepMantissaBits", &VariableCreationParameters::keepMantissaBits,
+         "Round floating point data to this many mantissa bits when writing it",
+         py::arg("keepBits"))
     .def_readwrite("setFillValue", &VariableCreationParameters::_py_setFillValue, "Set fill value")
     .def_readwrite("atts", &VariableCreationParameters::atts, "Attributes");
 }
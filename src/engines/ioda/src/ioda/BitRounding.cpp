@@ -0,0 +1,58 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_cxx_api
+ *
+ * @{
+ * \file BitRounding.cpp
+ * \brief Lossy precision trimming of floating point data
+ */
+
+#include "ioda/Misc/BitRounding.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "ioda/Exception.h"
+
+namespace ioda {
+namespace {
+template <typename FloatType, typename BitsType, int MantissaBits>
+void bitRoundImpl(gsl::span<FloatType> values, int keepBits, const FloatType* fillValue) {
+  if (keepBits < 0)
+    throw Exception("The number of mantissa bits to keep cannot be negative.", ioda_Here())
+      .add("keepBits", keepBits);
+  if (keepBits >= MantissaBits) return;
+
+  const int shift         = MantissaBits - keepBits;
+  const BitsType halfUlp  = BitsType(1) << (shift - 1);
+  const BitsType keepMask = ~((BitsType(1) << shift) - 1);
+  for (FloatType& value : values) {
+    if (!std::isfinite(value)) continue;
+    if ((fillValue != nullptr) && (value == *fillValue)) continue;
+    BitsType bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // Add just under half an ulp, plus one more if the last kept bit is set, so that
+    // ties round to even. A carry out of the mantissa correctly bumps the exponent.
+    bits += (halfUlp - 1) + ((bits >> shift) & 1);
+    bits &= keepMask;
+    std::memcpy(&value, &bits, sizeof(bits));
+  }
+}
+}  // namespace
+
+void bitRoundMantissa(gsl::span<float> values, int keepBits, const float* fillValue) {
+  bitRoundImpl<float, std::uint32_t, 23>(values, keepBits, fillValue);
+}
+
+void bitRoundMantissa(gsl::span<double> values, int keepBits, const double* fillValue) {
+  bitRoundImpl<double, std::uint64_t, 52>(values, keepBits, fillValue);
+}
+
+}  // namespace ioda
+
+/// @}
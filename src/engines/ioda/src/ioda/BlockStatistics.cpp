@@ -0,0 +1,301 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/// \file BlockStatistics.cpp
+/// \brief Per block ranges of the location metadata of a ioda file
+
+#include "ioda/Io/BlockStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "ioda/Exception.h"
+#include "ioda/Group.h"
+#include "ioda/Variables/Variable.h"
+
+#include "oops/util/Logger.h"
+#include "oops/util/missingValues.h"
+
+namespace ioda {
+
+namespace {
+
+// Used when MetaData/dateTime is not chunked. It matches the default frame size of the
+// obs space reader, which reads the locations in pieces of this size.
+constexpr Dimensions_t defaultBlockSize = 10000;
+
+const char blockSizeAttrName[] = "blockSize";
+const char nlocsAttrName[] = "nlocs";
+const char numBlocksVarName[] = "nblocks";
+const char * const dateTimeNames[] = { "dateTime_min", "dateTime_max" };
+const char * const dateTimeEndNames[] = { "dateTime_first", "dateTime_last" };
+const char * const latitudeNames[] = { "latitude_min", "latitude_max" };
+const char * const longitudeNames[] = { "longitude_min", "longitude_max" };
+
+template <typename T>
+T fillValueOf(const Variable & var) {
+    return var.hasFillValue() ? detail::getFillValue<T>(var.getFillValue())
+                              : util::missingValue(T());
+}
+
+// Ranges of the valid values of a float variable. Blocks with no valid values get the
+// missing value for both ends of the range.
+void floatRanges(const std::vector<float> & values, const float fill,
+                 const BlockStatistics & stats, std::vector<float> & mins,
+                 std::vector<float> & maxs) {
+    const float missingFloat = util::missingValue(missingFloat);
+    mins.assign(stats.numBlocks(), missingFloat);
+    maxs.assign(stats.numBlocks(), missingFloat);
+    for (std::size_t iblock = 0; iblock < stats.numBlocks(); ++iblock) {
+        const Dimensions_t start = stats.blockStart(iblock);
+        const Dimensions_t end = start + stats.blockCount(iblock);
+        float lo = std::numeric_limits<float>::max();
+        float hi = std::numeric_limits<float>::lowest();
+        bool haveValid = false;
+        for (Dimensions_t i = start; i < end; ++i) {
+            const float value = values[i];
+            if ((value == fill) || (value == missingFloat) || std::isnan(value)) continue;
+            lo = std::min(lo, value);
+            hi = std::max(hi, value);
+            haveValid = true;
+        }
+        if (haveValid) {
+            mins[iblock] = lo;
+            maxs[iblock] = hi;
+        }
+    }
+}
+
+template <typename T>
+void writeRange(Group & statsGroup, const Variable & numBlocksVar, const char * const names[],
+                const std::vector<T> & mins, const std::vector<T> & maxs,
+                const std::string & units) {
+    VariableCreationParameters params;
+    params.setFillValue<T>(util::missingValue(T()));
+    const std::vector<T> * values[] = { &mins, &maxs };
+    for (std::size_t i = 0; i < 2; ++i) {
+        Variable var = statsGroup.vars.createWithScales<T>(names[i], { numBlocksVar }, params);
+        if (!units.empty()) {
+            var.atts.add<std::string>("units", units);
+        }
+        if (!values[i]->empty()) {
+            var.write<T>(*values[i]);
+        }
+    }
+}
+
+template <typename T>
+bool readRange(const Group & statsGroup, const char * const names[], const std::size_t numBlocks,
+               std::vector<T> & mins, std::vector<T> & maxs) {
+    std::vector<T> * values[] = { &mins, &maxs };
+    for (std::size_t i = 0; i < 2; ++i) {
+        if (!statsGroup.vars.exists(names[i])) return false;
+        statsGroup.vars.open(names[i]).read<T>(*values[i]);
+        if (values[i]->size() != numBlocks) return false;
+    }
+    return true;
+}
+
+// true if the first and last dateTime of each block are those recorded in the statistics.
+// Only these values are read, so that checking costs little next to the reads the
+// statistics save. Edits of the other dateTimes of a block go unnoticed.
+bool matchesDateTimes(const Group & obsGroup, const BlockStatistics & stats) {
+    if (!obsGroup.vars.exists("MetaData/dateTime")) return false;
+    const Variable dtVar = obsGroup.vars.open("MetaData/dateTime");
+    if (!dtVar.isA<int64_t>() || (dtVar.getDimensions().dimsCur[0] != stats.nlocs)) {
+        return false;
+    }
+
+    std::vector<Selection::VecDimensions_t> points;
+    std::vector<int64_t> expected;
+    for (std::size_t iblock = 0; iblock < stats.numBlocks(); ++iblock) {
+        const Dimensions_t start = stats.blockStart(iblock);
+        const Dimensions_t last = start + stats.blockCount(iblock) - 1;
+        points.push_back(Selection::VecDimensions_t(1, start));
+        expected.push_back(stats.dateTimeFirst[iblock]);
+        if (last != start) {
+            points.push_back(Selection::VecDimensions_t(1, last));
+            expected.push_back(stats.dateTimeLast[iblock]);
+        }
+    }
+    if (points.empty()) return true;
+
+    const Dimensions_t numPoints = points.size();
+    const std::vector<Dimensions_t> memStart(1, 0);
+    const std::vector<Dimensions_t> memCount(1, numPoints);
+    std::vector<int64_t> values(numPoints);
+    dtVar.read<int64_t>(gsl::make_span(values),
+                        Selection().extent(memCount).select({SelectionOperator::SET,
+                                                             memStart, memCount}),
+                        Selection().select({SelectionOperator::SET, points}));
+    return values == expected;
+}
+
+}  // namespace
+
+//------------------------------------------------------------------------------------
+Dimensions_t BlockStatistics::blockCount(std::size_t i) const {
+    return std::min(blockSize, nlocs - blockStart(i));
+}
+
+//------------------------------------------------------------------------------------
+bool computeBlockStatistics(const Group & obsGroup, Dimensions_t blockSize,
+                            BlockStatistics & stats) {
+    if (!obsGroup.vars.exists("MetaData/dateTime") ||
+        !obsGroup.vars.exists("MetaData/latitude") ||
+        !obsGroup.vars.exists("MetaData/longitude")) {
+        return false;
+    }
+    const Variable dtVar = obsGroup.vars.open("MetaData/dateTime");
+    if (!dtVar.isA<int64_t>() || !dtVar.atts.exists("units")) {
+        return false;
+    }
+
+    if (blockSize <= 0) {
+        const std::vector<Dimensions_t> chunks = dtVar.getChunkSizes();
+        blockSize = (!chunks.empty() && (chunks[0] > 0)) ? chunks[0] : defaultBlockSize;
+    }
+    stats.blockSize = blockSize;
+    stats.nlocs = dtVar.getDimensions().dimsCur[0];
+    stats.dateTimeUnits = dtVar.atts.open("units").read<std::string>();
+    const std::size_t numBlocks = (stats.nlocs + blockSize - 1) / blockSize;
+
+    // dateTime. A missing value anywhere in a block opens its range up all the way.
+    std::vector<int64_t> dateTimes;
+    dtVar.read<int64_t>(dateTimes);
+    const int64_t dtFill = fillValueOf<int64_t>(dtVar);
+    const int64_t missingInt64 = util::missingValue(missingInt64);
+    stats.dateTimeMin.assign(numBlocks, std::numeric_limits<int64_t>::lowest());
+    stats.dateTimeMax.assign(numBlocks, std::numeric_limits<int64_t>::max());
+    stats.dateTimeFirst.resize(numBlocks);
+    stats.dateTimeLast.resize(numBlocks);
+    for (std::size_t iblock = 0; iblock < numBlocks; ++iblock) {
+        const auto first = dateTimes.begin() + stats.blockStart(iblock);
+        const auto last = first + stats.blockCount(iblock);
+        stats.dateTimeFirst[iblock] = *first;
+        stats.dateTimeLast[iblock] = *(last - 1);
+        const bool haveMissing = std::any_of(first, last, [&](int64_t value) {
+            return (value == dtFill) || (value == missingInt64);
+        });
+        if (!haveMissing) {
+            const auto range = std::minmax_element(first, last);
+            stats.dateTimeMin[iblock] = *range.first;
+            stats.dateTimeMax[iblock] = *range.second;
+        }
+    }
+
+    std::vector<float> values;
+    const Variable latVar = obsGroup.vars.open("MetaData/latitude");
+    latVar.read<float>(values);
+    floatRanges(values, fillValueOf<float>(latVar), stats, stats.latitudeMin,
+                stats.latitudeMax);
+    const Variable lonVar = obsGroup.vars.open("MetaData/longitude");
+    lonVar.read<float>(values);
+    floatRanges(values, fillValueOf<float>(lonVar), stats, stats.longitudeMin,
+                stats.longitudeMax);
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+bool writeBlockStatistics(Group & obsGroup, Dimensions_t blockSize) {
+    BlockStatistics stats;
+    if (!computeBlockStatistics(obsGroup, blockSize, stats)) {
+        return false;
+    }
+
+    Group statsGroup;
+    if (obsGroup.exists(blockStatisticsGroupName)) {
+        // Replace the old statistics. Remove the scale last, after the variables
+        // attached to it are gone.
+        statsGroup = obsGroup.open(blockStatisticsGroupName);
+        for (const auto & names : { dateTimeNames, dateTimeEndNames, latitudeNames,
+                                    longitudeNames }) {
+            for (std::size_t i = 0; i < 2; ++i) {
+                if (statsGroup.vars.exists(names[i])) statsGroup.vars.remove(names[i]);
+            }
+        }
+        if (statsGroup.vars.exists(numBlocksVarName)) statsGroup.vars.remove(numBlocksVarName);
+    } else {
+        statsGroup = obsGroup.create(blockStatisticsGroupName);
+    }
+
+    const Dimensions_t numBlocks = stats.numBlocks();
+    Variable numBlocksVar = statsGroup.vars.create<int>(numBlocksVarName, { numBlocks });
+    std::vector<int> blockNumbers(numBlocks);
+    std::iota(blockNumbers.begin(), blockNumbers.end(), 0);
+    if (numBlocks > 0) {
+        numBlocksVar.write<int>(blockNumbers);
+    }
+    numBlocksVar.setIsDimensionScale(numBlocksVarName);
+
+    if (statsGroup.atts.exists(blockSizeAttrName)) statsGroup.atts.remove(blockSizeAttrName);
+    if (statsGroup.atts.exists(nlocsAttrName)) statsGroup.atts.remove(nlocsAttrName);
+    statsGroup.atts.add<int64_t>(blockSizeAttrName, stats.blockSize);
+    statsGroup.atts.add<int64_t>(nlocsAttrName, stats.nlocs);
+
+    writeRange<int64_t>(statsGroup, numBlocksVar, dateTimeNames, stats.dateTimeMin,
+                        stats.dateTimeMax, stats.dateTimeUnits);
+    writeRange<int64_t>(statsGroup, numBlocksVar, dateTimeEndNames, stats.dateTimeFirst,
+                        stats.dateTimeLast, stats.dateTimeUnits);
+    writeRange<float>(statsGroup, numBlocksVar, latitudeNames, stats.latitudeMin,
+                      stats.latitudeMax, "degrees_north");
+    writeRange<float>(statsGroup, numBlocksVar, longitudeNames, stats.longitudeMin,
+                      stats.longitudeMax, "degrees_east");
+    return true;
+}
+
+//------------------------------------------------------------------------------------
+bool readBlockStatistics(const Group & obsGroup, BlockStatistics & stats) {
+    if (!obsGroup.exists(blockStatisticsGroupName) || !obsGroup.vars.exists("nlocs")) {
+        return false;
+    }
+    const Group statsGroup = obsGroup.open(blockStatisticsGroupName);
+    if (!statsGroup.atts.exists(blockSizeAttrName) || !statsGroup.atts.exists(nlocsAttrName)) {
+        return false;
+    }
+    stats.blockSize = statsGroup.atts.open(blockSizeAttrName).read<int64_t>();
+    stats.nlocs = statsGroup.atts.open(nlocsAttrName).read<int64_t>();
+    if ((stats.blockSize <= 0) ||
+        (stats.nlocs != obsGroup.vars.open("nlocs").getDimensions().dimsCur[0])) {
+        oops::Log::info() << "WARNING: ignoring block statistics that do not match "
+                          << "the nlocs dimension" << std::endl;
+        return false;
+    }
+    const std::size_t numBlocks = (stats.nlocs + stats.blockSize - 1) / stats.blockSize;
+
+    bool valid = readRange<int64_t>(statsGroup, dateTimeNames, numBlocks,
+                                    stats.dateTimeMin, stats.dateTimeMax) &&
+                 readRange<int64_t>(statsGroup, dateTimeEndNames, numBlocks,
+                                    stats.dateTimeFirst, stats.dateTimeLast) &&
+                 readRange<float>(statsGroup, latitudeNames, numBlocks,
+                                  stats.latitudeMin, stats.latitudeMax) &&
+                 readRange<float>(statsGroup, longitudeNames, numBlocks,
+                                  stats.longitudeMin, stats.longitudeMax);
+    if (valid) {
+        const Variable dtMinVar = statsGroup.vars.open(dateTimeNames[0]);
+        valid = dtMinVar.atts.exists("units");
+        if (valid) {
+            stats.dateTimeUnits = dtMinVar.atts.open("units").read<std::string>();
+        }
+    }
+    if (valid && !matchesDateTimes(obsGroup, stats)) {
+        oops::Log::info() << "WARNING: ignoring block statistics that do not match "
+                          << "MetaData/dateTime" << std::endl;
+        valid = false;
+    }
+    return valid;
+}
+
+//------------------------------------------------------------------------------------
+bool isBlockStatisticsVariable(const std::string & varName) {
+    const std::string prefix = std::string(blockStatisticsGroupName) + "/";
+    std::size_t start = (!varName.empty() && (varName[0] == '/')) ? 1 : 0;
+    return varName.compare(start, prefix.size(), prefix) == 0;
+}
+
+}  // namespace ioda
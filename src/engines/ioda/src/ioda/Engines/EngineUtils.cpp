@@ -214,7 +214,7 @@ Group constructBackend(BackendNames name, BackendCreationParameters& params) {
     throw Exception("Unknown BackendFileActions value", ioda_Here());
   }
   if (name == BackendNames::ObsStore) {
-    return ObsStore::createRootGroup();
+    return ObsStore::createRootGroup(params.obsStoreStorage);
   }
 
   // If we get to here, then we have a backend name that is
@@ -0,0 +1,565 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_hh
+ *
+ * @{
+ * \file HH-directchunks.cpp
+ * \brief Multithreaded chunk compression and decompression for the HDF5 engine.
+ */
+
+#include "./HH/HH-directchunks.h"
+
+#include <hdf5.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "./HH/HH-Filters.h"
+#include "ioda/Engines/HH.h"
+#include "ioda/Exception.h"
+#include "ioda/config.h"  // Auto-generated. Defines *_FOUND.
+
+#if ZLIB_FOUND
+#include <zlib.h>
+#endif
+
+namespace ioda {
+namespace Engines {
+namespace HH {
+namespace {
+/// Requested number of chunk threads (0: one per hardware thread).
+std::atomic<std::size_t> requestedChunkThreads{1};
+/// Number of chunks written by writeChunksDirect.
+std::atomic<std::size_t> directChunksWritten{0};
+/// Number of chunks read by readChunksDirect.
+std::atomic<std::size_t> directChunksRead{0};
+}  // namespace
+
+void setChunkThreads(std::size_t numThreads) { requestedChunkThreads = numThreads; }
+
+ChunkThreadStatistics getChunkThreadStatistics() {
+  ChunkThreadStatistics stats;
+  stats.chunksWritten = directChunksWritten;
+  stats.chunksRead    = directChunksRead;
+  return stats;
+}
+}  // namespace HH
+}  // namespace Engines
+
+namespace detail {
+namespace Engines {
+namespace HH {
+namespace {
+/// \brief A fixed set of worker threads that run the tasks of one job at a time.
+/// \details The calling thread works on the job too, so a pool of size n has n - 1 workers.
+class ThreadPool {
+public:
+  explicit ThreadPool(std::size_t size) {
+    for (std::size_t i = 1; i < size; ++i) workers_.emplace_back([this]() { workerLoop(); });
+  }
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker.join();
+  }
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::size_t size() const { return workers_.size() + 1; }
+
+  /// Run task(0) ... task(numTasks - 1) and wait for them. Rethrows the first exception.
+  void run(std::size_t numTasks, const std::function<void(std::size_t)>& task) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_     = &task;
+      numTasks_ = numTasks;
+      next_     = 0;
+      pending_  = numTasks;
+      error_    = nullptr;
+      ++job_;
+    }
+    wake_.notify_all();
+    work();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return pending_ == 0; });
+    task_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+  }
+
+private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  bool stop_                                   = false;
+  std::size_t job_                             = 0;
+  const std::function<void(std::size_t)>* task_ = nullptr;
+  std::size_t numTasks_                        = 0;
+  std::size_t next_                            = 0;
+  std::size_t pending_                         = 0;
+  std::exception_ptr error_;
+
+  void work() {
+    for (;;) {
+      std::size_t itask;
+      const std::function<void(std::size_t)>* task;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (next_ >= numTasks_) return;
+        itask = next_++;
+        task  = task_;
+      }
+      std::exception_ptr error;
+      try {
+        (*task)(itask);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (error && !error_) error_ = error;
+      if (--pending_ == 0) done_.notify_all();
+    }
+  }
+
+  void workerLoop() {
+    std::size_t seenJob = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&]() { return stop_ || (job_ != seenJob); });
+        if (stop_) return;
+        seenJob = job_;
+      }
+      work();
+    }
+  }
+};
+
+std::mutex poolMutex;
+std::unique_ptr<ThreadPool> pool;
+
+/// Run task(0) ... task(numTasks - 1) on the chunk thread pool.
+void runParallel(std::size_t numTasks, const std::function<void(std::size_t)>& task) {
+  std::lock_guard<std::mutex> lock(poolMutex);
+  const std::size_t numThreads = chunkThreads();
+  if (!pool || (pool->size() != numThreads)) {
+    pool.reset();
+    pool.reset(new ThreadPool(numThreads));
+  }
+  pool->run(numTasks, task);
+}
+
+/// \brief Layout of a dataset's chunks.
+struct ChunkGrid {
+  std::vector<hsize_t> dims;        ///< dataset dimensions
+  std::vector<hsize_t> chunkDims;   ///< chunk dimensions
+  std::vector<hsize_t> numChunks;   ///< number of chunks along each dimension
+  std::size_t elementSize = 0;      ///< bytes per value
+  std::size_t totalChunks = 0;      ///< total number of chunks
+
+  std::size_t chunkBytes() const {
+    std::size_t n = elementSize;
+    for (const auto d : chunkDims) n *= static_cast<std::size_t>(d);
+    return n;
+  }
+
+  /// Element coordinates of the first value of chunk ichunk (chunks in row-major order).
+  std::vector<hsize_t> chunkOffset(std::size_t ichunk) const {
+    std::vector<hsize_t> offset(dims.size());
+    for (std::size_t d = dims.size(); d-- > 0;) {
+      offset[d] = (ichunk % numChunks[d]) * chunkDims[d];
+      ichunk /= numChunks[d];
+    }
+    return offset;
+  }
+
+  /// \brief Copy the values of one chunk between a buffer and the chunk buffer.
+  /// \details The buffer holds the block of the dataset that starts at element start and
+  ///   has count elements along each dimension. Only the part of the chunk inside both
+  ///   that block and the dataset extent is copied; the rest of the chunk buffer (which
+  ///   always holds a whole chunk) is left untouched.
+  void copy(const std::vector<hsize_t>& offset, const std::vector<hsize_t>& start,
+            const std::vector<hsize_t>& count, char* data, char* chunk, bool toChunk) const {
+    const std::size_t rank = dims.size();
+    std::vector<hsize_t> lo(rank), hi(rank);
+    for (std::size_t d = 0; d < rank; ++d) {
+      lo[d] = std::max(offset[d], start[d]);
+      hi[d] = std::min(offset[d] + chunkDims[d], start[d] + count[d]);
+      if (lo[d] >= hi[d]) return;
+    }
+    // Number of bytes in each run along the last dimension.
+    const std::size_t runBytes = static_cast<std::size_t>(hi[rank - 1] - lo[rank - 1])
+                                 * elementSize;
+    // Element coordinates of the current run (all dimensions but the last).
+    std::vector<hsize_t> pos(lo);
+    for (;;) {
+      std::size_t dataPos  = 0;
+      std::size_t chunkPos = 0;
+      for (std::size_t d = 0; d < rank; ++d) {
+        dataPos  = dataPos * count[d] + (pos[d] - start[d]);
+        chunkPos = chunkPos * chunkDims[d] + (pos[d] - offset[d]);
+      }
+      char* dataPtr  = data + dataPos * elementSize;
+      char* chunkPtr = chunk + chunkPos * elementSize;
+      if (toChunk)
+        std::memcpy(chunkPtr, dataPtr, runBytes);
+      else
+        std::memcpy(dataPtr, chunkPtr, runBytes);
+
+      // Next run: odometer over the leading dimensions.
+      std::size_t d = rank - 1;
+      for (;;) {
+        if (d == 0) return;
+        --d;
+        if (++pos[d] < hi[d]) break;
+        pos[d] = lo[d];
+      }
+    }
+  }
+
+  /// Offsets of the chunks that overlap the block [start, start + count), in row-major order.
+  std::vector<std::vector<hsize_t>> overlappingChunks(const std::vector<hsize_t>& start,
+                                                      const std::vector<hsize_t>& count) const {
+    const std::size_t rank = dims.size();
+    std::vector<std::vector<hsize_t>> offsets;
+    std::vector<hsize_t> first(rank), last(rank);
+    for (std::size_t d = 0; d < rank; ++d) {
+      if (count[d] == 0) return offsets;
+      first[d] = start[d] / chunkDims[d];
+      last[d]  = (start[d] + count[d] - 1) / chunkDims[d];
+    }
+    std::vector<hsize_t> idx(first);
+    for (;;) {
+      std::vector<hsize_t> offset(rank);
+      for (std::size_t d = 0; d < rank; ++d) offset[d] = idx[d] * chunkDims[d];
+      offsets.push_back(std::move(offset));
+      std::size_t d = rank;
+      for (;;) {
+        if (d == 0) return offsets;
+        --d;
+        if (++idx[d] <= last[d]) break;
+        idx[d] = first[d];
+      }
+    }
+  }
+};
+
+/// Set up the chunk grid of a dataset. Returns false if the dataset is not chunked.
+bool getChunkGrid(hid_t dset, hid_t dcpl, hid_t fileType, ChunkGrid& grid) {
+  if (H5Pget_layout(dcpl) != H5D_CHUNKED) return false;
+  HH_hid_t space(H5Dget_space(dset), Handles::Closers::CloseHDF5Dataspace::CloseP);
+  if (space() < 0) throw Exception("H5Dget_space failed.", ioda_Here());
+  const int rank = H5Sget_simple_extent_ndims(space());
+  if (rank <= 0) return false;
+  grid.dims.resize(rank);
+  grid.chunkDims.resize(rank);
+  if (H5Sget_simple_extent_dims(space(), grid.dims.data(), nullptr) < 0)
+    throw Exception("H5Sget_simple_extent_dims failed.", ioda_Here());
+  if (H5Pget_chunk(dcpl, rank, grid.chunkDims.data()) != rank)
+    throw Exception("H5Pget_chunk failed.", ioda_Here());
+  grid.elementSize = H5Tget_size(fileType);
+  grid.numChunks.resize(rank);
+  grid.totalChunks = 1;
+  for (int d = 0; d < rank; ++d) {
+    grid.numChunks[d] = (grid.dims[d] + grid.chunkDims[d] - 1) / grid.chunkDims[d];
+    grid.totalChunks *= static_cast<std::size_t>(grid.numChunks[d]);
+  }
+  return true;
+}
+
+/// Returns false if the values of the type are (or hold) pointers to variable-length data,
+/// whose in-memory form is not what is stored in the chunks.
+bool isFixedSize(hid_t fileType) {
+  return (H5Tdetect_class(fileType, H5T_VLEN) <= 0) && (H5Tis_variable_str(fileType) <= 0);
+}
+
+/// \brief A whole chunk of the values HDF5 puts in the parts of a chunk that nothing was
+///   written to: the dataset's fill value, or zeros if the fill value is never written.
+std::vector<char> fillChunk(hid_t dcpl, hid_t fileType, const ChunkGrid& grid) {
+  std::vector<char> value(grid.elementSize, 0);
+  H5D_fill_time_t fillTime;
+  if (H5Pget_fill_time(dcpl, &fillTime) < 0)
+    throw Exception("H5Pget_fill_time failed.", ioda_Here());
+  if ((fillTime != H5D_FILL_TIME_NEVER) && (H5Pget_fill_value(dcpl, fileType, value.data()) < 0))
+    throw Exception("H5Pget_fill_value failed.", ioda_Here());
+  std::vector<char> chunk;
+  chunk.reserve(grid.chunkBytes());
+  for (std::size_t i = 0; i < grid.chunkBytes(); i += grid.elementSize)
+    chunk.insert(chunk.end(), value.begin(), value.end());
+  return chunk;
+}
+
+/// HDF5's shuffle filter: byte k of every value is stored together.
+void shuffleBytes(const std::vector<char>& in, std::size_t typeSize, std::vector<char>& out) {
+  out.resize(in.size());
+  const std::size_t numValues = in.size() / typeSize;
+  if ((typeSize <= 1) || (numValues <= 1)) {
+    out = in;
+    return;
+  }
+  for (std::size_t b = 0; b < typeSize; ++b)
+    for (std::size_t i = 0; i < numValues; ++i) out[b * numValues + i] = in[i * typeSize + b];
+  // Leftover bytes (never for whole chunks) are stored as they are.
+  const std::size_t shuffled = numValues * typeSize;
+  std::copy(in.begin() + shuffled, in.end(), out.begin() + shuffled);
+}
+
+/// Undo shuffleBytes.
+void unshuffleBytes(const std::vector<char>& in, std::size_t typeSize, std::vector<char>& out) {
+  out.resize(in.size());
+  const std::size_t numValues = in.size() / typeSize;
+  if ((typeSize <= 1) || (numValues <= 1)) {
+    out = in;
+    return;
+  }
+  for (std::size_t b = 0; b < typeSize; ++b)
+    for (std::size_t i = 0; i < numValues; ++i) out[i * typeSize + b] = in[b * numValues + i];
+  const std::size_t shuffled = numValues * typeSize;
+  std::copy(in.begin() + shuffled, in.end(), out.begin() + shuffled);
+}
+
+/// \brief The filters of a dataset that can be run outside of HDF5.
+struct FilterPipeline {
+  std::vector<Filters::filter_info> filters;
+
+  /// Returns false unless the pipeline is shuffle and/or deflate, with a deflate.
+  bool set(HH_hid_t dcpl, std::size_t elementSize) {
+    filters = Filters(dcpl).get();
+    bool hasDeflate = false;
+    for (auto& filter : filters) {
+      if (filter.id == H5Z_FILTER_DEFLATE) {
+        if (filter.cd_values.empty()) return false;
+        hasDeflate = true;
+      } else if (filter.id == H5Z_FILTER_SHUFFLE) {
+        if (filter.cd_values.empty()) filter.cd_values.push_back(elementSize);
+      } else {
+        return false;
+      }
+    }
+    return hasDeflate;
+  }
+
+#if ZLIB_FOUND
+  /// Apply the filters, in order, to a chunk.
+  void encode(std::vector<char>& chunk) const {
+    std::vector<char> out;
+    for (const auto& filter : filters) {
+      if (filter.id == H5Z_FILTER_SHUFFLE) {
+        shuffleBytes(chunk, filter.cd_values[0], out);
+      } else {
+        uLongf outLen = compressBound(static_cast<uLong>(chunk.size()));
+        out.resize(outLen);
+        int rc = compress2(reinterpret_cast<Bytef*>(out.data()), &outLen,
+                           reinterpret_cast<const Bytef*>(chunk.data()),
+                           static_cast<uLong>(chunk.size()),
+                           static_cast<int>(filter.cd_values[0]));
+        if (rc != Z_OK) throw Exception("Deflate failed.", ioda_Here()).add("zlib code", rc);
+        out.resize(outLen);
+      }
+      chunk.swap(out);
+    }
+  }
+
+  /// \brief Undo the filters, in reverse order, on a chunk read with H5Dread_chunk.
+  /// \param filterMask has bit i set if filter i was skipped when the chunk was written.
+  /// \param chunkBytes is the size of the decoded chunk.
+  void decode(std::vector<char>& chunk, uint32_t filterMask, std::size_t chunkBytes) const {
+    std::vector<char> out;
+    for (std::size_t i = filters.size(); i-- > 0;) {
+      if (filterMask & (1u << i)) continue;
+      const auto& filter = filters[i];
+      if (filter.id == H5Z_FILTER_SHUFFLE) {
+        unshuffleBytes(chunk, filter.cd_values[0], out);
+      } else {
+        uLongf outLen = static_cast<uLongf>(chunkBytes);
+        out.resize(chunkBytes);
+        int rc = uncompress(reinterpret_cast<Bytef*>(out.data()), &outLen,
+                            reinterpret_cast<const Bytef*>(chunk.data()),
+                            static_cast<uLong>(chunk.size()));
+        if (rc != Z_OK) throw Exception("Inflate failed.", ioda_Here()).add("zlib code", rc);
+        out.resize(outLen);
+      }
+      chunk.swap(out);
+    }
+    if (chunk.size() != chunkBytes)
+      throw Exception("Decoded chunk has the wrong size.", ioda_Here())
+        .add("expected", chunkBytes)
+        .add("actual", chunk.size());
+  }
+#endif
+};
+}  // namespace
+
+std::size_t chunkThreads() {
+  std::size_t n = ioda::Engines::HH::requestedChunkThreads;
+  if (n == 0) n = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  return n;
+}
+
+bool writeChunksDirect(HH_hid_t dset, hid_t memType, gsl::span<const char> data) {
+#if ZLIB_FOUND && H5_VERSION_GE(1, 10, 3)
+  const std::size_t numThreads = chunkThreads();
+  if (numThreads < 2) return false;
+
+  HH_hid_t dcpl(H5Dget_create_plist(dset()), Handles::Closers::CloseHDF5PropertyList::CloseP);
+  HH_hid_t fileType(H5Dget_type(dset()), Handles::Closers::CloseHDF5Datatype::CloseP);
+  if ((dcpl() < 0) || (fileType() < 0))
+    throw Exception("Cannot get the dataset properties.", ioda_Here());
+  if (H5Tequal(fileType(), memType) <= 0) return false;
+  if (!isFixedSize(fileType())) return false;
+
+  ChunkGrid grid;
+  if (!getChunkGrid(dset(), dcpl(), fileType(), grid)) return false;
+  if (grid.totalChunks < 2) return false;
+  std::size_t numValues = 1;
+  for (const auto d : grid.dims) numValues *= static_cast<std::size_t>(d);
+  if (static_cast<std::size_t>(data.size()) != numValues * grid.elementSize) return false;
+
+  FilterPipeline pipeline;
+  if (!pipeline.set(dcpl, grid.elementSize)) return false;
+
+  // Partial chunks at the edges of the dataset are padded as H5Dwrite would pad them, so
+  // that the stored chunks are the same.
+  const std::vector<char> padding = fillChunk(dcpl(), fileType(), grid);
+
+  // Chunks are encoded in batches so that only a few encoded chunks are held at a time.
+  // The library is not thread safe, so the chunks are written from this thread.
+  const std::vector<hsize_t> start(grid.dims.size(), 0);
+  char* values                = const_cast<char*>(data.data());  // only read from
+  const std::size_t batchSize = 4 * numThreads;
+  std::vector<std::vector<char>> encoded(std::min(batchSize, grid.totalChunks));
+  for (std::size_t first = 0; first < grid.totalChunks; first += batchSize) {
+    const std::size_t count = std::min(batchSize, grid.totalChunks - first);
+    runParallel(count, [&](std::size_t i) {
+      std::vector<char>& chunk = encoded[i];
+      chunk.assign(padding.begin(), padding.end());
+      grid.copy(grid.chunkOffset(first + i), start, grid.dims, values, chunk.data(), true);
+      pipeline.encode(chunk);
+    });
+    for (std::size_t i = 0; i < count; ++i) {
+      const std::vector<hsize_t> offset = grid.chunkOffset(first + i);
+      if (H5Dwrite_chunk(dset(), H5P_DEFAULT, 0, offset.data(), encoded[i].size(),
+                         encoded[i].data()) < 0)
+        throw Exception("H5Dwrite_chunk failed.", ioda_Here());
+    }
+  }
+  ioda::Engines::HH::directChunksWritten += grid.totalChunks;
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool readChunksDirect(HH_hid_t dset, hid_t memType, HH_hid_t fileSpace, gsl::span<char> data) {
+#if ZLIB_FOUND && H5_VERSION_GE(1, 10, 5)
+  const std::size_t numThreads = chunkThreads();
+  if (numThreads < 2) return false;
+
+  HH_hid_t dcpl(H5Dget_create_plist(dset()), Handles::Closers::CloseHDF5PropertyList::CloseP);
+  HH_hid_t fileType(H5Dget_type(dset()), Handles::Closers::CloseHDF5Datatype::CloseP);
+  if ((dcpl() < 0) || (fileType() < 0))
+    throw Exception("Cannot get the dataset properties.", ioda_Here());
+  if (H5Tequal(fileType(), memType) <= 0) return false;
+  if (!isFixedSize(fileType())) return false;
+
+  ChunkGrid grid;
+  if (!getChunkGrid(dset(), dcpl(), fileType(), grid)) return false;
+
+  // The block of the dataset being read: everything, or a hyperslab selection that fills
+  // its bounding box (however many blocks it was built from).
+  const std::size_t rank = grid.dims.size();
+  std::vector<hsize_t> start(rank, 0);
+  std::vector<hsize_t> count(grid.dims);
+  if ((fileSpace() != H5S_ALL) && (H5Sget_select_type(fileSpace()) != H5S_SEL_ALL)) {
+    if (H5Sget_select_type(fileSpace()) != H5S_SEL_HYPERSLABS) return false;
+    std::vector<hsize_t> end(rank);
+    if (H5Sget_select_bounds(fileSpace(), start.data(), end.data()) < 0)
+      throw Exception("H5Sget_select_bounds failed.", ioda_Here());
+    for (std::size_t d = 0; d < rank; ++d) count[d] = end[d] - start[d] + 1;
+  }
+  std::size_t numValues = 1;
+  for (const auto c : count) numValues *= static_cast<std::size_t>(c);
+  if ((fileSpace() != H5S_ALL)
+      && (static_cast<std::size_t>(H5Sget_select_npoints(fileSpace())) != numValues))
+    return false;
+  if (static_cast<std::size_t>(data.size()) != numValues * grid.elementSize) return false;
+
+  const std::vector<std::vector<hsize_t>> offsets = grid.overlappingChunks(start, count);
+  if (offsets.size() < 2) return false;
+
+  FilterPipeline pipeline;
+  if (!pipeline.set(dcpl, grid.elementSize)) return false;
+
+  // Nothing written yet: leave the fill values to H5Dread.
+  H5D_space_status_t spaceStatus;
+  if (H5Dget_space_status(dset(), &spaceStatus) < 0)
+    throw Exception("H5Dget_space_status failed.", ioda_Here());
+  if (spaceStatus == H5D_SPACE_STATUS_NOT_ALLOCATED) return false;
+
+  // Chunks that were never written hold the fill value.
+  std::vector<char> fill;
+
+  // As for writes, the library calls stay on this thread; only the decoding and the
+  // scattering of the values into place run on the pool.
+  const std::size_t batchSize = 4 * numThreads;
+  std::vector<std::vector<char>> raw(std::min(batchSize, offsets.size()));
+  std::vector<uint32_t> filterMasks(raw.size());
+  std::vector<char> isFill(raw.size());
+  for (std::size_t first = 0; first < offsets.size(); first += batchSize) {
+    const std::size_t numInBatch = std::min(batchSize, offsets.size() - first);
+    for (std::size_t i = 0; i < numInBatch; ++i) {
+      const hsize_t* offset = offsets[first + i].data();
+      unsigned storedMask   = 0;
+      haddr_t address       = HADDR_UNDEF;
+      hsize_t storedBytes   = 0;
+      if (H5Dget_chunk_info_by_coord(dset(), offset, &storedMask, &address, &storedBytes) < 0)
+        throw Exception("H5Dget_chunk_info_by_coord failed.", ioda_Here());
+      isFill[i] = (address == HADDR_UNDEF) || (storedBytes == 0);
+      if (isFill[i]) continue;
+      raw[i].resize(static_cast<std::size_t>(storedBytes));
+      filterMasks[i] = 0;
+      if (H5Dread_chunk(dset(), H5P_DEFAULT, offset, &filterMasks[i], raw[i].data()) < 0)
+        throw Exception("H5Dread_chunk failed.", ioda_Here());
+    }
+    const auto batchEnd = isFill.begin() + numInBatch;
+    if (fill.empty() && (std::find(isFill.begin(), batchEnd, 1) != batchEnd))
+      fill = fillChunk(dcpl(), fileType(), grid);
+    runParallel(numInBatch, [&](std::size_t i) {
+      char* chunk = fill.data();  // only read from
+      if (!isFill[i]) {
+        pipeline.decode(raw[i], filterMasks[i], grid.chunkBytes());
+        chunk = raw[i].data();
+      }
+      grid.copy(offsets[first + i], start, count, data.data(), chunk, false);
+    });
+  }
+  ioda::Engines::HH::directChunksRead += offsets.size();
+  return true;
+#else
+  return false;
+#endif
+}
+
+}  // namespace HH
+}  // namespace Engines
+}  // namespace detail
+}  // namespace ioda
+
+/// @}
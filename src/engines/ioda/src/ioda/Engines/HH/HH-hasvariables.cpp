@@ -29,6 +29,7 @@
 #include "./HH/HH-variables.h"
 #include "./HH/Handles.h"
 #include "ioda/Exception.h"
+#include "ioda/Misc/BitRounding.h"
 #include "ioda/Misc/DimensionScales.h"
 #include "ioda/Misc/Dimensions.h"
 #include "ioda/Misc/StringFuncs.h"
@@ -112,6 +113,9 @@ Variable HH_HasVariables::open(const std::string& name) const {
   auto b = std::make_shared<HH_Variable>(
     HH_hid_t(dsetid, Handles::Closers::CloseHDF5Dataset::CloseP), shared_from_this());
   Variable var{b};
+  // Read once here rather than on each write.
+  if (var.atts.exists(bitRoundingAttrName))
+    b->setKeepMantissaBits(var.atts.read<int>(bitRoundingAttrName));
   return var;
 }
 
@@ -190,6 +194,12 @@ Variable HH_HasVariables::create(const std::string& name, const Type& in_memory_
         sizeof(FillValueData_t::FillValueUnion_t)),in_memory_dataType);
     }
 
+    // Record the mantissa bit rounding applied to floating point data by HH_Variable::write.
+    if ((params.keepMantissaBits_ >= 0) && (H5Tget_class(typeBackend->handle()) == H5T_FLOAT)) {
+      var.atts.add<int>(bitRoundingAttrName, params.keepMantissaBits_);
+      b->setKeepMantissaBits(params.keepMantissaBits_);
+    }
+
     return var;
   }
   catch (std::bad_cast&) {
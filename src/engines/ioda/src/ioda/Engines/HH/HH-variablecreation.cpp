@@ -24,6 +24,7 @@
 #include "./HH/HH-hasvariables.h"
 #include "./HH/HH-types.h"
 #include "./HH/Handles.h"
+#include "ioda/Exception.h"
 #include "ioda/Misc/DimensionScales.h"
 
 namespace ioda {
@@ -59,8 +60,6 @@ VariableCreation::VariableCreation(const VariableCreationParameters& p, const Ve
     // taking hints from the dimensions that the variable will be attached to.
     // Those hints are determined using a function.
 
-    /// \todo Revise chunking calculation.
-    // TODO(ryan): Revise and combine with the dimension scale hint.
     // Bit of an awkward call. If chunks are manually set, it uses those. Otherwise,
     // it uses the initial variable size as a hint. Problematic because we get to override it
     // if zero.
@@ -78,6 +77,10 @@ VariableCreation::VariableCreation(const VariableCreationParameters& p, const Ve
     //
     //   If we still have the chunksize set to zero, use an arbitrary default size
     //   for now (100).
+    //
+    //   Finally, shrink chunks that hold more than p.chunkTargetBytes. Hints taken from
+    //   the dimensions (a whole frame of locations, or the whole variable) would otherwise
+    //   give chunks of hundreds of megabytes.
 
     auto chunksizes = p.getChunks(dims);
     std::vector<hsize_t> hcs(chunksizes.size());  // chunksizes converted to hsize_t.
@@ -93,6 +96,12 @@ VariableCreation::VariableCreation(const VariableCreationParameters& p, const Ve
         hcs[i] = 100;
       }
     }
+    if (p.chunkTargetBytes > 0) {
+      std::vector<Dimensions_t> shape(hcs.begin(), hcs.end());
+      shape = chunking::sizeTargetedChunks(shape, H5Tget_size(data_type->handle()),
+                                           p.chunkTargetBytes);
+      for (size_t i = 0; i < hcs.size(); ++i) hcs[i] = gsl::narrow<hsize_t>(shape[i]);
+    }
     final_chunks_ = hcs;
 
     if (H5Pset_chunk(dcp_(), static_cast<int>(hcs.size()), hcs.data()) < 0) throw;
@@ -105,10 +114,11 @@ VariableCreation::VariableCreation(const VariableCreationParameters& p, const Ve
   // depends on user needs and a redesign of how the user specifies these options when
   // creating a variable. The current method is already rather complex.
   {
-    if ((p.gzip_ || p.szip_) && !p.chunk)
-      throw;  // Compression filters are only allowed when chunking is used.
+    if ((p.gzip_ || p.szip_ || p.shuffle_) && !p.chunk)
+      throw Exception("Compression filters need chunking", ioda_Here());
 
     Filters filt(dcp_.get());
+    if (p.shuffle_) filt.setShuffle();
     if (p.gzip_) filt.setGZIP(p.gzip_level_);
     if (p.szip_) filt.setSZIP(p.szip_options_, p.szip_PixelsPerBlock_);
   }
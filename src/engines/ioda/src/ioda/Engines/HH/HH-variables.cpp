@@ -23,12 +23,14 @@
 
 #include "./HH/HH-Filters.h"
 #include "./HH/HH-attributes.h"
+#include "./HH/HH-directchunks.h"
 #include "./HH/HH-hasattributes.h"
 #include "./HH/HH-hasvariables.h"
 #include "./HH/HH-types.h"
 #include "./HH/HH-util.h"
 #include "./HH/Handles.h"
 #include "ioda/Exception.h"
+#include "ioda/Misc/BitRounding.h"
 #include "ioda/Misc/DimensionScales.h"
 #include "ioda/Misc/Dimensions.h"
 #include "ioda/Misc/StringFuncs.h"
@@ -589,6 +591,35 @@ HH_hid_t HH_Variable::getSpaceWithSelection(const Selection& sel) const {
   return spc;
 }
 
+namespace {
+/// Round a buffer of floating point values to keepBits mantissa bits, leaving values
+/// equal to the variable's fill value alone.
+template <class T>
+void bitRoundBuffer(std::vector<char>& buf, int keepBits, HH_hid_t create_plist,
+                    hid_t memType) {
+  gsl::span<T> vals(reinterpret_cast<T*>(buf.data()), buf.size() / sizeof(T));
+  T fillValue{};
+  bool hasFillValue = false;
+  H5D_fill_value_t fvStatus;
+  if ((H5Pfill_value_defined(create_plist(), &fvStatus) >= 0)
+      && (fvStatus == H5D_FILL_VALUE_USER_DEFINED)) {
+    hasFillValue = (H5Pget_fill_value(create_plist(), memType, &fillValue) >= 0);
+  }
+  bitRoundMantissa(vals, keepBits, hasFillValue ? &fillValue : nullptr);
+}
+
+/// Does the dataspace select the whole of its extent?
+bool isAllSelected(HH_hid_t space) {
+  return (space() == H5S_ALL) || (H5Sget_select_type(space()) == H5S_SEL_ALL);
+}
+
+/// True if every point of the dataspace is selected, whatever kind of selection it is.
+bool isWholeExtentSelected(HH_hid_t space) {
+  return isAllSelected(space)
+         || (H5Sget_select_npoints(space()) == H5Sget_simple_extent_npoints(space()));
+}
+}  // namespace
+
 Variable HH_Variable::write(gsl::span<const char> data, const Type& in_memory_dataType,
                       const Selection& mem_selection, const Selection& file_selection) {
   // last arg set to false means we are not using parallel IO
@@ -665,6 +696,32 @@ Variable HH_Variable::writeImpl(gsl::span<const char> data, const Type& in_memor
     }
 
   } else {
+    // Variables created with VariableCreationParameters::keepMantissaBits have their
+    // floating point data rounded on the way to the file. The number of bits kept is
+    // recorded in an attribute, which is read when the variable is opened.
+    std::vector<char> rounded;
+    if ((memTypeClass == H5T_FLOAT) && (varTypeClass == H5T_FLOAT)
+        && (keepMantissaBits_ >= 0)) {
+      const int keepBits = keepMantissaBits_;
+      const size_t memTypeSize = H5Tget_size(memTypeBackend->handle());
+      if ((memTypeSize == sizeof(float)) || (memTypeSize == sizeof(double))) {
+        rounded.assign(data.begin(), data.end());
+        HH_hid_t create_plist(H5Dget_create_plist(var_()),
+                              Handles::Closers::CloseHDF5PropertyList::CloseP);
+        if (memTypeSize == sizeof(float))
+          bitRoundBuffer<float>(rounded, keepBits, create_plist, memTypeBackend->handle());
+        else
+          bitRoundBuffer<double>(rounded, keepBits, create_plist, memTypeBackend->handle());
+        data = gsl::make_span<const char>(rounded.data(), rounded.size());
+      }
+    }
+
+    // Serial whole-variable writes of deflate compressed variables compress their
+    // chunks on several threads.
+    if (!isParallelIo && isAllSelected(memSpace) && isAllSelected(fileSpace)
+        && writeChunksDirect(var_, memTypeBackend->handle(), data))
+      return Variable{shared_from_this()};
+
     // Pass-through case
     auto ret = H5Dwrite(var_(),                   // dataset id
                         memTypeBackend->handle(), // mem_type_id
@@ -754,6 +811,14 @@ Variable HH_Variable::read(gsl::span<char> data, const Type& in_memory_dataType,
       std::copy(out_buf.begin(), out_buf.end(), data.begin());
     }
   } else {
+    // Whole-variable and contiguous hyperslab reads of deflate compressed variables decompress
+    // their chunks on several threads. The values must fill the memory space in order. With
+    // H5S_ALL as the memory space, the buffer is laid out like the whole variable, so that
+    // only qualifies if the whole variable is read.
+    if (isWholeExtentSelected(memSpace) && ((memSpace() != H5S_ALL) || isAllSelected(fileSpace))
+        && readChunksDirect(var_, memTypeBackend->handle(), fileSpace, data))
+      return Variable{std::make_shared<HH_Variable>(*this)};
+
     // Pass-through case
     auto ret = H5Dread( var_(),                   // dataset id
                         memTypeBackend->handle(), // mem_type_id
@@ -1075,6 +1140,9 @@ VariableCreationParameters HH_Variable::getCreationParameters(bool doAtts, bool
   if (gz.first) res.compressWithGZIP(gz.second);
   auto sz = getSZIPCompression(create_plist);
   if (std::get<0>(sz)) res.compressWithSZIP(std::get<1>(sz), std::get<2>(sz));
+  if (Filters(create_plist).has(H5Z_FILTER_SHUFFLE)) res.setShuffle();
+  // Get mantissa bit rounding
+  if (atts.exists(bitRoundingAttrName)) res.keepMantissaBits(atts.read<int>(bitRoundingAttrName));
   // Get fill value
   res.fillValue_ = getFillValue(create_plist);
   // Attributes (optional)
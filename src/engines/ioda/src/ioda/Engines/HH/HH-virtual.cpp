@@ -0,0 +1,393 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_cxx_engines_pub_HH
+ *
+ * @{
+ * \file HH-virtual.cpp
+ * \brief Files that present a set of ioda files as one, using HDF5 virtual datasets.
+ */
+
+#include <hdf5.h>
+#include <hdf5_hl.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "./HH/HH-groups.h"
+#include "./HH/Handles.h"
+#include "ioda/Engines/HH.h"
+#include "ioda/Exception.h"
+#include "ioda/Group.h"
+
+namespace ioda {
+namespace Engines {
+namespace HH {
+namespace {
+using detail::Engines::HH::HH_hid_t;
+namespace Closers = detail::Engines::HH::Handles::Closers;
+
+/// Attributes that belong to the dimension scales API. They hold object references,
+/// which are only good inside their own file, so they are rebuilt rather than copied.
+const std::set<std::string> dimensionScaleAttributes{"CLASS", "NAME", "DIMENSION_LIST",
+                                                     "REFERENCE_LIST"};
+
+struct VisitData {
+  std::vector<std::string> groups;
+  std::vector<std::string> datasets;
+};
+
+#if H5_VERSION_GE(1, 12, 0)
+herr_t collectObjects(hid_t g_id, const char* name, const H5L_info2_t* info, void* op_data)
+#else
+herr_t collectObjects(hid_t g_id, const char* name, const H5L_info_t* info, void* op_data)
+#endif
+{
+  VisitData* data = static_cast<VisitData*>(op_data);
+  if (info->type != H5L_TYPE_HARD) return 0;
+#if H5_VERSION_GE(1, 12, 0)
+  H5O_info1_t oinfo;
+  if (H5Oget_info_by_name1(g_id, name, &oinfo, H5P_DEFAULT) < 0) return -1;
+#else
+  H5O_info_t oinfo;
+  if (H5Oget_info_by_name(g_id, name, &oinfo, H5P_DEFAULT) < 0) return -1;
+#endif
+  if (oinfo.type == H5O_TYPE_GROUP)
+    data->groups.emplace_back(std::string("/") + name);
+  else if (oinfo.type == H5O_TYPE_DATASET)
+    data->datasets.emplace_back(std::string("/") + name);
+  return 0;
+}
+
+herr_t copyOneAttribute(hid_t loc_id, const char* name, const H5A_info_t*, void* op_data) {
+  const hid_t dest = *static_cast<hid_t*>(op_data);
+  if (dimensionScaleAttributes.count(name)) return 0;
+
+  HH_hid_t att(H5Aopen(loc_id, name, H5P_DEFAULT), Closers::CloseHDF5Attribute::CloseP);
+  if (att() < 0) return -1;
+  HH_hid_t type(H5Aget_type(att()), Closers::CloseHDF5Datatype::CloseP);
+  HH_hid_t space(H5Aget_space(att()), Closers::CloseHDF5Dataspace::CloseP);
+  if ((type() < 0) || (space() < 0)) return -1;
+  const hssize_t numPoints = H5Sget_simple_extent_npoints(space());
+  if (numPoints < 0) return -1;
+  std::vector<char> buf(std::max<std::size_t>(1, numPoints * H5Tget_size(type())));
+  if (H5Aread(att(), type(), buf.data()) < 0) return -1;
+
+  HH_hid_t newAtt(H5Acreate2(dest, name, type(), space(), H5P_DEFAULT, H5P_DEFAULT),
+                  Closers::CloseHDF5Attribute::CloseP);
+  herr_t res = ((newAtt() < 0) || (H5Awrite(newAtt(), type(), buf.data()) < 0)) ? -1 : 0;
+
+  if ((H5Tis_variable_str(type()) > 0) || (H5Tdetect_class(type(), H5T_VLEN) > 0)) {
+#if H5_VERSION_GE(1, 12, 0)
+    H5Treclaim(type(), space(), H5P_DEFAULT, buf.data());
+#else
+    H5Dvlen_reclaim(type(), space(), H5P_DEFAULT, buf.data());
+#endif
+  }
+  return res;
+}
+
+void copyAttributes(hid_t src, hid_t dest, const std::string& path) {
+  hid_t destId = dest;
+  if (H5Aiterate2(src, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr, copyOneAttribute, &destId) < 0)
+    throw Exception("Cannot copy attributes.", ioda_Here()).add("object", path);
+}
+
+herr_t collectScaleName(hid_t, unsigned, hid_t dsid, void* op_data) {
+  std::vector<std::string>* names = static_cast<std::vector<std::string>*>(op_data);
+  const ssize_t len = H5Iget_name(dsid, nullptr, 0);
+  if (len <= 0) return -1;
+  std::vector<char> name(len + 1);
+  if (H5Iget_name(dsid, name.data(), name.size()) < 0) return -1;
+  names->emplace_back(name.data());
+  return 0;
+}
+
+/// Paths of the dimension scales attached to each dimension of a dataset.
+std::vector<std::vector<std::string>> attachedScales(hid_t dset, int rank) {
+  std::vector<std::vector<std::string>> res(rank);
+  for (int dim = 0; dim < rank; ++dim) {
+    if (H5DSget_num_scales(dset, dim) <= 0) continue;
+    if (H5DSiterate_scales(dset, dim, nullptr, collectScaleName, &res[dim]) < 0)
+      throw Exception("H5DSiterate_scales failed.", ioda_Here()).add("dimension", dim);
+  }
+  return res;
+}
+
+std::vector<hsize_t> currentDims(hid_t dset) {
+  HH_hid_t space(H5Dget_space(dset), Closers::CloseHDF5Dataspace::CloseP);
+  if (space() < 0) throw Exception("H5Dget_space failed.", ioda_Here());
+  const int rank = H5Sget_simple_extent_ndims(space());
+  if (rank < 0) throw Exception("H5Sget_simple_extent_ndims failed.", ioda_Here());
+  std::vector<hsize_t> dims(rank);
+  if (H5Sget_simple_extent_dims(space(), dims.data(), nullptr) < 0)
+    throw Exception("H5Sget_simple_extent_dims failed.", ioda_Here());
+  return dims;
+}
+
+bool isVariableLength(hid_t type) {
+  return (H5Tis_variable_str(type) > 0) || (H5Tdetect_class(type, H5T_VLEN) > 0);
+}
+
+/// Name under which a source file is recorded in the virtual file. Sources in the
+/// directory of the virtual file are recorded by their bare name, which HDF5 looks up
+/// relative to that directory, so that the set of files can be moved as a whole.
+std::string sourceFileName(const std::string& fileName, const std::string& sourceName) {
+  const auto dirOf = [](const std::string& name) {
+    const std::size_t slash = name.find_last_of('/');
+    return (slash == std::string::npos) ? std::string() : name.substr(0, slash + 1);
+  };
+  const std::string dir = dirOf(sourceName);
+  return (dir == dirOf(fileName)) ? sourceName.substr(dir.size()) : sourceName;
+}
+
+/// Create a virtual dataset that stacks the dataset at path in each source along its
+/// first dimension. Without locations, the dataset is left empty along that dimension.
+void createStackedDataset(hid_t file, const std::string& path, const std::string& fileName,
+                          const std::vector<std::string>& sourceNames,
+                          const std::vector<HH_hid_t>& sources, bool withLocations) {
+  HH_hid_t firstDset(H5Dopen2(sources[0](), path.c_str(), H5P_DEFAULT),
+                     Closers::CloseHDF5Dataset::CloseP);
+  HH_hid_t type(H5Dget_type(firstDset()), Closers::CloseHDF5Datatype::CloseP);
+  const std::vector<hsize_t> firstDims = currentDims(firstDset());
+
+  // Check that the dataset has the same type and trailing dimensions in every source.
+  std::vector<std::vector<hsize_t>> sourceDims;
+  hsize_t total = 0;
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    if (H5Lexists(sources[i](), path.c_str(), H5P_DEFAULT) <= 0)
+      throw Exception("A variable is missing from one of the files.", ioda_Here())
+        .add("variable", path)
+        .add("file", sourceNames[i]);
+    HH_hid_t dset(H5Dopen2(sources[i](), path.c_str(), H5P_DEFAULT),
+                  Closers::CloseHDF5Dataset::CloseP);
+    HH_hid_t dsetType(H5Dget_type(dset()), Closers::CloseHDF5Datatype::CloseP);
+    std::vector<hsize_t> dims = currentDims(dset());
+    if ((H5Tequal(type(), dsetType()) <= 0) || (dims.size() != firstDims.size())
+        || !std::equal(dims.begin() + 1, dims.end(), firstDims.begin() + 1))
+      throw Exception("A variable differs in type or shape between the files.", ioda_Here())
+        .add("variable", path)
+        .add("file", sourceNames[i]);
+    if (!withLocations) dims[0] = 0;
+    total += dims[0];
+    sourceDims.push_back(std::move(dims));
+  }
+
+  std::vector<hsize_t> dims = firstDims;
+  dims[0] = total;
+  HH_hid_t space(H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr),
+                 Closers::CloseHDF5Dataspace::CloseP);
+  HH_hid_t dcpl(H5Pcreate(H5P_DATASET_CREATE), Closers::CloseHDF5PropertyList::CloseP);
+  if ((space() < 0) || (dcpl() < 0))
+    throw Exception("Cannot set up a virtual dataset.", ioda_Here()).add("variable", path);
+
+  // Keep the fill value, so that readers see the same missing values.
+  HH_hid_t firstDcpl(H5Dget_create_plist(firstDset()), Closers::CloseHDF5PropertyList::CloseP);
+  H5D_fill_value_t fillStatus;
+  if ((H5Pfill_value_defined(firstDcpl(), &fillStatus) >= 0)
+      && (fillStatus == H5D_FILL_VALUE_USER_DEFINED) && !isVariableLength(type())) {
+    std::vector<char> fill(H5Tget_size(type()));
+    if ((H5Pget_fill_value(firstDcpl(), type(), fill.data()) < 0)
+        || (H5Pset_fill_value(dcpl(), type(), fill.data()) < 0))
+      throw Exception("Cannot copy the fill value.", ioda_Here()).add("variable", path);
+  }
+
+  std::vector<hsize_t> start(dims.size(), 0);
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    if (sourceDims[i][0] == 0) continue;
+    HH_hid_t sourceSpace(
+      H5Screate_simple(static_cast<int>(sourceDims[i].size()), sourceDims[i].data(), nullptr),
+      Closers::CloseHDF5Dataspace::CloseP);
+    if ((H5Sselect_hyperslab(space(), H5S_SELECT_SET, start.data(), nullptr,
+                             sourceDims[i].data(), nullptr) < 0)
+        || (H5Pset_virtual(dcpl(), space(), sourceFileName(fileName, sourceNames[i]).c_str(),
+                           path.c_str(), sourceSpace()) < 0))
+      throw Exception("H5Pset_virtual failed.", ioda_Here())
+        .add("variable", path)
+        .add("file", sourceNames[i]);
+    start[0] += sourceDims[i][0];
+  }
+  H5Sselect_all(space());
+
+  HH_hid_t dset(H5Dcreate2(file, path.c_str(), type(), space(), H5P_DEFAULT, dcpl(), H5P_DEFAULT),
+                Closers::CloseHDF5Dataset::CloseP);
+  if (dset() < 0)
+    throw Exception("Cannot create a virtual dataset.", ioda_Here()).add("variable", path);
+}
+
+/// Copy a dataset that is not split between the files from the first one.
+void copyDataset(hid_t file, const std::string& path, hid_t source) {
+  HH_hid_t srcDset(H5Dopen2(source, path.c_str(), H5P_DEFAULT), Closers::CloseHDF5Dataset::CloseP);
+  HH_hid_t type(H5Dget_type(srcDset()), Closers::CloseHDF5Datatype::CloseP);
+  HH_hid_t space(H5Dget_space(srcDset()), Closers::CloseHDF5Dataspace::CloseP);
+  HH_hid_t dcpl(H5Dget_create_plist(srcDset()), Closers::CloseHDF5PropertyList::CloseP);
+  HH_hid_t dset(H5Dcreate2(file, path.c_str(), type(), space(), H5P_DEFAULT, dcpl(), H5P_DEFAULT),
+                Closers::CloseHDF5Dataset::CloseP);
+  if (dset() < 0) throw Exception("Cannot create a dataset.", ioda_Here()).add("variable", path);
+
+  const hssize_t numPoints = H5Sget_simple_extent_npoints(space());
+  if (numPoints <= 0) return;
+  std::vector<char> buf(numPoints * H5Tget_size(type()));
+  if ((H5Dread(srcDset(), type(), H5S_ALL, H5S_ALL, H5P_DEFAULT, buf.data()) < 0)
+      || (H5Dwrite(dset(), type(), H5S_ALL, H5S_ALL, H5P_DEFAULT, buf.data()) < 0))
+    throw Exception("Cannot copy a dataset.", ioda_Here()).add("variable", path);
+  if (isVariableLength(type())) {
+#if H5_VERSION_GE(1, 12, 0)
+    H5Treclaim(type(), space(), H5P_DEFAULT, buf.data());
+#else
+    H5Dvlen_reclaim(type(), space(), H5P_DEFAULT, buf.data());
+#endif
+  }
+}
+
+bool isExcluded(const std::string& path, const std::vector<std::string>& excludeGroups) {
+  for (const auto& group : excludeGroups) {
+    const std::string prefix = "/" + group;
+    if ((path.compare(0, prefix.size(), prefix) == 0)
+        && ((path.size() == prefix.size()) || (path[prefix.size()] == '/')))
+      return true;
+  }
+  return false;
+}
+
+/// Create a file, with the given file access properties, that combines the sources.
+HH_hid_t createCombinedFile(const std::string& fileName, hid_t fapl,
+                            const std::vector<std::string>& sourceNames,
+                            const std::vector<std::string>& excludeGroups,
+                            const std::string& locationDimName, bool withLocations = true) {
+  if (sourceNames.empty()) throw Exception("No files to combine.", ioda_Here());
+
+  std::vector<HH_hid_t> sources;
+  for (const auto& name : sourceNames) {
+    sources.emplace_back(H5Fopen(name.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT),
+                         Closers::CloseHDF5File::CloseP);
+    if (sources.back()() < 0)
+      throw Exception("Cannot open a file to combine.", ioda_Here()).add("file", name);
+  }
+
+  // The first file is the template for the layout of all of them.
+  VisitData objects;
+  if (H5Lvisit(sources[0](), H5_INDEX_NAME, H5_ITER_INC, collectObjects, &objects) < 0)
+    throw Exception("H5Lvisit failed.", ioda_Here()).add("file", sourceNames[0]);
+  const std::string locationScale = "/" + locationDimName;
+  if (std::find(objects.datasets.begin(), objects.datasets.end(), locationScale)
+      == objects.datasets.end())
+    throw Exception("The files have no location dimension.", ioda_Here())
+      .add("dimension", locationDimName);
+
+  HH_hid_t file(H5Fcreate(fileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl),
+                Closers::CloseHDF5File::CloseP);
+  if (file() < 0) throw Exception("Cannot create the file.", ioda_Here()).add("file", fileName);
+  copyAttributes(sources[0](), file(), "/");
+
+  for (const auto& path : objects.groups) {
+    if (isExcluded(path, excludeGroups)) continue;
+    HH_hid_t srcGroup(H5Gopen2(sources[0](), path.c_str(), H5P_DEFAULT),
+                      Closers::CloseHDF5Group::CloseP);
+    HH_hid_t group(H5Gcreate2(file(), path.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT),
+                   Closers::CloseHDF5Group::CloseP);
+    if ((srcGroup() < 0) || (group() < 0))
+      throw Exception("Cannot create a group.", ioda_Here()).add("group", path);
+    copyAttributes(srcGroup(), group(), path);
+  }
+
+  // Datasets along the location dimension are stacked, the rest are copied. The scales
+  // are set up before anything is attached to them.
+  HH_hid_t srcLocationScale(H5Dopen2(sources[0](), locationScale.c_str(), H5P_DEFAULT),
+                            Closers::CloseHDF5Dataset::CloseP);
+  std::vector<std::string> datasets;
+  for (const auto& path : objects.datasets)
+    if (!isExcluded(path, excludeGroups)) datasets.push_back(path);
+  for (const auto& path : datasets) {
+    HH_hid_t srcDset(H5Dopen2(sources[0](), path.c_str(), H5P_DEFAULT),
+                     Closers::CloseHDF5Dataset::CloseP);
+    const bool alongLocations
+      = (path == locationScale)
+        || (!currentDims(srcDset()).empty()
+            && (H5DSis_attached(srcDset(), srcLocationScale(), 0) > 0));
+    if (alongLocations)
+      createStackedDataset(file(), path, fileName, sourceNames, sources, withLocations);
+    else
+      copyDataset(file(), path, sources[0]());
+
+    HH_hid_t dset(H5Dopen2(file(), path.c_str(), H5P_DEFAULT), Closers::CloseHDF5Dataset::CloseP);
+    copyAttributes(srcDset(), dset(), path);
+    if (H5DSis_scale(srcDset()) > 0) {
+      const ssize_t len = H5DSget_scale_name(srcDset(), nullptr, 0);
+      std::vector<char> scaleName(std::max<ssize_t>(len, 0) + 1, '\0');
+      if (len > 0) H5DSget_scale_name(srcDset(), scaleName.data(), scaleName.size());
+      if (H5DSset_scale(dset(), (len > 0) ? scaleName.data() : nullptr) < 0)
+        throw Exception("H5DSset_scale failed.", ioda_Here()).add("variable", path);
+    }
+  }
+
+  for (const auto& path : datasets) {
+    HH_hid_t srcDset(H5Dopen2(sources[0](), path.c_str(), H5P_DEFAULT),
+                     Closers::CloseHDF5Dataset::CloseP);
+    if (H5DSis_scale(srcDset()) > 0) continue;
+    HH_hid_t dset(H5Dopen2(file(), path.c_str(), H5P_DEFAULT), Closers::CloseHDF5Dataset::CloseP);
+    const std::vector<std::vector<std::string>> scales
+      = attachedScales(srcDset(), static_cast<int>(currentDims(srcDset()).size()));
+    for (std::size_t dim = 0; dim < scales.size(); ++dim) {
+      for (const auto& scalePath : scales[dim]) {
+        if (isExcluded(scalePath, excludeGroups)) continue;
+        HH_hid_t scale(H5Dopen2(file(), scalePath.c_str(), H5P_DEFAULT),
+                       Closers::CloseHDF5Dataset::CloseP);
+        if ((scale() < 0)
+            || (H5DSattach_scale(dset(), scale(), static_cast<unsigned>(dim)) < 0))
+          throw Exception("Cannot attach a dimension scale.", ioda_Here())
+            .add("variable", path)
+            .add("scale", scalePath);
+      }
+    }
+  }
+  return file;
+}
+}  // namespace
+
+void createVirtualFile(const std::string& fileName, const std::vector<std::string>& sourceNames,
+                       const std::vector<std::string>& excludeGroups,
+                       const std::string& locationDimName) {
+  createCombinedFile(fileName, H5P_DEFAULT, sourceNames, excludeGroups, locationDimName);
+}
+
+namespace {
+Group openCombinedFile(const std::vector<std::string>& sourceNames,
+                       const std::vector<std::string>& excludeGroups,
+                       const std::string& locationDimName, bool withLocations) {
+  // The combined file only holds metadata, so it is kept in memory and never written out.
+  HH_hid_t fapl(H5Pcreate(H5P_FILE_ACCESS), Closers::CloseHDF5PropertyList::CloseP);
+  if ((fapl() < 0) || (H5Pset_fapl_core(fapl(), 1000000, false) < 0))
+    throw Exception("Cannot set up an in-memory file.", ioda_Here());
+  HH_hid_t file = createCombinedFile(genUniqueName(), fapl(), sourceNames, excludeGroups,
+                                     locationDimName, withLocations);
+  auto backend = std::make_shared<detail::Engines::HH::HH_Group>(
+    file, getCapabilitiesInMemoryEngine(), file);
+  return ::ioda::Group{backend};
+}
+}  // namespace
+
+Group openVirtualFile(const std::vector<std::string>& sourceNames,
+                      const std::vector<std::string>& excludeGroups,
+                      const std::string& locationDimName) {
+  return openCombinedFile(sourceNames, excludeGroups, locationDimName, true);
+}
+
+Group openEmptyVirtualFile(const std::string& templateName,
+                           const std::vector<std::string>& excludeGroups,
+                           const std::string& locationDimName) {
+  return openCombinedFile({templateName}, excludeGroups, locationDimName, false);
+}
+
+}  // namespace HH
+}  // namespace Engines
+}  // namespace ioda
+
+/// @}
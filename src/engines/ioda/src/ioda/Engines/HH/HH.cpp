@@ -253,6 +253,13 @@ Capabilities getCapabilitiesInMemoryEngine() {
   return caps;
 }
 
+bool isThreadSafe() {
+  hbool_t threadSafe = false;
+  if (H5is_library_threadsafe(&threadSafe) < 0)
+    throw Exception("Bad HDF5 return value", ioda_Here());
+  return threadSafe > 0;
+}
+
 std::ostream& operator<<(std::ostream& os, const ioda::Engines::HH::HDF5_Version& ver)
 {
   using namespace ioda::Engines::HH;
@@ -0,0 +1,68 @@
+#pragma once
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_hh
+ *
+ * @{
+ * \file HH-directchunks.h
+ * \brief Multithreaded chunk compression and decompression for the HDF5 engine.
+ */
+
+#include <cstddef>
+
+#include <gsl/gsl-lite.hpp>
+
+#include "./Handles.h"
+#include "ioda/defs.h"
+
+namespace ioda {
+namespace detail {
+namespace Engines {
+namespace HH {
+/// @brief Number of threads used to compress and decompress chunks.
+/// @ingroup ioda_internals_engines_hh
+/// @see ioda::Engines::HH::setChunkThreads
+IODA_HIDDEN std::size_t chunkThreads();
+
+/// @brief Write the whole of a chunked, deflate compressed dataset, compressing its
+///   chunks in parallel.
+/// @ingroup ioda_internals_engines_hh
+/// @details HDF5 runs the filter pipeline on one chunk at a time inside H5Dwrite. Here
+///   the chunks are cut out of the buffer and run through the same filters (shuffle
+///   and deflate, with the dataset's settings) on a pool of threads. The encoded chunks
+///   are then handed to HDF5 with H5Dwrite_chunk, so the file is the same as if H5Dwrite
+///   had done the compression.
+/// @param dset is the dataset.
+/// @param memType is the type of the values in data. It must match the dataset type.
+/// @param data holds every value of the dataset, in row-major order.
+/// @return false if nothing was written because the dataset does not qualify (no
+///   chunking, other filters, type conversion needed, a single chunk, a single
+///   thread, or no zlib). The caller then falls back to H5Dwrite.
+IODA_HIDDEN bool writeChunksDirect(HH_hid_t dset, hid_t memType, gsl::span<const char> data);
+
+/// @brief Read the whole of a chunked, deflate compressed dataset, or a contiguous block
+///   of it, decompressing the chunks in parallel.
+/// @ingroup ioda_internals_engines_hh
+/// @details The reverse of writeChunksDirect. The raw chunks that overlap the selection
+///   are fetched with H5Dread_chunk, run back through the filters on a pool of threads
+///   and scattered into the buffer. Chunks that were never written read as the fill value.
+/// @param dset is the dataset.
+/// @param memType is the type of the values in data. It must match the dataset type.
+/// @param fileSpace is the file selection: H5S_ALL, an "all" selection, or a hyperslab
+///   selection that covers the whole of its bounding box.
+/// @param data receives the selected values, in row-major order.
+/// @return false if nothing was read because the dataset or the selection does not
+///   qualify (see writeChunksDirect; other selections do not qualify either). The caller
+///   then falls back to H5Dread.
+IODA_HIDDEN bool readChunksDirect(HH_hid_t dset, hid_t memType, HH_hid_t fileSpace,
+                                  gsl::span<char> data);
+}  // namespace HH
+}  // namespace Engines
+}  // namespace detail
+}  // namespace ioda
+
+/// @}
@@ -40,6 +40,9 @@ class IODA_HIDDEN HH_Variable : public ioda::detail::Variable_Backend,
                                 public std::enable_shared_from_this<HH_Variable> {
   HH_hid_t var_;
   std::weak_ptr<const HH_HasVariables> container_;
+  /// Number of mantissa bits kept when floating point data are written (negative: all).
+  /// Read from the bitRoundingAttrName attribute once, when the variable is opened.
+  int keepMantissaBits_ = -1;
 
 public:
   HH_Variable();
@@ -49,6 +52,10 @@ public:
   HH_hid_t get() const;
   bool isVariable() const;
 
+  /// @brief Set the number of mantissa bits kept when floating point data are written.
+  /// @details Used when the variable is created or opened; see bitRoundingAttrName.
+  void setKeepMantissaBits(int keepBits) { keepMantissaBits_ = keepBits; }
+
   /// @brief Get HDF5-internal type.
   /// @return Handle to HDF5-internal type.
   HH_hid_t internalType() const;
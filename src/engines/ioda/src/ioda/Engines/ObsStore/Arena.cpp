@@ -0,0 +1,147 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file Arena.cpp
+ * \brief Per-tree allocator for ObsStore variable data buffers
+ */
+
+#include "./Arena.hpp"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include "ioda/Exception.h"
+
+namespace ioda {
+namespace ObsStore {
+namespace {
+/// Size (and alignment) of a transparent huge page on the platforms we run on.
+const std::size_t hugePageSize = 2 * 1024 * 1024;
+
+std::size_t roundUp(std::size_t bytes, std::size_t multiple) {
+  return ((bytes + multiple - 1) / multiple) * multiple;
+}
+}  // namespace
+
+//------------------------------------------------------------------------------
+Arena::Arena(const Engines::ObsStore::ArenaParameters &params) : params_(params) {}
+
+Arena::~Arena() {
+  // Containers release their buffers before the arena goes (they hold a reference to it),
+  // so only the cache is left.
+  for (const auto &block : cache_) unmapBlock(block.second, block.first);
+}
+
+std::size_t Arena::mappedSize(std::size_t bytes) const { return roundUp(bytes, hugePageSize); }
+
+void *Arena::mapBlock(std::size_t mappedBytes) {
+  // Over-allocate by one huge page so that the block can start on a huge page boundary,
+  // then give back the unused head and tail.
+  std::size_t reserveBytes = mappedBytes + hugePageSize;
+  void *addr = mmap(nullptr, reserveBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1, 0);
+  if (addr == MAP_FAILED) {
+    throw Exception("Unable to map memory for the ObsStore arena", ioda_Here())
+      .add("bytes", mappedBytes)
+      .add("reason", std::strerror(errno));
+  }
+  char *start   = static_cast<char *>(addr);
+  char *aligned = reinterpret_cast<char *>(
+    roundUp(reinterpret_cast<std::uintptr_t>(start), hugePageSize));
+  std::size_t head = static_cast<std::size_t>(aligned - start);
+  std::size_t tail = reserveBytes - head - mappedBytes;
+  if (head > 0) munmap(start, head);
+  if (tail > 0) munmap(aligned + mappedBytes, tail);
+
+#ifdef MADV_HUGEPAGE
+  if (params_.hugePages && (madvise(aligned, mappedBytes, MADV_HUGEPAGE) == 0)) {
+    hugePageBlocks_.insert(aligned);
+    stats_.hugePageBytes += mappedBytes;
+  }
+#endif
+
+  stats_.mappedBytes += mappedBytes;
+  stats_.peakMappedBytes = std::max(stats_.peakMappedBytes, stats_.mappedBytes);
+  return aligned;
+}
+
+void Arena::unmapBlock(void *ptr, std::size_t mappedBytes) {
+  munmap(ptr, mappedBytes);
+  stats_.mappedBytes -= mappedBytes;
+  // Only the blocks the kernel accepted the advice for were counted.
+  if (hugePageBlocks_.erase(ptr) > 0) stats_.hugePageBytes -= mappedBytes;
+}
+
+void *Arena::allocate(std::size_t bytes) {
+  if (bytes < params_.minMappedBytes) {
+    void *ptr = ::operator new(bytes);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.liveAllocations;
+    ++stats_.totalAllocations;
+    stats_.bytesInUse += bytes;
+    stats_.heapBytes += bytes;
+    return ptr;
+  }
+
+  std::size_t mappedBytes = mappedSize(bytes);
+  std::lock_guard<std::mutex> lock(mutex_);
+  void *ptr = nullptr;
+  auto icached = cache_.find(mappedBytes);
+  if (icached != cache_.end()) {
+    // Reused pages keep their NUMA placement; the cache only ever holds blocks released
+    // by this tree, which is filled by its owning thread.
+    ptr = icached->second;
+    cache_.erase(icached);
+    stats_.cachedBytes -= mappedBytes;
+    ++stats_.cacheHits;
+  } else {
+    ptr = mapBlock(mappedBytes);
+  }
+  ++stats_.liveAllocations;
+  ++stats_.totalAllocations;
+  stats_.bytesInUse += bytes;
+  return ptr;
+}
+
+void Arena::deallocate(void *ptr, std::size_t bytes) noexcept {
+  if (ptr == nullptr) return;
+  if (bytes < params_.minMappedBytes) {
+    ::operator delete(ptr);
+    std::lock_guard<std::mutex> lock(mutex_);
+    --stats_.liveAllocations;
+    stats_.bytesInUse -= bytes;
+    stats_.heapBytes -= bytes;
+    return;
+  }
+
+  std::size_t mappedBytes = mappedSize(bytes);
+  std::lock_guard<std::mutex> lock(mutex_);
+  --stats_.liveAllocations;
+  stats_.bytesInUse -= bytes;
+  if (stats_.cachedBytes + mappedBytes <= params_.cacheBytes) {
+    cache_.emplace(mappedBytes, ptr);
+    stats_.cachedBytes += mappedBytes;
+  } else {
+    unmapBlock(ptr, mappedBytes);
+  }
+}
+
+Engines::ObsStore::ArenaStatistics Arena::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
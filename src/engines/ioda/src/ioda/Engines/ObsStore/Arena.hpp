@@ -0,0 +1,135 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file Arena.hpp
+ * \brief Per-tree allocator for ObsStore variable data buffers
+ */
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <utility>
+
+#include "./MemoryAccount.hpp"
+#include "ioda/Engines/ObsStore.h"
+
+namespace ioda {
+namespace ObsStore {
+/// \brief allocator for the data buffers of the variables in one ObsStore tree
+/// \ingroup ioda_internals_engines_obsstore
+/// \details Small requests go to the heap. Large requests get their own anonymous
+///          mapping, aligned to (and rounded up to a multiple of) the huge page size and,
+///          if requested, advised for transparent huge pages. A fresh mapping has no
+///          physical pages until it is first written, so its pages are placed on the NUMA
+///          node of the thread that fills the buffer (the thread that owns the ObsSpace)
+///          instead of wherever a recycled heap block happened to live. Released mappings
+///          are kept in a size-keyed cache, up to a limit, for reuse by later requests.
+class Arena {
+private:
+  /// \brief settings
+  Engines::ObsStore::ArenaParameters params_;
+  /// \brief guards the cache and the statistics
+  mutable std::mutex mutex_;
+  /// \brief released mappings available for reuse, by size
+  std::multimap<std::size_t, void *> cache_;
+  /// \brief mappings (live or cached) advised for transparent huge pages
+  std::set<void *> hugePageBlocks_;
+  /// \brief statistics
+  Engines::ObsStore::ArenaStatistics stats_;
+
+  /// \brief create a new aligned mapping
+  void *mapBlock(std::size_t mappedBytes);
+  /// \brief release a mapping
+  void unmapBlock(void *ptr, std::size_t mappedBytes);
+  /// \brief size of the mapping used for a request of the given size
+  std::size_t mappedSize(std::size_t bytes) const;
+
+public:
+  /// \param params settings
+  explicit Arena(const Engines::ObsStore::ArenaParameters &params);
+  ~Arena();
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /// \brief allocate memory (suitably aligned for any fundamental type)
+  /// \param bytes size of the request
+  void *allocate(std::size_t bytes);
+  /// \brief return memory obtained from allocate
+  /// \param ptr address returned by allocate
+  /// \param bytes size given to allocate
+  void deallocate(void *ptr, std::size_t bytes) noexcept;
+
+  /// \brief snapshot of the allocation statistics
+  Engines::ObsStore::ArenaStatistics statistics() const;
+};
+
+/// \brief standard allocator adaptor for Arena
+/// \ingroup ioda_internals_engines_obsstore
+/// \details A default constructed ArenaAllocator (no arena) uses operator new, so that
+///          containers using it behave exactly as with std::allocator. An allocator with a
+///          MemoryCharge charges every allocation to it until it is released.
+template <typename T>
+class ArenaAllocator {
+private:
+  /// \brief arena to allocate from (may be nullptr)
+  std::shared_ptr<Arena> arena_;
+  /// \brief charge for the allocations (may be nullptr)
+  std::shared_ptr<MemoryCharge> charge_;
+
+public:
+  typedef T value_type;
+
+  ArenaAllocator() noexcept {}
+  explicit ArenaAllocator(std::shared_ptr<Arena> arena) noexcept : arena_(std::move(arena)) {}
+  ArenaAllocator(std::shared_ptr<Arena> arena, std::shared_ptr<MemoryCharge> charge) noexcept
+      : arena_(std::move(arena)), charge_(std::move(charge)) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+      : arena_(other.arena()), charge_(other.charge()) {}
+
+  /// \brief the arena used by this allocator
+  const std::shared_ptr<Arena> &arena() const noexcept { return arena_; }
+  /// \brief the charge used by this allocator
+  const std::shared_ptr<MemoryCharge> &charge() const noexcept { return charge_; }
+
+  T *allocate(std::size_t n) {
+    T *ptr = arena_ ? static_cast<T *>(arena_->allocate(n * sizeof(T)))
+                    : static_cast<T *>(::operator new(n * sizeof(T)));
+    if (charge_) charge_->add(MemoryKind::Values, n * sizeof(T));
+    return ptr;
+  }
+
+  void deallocate(T *ptr, std::size_t n) noexcept {
+    if (charge_) charge_->release(MemoryKind::Values, n * sizeof(T));
+    if (arena_) {
+      arena_->deallocate(ptr, n * sizeof(T));
+    } else {
+      ::operator delete(ptr);
+    }
+  }
+
+  // Memory has to go back through the allocator that charged it.
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &other) const noexcept {
+    return (arena_ == other.arena()) && (charge_ == other.charge());
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &other) const noexcept {
+    return !(*this == other);
+  }
+};
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
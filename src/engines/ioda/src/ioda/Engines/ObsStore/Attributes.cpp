@@ -23,8 +23,10 @@ namespace ObsStore {
 //                          Attribute functions
 //*********************************************************************
 Attribute::Attribute(const std::vector<std::size_t>& dimensions,
-                     const std::shared_ptr<Type> dtype)
-                         : dimensions_(dimensions), dtype_(std::move(dtype)), attr_data_() {
+                     const std::shared_ptr<Type> dtype,
+                     const std::shared_ptr<MemoryCharge>& charge)
+                         : dimensions_(dimensions), dtype_(std::move(dtype)), attr_data_(),
+                           charged_(charge, MemoryKind::Attributes) {
   // Get a typed storage object based on dtype
   attr_data_.reset(createVarAttrStore(dtype_));
 
@@ -32,6 +34,7 @@ Attribute::Attribute(const std::vector<std::size_t>& dimensions,
   std::size_t numElements = std::accumulate(dimensions_.begin(), dimensions_.end(), (size_t)1,
                                             std::multiplies<std::size_t>());
   attr_data_->resize(numElements);
+  recharge();
 }
 
 std::vector<std::size_t> Attribute::get_dimensions() const { return dimensions_; }
@@ -56,6 +59,7 @@ std::shared_ptr<Attribute> Attribute::write(gsl::span<const char> data,
   Selection m_select(start, npoints);
   Selection f_select(start, npoints);
   attr_data_->write(data, m_select, f_select);
+  recharge();
   return shared_from_this();
 }
 
@@ -77,13 +81,36 @@ std::shared_ptr<Attribute> Attribute::read(gsl::span<char> data, const Type & dt
   return shared_from_this();
 }
 
+std::shared_ptr<Attribute> Attribute::clone(const std::shared_ptr<MemoryCharge>& charge) const {
+  auto attr = std::make_shared<Attribute>();
+  attr->dimensions_ = dimensions_;
+  attr->dtype_      = dtype_;
+  attr->attr_data_.reset(attr_data_->clone(nullptr));
+  attr->charged_    = ChargedBytes(charge, MemoryKind::Attributes);
+  attr->charged_.set(charged_.bytes());
+  return attr;
+}
+
+void Attribute::recharge() {
+  std::size_t numElements = std::accumulate(dimensions_.begin(), dimensions_.end(), (size_t)1,
+                                            std::multiplies<std::size_t>());
+  const VarAttrStore<std::string>* strings =
+    dynamic_cast<const VarAttrStore<std::string>*>(attr_data_.get());
+  if (strings != nullptr) {
+    charged_.set(numElements * dtype_->getNumElements() * sizeof(std::string) +
+                 strings->heapBytes());
+  } else {
+    charged_.set(numElements * dtype_->getSize());
+  }
+}
+
 //*********************************************************************
 //                        Has_Attributes function
 //*********************************************************************
 std::shared_ptr<Attribute> Has_Attributes::create(const std::string& name,
                                                   const std::shared_ptr<Type> & dtype,
                                                   const std::vector<std::size_t>& dims) {
-  std::shared_ptr<Attribute> att(new Attribute(dims, dtype));
+  std::shared_ptr<Attribute> att(new Attribute(dims, dtype, charge_));
   attributes_.insert(std::pair<std::string, std::shared_ptr<Attribute>>(name, att));
   return att;
 }
@@ -115,6 +142,17 @@ std::vector<std::string> Has_Attributes::list() const {
   }
   return attrList;
 }
+
+std::shared_ptr<Has_Attributes> Has_Attributes::clone(
+  const std::shared_ptr<MemoryCharge>& charge) const {
+  auto atts = std::make_shared<Has_Attributes>();
+  atts->charge_ = charge;
+  for (const auto& iattr : attributes_) {
+    atts->attributes_.insert(std::pair<std::string, std::shared_ptr<Attribute>>(
+      iattr.first, iattr.second->clone(charge)));
+  }
+  return atts;
+}
 }  // namespace ObsStore
 }  // namespace ioda
 
@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "./MemoryAccount.hpp"
 #include "./Selection.hpp"
 #include "./Type.hpp"
 #include "./VarAttrStore.hpp"
@@ -42,9 +43,19 @@ private:
   /// \brief container for attribute data values
   std::unique_ptr<VarAttrStore_Base> attr_data_;
 
+  /// \brief the attribute data values, as charged to their group or variable
+  ChargedBytes charged_;
+
+  /// \brief update the charge after the attribute data values have been written
+  void recharge();
+
 public:
   Attribute() {}
-  Attribute(const std::vector<std::size_t>& dimensions, const std::shared_ptr<Type> dtype);
+  /// \param dimensions shape of the attribute
+  /// \param dtype ObsStore Type of the attribute
+  /// \param charge charge for the attribute data values (nullptr: no accounting)
+  Attribute(const std::vector<std::size_t>& dimensions, const std::shared_ptr<Type> dtype,
+            const std::shared_ptr<MemoryCharge>& charge = nullptr);
   ~Attribute() {}
 
   /// \brief returns dimensions vector
@@ -63,6 +74,10 @@ public:
   /// \param data contiguous block of data to transfer
   /// \param dtype ObsStore Type
   std::shared_ptr<Attribute> read(gsl::span<char> data, const Type & dtype);
+
+  /// \brief create an attribute with the same shape, type and values
+  /// \param charge charge for the values of the new attribute (nullptr: no accounting)
+  std::shared_ptr<Attribute> clone(const std::shared_ptr<MemoryCharge>& charge) const;
 };
 
 /// \ingroup ioda_internals_engines_obsstore
@@ -71,6 +86,9 @@ private:
   /// \brief container of attributes
   std::map<std::string, std::shared_ptr<Attribute>> attributes_;
 
+  /// \brief charge for the values of new attributes (nullptr: no accounting)
+  std::shared_ptr<MemoryCharge> charge_;
+
 public:
   Has_Attributes() {}
   ~Has_Attributes() {}
@@ -102,6 +120,17 @@ public:
 
   /// \brief returns a list of the names of attributes in the container
   std::vector<std::string> list() const;
+
+  /// \brief create a container holding clones of all the attributes in this one
+  /// \param charge charge for the values of the cloned attributes (nullptr: no accounting)
+  std::shared_ptr<Has_Attributes> clone(const std::shared_ptr<MemoryCharge>& charge) const;
+
+  /// \brief set the charge for the values of the attributes created from now on
+  /// \param charge charge of the owning group or variable (nullptr: no accounting)
+  void setCharge(const std::shared_ptr<MemoryCharge>& charge) { charge_ = charge; }
+
+  /// \brief the charge for the values of new attributes
+  const std::shared_ptr<MemoryCharge>& charge() const { return charge_; }
 };
 #if defined(__INTEL_COMPILER)
 #  pragma warning(pop)
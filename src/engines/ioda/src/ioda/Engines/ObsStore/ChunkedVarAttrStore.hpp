@@ -0,0 +1,212 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file ChunkedVarAttrStore.hpp
+ * \brief ObsStore variable data storage in fixed-size blocks of locations
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "gsl/gsl-lite.hpp"
+
+#include "./Arena.hpp"
+#include "./MemoryAccount.hpp"
+#include "./Selection.hpp"
+#include "./VarAttrStore.hpp"
+
+namespace ioda {
+namespace ObsStore {
+/// \brief data storage for fundamental types held in a table of fixed-size blocks
+/// \ingroup ioda_internals_engines_obsstore
+/// \details Each block holds the values of a fixed number of locations (leading dimension
+///          entries). Growing the variable along its leading dimension only allocates the
+///          blocks that are needed for the new locations; existing values are never moved.
+///          Blocks are shared with clones until modified, block by block, so modifying
+///          part of a cloned variable only copies the blocks that are touched.
+///
+///          Variables that fit in one block are read and written through a contiguous
+///          fast path.
+template <typename DataType>
+class ChunkedVarAttrStore : public VarAttrStore_Base {
+private:
+  typedef std::vector<DataType, ArenaAllocator<DataType>> Block;
+
+  /// \brief block table
+  std::vector<std::shared_ptr<Block>> blocks_;
+  /// \brief arena supplying the blocks (nullptr: the heap)
+  std::shared_ptr<Arena> arena_;
+  /// \brief charge for the blocks allocated by this store (nullptr: no accounting)
+  std::shared_ptr<MemoryCharge> charge_;
+  /// \brief number of values in a block
+  std::size_t block_values_;
+  /// \brief total number of values
+  std::size_t num_values_;
+
+  /// \brief number of elements in one data piece (for arrayed types)
+  std::size_t num_elements_;
+
+  /// \brief a block, copied first if it is shared with a clone
+  DataType *modifiableBlock(std::size_t iblock) {
+    std::shared_ptr<Block> &block = blocks_[iblock];
+    if (block.use_count() > 1) {
+      block = std::make_shared<Block>(*block, ArenaAllocator<DataType>(arena_, charge_));
+    } else {
+      // See VarAttrStore::modifiable
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return block->data();
+  }
+
+  /// \brief set values [first, last) to value
+  void fill(std::size_t first, std::size_t last, const DataType &value) {
+    while (first < last) {
+      std::size_t iblock = first / block_values_;
+      std::size_t offset = first % block_values_;
+      std::size_t count  = std::min(last - first, block_values_ - offset);
+      DataType *vals     = modifiableBlock(iblock);
+      std::fill(vals + offset, vals + offset + count, value);
+      first += count;
+    }
+  }
+
+  /// \brief change the number of values; new values are set to value
+  void resizeValues(std::size_t newCount, const DataType &value) {
+    if (newCount == num_values_) return;
+    std::size_t numBlocks = (newCount + block_values_ - 1) / block_values_;
+    if (newCount < num_values_) {
+      blocks_.resize(numBlocks);
+      num_values_ = newCount;
+      return;
+    }
+    std::size_t oldCount = num_values_;
+    blocks_.reserve(numBlocks);
+    while (blocks_.size() < numBlocks) {
+      blocks_.push_back(
+        std::make_shared<Block>(block_values_, value, ArenaAllocator<DataType>(arena_, charge_)));
+    }
+    num_values_ = newCount;
+    // Values past the old end in the old last block may be left over from a shrink.
+    std::size_t oldBlockEnd = std::min(newCount, ((oldCount + block_values_ - 1) / block_values_)
+                                                   * block_values_);
+    fill(oldCount, oldBlockEnd, value);
+  }
+
+public:
+  /// \param numElements number of elements in one data piece
+  /// \param blockSize number of data pieces in a block
+  /// \param arena arena supplying the blocks (nullptr: the heap)
+  ChunkedVarAttrStore(const std::size_t numElements, const std::size_t blockSize,
+                      const std::shared_ptr<Arena> &arena,
+                      const std::shared_ptr<MemoryCharge> &charge = nullptr)
+      : arena_(arena), charge_(charge),
+        block_values_(std::max<std::size_t>(blockSize, 1) * numElements),
+        num_values_(0), num_elements_(numElements) {}
+  ~ChunkedVarAttrStore() {}
+
+  /// \brief resizes memory allocated for data storage
+  /// \param newSize new size for allocated memory in number of vector elements
+  void resize(std::size_t newSize) override { resizeValues(newSize * num_elements_, DataType()); }
+
+  /// \brief resizes memory allocated for data storage
+  /// \param newSize new size for allocated memory in number of vector elements
+  /// \param fillvalue new elements get initialized to fillValue
+  void resize(std::size_t newSize, gsl::span<char> &fillValue) override {
+    gsl::span<DataType> fv_span(reinterpret_cast<DataType *>(fillValue.data()), 1);
+    resizeValues(newSize * num_elements_, fv_span[0]);
+  }
+
+  /// \brief transfer data to data storage
+  /// \param data contiguous block of data to transfer
+  /// \param m_select Selection ojbect: how to select from data argument
+  /// \param f_select Selection ojbect: how to select to storage
+  void write(gsl::span<const char> data, const Selection &m_select,
+             const Selection &f_select) override {
+    if (data.size() > 0) {
+      const DataType *d_vals = reinterpret_cast<const DataType *>(data.data());
+      // assumes m_select and f_select have same number of points
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      if (blocks_.size() == 1) {
+        DataType *vals = modifiableBlock(0);
+        while (!m_iter.end_lin_indx()) {
+          std::size_t m_indx = m_iter.next_lin_indx() * num_elements_;
+          std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+          for (std::size_t i = 0; i < num_elements_; ++i) {
+            vals[f_indx + i] = d_vals[m_indx + i];
+          }
+        }
+        return;
+      }
+
+      std::size_t curBlock = blocks_.size();
+      DataType *vals       = nullptr;
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx = m_iter.next_lin_indx() * num_elements_;
+        std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+        for (std::size_t i = 0; i < num_elements_; ++i) {
+          std::size_t iblock = (f_indx + i) / block_values_;
+          if (iblock != curBlock) {
+            vals     = modifiableBlock(iblock);
+            curBlock = iblock;
+          }
+          vals[(f_indx + i) % block_values_] = d_vals[m_indx + i];
+        }
+      }
+    }
+  }
+
+  /// \brief transfer data from data storage
+  /// \param data contiguous block of data to transfer
+  /// \param m_select Selection ojbect: how to select to data argument
+  /// \param f_select Selection ojbect: how to select from storage
+  void read(gsl::span<char> data, const Selection &m_select,
+            const Selection &f_select) const override {
+    if (data.size() > 0) {
+      DataType *d_vals = reinterpret_cast<DataType *>(data.data());
+      // assumes m_select and f_select have same number of points
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      if (blocks_.size() == 1) {
+        const DataType *vals = blocks_[0]->data();
+        while (!m_iter.end_lin_indx()) {
+          std::size_t m_indx = m_iter.next_lin_indx() * num_elements_;
+          std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+          for (std::size_t i = 0; i < num_elements_; ++i) {
+            d_vals[m_indx + i] = vals[f_indx + i];
+          }
+        }
+        return;
+      }
+
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx = m_iter.next_lin_indx() * num_elements_;
+        std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+        for (std::size_t i = 0; i < num_elements_; ++i) {
+          const Block &block = *blocks_[(f_indx + i) / block_values_];
+          d_vals[m_indx + i] = block[(f_indx + i) % block_values_];
+        }
+      }
+    }
+  }
+
+  /// \brief create a store sharing the blocks of this one until they are modified
+  VarAttrStore_Base *clone(const std::shared_ptr<MemoryCharge> &charge) const override {
+    ChunkedVarAttrStore<DataType> *store = new ChunkedVarAttrStore<DataType>(*this);
+    store->charge_ = charge;
+    return store;
+  }
+};
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
@@ -0,0 +1,93 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file Codec.cpp
+ * \brief Lossless byte codec used by compressed ObsStore data storage
+ */
+
+#include "./Codec.hpp"
+
+#include <cstring>
+
+#include "ioda/Exception.h"
+#include "ioda/config.h"  // Auto-generated. Defines *_FOUND.
+
+#if ZLIB_FOUND
+#include <zlib.h>
+#endif
+
+namespace ioda {
+namespace ObsStore {
+namespace {
+// Compressing is done once per block when a variable settles, decompressing on most reads
+// of a cold variable, so the fastest deflate level is used.
+#if ZLIB_FOUND
+const int deflateLevel = Z_BEST_SPEED;
+#endif
+}  // namespace
+
+//------------------------------------------------------------------------------
+void packBytes(const char *data, std::size_t numBytes, std::size_t valueSize,
+               std::vector<char> &packed) {
+  // Shuffle: byte k of value i goes to position k * numValues + i.
+  std::size_t numValues = (valueSize > 0) ? numBytes / valueSize : 0;
+  std::vector<char> shuffled(numBytes);
+  for (std::size_t i = 0; i < numValues; ++i) {
+    for (std::size_t k = 0; k < valueSize; ++k) {
+      shuffled[k * numValues + i] = data[i * valueSize + k];
+    }
+  }
+
+#if ZLIB_FOUND
+  const std::size_t start = packed.size();
+  uLongf packedSize       = compressBound(static_cast<uLong>(numBytes));
+  packed.resize(start + packedSize);
+  if (compress2(reinterpret_cast<Bytef *>(packed.data() + start), &packedSize,
+                reinterpret_cast<const Bytef *>(shuffled.data()), static_cast<uLong>(numBytes),
+                deflateLevel) != Z_OK)
+    throw Exception("Cannot compress ObsStore data", ioda_Here());
+  packed.resize(start + packedSize);
+#else
+  // Without zlib the bytes are stored as they are, which saves nothing: the caller then
+  // keeps the values raw.
+  packed.insert(packed.end(), shuffled.begin(), shuffled.end());
+#endif
+}
+
+//------------------------------------------------------------------------------
+void unpackBytes(const char *packed, std::size_t packedSize, std::size_t valueSize, char *data,
+                 std::size_t numBytes) {
+  std::vector<char> shuffled(numBytes);
+#if ZLIB_FOUND
+  uLongf outSize = static_cast<uLongf>(numBytes);
+  if ((uncompress(reinterpret_cast<Bytef *>(shuffled.data()), &outSize,
+                  reinterpret_cast<const Bytef *>(packed), static_cast<uLong>(packedSize))
+       != Z_OK) || (outSize != numBytes))
+    throw Exception("Corrupt compressed ObsStore data", ioda_Here())
+      .add("expected bytes", numBytes).add("decoded bytes", outSize);
+#else
+  if (packedSize != numBytes)
+    throw Exception("Corrupt compressed ObsStore data", ioda_Here())
+      .add("expected bytes", numBytes).add("stored bytes", packedSize);
+  std::memcpy(shuffled.data(), packed, numBytes);
+#endif
+
+  // Unshuffle
+  std::size_t numValues = (valueSize > 0) ? numBytes / valueSize : 0;
+  for (std::size_t i = 0; i < numValues; ++i) {
+    for (std::size_t k = 0; k < valueSize; ++k) {
+      data[i * valueSize + k] = shuffled[k * numValues + i];
+    }
+  }
+}
+
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
@@ -0,0 +1,48 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file Codec.hpp
+ * \brief Lossless byte codec used by compressed ObsStore data storage
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace ioda {
+namespace ObsStore {
+/// \brief compress an array of fixed-size values
+/// \ingroup ioda_internals_engines_obsstore
+/// \details The bytes are first shuffled so that byte k of every value is stored
+///          together (this gathers the slowly varying high-order bytes of numeric data
+///          into long runs), then deflated with zlib, as the HDF5 shuffle and deflate
+///          filters do. Low-entropy columns (flags, counts, metadata with few distinct
+///          values) shrink a lot; real-valued observations shrink much less, mostly
+///          through their exponent and sign bytes. Without zlib the shuffled bytes are
+///          stored as they are.
+/// \param data start of the values
+/// \param numBytes size of the values in bytes (a multiple of valueSize)
+/// \param valueSize size of one value in bytes
+/// \param[out] packed the compressed bytes are appended to it
+void packBytes(const char *data, std::size_t numBytes, std::size_t valueSize,
+               std::vector<char> &packed);
+
+/// \brief reverse packBytes
+/// \ingroup ioda_internals_engines_obsstore
+/// \param packed start of the compressed bytes
+/// \param packedSize number of compressed bytes
+/// \param valueSize size of one value in bytes (as given to packBytes)
+/// \param[out] data destination for the values
+/// \param numBytes size of the values in bytes (as given to packBytes)
+void unpackBytes(const char *packed, std::size_t packedSize, std::size_t valueSize, char *data,
+                 std::size_t numBytes);
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
@@ -0,0 +1,300 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file CompressedVarAttrStore.hpp
+ * \brief Compressed ObsStore variable data storage for rarely accessed variables
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "gsl/gsl-lite.hpp"
+
+#include "./Codec.hpp"
+#include "./MemoryAccount.hpp"
+#include "./Selection.hpp"
+#include "./VarAttrStore.hpp"
+
+namespace ioda {
+namespace ObsStore {
+/// \brief data storage for fundamental types that is kept compressed while cold
+/// \ingroup ioda_internals_engines_obsstore
+/// \details Writes and resizes work on the raw values. The values are compressed (see
+///          packBytes), in independent blocks of about packBlockBytes, once writing is
+///          finished: after a write that covers every value, or when the tree is compacted
+///          (see compact). From then on each read decodes only the blocks its selection
+///          touches into a temporary buffer. Every time packed data has to be decoded
+///          counts as an access; once hotLimit accesses have happened the variable is
+///          treated as hot and is kept raw for good (a hotLimit of zero disables this).
+///          Values that do not compress are kept raw too.
+///
+///          Reads can change the representation, so every method takes an internal lock.
+///          This keeps concurrent reads safe, as required by the ObsStore thread-safety
+///          contract.
+template <typename DataType>
+class CompressedVarAttrStore : public VarAttrStore_Base {
+private:
+  /// \brief guards the representation
+  mutable std::mutex mutex_;
+  /// \brief values, when not packed
+  mutable std::vector<DataType> raw_;
+  /// \brief compressed values, when packed: the packed blocks one after the other
+  mutable std::vector<char> packed_;
+  /// \brief start of each block in packed_, followed by the end of the last block
+  mutable std::vector<std::size_t> block_starts_;
+  /// \brief total number of values
+  std::size_t num_values_;
+  /// \brief true if the values are held in packed_
+  mutable bool is_packed_;
+  /// \brief true if the values are to be kept raw from now on
+  mutable bool is_hot_;
+  /// \brief number of times the packed values had to be decoded
+  mutable std::size_t num_accesses_;
+  /// \brief number of accesses after which the variable is hot
+  std::size_t hot_limit_;
+
+  /// \brief number of elements in one data piece (for arrayed types)
+  std::size_t num_elements_;
+  /// \brief number of values in a packed block (a whole number of data pieces)
+  std::size_t block_values_;
+
+  /// \brief raw_, packed_ and block_starts_, as charged to the variable
+  mutable ChargedBytes charged_;
+
+  /// \brief update the charge after raw_, packed_ or block_starts_ have been (re)allocated
+  void recharge() const {
+    charged_.set(raw_.capacity() * sizeof(DataType) + packed_.capacity() +
+                 block_starts_.capacity() * sizeof(std::size_t));
+  }
+
+  /// \brief number of values in a packed block, for data pieces of numElements values
+  static std::size_t valuesPerBlock(std::size_t numElements) {
+    std::size_t pieceValues = std::max<std::size_t>(1, numElements);
+    return std::max<std::size_t>(1, packBlockBytes / (pieceValues * sizeof(DataType))) *
+           pieceValues;
+  }
+
+  /// \brief number of values in a block
+  std::size_t blockSize(std::size_t iblock) const {
+    return std::min(block_values_, num_values_ - iblock * block_values_);
+  }
+
+  /// \brief decode one block of packed_ into values
+  void decodeBlock(std::size_t iblock, DataType *values) const {
+    unpackBytes(packed_.data() + block_starts_[iblock],
+                block_starts_[iblock + 1] - block_starts_[iblock], sizeof(DataType),
+                reinterpret_cast<char *>(values), blockSize(iblock) * sizeof(DataType));
+  }
+
+  /// \brief move the values back into raw_ (for writes or when the variable turns hot)
+  void unpack() const {
+    if (is_packed_) {
+      raw_.resize(num_values_);
+      for (std::size_t iblock = 0; iblock + 1 < block_starts_.size(); ++iblock) {
+        decodeBlock(iblock, raw_.data() + iblock * block_values_);
+      }
+      std::vector<char>().swap(packed_);
+      std::vector<std::size_t>().swap(block_starts_);
+      is_packed_ = false;
+      ++num_accesses_;
+      if ((hot_limit_ > 0) && (num_accesses_ >= hot_limit_)) is_hot_ = true;
+      recharge();
+    }
+  }
+
+  /// \brief compress raw_ into packed_ if that saves memory
+  void pack() const {
+    if (is_packed_ || is_hot_ || raw_.empty()) return;
+    for (std::size_t first = 0; first < num_values_; first += block_values_) {
+      block_starts_.push_back(packed_.size());
+      packBytes(reinterpret_cast<const char *>(raw_.data() + first),
+                std::min(block_values_, num_values_ - first) * sizeof(DataType),
+                sizeof(DataType), packed_);
+    }
+    block_starts_.push_back(packed_.size());
+    if (packed_.size() + block_starts_.size() * sizeof(std::size_t) <
+        raw_.size() * sizeof(DataType)) {
+      packed_.shrink_to_fit();
+      block_starts_.shrink_to_fit();
+      std::vector<DataType>().swap(raw_);
+      is_packed_ = true;
+    } else {
+      // Incompressible: not worth trying again.
+      std::vector<char>().swap(packed_);
+      std::vector<std::size_t>().swap(block_starts_);
+      is_hot_ = true;
+    }
+    recharge();
+  }
+
+  /// \brief copy selected values from vals to data
+  void readFrom(const DataType *vals, gsl::span<char> data, const Selection &m_select,
+                const Selection &f_select) const {
+    const char *c_vals = reinterpret_cast<const char *>(vals);
+    // assumes m_select and f_select have same number of points
+    std::size_t datumLen = num_elements_ * sizeof(DataType);
+    SelectIterator m_iter(m_select);
+    SelectIterator f_iter(f_select);
+    while (!m_iter.end_lin_indx()) {
+      std::size_t m_indx = m_iter.next_lin_indx() * datumLen;
+      std::size_t f_indx = f_iter.next_lin_indx() * datumLen;
+      for (std::size_t i = 0; i < datumLen; ++i) {
+        data[m_indx + i] = c_vals[f_indx + i];
+      }
+    }
+  }
+
+  /// \brief copy selected values from the packed blocks to data
+  /// \details Only the blocks holding selected values are decoded.
+  void readPacked(gsl::span<char> data, const Selection &m_select,
+                  const Selection &f_select) const {
+    // Find the blocks the selection touches and give each a place in the buffer.
+    const std::size_t unused = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> block_slots(block_starts_.size() - 1, unused);
+    std::size_t num_slots = 0;
+    SelectIterator b_iter(f_select);
+    while (!b_iter.end_lin_indx()) {
+      std::size_t iblock = b_iter.next_lin_indx() * num_elements_ / block_values_;
+      if (block_slots[iblock] == unused) block_slots[iblock] = num_slots++;
+    }
+
+    std::vector<DataType> values(num_slots * block_values_);
+    for (std::size_t iblock = 0; iblock < block_slots.size(); ++iblock) {
+      if (block_slots[iblock] != unused)
+        decodeBlock(iblock, values.data() + block_slots[iblock] * block_values_);
+    }
+
+    // A data piece never straddles two blocks.
+    std::size_t datumLen = num_elements_ * sizeof(DataType);
+    SelectIterator m_iter(m_select);
+    SelectIterator f_iter(f_select);
+    while (!m_iter.end_lin_indx()) {
+      std::size_t m_indx = m_iter.next_lin_indx() * datumLen;
+      std::size_t f_value = f_iter.next_lin_indx() * num_elements_;
+      std::size_t iblock = f_value / block_values_;
+      const DataType *src = values.data() + block_slots[iblock] * block_values_ +
+                            (f_value - iblock * block_values_);
+      std::memcpy(data.data() + m_indx, src, datumLen);
+    }
+  }
+
+public:
+  /// \brief approximate size of the raw values of a packed block, in bytes
+  static const std::size_t packBlockBytes = 1 << 16;
+
+  CompressedVarAttrStore(const std::size_t numElements, const std::size_t hotLimit,
+                         const std::shared_ptr<MemoryCharge> &charge = nullptr)
+      : num_values_(0), is_packed_(false), is_hot_(false), num_accesses_(0),
+        hot_limit_(hotLimit), num_elements_(numElements),
+        block_values_(valuesPerBlock(numElements)),
+        charged_(charge, MemoryKind::Values) {}
+  CompressedVarAttrStore(const CompressedVarAttrStore &other)
+      : num_values_(other.num_values_), num_accesses_(0), hot_limit_(other.hot_limit_),
+        num_elements_(other.num_elements_), block_values_(other.block_values_) {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    raw_       = other.raw_;
+    packed_    = other.packed_;
+    block_starts_ = other.block_starts_;
+    is_packed_ = other.is_packed_;
+    is_hot_    = other.is_hot_;
+    charged_   = other.charged_;
+  }
+  ~CompressedVarAttrStore() {}
+
+  /// \brief resizes memory allocated for data storage
+  /// \param newSize new size for allocated memory in number of vector elements
+  void resize(std::size_t newSize) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unpack();
+    num_values_ = newSize * num_elements_;
+    raw_.resize(num_values_);
+    recharge();
+  }
+
+  /// \brief resizes memory allocated for data storage
+  /// \param newSize new size for allocated memory in number of vector elements
+  /// \param fillvalue new elements get initialized to fillValue
+  void resize(std::size_t newSize, gsl::span<char> &fillValue) override {
+    gsl::span<DataType> fv_span(reinterpret_cast<DataType *>(fillValue.data()), 1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    unpack();
+    num_values_ = newSize * num_elements_;
+    raw_.resize(num_values_, fv_span[0]);
+    recharge();
+  }
+
+  /// \brief transfer data to data storage
+  /// \param data contiguous block of data to transfer
+  /// \param m_select Selection ojbect: how to select from data argument
+  /// \param f_select Selection ojbect: how to select to storage
+  void write(gsl::span<const char> data, const Selection &m_select,
+             const Selection &f_select) override {
+    if (data.size() > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      unpack();
+      const DataType *d_vals = reinterpret_cast<const DataType *>(data.data());
+      // assumes m_select and f_select have same number of points
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      std::size_t num_written = 0;
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx = m_iter.next_lin_indx() * num_elements_;
+        std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+        for (std::size_t i = 0; i < num_elements_; ++i) {
+          raw_[f_indx + i] = d_vals[m_indx + i];
+        }
+        num_written += num_elements_;
+      }
+      // A write of the whole variable is taken to be its last one for a while.
+      if (num_written == num_values_) pack();
+    }
+  }
+
+  /// \brief transfer data from data storage
+  /// \param data contiguous block of data to transfer
+  /// \param m_select Selection ojbect: how to select to data argument
+  /// \param f_select Selection ojbect: how to select from storage
+  void read(gsl::span<char> data, const Selection &m_select,
+            const Selection &f_select) const override {
+    if (data.size() > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (is_packed_) {
+        if ((hot_limit_ > 0) && (num_accesses_ + 1 >= hot_limit_)) {
+          unpack();
+        } else {
+          ++num_accesses_;
+          readPacked(data, m_select, f_select);
+          return;
+        }
+      }
+      readFrom(raw_.data(), data, m_select, f_select);
+    }
+  }
+
+  /// \brief compress the values, which are not expected to be written for a while
+  void compact() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pack();
+  }
+
+  /// \brief create a store holding a copy of the (possibly compressed) values
+  VarAttrStore_Base *clone(const std::shared_ptr<MemoryCharge> &charge) const override {
+    CompressedVarAttrStore<DataType> *store = new CompressedVarAttrStore<DataType>(*this);
+    store->charged_.rebind(charge);
+    return store;
+  }
+};
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
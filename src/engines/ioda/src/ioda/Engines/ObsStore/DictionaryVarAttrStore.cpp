@@ -0,0 +1,266 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file DictionaryVarAttrStore.cpp
+ * \brief Dictionary encoded ObsStore string variable storage
+ */
+
+#include "./DictionaryVarAttrStore.hpp"
+
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#include "ioda/Exception.h"
+
+namespace ioda {
+namespace ObsStore {
+//------------------------------------------------------------------------------
+constexpr std::size_t DictionaryVarAttrStore::minEncodedDistinct;
+constexpr DictionaryVarAttrStore::Code DictionaryVarAttrStore::emptySlot;
+
+DictionaryVarAttrStore::Contents &DictionaryVarAttrStore::modifiable() {
+  if (contents_.use_count() > 1) {
+    contents_ = std::make_shared<Contents>(*contents_);
+    contents_->charged.rebind(charge_);
+  } else {
+    // See VarAttrStore::modifiable
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  return *contents_;
+}
+
+std::size_t DictionaryVarAttrStore::findSlot(const Contents &contents,
+                                             const std::string &value) {
+  // Linear probing; the table is at most half full, so an empty slot is always found.
+  const std::size_t mask = contents.slots.size() - 1;
+  std::size_t islot = std::hash<std::string>()(value) & mask;
+  while ((contents.slots[islot] != emptySlot) &&
+         (contents.dictionary[contents.slots[islot]] != value)) {
+    islot = (islot + 1) & mask;
+  }
+  return islot;
+}
+
+void DictionaryVarAttrStore::rebuildSlots(Contents &contents) {
+  std::size_t numSlots = 16;
+  while (numSlots < 2 * (contents.dictionary.size() + 1)) numSlots *= 2;
+  contents.slots.assign(numSlots, emptySlot);
+  for (std::size_t code = 0; code < contents.dictionary.size(); ++code) {
+    contents.slots[findSlot(contents, contents.dictionary[code])] = static_cast<Code>(code);
+  }
+}
+
+DictionaryVarAttrStore::Code DictionaryVarAttrStore::encode(Contents &contents,
+                                                            const std::string &value) {
+  if (contents.slots.empty()) rebuildSlots(contents);
+  std::size_t islot = findSlot(contents, value);
+  if (contents.slots[islot] != emptySlot) return contents.slots[islot];
+
+  if (contents.dictionary.size() >= emptySlot)
+    throw Exception("Too many distinct strings for a dictionary encoded variable",
+                    ioda_Here());
+  Code code = static_cast<Code>(contents.dictionary.size());
+  contents.dictionary.push_back(value);
+  contents.uses.push_back(0);
+  contents.unused++;
+  contents.heap_bytes += stringHeapBytes(contents.dictionary.back());
+  contents.slots[islot] = code;
+  if (2 * contents.dictionary.size() > contents.slots.size()) rebuildSlots(contents);
+  return code;
+}
+
+void DictionaryVarAttrStore::assign(Contents &contents, std::size_t i, Code code) {
+  Code oldCode = contents.codes[i];
+  if (oldCode == code) return;
+  if (--contents.uses[oldCode] == 0) contents.unused++;
+  if (contents.uses[code]++ == 0) contents.unused--;
+  contents.codes[i] = code;
+}
+
+void DictionaryVarAttrStore::resizeTo(Contents &contents, std::size_t newSize,
+                                      const std::string &value) {
+  if (!contents.encoded) {
+    for (std::size_t i = newSize; i < contents.values.size(); ++i) {
+      contents.heap_bytes -= stringHeapBytes(contents.values[i]);
+    }
+    std::size_t oldSize = contents.values.size();
+    contents.values.resize(newSize, value);
+    for (std::size_t i = oldSize; i < newSize; ++i) {
+      contents.heap_bytes += stringHeapBytes(contents.values[i]);
+    }
+    return;
+  }
+
+  for (std::size_t i = newSize; i < contents.codes.size(); ++i) {
+    if (--contents.uses[contents.codes[i]] == 0) contents.unused++;
+  }
+  if (newSize > contents.codes.size()) {
+    // Only encode the value when it is used, so that shrinking adds nothing.
+    Code code = encode(contents, value);
+    if (contents.uses[code] == 0) contents.unused--;
+    contents.uses[code] += newSize - contents.codes.size();
+    contents.codes.resize(newSize, code);
+  } else {
+    contents.codes.resize(newSize);
+  }
+}
+
+void DictionaryVarAttrStore::compact(Contents &contents) {
+  std::vector<Code> newCodes(contents.dictionary.size(), emptySlot);
+  std::size_t numKept = 0;
+  for (std::size_t code = 0; code < contents.dictionary.size(); ++code) {
+    if (contents.uses[code] == 0) {
+      contents.heap_bytes -= stringHeapBytes(contents.dictionary[code]);
+      continue;
+    }
+    newCodes[code] = static_cast<Code>(numKept);
+    if (numKept != code) {
+      contents.dictionary[numKept] = std::move(contents.dictionary[code]);
+      contents.uses[numKept] = contents.uses[code];
+    }
+    numKept++;
+  }
+  contents.dictionary.resize(numKept);
+  contents.dictionary.shrink_to_fit();
+  contents.uses.resize(numKept);
+  contents.uses.shrink_to_fit();
+  contents.unused = 0;
+  for (auto &code : contents.codes) code = newCodes[code];
+  rebuildSlots(contents);
+}
+
+void DictionaryVarAttrStore::decode(Contents &contents) {
+  contents.values.reserve(contents.codes.size());
+  contents.heap_bytes = 0;
+  for (const auto code : contents.codes) {
+    contents.values.push_back(contents.dictionary[code]);
+    contents.heap_bytes += stringHeapBytes(contents.values.back());
+  }
+  contents.encoded = false;
+  std::vector<std::string>().swap(contents.dictionary);
+  std::vector<std::size_t>().swap(contents.uses);
+  std::vector<Code>().swap(contents.slots);
+  std::vector<Code>().swap(contents.codes);
+  contents.unused = 0;
+}
+
+void DictionaryVarAttrStore::tidy(Contents &contents) {
+  if (contents.encoded) {
+    if (2 * contents.unused > contents.dictionary.size()) compact(contents);
+    const std::size_t numDistinct = contents.dictionary.size() - contents.unused;
+    if ((numDistinct > minEncodedDistinct) && (2 * numDistinct > contents.codes.size()))
+      decode(contents);
+  }
+  contents.charged.set(contents.heap_bytes +
+                       contents.dictionary.capacity() * sizeof(std::string) +
+                       contents.uses.capacity() * sizeof(std::size_t) +
+                       contents.slots.capacity() * sizeof(Code) +
+                       contents.codes.capacity() * sizeof(Code) +
+                       contents.values.capacity() * sizeof(std::string));
+}
+
+void DictionaryVarAttrStore::resize(std::size_t newSize) {
+  std::size_t oldSize = contents_->encoded ? contents_->codes.size() : contents_->values.size();
+  if (oldSize == newSize * num_elements_) return;
+  Contents &contents = modifiable();
+  resizeTo(contents, newSize * num_elements_, std::string());
+  tidy(contents);
+}
+
+void DictionaryVarAttrStore::resize(std::size_t newSize, gsl::span<char> &fillValue) {
+  std::size_t oldSize = contents_->encoded ? contents_->codes.size() : contents_->values.size();
+  if (oldSize == newSize * num_elements_) return;
+  // At this point, fillValue[0] is a char * pointing to the string
+  // to be used for a fill value.
+  gsl::span<char *> fv_span(reinterpret_cast<char **>(fillValue.data()), 1);
+  Contents &contents = modifiable();
+  resizeTo(contents, newSize * num_elements_, std::string(fv_span[0]));
+  tidy(contents);
+}
+
+void DictionaryVarAttrStore::write(gsl::span<const char> data, const Selection &m_select,
+                                   const Selection &f_select) {
+  // data is a series of char * pointing to null terminated strings
+  if (data.size() > 0) {
+    auto data_pointer = reinterpret_cast<const char *const *>(data.data());
+    Contents &contents = modifiable();
+
+    // assumes m_select and f_select have same number of points
+    SelectIterator m_iter(m_select);
+    SelectIterator f_iter(f_select);
+    std::string value;
+    while (!m_iter.end_lin_indx()) {
+      std::size_t m_indx = m_iter.next_lin_indx() * num_elements_;
+      std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+      for (std::size_t i = 0; i < num_elements_; ++i) {
+        if (contents.encoded) {
+          value.assign(data_pointer[m_indx + i]);
+          assign(contents, f_indx + i, encode(contents, value));
+        } else {
+          std::string &stored = contents.values[f_indx + i];
+          contents.heap_bytes -= stringHeapBytes(stored);
+          stored.assign(data_pointer[m_indx + i]);
+          contents.heap_bytes += stringHeapBytes(stored);
+        }
+      }
+    }
+    tidy(contents);
+  }
+}
+
+void DictionaryVarAttrStore::read(gsl::span<char> data, const Selection &m_select,
+                                  const Selection &f_select) const {
+  // data receives a series of char * pointing into the dictionary
+  if (data.size() > 0) {
+    auto data_pointer = reinterpret_cast<const char **>(data.data());
+    const Contents &contents = *contents_;
+
+    // assumes m_select and f_select have same number of points
+    SelectIterator m_iter(m_select);
+    SelectIterator f_iter(f_select);
+    while (!m_iter.end_lin_indx()) {
+      std::size_t m_indx = m_iter.next_lin_indx() * num_elements_;
+      std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+      for (std::size_t i = 0; i < num_elements_; ++i) {
+        data_pointer[m_indx + i] = contents.encoded
+                                 ? contents.dictionary[contents.codes[f_indx + i]].data()
+                                 : contents.values[f_indx + i].data();
+      }
+    }
+  }
+}
+
+VarAttrStore_Base *DictionaryVarAttrStore::clone(
+  const std::shared_ptr<MemoryCharge> &charge) const {
+  DictionaryVarAttrStore *store = new DictionaryVarAttrStore(*this);
+  store->charge_ = charge;
+  return store;
+}
+
+bool DictionaryVarAttrStore::readCodes(std::vector<Code> &codes,
+                                       const Selection &f_select) const {
+  if (!contents_->encoded) return false;
+  codes.clear();
+  codes.reserve(f_select.npoints() * num_elements_);
+  SelectIterator f_iter(f_select);
+  while (!f_iter.end_lin_indx()) {
+    std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+    for (std::size_t i = 0; i < num_elements_; ++i) {
+      codes.push_back(contents_->codes[f_indx + i]);
+    }
+  }
+  return true;
+}
+
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
@@ -0,0 +1,177 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file DictionaryVarAttrStore.hpp
+ * \brief Dictionary encoded ObsStore string variable storage
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gsl/gsl-lite.hpp"
+
+#include "./MemoryAccount.hpp"
+#include "./Selection.hpp"
+#include "./VarAttrStore.hpp"
+
+namespace ioda {
+namespace ObsStore {
+/// \brief data storage for strings as a table of unique values plus integer codes
+/// \ingroup ioda_internals_engines_obsstore
+/// \details This is the storage for all ObsStore string variables. Most of them (station
+///          ids, instrument names, ...) have few distinct values compared with their
+///          length, so storing each distinct value once and a 32-bit code per element is
+///          much smaller than one std::string per element. Equal strings have equal codes,
+///          so callers can compare and group on the codes (see readCodes) and only turn
+///          codes into strings where they are needed.
+///
+///          Variables whose values are mostly distinct gain nothing from the table, so once
+///          more than half of the values of a variable are distinct (and there are more than
+///          minEncodedDistinct of them) the store switches, for good, to one std::string per
+///          element. Values that are no longer referenced after a write or a resize are
+///          dropped from the table once they make up half of it; the codes of the remaining
+///          values may change when that happens.
+///
+///          The table is indexed by an open addressing hash table of codes, which compares
+///          against the table entries, so that each distinct value is held only once.
+///
+///          The stored values are shared with clones until either is modified.
+class DictionaryVarAttrStore : public VarAttrStore_Base {
+public:
+  /// \brief type of the codes
+  typedef std::uint32_t Code;
+
+  /// \brief number of distinct values up to which a variable is always dictionary encoded
+  static constexpr std::size_t minEncodedDistinct = 1024;
+
+private:
+  /// \brief the stored values
+  struct Contents {
+    /// \brief true while the values are dictionary encoded, false once they are held as
+    ///        one string per element in values
+    bool encoded = true;
+    /// \brief distinct values, indexed by code
+    std::vector<std::string> dictionary;
+    /// \brief number of elements holding each code
+    std::vector<std::size_t> uses;
+    /// \brief number of entries of dictionary that no element holds
+    std::size_t unused = 0;
+    /// \brief hash table of the codes in dictionary (emptySlot: unused slot); its size is
+    ///        a power of two, at least twice the size of dictionary
+    std::vector<Code> slots;
+    /// \brief one code per stored string
+    std::vector<Code> codes;
+    /// \brief one value per stored string, when not encoded
+    std::vector<std::string> values;
+    /// \brief heap memory of the strings in dictionary and values
+    std::size_t heap_bytes = 0;
+    /// \brief all of the above, as charged to the variable
+    ChargedBytes charged;
+  };
+  /// \brief the stored values, shared with clones until modified
+  std::shared_ptr<Contents> contents_;
+
+  /// \brief number of elements in one data piece (for arrayed types)
+  std::size_t num_elements_;
+
+  /// \brief charge for the copies of the stored values made by this store
+  std::shared_ptr<MemoryCharge> charge_;
+
+  /// \brief marker of an unused slot of the hash table
+  static constexpr Code emptySlot = std::numeric_limits<Code>::max();
+
+  /// \brief the stored values, copied first if they are shared with a clone
+  Contents &modifiable();
+
+  /// \brief position in the hash table holding the code of value, or the empty slot
+  ///        where it would go
+  static std::size_t findSlot(const Contents &contents, const std::string &value);
+
+  /// \brief rebuild the hash table for the current dictionary
+  static void rebuildSlots(Contents &contents);
+
+  /// \brief code for a value, adding it to the dictionary if new
+  static Code encode(Contents &contents, const std::string &value);
+
+  /// \brief set element i to code, keeping the use counts
+  static void assign(Contents &contents, std::size_t i, Code code);
+
+  /// \brief resize to newSize elements, setting new elements to value
+  static void resizeTo(Contents &contents, std::size_t newSize, const std::string &value);
+
+  /// \brief drop the values of the dictionary that no element holds and renumber the rest
+  static void compact(Contents &contents);
+
+  /// \brief switch to one string per element
+  static void decode(Contents &contents);
+
+  /// \brief compact or decode the stored values as needed and update the charge after
+  ///        they have changed
+  static void tidy(Contents &contents);
+
+public:
+  DictionaryVarAttrStore() : contents_(std::make_shared<Contents>()), num_elements_(1) {}
+  DictionaryVarAttrStore(const std::size_t numElements)
+      : contents_(std::make_shared<Contents>()), num_elements_(numElements) {}
+  /// \param numElements number of elements in one data piece
+  /// \param charge charge for the stored values (nullptr: no accounting)
+  DictionaryVarAttrStore(const std::size_t numElements,
+                         const std::shared_ptr<MemoryCharge> &charge)
+      : contents_(std::make_shared<Contents>()), num_elements_(numElements), charge_(charge) {
+    contents_->charged = ChargedBytes(charge, MemoryKind::Strings);
+  }
+  ~DictionaryVarAttrStore() {}
+
+  /// \brief resizes memory allocated for data storage
+  /// \param newSize new size for allocated memory in number of vector elements
+  void resize(std::size_t newSize) override;
+
+  /// \brief resizes memory allocated for data storage
+  /// \param newSize new size for allocated memory in number of vector elements
+  /// \param fillvalue new elements get initialized to fillValue
+  void resize(std::size_t newSize, gsl::span<char> &fillValue) override;
+
+  /// \brief transfer data to data storage
+  /// \param data contiguous block of data to transfer
+  /// \param m_select Selection object: how to select from data argument
+  /// \param f_select Selection object: how to select to storage
+  void write(gsl::span<const char> data, const Selection &m_select,
+             const Selection &f_select) override;
+
+  /// \brief transfer data from data storage
+  /// \param data contiguous block of data to transfer
+  /// \param m_select Selection ojbect: how to select to data argument
+  /// \param f_select Selection ojbect: how to select from storage
+  void read(gsl::span<char> data, const Selection &m_select,
+            const Selection &f_select) const override;
+
+  /// \brief create a store sharing the values of this one until either is modified
+  VarAttrStore_Base *clone(const std::shared_ptr<MemoryCharge> &charge) const override;
+
+  /// \brief true while the values are dictionary encoded
+  bool encoded() const { return contents_->encoded; }
+
+  /// \brief the distinct values, indexed by code (empty when not encoded)
+  /// \details May hold a few values that are no longer referenced by any element.
+  const std::vector<std::string> &dictionary() const { return contents_->dictionary; }
+
+  /// \brief transfer codes from data storage
+  /// \param codes receives one code per selected element, in selection order
+  /// \param f_select Selection object: how to select from storage
+  /// \returns false if the values are not dictionary encoded
+  bool readCodes(std::vector<Code> &codes, const Selection &f_select) const;
+};
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
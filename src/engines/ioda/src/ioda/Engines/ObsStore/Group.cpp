@@ -12,8 +12,10 @@
  */
 #include "./Group.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
+#include "./MappedVarAttrStore.hpp"
 #include "./Variables.hpp"
 #include "ioda/defs.h"
 #include "ioda/Exception.h"
@@ -21,7 +23,11 @@
 namespace ioda {
 namespace ObsStore {
 Group::Group()
-    : atts(std::make_shared<Has_Attributes>()), vars(std::make_shared<Has_Variables>()) {}
+    : path_index_(std::make_shared<PathIndex>()),
+      atts(std::make_shared<Has_Attributes>()),
+      vars(std::make_shared<Has_Variables>()) {
+  vars->setPathIndex(path_index_, path_prefix_);
+}
 Group::~Group() = default;
 
 std::list<std::string> Group::list() const {
@@ -73,19 +79,26 @@ bool Group::exists(const std::string& name) {
 }
 
 std::shared_ptr<Group> Group::create(const std::string& name) {
+  // If the whole path already exists, we are done.
+  std::shared_ptr<Group> childGroup = open(name, false);
+  if (childGroup != nullptr) return childGroup;
+
   // split name into first group and remaining children of the first group
   // ie, "a/b/c/d" -> "a", "b/c/d"
   std::vector<std::string> pathSections = splitFirstLevel(name);
 
   // If the child exists grab it, otherwise create it.
-  std::shared_ptr<Group> childGroup;
-  if (this->exists(pathSections[0])) {
-    childGroup = this->open(pathSections[0]);
+  auto igrp = child_groups_.find(pathSections[0]);
+  if (igrp != child_groups_.end()) {
+    childGroup = igrp->second;
   } else {
     childGroup = std::make_shared<Group>();
     childGroup->vars->setParentGroup(childGroup);
+    childGroup->setPathIndex(path_index_, path_prefix_ + pathSections[0] + "/");
+    childGroup->setStorage(storage_, arena_, account_);
     child_groups_.insert(
       std::pair<std::string, std::shared_ptr<Group>>(pathSections[0], childGroup));
+    path_index_->groups[path_prefix_ + pathSections[0]] = childGroup;
   }
 
   // Recurse if there are more levels in the input name
@@ -99,24 +112,13 @@ std::shared_ptr<Group> Group::create(const std::string& name) {
 std::shared_ptr<Group> Group::open(const std::string& name, const bool throwIfNotFound) {
   std::shared_ptr<Group> childGroup(nullptr);
 
-  // split name into first group and remaining children of the first group
-  // ie, "a/b/c/d" -> "a", "b/c/d"
-  std::vector<std::string> pathSections = splitFirstLevel(name);
-
-  auto igrp = child_groups_.find(pathSections[0]);
-  if (igrp == child_groups_.end()) {
-    childGroup = nullptr;
-  } else {
-    childGroup = igrp->second;
-  }
-
-  // Recurse if there are more levels in the input name
-  if ((pathSections.size() > 1) && (childGroup != nullptr)) {
-    childGroup = childGroup->open(pathSections[1], throwIfNotFound);
+  auto igrp = path_index_->groups.find(path_prefix_ + name);
+  if (igrp != path_index_->groups.end()) {
+    childGroup = igrp->second.lock();
   }
 
   if (throwIfNotFound && (childGroup == nullptr)) {
-    throw Exception("Child group not found", ioda_Here());
+    throw Exception("Child group not found", ioda_Here()).add("name", name);
   }
 
   return childGroup;
@@ -125,10 +127,80 @@ std::shared_ptr<Group> Group::open(const std::string& name, const bool throwIfNo
 std::shared_ptr<Group> Group::createRootGroup() {
   std::shared_ptr<Group> group = std::make_shared<Group>();
   group->vars->setParentGroup(group);
+  group->setStorage(nullptr, nullptr, std::make_shared<MemoryAccount>());
+  return group;
+}
+
+std::shared_ptr<Group> Group::createRootGroup(
+  const Engines::ObsStore::StorageParameters& storage) {
+  // Fail early, before any variable is created, if mapped variables cannot be backed
+  // in the scratch directory. Every mapped buffer of the tree uses this directory.
+  const bool mapped =
+    (storage.defaultKind == Engines::ObsStore::StorageKind::MappedFile) ||
+    std::any_of(storage.policies.begin(), storage.policies.end(), [](const auto& policy) {
+      return policy.second == Engines::ObsStore::StorageKind::MappedFile;
+    });
+  if (mapped) MappedBuffer::checkDirectory(storage.scratchPath());
+
+  std::shared_ptr<Group> group = createRootGroup();
+  std::shared_ptr<Arena> arena;
+  if (storage.arena.enabled) arena = std::make_shared<Arena>(storage.arena);
+  group->setStorage(std::make_shared<const Engines::ObsStore::StorageParameters>(storage), arena,
+                    group->account_);
+  return group;
+}
+
+std::shared_ptr<Group> Group::clone() const {
+  std::shared_ptr<Group> group = createRootGroup();
+  group->setStorage(storage_, arena_, group->account_);
+
+  std::map<const Variable*, std::shared_ptr<Variable>> clones;
+  cloneInto(*group, clones);
+
+  // Dimension scales attached within the copied groups have to refer to the copies.
+  for (const auto& iclone : clones) iclone.second->remapDimensionScales(clones);
   return group;
 }
 
+void Group::compact() const {
+  vars->forEach([](const std::string&, const std::shared_ptr<Variable>& var) { var->compact(); });
+  for (const auto& ichild : child_groups_) ichild.second->compact();
+}
+
 // Private methods
+void Group::cloneInto(Group& dest,
+                      std::map<const Variable*, std::shared_ptr<Variable>>& clones) const {
+  dest.atts = atts->clone(dest.atts->charge());
+  vars->forEach([&](const std::string& name, const std::shared_ptr<Variable>& var) {
+    std::shared_ptr<Variable> varClone = var->clone(dest.vars->newCharge(name));
+    dest.vars->insert(name, varClone);
+    clones[var.get()] = varClone;
+  });
+  for (const auto& ichild : child_groups_) {
+    ichild.second->cloneInto(*dest.create(ichild.first), clones);
+  }
+}
+
+void Group::setPathIndex(const std::shared_ptr<PathIndex>& pathIndex,
+                         const std::string& pathPrefix) {
+  path_index_  = pathIndex;
+  path_prefix_ = pathPrefix;
+  vars->setPathIndex(pathIndex, pathPrefix);
+}
+
+void Group::setStorage(
+  const std::shared_ptr<const Engines::ObsStore::StorageParameters>& storage,
+  const std::shared_ptr<Arena>& arena, const std::shared_ptr<MemoryAccount>& account) {
+  storage_ = storage;
+  arena_   = arena;
+  account_ = account;
+  // The attributes of a group are charged to the group itself.
+  std::string groupPath = path_prefix_.empty() ? path_prefix_
+                                               : path_prefix_.substr(0, path_prefix_.size() - 1);
+  atts->setCharge(account ? std::make_shared<MemoryCharge>(account, groupPath, "") : nullptr);
+  vars->setStorage(storage, arena, account);
+}
+
 std::vector<std::string> Group::splitFirstLevel(const std::string& path) {
   std::vector<std::string> pathSections;
   auto pos = path.find('/');
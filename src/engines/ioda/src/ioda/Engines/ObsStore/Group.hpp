@@ -8,6 +8,13 @@
  * \brief Implementation of the in-memory ObsStore backend.
  * \ingroup ioda_internals_engines
  *
+ * Reads (open, exists, list, Variable::read, Attribute::read) only touch state
+ * that is immutable for the duration of the read, so they may run concurrently.
+ * In particular, Selection objects are immutable and per-transfer iteration state
+ * lives in SelectIterator objects on the caller's stack. Anything that mutates
+ * a container or a data store requires exclusive access. See
+ * \ref ioda_cxx_engines_pub_ObsStore for the public contract.
+ *
  * @{
  * \file Group.hpp
  * \brief Functions for ObsStore Group and Has_Groups
@@ -21,17 +28,53 @@
 #include <string>
 #include <vector>
 
+#include "./Arena.hpp"
 #include "./Attributes.hpp"
+#include "./MemoryAccount.hpp"
+#include "./PathIndex.hpp"
+#include "ioda/Engines/ObsStore.h"
 
 namespace ioda {
 namespace ObsStore {
 class Has_Variables;
+class Variable;
 /// \ingroup ioda_internals_engines_obsstore
 class Group {
 private:
   /// \brief container for child groups
   std::map<std::string, std::shared_ptr<Group>> child_groups_;
 
+  /// \brief full-path index shared by all groups in this tree
+  std::shared_ptr<PathIndex> path_index_;
+  /// \brief full path of this group, with a trailing '/' (empty for the root group)
+  std::string path_prefix_;
+
+  /// \brief attach this group (and its variables container) to a tree's path index
+  /// \param pathIndex index shared by the tree
+  /// \param pathPrefix full path of this group, with a trailing '/'
+  void setPathIndex(const std::shared_ptr<PathIndex>& pathIndex, const std::string& pathPrefix);
+
+  /// \brief storage policies of the tree (nullptr: everything in memory)
+  std::shared_ptr<const Engines::ObsStore::StorageParameters> storage_;
+  /// \brief allocator of the tree (nullptr: the heap)
+  std::shared_ptr<Arena> arena_;
+  /// \brief memory account of the tree (nullptr: no accounting)
+  std::shared_ptr<MemoryAccount> account_;
+
+  /// \brief set the storage policies for this group (and its variables container)
+  /// \param storage storage policies of the tree
+  /// \param arena allocator of the tree
+  /// \param account memory account of the tree
+  void setStorage(const std::shared_ptr<const Engines::ObsStore::StorageParameters>& storage,
+                  const std::shared_ptr<Arena>& arena,
+                  const std::shared_ptr<MemoryAccount>& account);
+
+  /// \brief fill dest (a group of another tree) with clones of the contents of this group
+  /// \param dest destination group
+  /// \param clones receives the clone of each variable, keyed by the original
+  void cloneInto(Group& dest,
+                 std::map<const Variable*, std::shared_ptr<Variable>>& clones) const;
+
   /// \brief split a path into the first level and remainder of the path
   /// \param path Hierarchical path
   static std::vector<std::string> splitFirstLevel(const std::string& path);
@@ -60,19 +103,42 @@ public:
                    const std::string& prefix = "") const;
 
   /// \brief returns true if child group exists
-  /// \param name of child group
+  /// \param name of child group (may be a hierarchical path)
   bool exists(const std::string& name);
 
-  /// \brief create a new group
-  /// \param name name of child group
+  /// \brief create a new group (returns the existing group if already there)
+  /// \param name name of child group (may be a hierarchical path)
   std::shared_ptr<Group> create(const std::string& name);
 
   /// \brief open an existing child group
-  /// \param name name of child group
+  /// \param name name of child group (may be a hierarchical path)
+  /// \details This is a single lookup in the tree's path index.
   std::shared_ptr<Group> open(const std::string& name, const bool throwIfNotFound = true);
 
+  /// \brief create a new tree holding a copy of this group and everything below it
+  /// \details This group becomes the root group of the new tree, which uses the same
+  ///          storage policies and arena as this tree. Variable values are shared with the
+  ///          copy until modified, so the cost is proportional to the number of groups,
+  ///          variables and attributes rather than to the amount of data.
+  std::shared_ptr<Group> clone() const;
+
+  /// \brief compact the variables of this group and everything below it
+  /// \details See Variable::compact.
+  void compact() const;
+
+  /// \brief the allocator of the tree (nullptr if the tree does not use an arena)
+  std::shared_ptr<Arena> arena() const { return arena_; }
+
+  /// \brief the memory account of the tree (nullptr for a group created outside a tree)
+  std::shared_ptr<MemoryAccount> account() const { return account_; }
+
   /// \brief Creates a root group
   static std::shared_ptr<Group> createRootGroup();
+
+  /// \brief Creates a root group whose variables are placed according to storage policies
+  /// \param storage storage policies applied to every variable created in the tree
+  static std::shared_ptr<Group> createRootGroup(
+    const Engines::ObsStore::StorageParameters& storage);
 };
 }  // namespace ObsStore
 }  // namespace ioda
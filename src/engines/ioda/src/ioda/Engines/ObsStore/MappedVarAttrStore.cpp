@@ -0,0 +1,111 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file MappedVarAttrStore.cpp
+ * \brief ObsStore variable data storage backed by a memory-mapped scratch file
+ */
+
+#include "./MappedVarAttrStore.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "ioda/Exception.h"
+
+namespace ioda {
+namespace ObsStore {
+//------------------------------------------------------------------------------
+namespace {
+/// Create an unlinked scratch file of the given size in directory and map it.
+/// No descriptor is kept: the mapping holds the file until it is unmapped.
+char *mapScratchFile(const std::string &directory, std::size_t size) {
+  std::string templ = directory + "/ioda-obsstore-XXXXXX";
+  std::vector<char> path(templ.begin(), templ.end());
+  path.push_back('\0');
+  int fd = mkstemp(path.data());
+  if (fd < 0) {
+    throw Exception("Unable to create ObsStore scratch file", ioda_Here())
+      .add("directory", directory)
+      .add("reason", std::strerror(errno));
+  }
+  // Nothing refers to the file by name, so remove it now. The storage is released
+  // when the mapping goes away, including when the process dies.
+  unlink(path.data());
+
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    int err = errno;
+    close(fd);
+    throw Exception("Unable to resize ObsStore scratch file", ioda_Here())
+      .add("newSize", size)
+      .add("reason", std::strerror(err));
+  }
+  void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int err = errno;
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw Exception("Unable to map ObsStore scratch file", ioda_Here())
+      .add("newSize", size)
+      .add("reason", std::strerror(err));
+  }
+  return static_cast<char *>(addr);
+}
+}  // namespace
+
+MappedBuffer::MappedBuffer(const std::string &directory,
+                           const std::shared_ptr<MemoryCharge> &charge)
+    : directory_(directory), addr_(nullptr), size_(0), capacity_(0),
+      charged_(charge, MemoryKind::Mapped) {}
+
+MappedBuffer::~MappedBuffer() {
+  if (addr_ != nullptr) munmap(addr_, capacity_);
+}
+
+void MappedBuffer::checkDirectory(const std::string &directory) {
+  munmap(mapScratchFile(directory, 1), 1);
+}
+
+void MappedBuffer::resize(std::size_t newSize) {
+  if (newSize == size_) return;
+
+  if ((newSize > capacity_) || (newSize < capacity_ / 4)) {
+    // Each mapping gets a new file, so that no descriptor has to be kept open to grow
+    // it. The new file reads as zero past the bytes copied from the old one. Growth
+    // at least doubles the capacity; a buffer that has shrunk well below its capacity
+    // gives the rest back.
+    std::size_t newCapacity = 0;
+    if (newSize > 0) {
+      const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+      newCapacity = (newSize > capacity_) ? std::max(newSize, 2 * capacity_) : 2 * newSize;
+      newCapacity = (newCapacity + pageSize - 1) / pageSize * pageSize;
+    }
+    char *addr = (newCapacity > 0) ? mapScratchFile(directory_, newCapacity) : nullptr;
+    if (addr_ != nullptr) {
+      if (addr != nullptr) std::memcpy(addr, addr_, std::min(size_, newSize));
+      munmap(addr_, capacity_);
+    }
+    addr_ = addr;
+    capacity_ = newCapacity;
+  } else if (newSize < size_) {
+    // The bytes past the size have to read as zero if the buffer grows again.
+    std::memset(addr_ + newSize, 0, size_ - newSize);
+  }
+  size_ = newSize;
+  charged_.set(capacity_);
+}
+
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
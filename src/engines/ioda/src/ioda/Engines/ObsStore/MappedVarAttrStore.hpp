@@ -0,0 +1,197 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file MappedVarAttrStore.hpp
+ * \brief ObsStore variable data storage backed by a memory-mapped scratch file
+ */
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "gsl/gsl-lite.hpp"
+
+#include "./MemoryAccount.hpp"
+#include "./Selection.hpp"
+#include "./VarAttrStore.hpp"
+
+namespace ioda {
+namespace ObsStore {
+/// \brief a resizable block of bytes held in a memory-mapped file
+/// \ingroup ioda_internals_engines_obsstore
+/// \details The file is created in the given directory, unlinked and closed straight
+///          away, so it never outlives the process even if the process is killed, and no
+///          file descriptor is held per buffer. The mapping grows geometrically: when the
+///          size passes the capacity, a file of at least twice the capacity is mapped and
+///          the leading bytes are copied, so that a variable extended one frame at a time
+///          is copied a bounded number of times. The mapping is shared, which lets the
+///          kernel write cold pages back to the file and drop them from memory instead of
+///          pushing them to swap.
+class MappedBuffer {
+private:
+  /// \brief directory holding the (unlinked) backing files
+  std::string directory_;
+  /// \brief start of the mapping (nullptr when capacity_ is zero)
+  char *addr_;
+  /// \brief size of the buffer in bytes
+  std::size_t size_;
+  /// \brief size of the mapping in bytes
+  std::size_t capacity_;
+  /// \brief the mapping, as charged to its variable
+  ChargedBytes charged_;
+
+public:
+  /// \param directory directory in which to create the backing file
+  /// \param charge charge for the mapping (nullptr: no accounting)
+  explicit MappedBuffer(const std::string &directory,
+                        const std::shared_ptr<MemoryCharge> &charge = nullptr);
+  ~MappedBuffer();
+
+  /// \brief throw if no backing file can be mapped in the directory
+  static void checkDirectory(const std::string &directory);
+
+  MappedBuffer(const MappedBuffer &) = delete;
+  MappedBuffer &operator=(const MappedBuffer &) = delete;
+
+  /// \brief change the size of the buffer, preserving the leading bytes
+  /// \details Bytes past the old size read as zero.
+  /// \param newSize new size in bytes
+  void resize(std::size_t newSize);
+
+  /// \brief start of the buffer
+  char *data() { return addr_; }
+  /// \brief start of the buffer
+  const char *data() const { return addr_; }
+  /// \brief size of the buffer in bytes
+  std::size_t size() const { return size_; }
+  /// \brief size of the mapping in bytes
+  std::size_t capacity() const { return capacity_; }
+};
+
+/// \brief data storage for fundamental types held in a MappedBuffer
+/// \ingroup ioda_internals_engines_obsstore
+/// \details Behaves like VarAttrStore<DataType>. There is no std::string version
+///          because strings own heap memory that cannot live in a file. The mapping
+///          is shared with clones until either is modified.
+template <typename DataType>
+class MappedVarAttrStore : public VarAttrStore_Base {
+private:
+  /// \brief directory holding the backing files
+  std::string directory_;
+  /// \brief charge for the mappings created by this store (nullptr: no accounting)
+  std::shared_ptr<MemoryCharge> charge_;
+  /// \brief data storage mechanism (mapped file), shared with clones until modified
+  std::shared_ptr<MappedBuffer> buffer_;
+
+  /// \brief number of elements in one data piece (for arrayed types)
+  std::size_t num_elements_;
+
+  /// \brief the buffer, copied to a new file first if it is shared with a clone
+  MappedBuffer &modifiable() {
+    if (buffer_.use_count() > 1) {
+      auto copy = std::make_shared<MappedBuffer>(directory_, charge_);
+      copy->resize(buffer_->size());
+      if (buffer_->size() > 0) std::memcpy(copy->data(), buffer_->data(), buffer_->size());
+      buffer_ = copy;
+    } else {
+      // See VarAttrStore::modifiable
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *buffer_;
+  }
+
+  /// \brief typed view of the buffer
+  DataType *values() { return reinterpret_cast<DataType *>(modifiable().data()); }
+
+public:
+  MappedVarAttrStore(const std::string &directory, const std::size_t numElements,
+                     const std::shared_ptr<MemoryCharge> &charge = nullptr)
+      : directory_(directory), charge_(charge),
+        buffer_(std::make_shared<MappedBuffer>(directory, charge)), num_elements_(numElements) {}
+  ~MappedVarAttrStore() {}
+
+  /// \brief resizes memory allocated for data storage
+  /// \param newSize new size for allocated memory in number of vector elements
+  void resize(std::size_t newSize) override {
+    if (buffer_->size() == newSize * num_elements_ * sizeof(DataType)) return;
+    modifiable().resize(newSize * num_elements_ * sizeof(DataType));
+  }
+
+  /// \brief resizes memory allocated for data storage
+  /// \param newSize new size for allocated memory in number of vector elements
+  /// \param fillvalue new elements get initialized to fillValue
+  void resize(std::size_t newSize, gsl::span<char> &fillValue) override {
+    gsl::span<DataType> fv_span(reinterpret_cast<DataType *>(fillValue.data()), 1);
+    std::size_t oldCount = buffer_->size() / sizeof(DataType);
+    std::size_t newCount = newSize * num_elements_;
+    if (oldCount == newCount) return;
+    modifiable().resize(newCount * sizeof(DataType));
+    DataType *vals = values();
+    for (std::size_t i = oldCount; i < newCount; ++i) {
+      vals[i] = fv_span[0];
+    }
+  }
+
+  /// \brief transfer data to data storage
+  /// \param data contiguous block of data to transfer
+  /// \param m_select Selection ojbect: how to select from data argument
+  /// \param f_select Selection ojbect: how to select to storage
+  void write(gsl::span<const char> data, const Selection &m_select,
+             const Selection &f_select) override {
+    if (data.size() > 0) {
+      const DataType *d_vals = reinterpret_cast<const DataType *>(data.data());
+      DataType *vals = values();
+      // assumes m_select and f_select have same number of points
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx = m_iter.next_lin_indx() * num_elements_;
+        std::size_t f_indx = f_iter.next_lin_indx() * num_elements_;
+        for (std::size_t i = 0; i < num_elements_; ++i) {
+          vals[f_indx + i] = d_vals[m_indx + i];
+        }
+      }
+    }
+  }
+
+  /// \brief transfer data from data storage
+  /// \param data contiguous block of data to transfer
+  /// \param m_select Selection ojbect: how to select to data argument
+  /// \param f_select Selection ojbect: how to select from storage
+  void read(gsl::span<char> data, const Selection &m_select,
+            const Selection &f_select) const override {
+    if (data.size() > 0) {
+      const char *c_vals = buffer_->data();
+      // assumes m_select and f_select have same number of points
+      std::size_t datumLen = num_elements_ * sizeof(DataType);
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx = m_iter.next_lin_indx() * datumLen;
+        std::size_t f_indx = f_iter.next_lin_indx() * datumLen;
+        for (std::size_t i = 0; i < datumLen; ++i) {
+          data[m_indx + i] = c_vals[f_indx + i];
+        }
+      }
+    }
+  }
+
+  /// \brief create a store sharing the mapping of this one until either is modified
+  VarAttrStore_Base *clone(const std::shared_ptr<MemoryCharge> &charge) const override {
+    MappedVarAttrStore<DataType> *store = new MappedVarAttrStore<DataType>(*this);
+    store->charge_ = charge;
+    return store;
+  }
+};
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
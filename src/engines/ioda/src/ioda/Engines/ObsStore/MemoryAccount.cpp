@@ -0,0 +1,105 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file MemoryAccount.cpp
+ * \brief Per-tree accounting of the memory held by ObsStore objects
+ */
+
+#include "./MemoryAccount.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace ioda {
+namespace ObsStore {
+namespace {
+/// Add delta to the entry for key, removing entries that drop to zero.
+void addToEntry(std::map<std::string, std::size_t> &entries, const std::string &key,
+                std::ptrdiff_t delta) {
+  std::size_t &bytes = entries[key];
+  bytes += delta;
+  if (bytes == 0) entries.erase(key);
+}
+}  // namespace
+
+//------------------------------------------------------------------------------
+void MemoryAccount::add(const std::string &group, const std::string &variable, MemoryKind kind,
+                        std::ptrdiff_t delta) {
+  switch (kind) {
+    case MemoryKind::Values:
+      stats_.valueBytes += delta;
+      break;
+    case MemoryKind::Strings:
+      stats_.stringBytes += delta;
+      break;
+    case MemoryKind::Attributes:
+      stats_.attributeBytes += delta;
+      break;
+    case MemoryKind::Mapped:
+      // Mapped pages can be written back and dropped by the kernel, so they are kept
+      // apart from process memory.
+      stats_.mappedBytes += delta;
+      return;
+  }
+  stats_.bytes += delta;
+  stats_.peakBytes = std::max(stats_.peakBytes, stats_.bytes);
+  addToEntry(stats_.groupBytes, group, delta);
+  if (!variable.empty()) addToEntry(stats_.variableBytes, variable, delta);
+}
+
+void MemoryAccount::setExternal(const std::string &name, std::size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto ientry = stats_.externalBytesByName.find(name);
+  std::size_t oldBytes = (ientry == stats_.externalBytesByName.end()) ? 0 : ientry->second;
+  if (bytes == 0) {
+    if (ientry != stats_.externalBytesByName.end()) stats_.externalBytesByName.erase(ientry);
+  } else {
+    stats_.externalBytesByName[name] = bytes;
+  }
+  stats_.externalBytes = stats_.externalBytes - oldBytes + bytes;
+  stats_.bytes = stats_.bytes - oldBytes + bytes;
+  stats_.peakBytes = std::max(stats_.peakBytes, stats_.bytes);
+}
+
+Engines::ObsStore::MemoryStatistics MemoryAccount::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+//------------------------------------------------------------------------------
+MemoryCharge::MemoryCharge(const std::shared_ptr<MemoryAccount> &account,
+                           const std::string &group, const std::string &variable)
+    : account_(account), group_(group), variable_(variable), bytes_(0) {}
+
+void MemoryCharge::add(MemoryKind kind, std::size_t bytes) noexcept {
+  std::lock_guard<std::mutex> lock(account_->mutex_);
+  // Mapped bytes are not part of the per-variable totals (see MemoryAccount::add).
+  if (kind != MemoryKind::Mapped) bytes_ += bytes;
+  account_->add(group_, variable_, kind, static_cast<std::ptrdiff_t>(bytes));
+}
+
+void MemoryCharge::release(MemoryKind kind, std::size_t bytes) noexcept {
+  std::lock_guard<std::mutex> lock(account_->mutex_);
+  if (kind != MemoryKind::Mapped) bytes_ -= bytes;
+  account_->add(group_, variable_, kind, -static_cast<std::ptrdiff_t>(bytes));
+}
+
+void MemoryCharge::rename(const std::string &variable) {
+  std::lock_guard<std::mutex> lock(account_->mutex_);
+  std::map<std::string, std::size_t> &entries = account_->stats_.variableBytes;
+  if (bytes_ > 0) {
+    addToEntry(entries, variable_, -static_cast<std::ptrdiff_t>(bytes_));
+    addToEntry(entries, variable, static_cast<std::ptrdiff_t>(bytes_));
+  }
+  variable_ = variable;
+}
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
@@ -0,0 +1,167 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file MemoryAccount.hpp
+ * \brief Per-tree accounting of the memory held by ObsStore objects
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "ioda/Engines/ObsStore.h"
+
+namespace ioda {
+namespace ObsStore {
+/// \brief what a charged block of memory holds
+/// \ingroup ioda_internals_engines_obsstore
+enum class MemoryKind {
+  Values,      ///< numeric variable values in process memory
+  Strings,     ///< string variable dictionaries and codes
+  Attributes,  ///< attribute values
+  Mapped       ///< numeric variable values in mapped scratch files
+};
+
+/// \brief running totals of the memory held by one ObsStore tree
+/// \ingroup ioda_internals_engines_obsstore
+/// \details The totals are updated by MemoryCharge whenever a store allocates or releases
+///          memory, so reading them never has to visit the variables.
+class MemoryAccount {
+private:
+  friend class MemoryCharge;
+
+  /// \brief guards the statistics
+  mutable std::mutex mutex_;
+  /// \brief statistics
+  Engines::ObsStore::MemoryStatistics stats_;
+
+  /// \brief add delta (which may be negative) to the totals for a group and a variable
+  /// \param group full path of the group
+  /// \param variable full path of the variable (empty for the attributes of a group)
+  void add(const std::string &group, const std::string &variable, MemoryKind kind,
+           std::ptrdiff_t delta);
+
+public:
+  MemoryAccount() {}
+
+  MemoryAccount(const MemoryAccount &) = delete;
+  MemoryAccount &operator=(const MemoryAccount &) = delete;
+
+  /// \brief record the size of memory held outside the tree by its owner
+  /// \param name name of the memory; a later call with the same name replaces the size
+  /// \param bytes size in bytes (0 removes the entry)
+  void setExternal(const std::string &name, std::size_t bytes);
+
+  /// \brief snapshot of the statistics
+  Engines::ObsStore::MemoryStatistics statistics() const;
+};
+
+/// \brief charges the memory of one variable, or of the attributes of one group, to the
+///        account of its tree
+/// \ingroup ioda_internals_engines_obsstore
+/// \details A charge is shared by the store of the variable and by the buffers it
+///          allocated. Buffers shared with a clone keep their charge, so their memory is
+///          counted once, by the tree that allocated them, for as long as it is held.
+class MemoryCharge {
+private:
+  /// \brief account of the tree
+  std::shared_ptr<MemoryAccount> account_;
+  /// \brief full path of the group
+  std::string group_;
+  /// \brief full path of the variable (empty for the attributes of a group)
+  std::string variable_;
+  /// \brief bytes currently charged (guarded by the mutex of the account)
+  std::size_t bytes_;
+
+public:
+  /// \param account account of the tree
+  /// \param group full path of the group holding the object
+  /// \param variable full path of the variable (empty for the attributes of a group)
+  MemoryCharge(const std::shared_ptr<MemoryAccount> &account, const std::string &group,
+               const std::string &variable);
+
+  MemoryCharge(const MemoryCharge &) = delete;
+  MemoryCharge &operator=(const MemoryCharge &) = delete;
+
+  /// \brief record an allocation
+  void add(MemoryKind kind, std::size_t bytes) noexcept;
+  /// \brief record a release
+  void release(MemoryKind kind, std::size_t bytes) noexcept;
+  /// \brief move the charged bytes to a new variable path (in the same group)
+  void rename(const std::string &variable);
+  /// \brief account of the tree
+  const std::shared_ptr<MemoryAccount> &account() const { return account_; }
+};
+
+/// \brief size of a block of memory whose size is tracked by its owner, charged to a
+///        MemoryCharge
+/// \ingroup ioda_internals_engines_obsstore
+/// \details For stores that hold containers other than vectors with an ArenaAllocator.
+///          A copy charges its own bytes, as the owner of a copy holds a copy of the memory.
+class ChargedBytes {
+private:
+  std::shared_ptr<MemoryCharge> charge_;
+  MemoryKind kind_;
+  std::size_t bytes_;
+
+public:
+  ChargedBytes() : kind_(MemoryKind::Values), bytes_(0) {}
+  /// \param charge charge to use (nullptr: no accounting)
+  /// \param kind what the memory holds
+  ChargedBytes(const std::shared_ptr<MemoryCharge> &charge, MemoryKind kind)
+      : charge_(charge), kind_(kind), bytes_(0) {}
+  ChargedBytes(const ChargedBytes &other)
+      : charge_(other.charge_), kind_(other.kind_), bytes_(0) {
+    set(other.bytes_);
+  }
+  ChargedBytes &operator=(const ChargedBytes &other) {
+    if (this != &other) {
+      set(0);
+      charge_ = other.charge_;
+      kind_   = other.kind_;
+      set(other.bytes_);
+    }
+    return *this;
+  }
+  ~ChargedBytes() { set(0); }
+
+  /// \brief charge the memory to another charge
+  void rebind(const std::shared_ptr<MemoryCharge> &charge) {
+    std::size_t bytes = bytes_;
+    set(0);
+    charge_ = charge;
+    set(bytes);
+  }
+
+  /// \brief set the size of the memory
+  void set(std::size_t bytes) noexcept {
+    if (charge_) {
+      if (bytes > bytes_) charge_->add(kind_, bytes - bytes_);
+      if (bytes < bytes_) charge_->release(kind_, bytes_ - bytes);
+    }
+    bytes_ = bytes;
+  }
+
+  std::size_t bytes() const { return bytes_; }
+};
+
+/// \brief heap memory owned by a string (none if the value is stored in the object itself)
+/// \ingroup ioda_internals_engines_obsstore
+inline std::size_t stringHeapBytes(const std::string &value) {
+  const char *data = value.data();
+  const char *self = reinterpret_cast<const char *>(&value);
+  if ((data >= self) && (data < self + sizeof(std::string))) return 0;
+  return value.capacity() + 1;
+}
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
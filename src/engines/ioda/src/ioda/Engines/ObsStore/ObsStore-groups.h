@@ -84,6 +84,9 @@ public:
     auto backend = std::make_shared<ObsStore_Group_Backend>(backend_->open(name));
     return ::ioda::Group{backend};
   }
+
+  /// \brief the ObsStore group behind this backend
+  const std::shared_ptr<ioda::ObsStore::Group>& obsStoreGroup() const { return backend_; }
 };
 
 }  // namespace ObsStore
@@ -12,9 +12,6 @@
  */
 #include "./ObsStore-selection.h"
 
-#include <numeric>
-#include <set>
-
 #include "ioda/defs.h"
 #include "ioda/Exception.h"
 
@@ -25,6 +22,7 @@ ioda::ObsStore::Selection createObsStoreSelection(const ioda::Selection& selecti
                                                   const std::vector<Dimensions_t>& dim_sizes) {
   ioda::ObsStore::SelectionModes mode = ioda::ObsStore::SelectionModes::ALL;
   std::vector<ioda::ObsStore::SelectSpecs> dim_selects;
+  std::vector<ioda::ObsStore::SelectRanges> dim_ranges;
   std::size_t start   = 0;
   std::size_t npoints = 0;
 
@@ -51,7 +49,7 @@ ioda::ObsStore::Selection createObsStoreSelection(const ioda::Selection& selecti
       // Selection is specified as hyperslab
       mode = ioda::ObsStore::SelectionModes::INTERSECT;
       genDimSelects(first_action->start_, first_action->count_, first_action->stride_,
-                    first_action->block_, dim_selects);
+                    first_action->block_, dim_ranges);
     } else if (!first_action->points_.empty()) {
       // Selection is specified as list of points
       mode = ioda::ObsStore::SelectionModes::POINT;
@@ -59,22 +57,24 @@ ioda::ObsStore::Selection createObsStoreSelection(const ioda::Selection& selecti
     } else if (!first_action->dimension_indices_starts_.empty()) {
       // Selection is specified as dimension indices
       mode = ioda::ObsStore::SelectionModes::INTERSECT;
-      genDimSelects(selection.getActions(), dim_sizes, dim_selects);
+      genDimSelects(selection.getActions(), dim_sizes, dim_ranges);
     } else {
       throw Exception("Unrecongnized selection mode", ioda_Here());
     }
   }
 
   if (mode == ioda::ObsStore::SelectionModes::ALL) return ioda::ObsStore::Selection{start, npoints};
+  if (mode == ioda::ObsStore::SelectionModes::INTERSECT)
+    return ioda::ObsStore::Selection{dim_ranges, dim_sizes};
   return ioda::ObsStore::Selection{mode, dim_selects, dim_sizes};
 }
 
 void genDimSelects(const Selection::VecDimensions_t& start, const Selection::VecDimensions_t& count,
                    const Selection::VecDimensions_t& stride,
                    const Selection::VecDimensions_t& block,
-                   std::vector<ioda::ObsStore::SelectSpecs>& selects) {
+                   std::vector<ioda::ObsStore::SelectRanges>& selects) {
   // Walk through the start, count, stride, block specs and generate
-  // the indices for each dimension.
+  // the runs for each dimension.
   std::size_t numDims = start.size();
   selects.resize(numDims);
   for (std::size_t idim = 0; idim < numDims; ++idim) {
@@ -90,11 +90,16 @@ void genDimSelects(const Selection::VecDimensions_t& start, const Selection::Vec
       dim_block = block[idim];
     }
 
-    // Generate the dimension selects
-    for (std::size_t i = 0; i < dim_count; ++i) {
-      std::size_t block_start = dim_start + (i * dim_stride);
-      for (std::size_t j = 0; j < dim_block; ++j) {
-        selects[idim].push_back(block_start + j);
+    // Generate the dimension selects. When the blocks touch or overlap they
+    // form one run, otherwise there is one run per block.
+    selects[idim].clear();
+    if ((dim_count == 0) || (dim_block == 0)) continue;
+    if (dim_block >= dim_stride) {
+      selects[idim].emplace_back(dim_start, (dim_count - 1) * dim_stride + dim_block);
+    } else {
+      selects[idim].reserve(dim_count);
+      for (std::size_t i = 0; i < dim_count; ++i) {
+        selects[idim].emplace_back(dim_start + (i * dim_stride), dim_block);
       }
     }
   }
@@ -121,45 +126,48 @@ void genDimSelects(const std::vector<Selection::VecDimensions_t>& points,
 
 void genDimSelects(const std::vector<Selection::SingleSelection>& actions,
                    const std::vector<Dimensions_t>& dim_sizes,
-                   std::vector<ioda::ObsStore::SelectSpecs>& selects) {
+                   std::vector<ioda::ObsStore::SelectRanges>& selects) {
   // Initialize selects to the same rank as dim_sizes. Fill in the dimension
-  // indices according to the selections actions. Then if any dimensions have
+  // runs according to the selections actions. Then if any dimensions have
   // not been filled, set their selections to all of the indices in
   // that dimension.
-  selects.resize(dim_sizes.size());
+  selects.assign(dim_sizes.size(), ioda::ObsStore::SelectRanges());
+  std::vector<bool> dimSelected(dim_sizes.size(), false);
 
-  // Each element in actions is a list of indices for a particular dimension
-  for (std::size_t iact = 0; iact < actions.size(); ++iact) {
-    // Create an ordered set of indices (in case the starts and counts overlap)
-    // Then copy the set into the selects structure.
-    std::set<std::size_t> dim_indices;
-    bool haveCounts = (!actions[iact].dimension_indices_counts_.empty());
-    for (std::size_t i = 0; i < actions[iact].dimension_indices_starts_.size(); ++i) {
-      std::size_t idx = actions[iact].dimension_indices_starts_[i];
-      if (haveCounts) {
-        for (std::size_t j = 0; j < actions[iact].dimension_indices_counts_.size(); ++j) {
-          dim_indices.insert(idx + j);
-        }
-      } else {
-        dim_indices.insert(idx);
-      }
+  // Each element in actions is a list of index runs for a particular dimension
+  for (const auto& action : actions) {
+    // Gather the runs for this action and normalize them (in case the starts and
+    // counts overlap or are out of order). A missing count means a run of length 1.
+    ioda::ObsStore::SelectRanges actionRanges;
+    actionRanges.reserve(action.dimension_indices_starts_.size());
+    for (std::size_t i = 0; i < action.dimension_indices_starts_.size(); ++i) {
+      std::size_t count = (i < action.dimension_indices_counts_.size())
+                        ? action.dimension_indices_counts_[i] : 1;
+      actionRanges.emplace_back(action.dimension_indices_starts_[i], count);
     }
+    ioda::ObsStore::normalizeSelectRanges(actionRanges);
 
-    // copy the set of indices into the selects structure
-    std::size_t idim = actions[iact].dimension_;
-    selects[idim].resize(dim_indices.size());
-    std::size_t iidx = 0;
-    for (auto iset = dim_indices.begin(); iset != dim_indices.end(); ++iset) {
-      selects[idim][iidx] = *iset;
-      iidx++;
+    // Combine with any earlier selection on the same dimension
+    std::size_t idim = action.dimension_;
+    if (idim >= selects.size())
+      throw Exception("Selection dimension is out of range", ioda_Here())
+        .add("dimension", idim).add("rank", selects.size());
+    if (!dimSelected[idim]) {
+      selects[idim].swap(actionRanges);
+    } else if (action.op_ == SelectionOperator::OR) {
+      selects[idim] = ioda::ObsStore::unionSelectRanges(selects[idim], actionRanges);
+    } else if (action.op_ == SelectionOperator::AND) {
+      selects[idim] = ioda::ObsStore::intersectSelectRanges(selects[idim], actionRanges);
+    } else {
+      selects[idim].swap(actionRanges);
     }
+    dimSelected[idim] = true;
   }
 
-  // For any unfilled dimensions, insert all indices.
+  // For any unfilled dimensions, select all indices as a single run.
   for (std::size_t idim = 0; idim < selects.size(); ++idim) {
-    if (selects[idim].empty()) {
-      selects[idim].resize(dim_sizes[idim]);
-      std::iota(selects[idim].begin(), selects[idim].end(), 0);
+    if (!dimSelected[idim] && (dim_sizes[idim] > 0)) {
+      selects[idim].emplace_back(0, dim_sizes[idim]);
     }
   }
 }
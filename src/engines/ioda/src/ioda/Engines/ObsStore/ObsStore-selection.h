@@ -26,23 +26,28 @@ namespace ObsStore {
 ioda::ObsStore::Selection createObsStoreSelection(const ioda::Selection& selection,
                                                   const std::vector<Dimensions_t>& dim_sizes);
 
-/// \brief generate the dimension selection structure from hyperslab specs
+/// \brief generate the dimension selection runs from hyperslab specs
+/// \details Produces at most one run per block in each dimension, and a single run
+///          when the blocks are contiguous (block >= stride).
 /// \ingroup ioda_internals_engines_obsstore
 void genDimSelects(const Selection::VecDimensions_t& start, const Selection::VecDimensions_t& count,
                    const Selection::VecDimensions_t& stride,
                    const Selection::VecDimensions_t& block,
-                   std::vector<ioda::ObsStore::SelectSpecs>& selects);
+                   std::vector<ioda::ObsStore::SelectRanges>& selects);
 
 /// \brief generate the dimension selection structure from point specs
 /// \ingroup ioda_internals_engines_obsstore
 void genDimSelects(const std::vector<Selection::VecDimensions_t>& points,
                    std::vector<ioda::ObsStore::SelectSpecs>& selects);
 
-/// \brief generate the dimension selection structure from dimension index specs
+/// \brief generate the dimension selection runs from dimension index specs
+/// \details Actions on the same dimension are combined with union (OR) or
+///          intersection (AND) on the runs. Any other operator replaces the
+///          selection for that dimension.
 /// \ingroup ioda_internals_engines_obsstore
 void genDimSelects(const std::vector<Selection::SingleSelection>& actions,
                    const std::vector<Dimensions_t>& dim_sizes,
-                   std::vector<ioda::ObsStore::SelectSpecs>& selects);
+                   std::vector<ioda::ObsStore::SelectRanges>& selects);
 }  // namespace ObsStore
 }  // namespace Engines
 }  // namespace ioda
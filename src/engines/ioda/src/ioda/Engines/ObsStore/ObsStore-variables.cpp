@@ -11,6 +11,9 @@
  * \brief Functions for ioda::Variable and ioda::Has_Variables backed by ObsStore
  */
 #include "./ObsStore-variables.h"
+
+#include <limits>
+
 #include "ioda/Exception.h"
 
 namespace ioda {
@@ -237,6 +240,24 @@ Variable ObsStore_Variable_Backend::read(gsl::span<char> data, const Type& in_me
   return Variable{std::make_shared<ObsStore_Variable_Backend>(*this)};
 }
 
+bool ObsStore_Variable_Backend::readDictionaryEncoded(std::vector<int>& codes,
+                                                      std::vector<std::string>& dictionary,
+                                                      const Selection& file_selection) const {
+  ioda::ObsStore::Selection f_select
+    = createObsStoreSelection(file_selection, backend_->get_dimensions());
+
+  std::vector<ioda::ObsStore::DictionaryVarAttrStore::Code> storeCodes;
+  std::vector<std::string> storeDictionary;
+  if (!backend_->readCodes(storeCodes, storeDictionary, f_select)) return false;
+
+  if (storeDictionary.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+    throw Exception("Too many distinct strings to return as int codes", ioda_Here())
+      .add("dictionary size", storeDictionary.size());
+  codes.assign(storeCodes.begin(), storeCodes.end());
+  dictionary.swap(storeDictionary);
+  return true;
+}
+
 //*************************************************************************
 // ObsStore_HasVariables_Backend functions
 //*************************************************************************
@@ -285,12 +306,7 @@ Variable ObsStore_HasVariables_Backend::create(const std::string& name,
   // Convert to obs store create parameters.
   ioda::ObsStore::VarCreateParams os_params;
 
-  os_params.fvdata        = params.fillValue_;
-  const auto fvdata_final = params.finalize();  // Using in a span. Keep in scope.
-  if (os_params.fvdata.set_) {
-    os_params.fill_value
-      = gsl::make_span<char>((char*)&(fvdata_final), sizeof(fvdata_final));  // NOLINT
-  }
+  os_params.fvdata = params.fillValue_;
 
   // Call backend create
   auto res = backend_->create(name, std::make_shared<ioda::ObsStore::Type>(dtype),
@@ -131,6 +131,12 @@ public:
   /// \param file_selection ioda::Selection for incoming Variable data
   Variable read(gsl::span<char> data, const Type& in_memory_dataType,
                 const Selection& mem_selection, const Selection& file_selection) const final;
+  /// \brief transfer dictionary codes from a string ObsStore Variable
+  /// \param codes one code per selected element
+  /// \param dictionary distinct values, indexed by code
+  /// \param file_selection ioda::Selection for incoming Variable data
+  bool readDictionaryEncoded(std::vector<int>& codes, std::vector<std::string>& dictionary,
+                             const Selection& file_selection) const final;
 };
 
 /// \brief This is the implementation of Has_Variables in ioda::ObsStore
@@ -12,8 +12,12 @@
  */
 #include "ioda/Engines/ObsStore.h"
 
+#include <cstdlib>
+#include <ostream>
+
 #include "./Group.hpp"
 #include "./ObsStore-groups.h"
+#include "ioda/Copying.h"
 #include "ioda/Group.h"
 
 namespace ioda {
@@ -26,15 +30,121 @@ Group createRootGroup() {
   return ::ioda::Group{backend};
 }
 
-Capabilities getCapabilities() {
-  static Capabilities caps;
-  static bool inited = false;
-  if (!inited) {
-    caps.canChunk            = Capability_Mask::Ignored;
-    caps.canCompressWithGZIP = Capability_Mask::Ignored;
-    caps.canCompressWithSZIP = Capability_Mask::Ignored;
-    caps.MPIaware            = Capability_Mask::Unsupported;
+Group createRootGroup(const StorageParameters& storage) {
+  auto backend = std::make_shared<ObsStore_Group_Backend>(
+    ioda::ObsStore::Group::createRootGroup(storage));
+  return ::ioda::Group{backend};
+}
+
+StorageKind StorageParameters::lookup(const std::string& varPath) const {
+  // Try the variable itself, then each enclosing group from the nearest outwards.
+  std::string path = varPath;
+  while (!path.empty()) {
+    auto ipolicy = policies.find(path);
+    if (ipolicy != policies.end()) return ipolicy->second;
+    auto pos = path.find_last_of('/');
+    path = (pos == std::string::npos) ? std::string() : path.substr(0, pos);
+  }
+  return defaultKind;
+}
+
+std::string StorageParameters::scratchPath() const {
+  if (!scratchDirectory.empty()) return scratchDirectory;
+  const char* tmpdir = std::getenv("TMPDIR");
+  if ((tmpdir != nullptr) && (tmpdir[0] != '\0')) return std::string(tmpdir);
+  return std::string("/tmp");
+}
+
+Group cloneGroup(const Group& group) {
+  auto backend = std::dynamic_pointer_cast<ObsStore_Group_Backend>(group.getBackend());
+  if (!backend) {
+    // Other engines: copy the data.
+    Group copy = createRootGroup();
+    copyGroup(group, copy);
+    return copy;
+  }
+  auto cloneBackend =
+    std::make_shared<ObsStore_Group_Backend>(backend->obsStoreGroup()->clone());
+  return ::ioda::Group{cloneBackend};
+}
+
+bool getArenaStatistics(const Group& group, ArenaStatistics& stats) {
+  auto backend = std::dynamic_pointer_cast<ObsStore_Group_Backend>(group.getBackend());
+  if (!backend) return false;
+  std::shared_ptr<ioda::ObsStore::Arena> arena = backend->obsStoreGroup()->arena();
+  if (!arena) return false;
+  stats = arena->statistics();
+  return true;
+}
+
+std::ostream& operator<<(std::ostream& os, const ArenaStatistics& stats) {
+  os << "live allocations: " << stats.liveAllocations
+     << ", total allocations: " << stats.totalAllocations
+     << ", cache hits: " << stats.cacheHits
+     << ", bytes in use: " << stats.bytesInUse
+     << " (heap: " << stats.heapBytes << ")"
+     << ", bytes mapped: " << stats.mappedBytes
+     << " (peak: " << stats.peakMappedBytes
+     << ", huge pages: " << stats.hugePageBytes
+     << ", cached: " << stats.cachedBytes << ")";
+  return os;
+}
+
+bool getMemoryStatistics(const Group& group, MemoryStatistics& stats) {
+  auto backend = std::dynamic_pointer_cast<ObsStore_Group_Backend>(group.getBackend());
+  if (!backend) return false;
+  std::shared_ptr<ioda::ObsStore::MemoryAccount> account = backend->obsStoreGroup()->account();
+  if (!account) return false;
+  stats = account->statistics();
+  return true;
+}
+
+bool compactGroup(const Group& group) {
+  auto backend = std::dynamic_pointer_cast<ObsStore_Group_Backend>(group.getBackend());
+  if (!backend) return false;
+  backend->obsStoreGroup()->compact();
+  return true;
+}
+
+bool setExternalBytes(const Group& group, const std::string& name, std::size_t bytes) {
+  auto backend = std::dynamic_pointer_cast<ObsStore_Group_Backend>(group.getBackend());
+  if (!backend) return false;
+  std::shared_ptr<ioda::ObsStore::MemoryAccount> account = backend->obsStoreGroup()->account();
+  if (!account) return false;
+  account->setExternal(name, bytes);
+  return true;
+}
+
+std::ostream& operator<<(std::ostream& os, const MemoryStatistics& stats) {
+  os << "bytes: " << stats.bytes
+     << " (peak: " << stats.peakBytes
+     << ", values: " << stats.valueBytes
+     << ", strings: " << stats.stringBytes
+     << ", attributes: " << stats.attributeBytes
+     << ", external: " << stats.externalBytes << ")"
+     << ", bytes mapped: " << stats.mappedBytes
+     << ", by group:";
+  for (const auto& igroup : stats.groupBytes)
+    os << " " << (igroup.first.empty() ? std::string("/") : igroup.first) << "=" << igroup.second;
+  if (!stats.externalBytesByName.empty()) {
+    os << ", external by name:";
+    for (const auto& iexternal : stats.externalBytesByName)
+      os << " " << iexternal.first << "=" << iexternal.second;
   }
+  return os;
+}
+
+Capabilities getCapabilities() {
+  // Initialized once (thread-safe static initialization), so that concurrent
+  // callers only ever read caps.
+  static const Capabilities caps = []() {
+    Capabilities c;
+    c.canChunk            = Capability_Mask::Ignored;
+    c.canCompressWithGZIP = Capability_Mask::Ignored;
+    c.canCompressWithSZIP = Capability_Mask::Ignored;
+    c.MPIaware            = Capability_Mask::Unsupported;
+    return c;
+  }();
 
   return caps;
 }
@@ -0,0 +1,40 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! \addtogroup ioda_internals_engines_obsstore
+ *
+ * @{
+ * \file PathIndex.hpp
+ * \brief Full-path lookup index for ObsStore Groups and Variables
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace ioda {
+namespace ObsStore {
+class Group;
+class Variable;
+
+/// \brief index of every group and variable in an ObsStore tree, keyed by full path
+/// \ingroup ioda_internals_engines_obsstore
+/// \details One PathIndex is shared by the root group and all of its descendants.
+///          Keys are paths relative to the root without a leading or trailing '/',
+///          e.g. "MetaData" for a group and "MetaData/latitude" for a variable. The
+///          Group and Has_Variables containers keep the index consistent on create,
+///          remove and rename so that open and exists are a single hash lookup.
+struct PathIndex {
+  /// \brief groups by full path (weak to avoid a cycle with the groups holding the index)
+  std::unordered_map<std::string, std::weak_ptr<Group>> groups;
+  /// \brief variables by full path
+  std::unordered_map<std::string, std::shared_ptr<Variable>> variables;
+};
+}  // namespace ObsStore
+}  // namespace ioda
+
+/// @}
@@ -11,6 +11,8 @@
  * \brief Functions for ObsStore Selection
  */
 
+#include <algorithm>
+
 #include "gsl/gsl-lite.hpp"
 
 #include "./Selection.hpp"
@@ -18,6 +20,75 @@
 
 namespace ioda {
 namespace ObsStore {
+//*************************************************************************
+//           SelectRanges functions
+//*************************************************************************
+void appendSelectRange(SelectRanges& ranges, const SelectRange& range) {
+  if (range.count == 0) return;
+  if (!ranges.empty() && (range.start <= ranges.back().end())) {
+    // Overlaps or touches the last run --> extend the last run
+    SelectRange& last = ranges.back();
+    last.count        = std::max(last.end(), range.end()) - last.start;
+  } else {
+    ranges.push_back(range);
+  }
+}
+
+void normalizeSelectRanges(SelectRanges& ranges) {
+  std::sort(ranges.begin(), ranges.end(), [](const SelectRange& a, const SelectRange& b) {
+    return a.start < b.start;
+  });
+  SelectRanges merged;
+  merged.reserve(ranges.size());
+  for (const auto& range : ranges) {
+    appendSelectRange(merged, range);
+  }
+  ranges.swap(merged);
+}
+
+SelectRanges unionSelectRanges(const SelectRanges& lhs, const SelectRanges& rhs) {
+  // Merge step of a merge sort, coalescing runs as they are appended.
+  SelectRanges result;
+  result.reserve(lhs.size() + rhs.size());
+  auto ilhs = lhs.begin();
+  auto irhs = rhs.begin();
+  while ((ilhs != lhs.end()) || (irhs != rhs.end())) {
+    if ((irhs == rhs.end()) || ((ilhs != lhs.end()) && (ilhs->start <= irhs->start))) {
+      appendSelectRange(result, *ilhs++);
+    } else {
+      appendSelectRange(result, *irhs++);
+    }
+  }
+  return result;
+}
+
+SelectRanges intersectSelectRanges(const SelectRanges& lhs, const SelectRanges& rhs) {
+  // Walk both lists, always advancing the run that ends first.
+  SelectRanges result;
+  auto ilhs = lhs.begin();
+  auto irhs = rhs.begin();
+  while ((ilhs != lhs.end()) && (irhs != rhs.end())) {
+    const std::size_t start = std::max(ilhs->start, irhs->start);
+    const std::size_t end   = std::min(ilhs->end(), irhs->end());
+    if (start < end) {
+      result.emplace_back(start, end - start);
+    }
+    if (ilhs->end() < irhs->end()) {
+      ++ilhs;
+    } else {
+      ++irhs;
+    }
+  }
+  return result;
+}
+
+std::size_t countSelectRanges(const SelectRanges& ranges) {
+  std::size_t count = 0;
+  for (const auto& range : ranges) {
+    count += range.count;
+  }
+  return count;
+}
 
 //*************************************************************************
 //           SelectCounter functions
@@ -29,12 +100,13 @@ void SelectCounter::reset(const SelectionModes mode, const std::vector<std::size
   digit_sizes_ = digit_sizes;
   ndigits_     = digit_sizes.size();
   digits_.assign(digit_sizes.size(), 0);
-  counter_end_ = false;
+  // An empty digit place means there is nothing to count
+  counter_end_ = (std::find(digit_sizes.begin(), digit_sizes.end(), 0) != digit_sizes.end());
 }
 
 void SelectCounter::inc() {
   if (mode_ == SelectionModes::POINT) {
-    if (digits_[0] == ndigits_ - 1) {
+    if (digits_[0] == digit_sizes_[0] - 1) {
       // about to overflow the counter --> done
       counter_end_ = true;
       return;
@@ -75,7 +147,7 @@ const std::vector<std::size_t>& SelectCounter::count() const { return digits_; }
 Selection::Selection(const std::size_t start, const std::size_t npoints)
     : mode_(SelectionModes::ALL),
       end_(gsl::narrow<int>(start + npoints) - 1),
-      index_(0), npoints_(npoints) {
+      npoints_(npoints) {
   max_index_ = end_;
 }
 
@@ -83,17 +155,27 @@ Selection::Selection(const SelectionModes mode, const std::vector<SelectSpecs>&
                      const std::vector<Dimensions_t>& dim_sizes)
     : mode_(mode),
       end_(0),
-      index_(0),
       npoints_(1),
       max_index_(1),
-      dim_selects_(dim_selects),
-      dim_sizes_(dim_sizes),
-      // dim_select_sizes
-      counter_(std::unique_ptr<SelectCounter>(new SelectCounter)) {
+      dim_sizes_(dim_sizes) {
+  if (mode == SelectionModes::INTERSECT) {
+    // Convert the index lists to runs
+    dim_ranges_.resize(dim_selects.size());
+    for (std::size_t i = 0; i < dim_selects.size(); ++i) {
+      for (const auto index : dim_selects[i]) {
+        dim_ranges_[i].emplace_back(index, 1);
+      }
+      normalizeSelectRanges(dim_ranges_[i]);
+    }
+  } else {
+    dim_selects_ = dim_selects;
+  }
+
   // record the sizes of each dimension selection
   dim_select_sizes_.clear();
-  for (std::size_t i = 0; i < dim_selects_.size(); ++i) {
-    std::size_t dim_select_size = dim_selects_[i].size();
+  for (std::size_t i = 0; i < dim_selects.size(); ++i) {
+    std::size_t dim_select_size = (mode == SelectionModes::INTERSECT)
+                                ? countSelectRanges(dim_ranges_[i]) : dim_selects_[i].size();
     dim_select_sizes_.push_back(dim_select_size);
     if ((i == 0) || (mode == SelectionModes::INTERSECT)) {
       npoints_ *= dim_select_size;
@@ -107,64 +189,125 @@ Selection::Selection(const SelectionModes mode, const std::vector<SelectSpecs>&
   max_index_--;
 }
 
+Selection::Selection(const std::vector<SelectRanges>& dim_ranges,
+                     const std::vector<Dimensions_t>& dim_sizes)
+    : mode_(SelectionModes::INTERSECT),
+      end_(0),
+      npoints_(1),
+      max_index_(1),
+      dim_ranges_(dim_ranges),
+      dim_sizes_(dim_sizes) {
+  // The number of points is the product of the run lengths summed over each dimension.
+  dim_select_sizes_.clear();
+  for (std::size_t i = 0; i < dim_ranges_.size(); ++i) {
+    std::size_t dim_select_size = countSelectRanges(dim_ranges_[i]);
+    dim_select_sizes_.push_back(dim_select_size);
+    npoints_ *= dim_select_size;
+
+    max_index_ *= dim_sizes[i];
+  }
+  // See above: convert the total number of points into the maximum allowed index.
+  max_index_--;
+}
+
 Selection::Selection() = default;
 
 SelectionModes Selection::mode() const { return mode_; }
 
+std::size_t Selection::npoints() const { return npoints_; }
+
+//*************************************************************************
+//           SelectIterator functions
+//*************************************************************************
 // Following are a set of functions that provide an iterator style capability
 // that generates the linear memory indices correspoding to the selection
-// settings. The linear memory indices are generated by creating a counter
+// settings.
+//
+// For POINT mode, the linear memory indices are generated by creating a counter
 // with the same number of digits as the size of the dim_selects_ vector, and
 // making the maximum values of each digit place match the size of the corresponding
-// subvector in dim_selects_. This yields the same sequence as running through
-// nested for loops that walk through the dim_selects_ structure.
-void Selection::init_lin_indx() {
-  if (mode_ == SelectionModes::ALL) {
-    index_ = 0;
-  } else {
-    counter_->reset(mode_, dim_select_sizes_);
+// subvector in dim_selects_.
+//
+// For INTERSECT mode, each dimension keeps a position (run number plus offset
+// into that run) in its dim_ranges_ entry, and the positions are advanced like
+// the digits of a counter. Both yield the same sequence as running through
+// nested for loops that walk through the selected indices of each dimension.
+SelectIterator::SelectIterator(const Selection& select) : select_(select) {
+  if (select_.mode_ == SelectionModes::INTERSECT) {
+    range_pos_.assign(select_.dim_ranges_.size(), 0);
+    range_offset_.assign(select_.dim_ranges_.size(), 0);
+    ranges_end_ = (select_.npoints_ == 0);
+  } else if (select_.mode_ == SelectionModes::POINT) {
+    counter_.reset(select_.mode_, select_.dim_select_sizes_);
   }
 }
 
-std::size_t Selection::next_lin_indx() {
+std::size_t SelectIterator::next_lin_indx() {
   std::size_t lin_index = 0;
-  if (mode_ == SelectionModes::ALL) {
+  if (select_.mode_ == SelectionModes::ALL) {
     lin_index = index_;
     index_++;
+  } else if (select_.mode_ == SelectionModes::INTERSECT) {
+    const std::vector<SelectRanges>& dim_ranges = select_.dim_ranges_;
+
+    // Calculate linear index from current run positions
+    lin_index = dim_ranges[0][range_pos_[0]].start + range_offset_[0];
+    for (std::size_t i = 1; i < dim_ranges.size(); ++i) {
+      lin_index *= select_.dim_sizes_[i];
+      lin_index += dim_ranges[i][range_pos_[i]].start + range_offset_[i];
+    }
+
+    // Advance the least significant dimension for next time around,
+    // carrying into the more significant dimensions as runs are exhausted.
+    std::size_t idim = dim_ranges.size() - 1;
+    while (true) {
+      range_offset_[idim]++;
+      if (range_offset_[idim] < dim_ranges[idim][range_pos_[idim]].count) break;
+      range_offset_[idim] = 0;
+      range_pos_[idim]++;
+      if (range_pos_[idim] < dim_ranges[idim].size()) break;
+      range_pos_[idim] = 0;
+      if (idim == 0) {
+        ranges_end_ = true;
+        break;
+      }
+      idim--;
+    }
   } else {
+    const std::vector<SelectSpecs>& dim_selects = select_.dim_selects_;
+
     // Calculate linear index from current count
-    const std::vector<std::size_t>& curCount = counter_->count();
-    lin_index                                = dim_selects_[0][curCount[0]];
-    for (std::size_t i = 1; i < dim_selects_.size(); ++i) {
-      lin_index *= dim_sizes_[i];
-      lin_index += dim_selects_[i][curCount[i]];
+    const std::vector<std::size_t>& curCount = counter_.count();
+    lin_index                                = dim_selects[0][curCount[0]];
+    for (std::size_t i = 1; i < dim_selects.size(); ++i) {
+      lin_index *= select_.dim_sizes_[i];
+      lin_index += dim_selects[i][curCount[i]];
     }
 
     // increment counter for next time around
-    counter_->inc();
+    counter_.inc();
   }
 
   // Make sure lin_index_ is in bounds.
-  if (lin_index > max_index_)
+  if (lin_index > select_.max_index_)
     throw Exception("Next linear index is out of bounds.", ioda_Here())
       .add("  Next linear index: ", lin_index)
-      .add("  Maximum allowed index: ", max_index_);
+      .add("  Maximum allowed index: ", select_.max_index_);
 
   return lin_index;
 }
 
-bool Selection::end_lin_indx() const {
+bool SelectIterator::end_lin_indx() const {
   bool finished = false;
-  ;
-  if (mode_ == SelectionModes::ALL) {
-    finished = (index_ > end_);
+  if (select_.mode_ == SelectionModes::ALL) {
+    finished = (index_ > select_.end_);
+  } else if (select_.mode_ == SelectionModes::INTERSECT) {
+    finished = ranges_end_;
   } else {
-    finished = counter_->finished();
+    finished = counter_.finished();
   }
   return finished;
 }
-
-std::size_t Selection::npoints() const { return npoints_; }
 }  // namespace ObsStore
 }  // namespace ioda
 
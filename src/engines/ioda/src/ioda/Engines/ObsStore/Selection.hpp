@@ -27,11 +27,55 @@ namespace ObsStore {
 /// \ingroup ioda_internals_engines_obsstore
 typedef std::vector<std::size_t> SelectSpecs;
 
+/// \brief contiguous run of selected indices along one dimension
+/// \ingroup ioda_internals_engines_obsstore
+/// \details Represents the indices start, start+1, ..., start+count-1.
+struct SelectRange {
+  std::size_t start = 0;
+  std::size_t count = 0;
+
+  SelectRange() = default;
+  SelectRange(const std::size_t s, const std::size_t c) : start(s), count(c) {}
+
+  /// \brief one past the last index in the run
+  std::size_t end() const { return start + count; }
+};
+
+/// \brief container of selection runs for one dimension
+/// \ingroup ioda_internals_engines_obsstore
+/// \details Unless noted otherwise, the functions below expect and produce
+///          normalized run lists: sorted by start, non-empty, and with no two runs
+///          overlapping or touching. The cost of the algebra on these lists is
+///          proportional to the number of runs, not the number of selected indices.
+typedef std::vector<SelectRange> SelectRanges;
+
+/// \brief append a run to a list that is sorted by start, merging with the last run
+///        when they overlap or touch
+/// \ingroup ioda_internals_engines_obsstore
+void appendSelectRange(SelectRanges& ranges, const SelectRange& range);
+
+/// \brief sort and merge an arbitrary list of runs into normalized form
+/// \ingroup ioda_internals_engines_obsstore
+void normalizeSelectRanges(SelectRanges& ranges);
+
+/// \brief union of two normalized run lists
+/// \ingroup ioda_internals_engines_obsstore
+SelectRanges unionSelectRanges(const SelectRanges& lhs, const SelectRanges& rhs);
+
+/// \brief intersection of two normalized run lists
+/// \ingroup ioda_internals_engines_obsstore
+SelectRanges intersectSelectRanges(const SelectRanges& lhs, const SelectRanges& rhs);
+
+/// \brief total number of indices covered by a normalized run list
+/// \ingroup ioda_internals_engines_obsstore
+std::size_t countSelectRanges(const SelectRanges& ranges);
+
 /// \brief ObsStore selection modes
 /// \ingroup ioda_internals_engines_obsstore
 /// \details Selection mode meanings
 ///     ALL - select all points
-///     INTERSECT - select points in intersection of dim indices
+///     INTERSECT - select points in intersection of dim indices (the dim
+///                 indices are held as runs, see SelectRanges)
 ///                 if dim indices are
 ///                     dim 0: 1, 7, 8
 ///                     dim 1: 2, 4, 10
@@ -89,49 +133,81 @@ public:
 };
 
 /// \ingroup ioda_internals_engines_obsstore
+/// \details A Selection is immutable once constructed. The state for walking through
+///          its linear memory indices lives in a SelectIterator, so one Selection may
+///          be shared by any number of concurrent readers.
 class Selection {
 private:
+  friend class SelectIterator;
+
   /// \brief mode of selection (which impacts how linear memory is accessed)
   SelectionModes mode_ = SelectionModes::ALL;
 
   /// \brief end of selection for ALL mode
-  int end_ = 0;
-  /// \brief index value for ALL mode
-  int index_ = 0;
+  int end_ = -1;
 
   /// \brief total number of points in selection
   std::size_t npoints_ = 0;
   /// \brief maximum allowed index value
   std::size_t max_index_ = 0;
 
-  /// \brief selection indices for each dimension
+  /// \brief selection indices for each dimension (POINT mode)
   std::vector<SelectSpecs> dim_selects_;
+  /// \brief selection runs for each dimension (INTERSECT mode)
+  std::vector<SelectRanges> dim_ranges_;
   /// \brief sizes of data dimensions (length is rank of dimensions)
   std::vector<Dimensions_t> dim_sizes_;
   /// \brief number of dimension selections per dimension
   std::vector<std::size_t> dim_select_sizes_;
 
-  /// \brief counter for generating linear memory indices
-  std::unique_ptr<SelectCounter> counter_;
-
 public:
   Selection(const std::size_t start, const std::size_t npoints);
+  /// \brief explicit index selection
+  /// \details An INTERSECT mode selection given as index lists is converted to runs.
   Selection(const SelectionModes mode, const std::vector<SelectSpecs>& dim_selects,
             const std::vector<Dimensions_t>& dim_sizes);
+  /// \brief INTERSECT mode selection given as normalized runs for each dimension
+  Selection(const std::vector<SelectRanges>& dim_ranges,
+            const std::vector<Dimensions_t>& dim_sizes);
   Selection();
 
   /// \brief returns selection mode
   SelectionModes mode() const;
 
+  /// \brief returns number of points in selection
+  std::size_t npoints() const;
+};
+
+/// \ingroup ioda_internals_engines_obsstore
+/// \brief walks through the linear memory indices of a Selection
+/// \details Holds all of the iteration state, so each data transfer makes its own
+///          SelectIterator objects on the stack. The Selection must outlive the iterator.
+class SelectIterator {
+private:
+  /// \brief selection being walked
+  const Selection& select_;
+
+  /// \brief index value for ALL mode
+  int index_ = 0;
+
+  /// \brief counter for generating linear memory indices (POINT mode)
+  SelectCounter counter_;
+
+  /// \brief current run, per dimension (INTERSECT mode)
+  std::vector<std::size_t> range_pos_;
+  /// \brief current offset into the current run, per dimension (INTERSECT mode)
+  std::vector<std::size_t> range_offset_;
+  /// \brief true when finished walking the runs (INTERSECT mode)
+  bool ranges_end_ = false;
+
+public:
   /// \brief initializes iterator for walking through linear memory indices
-  void init_lin_indx();
+  explicit SelectIterator(const Selection& select);
+
   /// \brief returns next linear memory index
   std::size_t next_lin_indx();
   /// \brief returns true when at the end of the linear memory indices
   bool end_lin_indx() const;
-
-  /// \brief returns number of points in selection
-  std::size_t npoints() const;
 };
 }  // namespace ObsStore
 }  // namespace ioda
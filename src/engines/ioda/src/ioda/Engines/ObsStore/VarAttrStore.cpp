@@ -14,75 +14,122 @@
 #include "./VarAttrStore.hpp"
 
 #include <exception>
+#include <utility>
 
+#include "./ChunkedVarAttrStore.hpp"
+#include "./CompressedVarAttrStore.hpp"
+#include "./DictionaryVarAttrStore.hpp"
+#include "./MappedVarAttrStore.hpp"
 #include "./Type.hpp"
 #include "ioda/Exception.h"
 
 namespace ioda {
 namespace ObsStore {
-//------------------------------------------------------------------------------
-VarAttrStore_Base *createVarAttrStore(const std::shared_ptr<Type> & dtype) {
-  VarAttrStore_Base *newStore = nullptr;
-
-  // Get the fundamental (base) type marker. In the case of an arrayed type,
-  // the fundamental type mark is in the base type data member of dtype.
+namespace {
+/// \brief fundamental (base) type marker of a data type
+/// \details In the case of an arrayed type, the fundamental type mark is in the
+///          base type data member of dtype.
+ObsTypes getBaseObsType(const std::shared_ptr<Type> & dtype) {
   ObsTypes topLevelType = dtype->getType();
-  ObsTypes baseType;
   if (topLevelType == ObsTypes::ARRAY) {
-    baseType = dtype->getBaseType()->getType();
-  } else {
-    baseType = topLevelType;
+    return dtype->getBaseType()->getType();
   }
+  return topLevelType;
+}
 
-  // Record the number of elements in the type. For fundamental types this would be 1,
-  // and for arrayed types this would be determined according to the dimension sizes.
-  std::size_t numElements = dtype->getNumElements();
-
-  // Use the baseType value to determine which templated version of the data store
-  // to instantiate.
+/// \brief instantiate Store<T> for the fundamental type T that baseType refers to
+/// \details Returns nullptr for strings, which each store handles on its own.
+template <template <typename> class Store, typename... Args>
+VarAttrStore_Base *newFundamentalStore(ObsTypes baseType, Args&&... args) {
+  VarAttrStore_Base *newStore = nullptr;
   if (baseType == ObsTypes::FLOAT) {
-    newStore = new VarAttrStore<float>(numElements);
+    newStore = new Store<float>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::DOUBLE) {
-    newStore = new VarAttrStore<double>(numElements);
+    newStore = new Store<double>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::LDOUBLE) {
-    newStore = new VarAttrStore<long double>(numElements);
+    newStore = new Store<long double>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::SCHAR) {
-    newStore = new VarAttrStore<signed char>(numElements);
+    newStore = new Store<signed char>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::SHORT) {
-    newStore = new VarAttrStore<short>(numElements);
+    newStore = new Store<short>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::INT) {
-    newStore = new VarAttrStore<int>(numElements);
+    newStore = new Store<int>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::LONG) {
-    newStore = new VarAttrStore<long>(numElements);
+    newStore = new Store<long>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::LLONG) {
-    newStore = new VarAttrStore<long long>(numElements);
+    newStore = new Store<long long>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::UCHAR) {
-    newStore = new VarAttrStore<unsigned char>(numElements);
+    newStore = new Store<unsigned char>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::USHORT) {
-    newStore = new VarAttrStore<unsigned short>(numElements);
+    newStore = new Store<unsigned short>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::UINT) {
-    newStore = new VarAttrStore<unsigned int>(numElements);
+    newStore = new Store<unsigned int>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::ULONG) {
-    newStore = new VarAttrStore<unsigned long>(numElements);
+    newStore = new Store<unsigned long>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::ULLONG) {
-    newStore = new VarAttrStore<unsigned long long>(numElements);
+    newStore = new Store<unsigned long long>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::CHAR) {
-    newStore = new VarAttrStore<char>(numElements);
+    newStore = new Store<char>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::WCHAR) {
-    newStore = new VarAttrStore<wchar_t>(numElements);
+    newStore = new Store<wchar_t>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::CHAR16) {
-    newStore = new VarAttrStore<char16_t>(numElements);
+    newStore = new Store<char16_t>(std::forward<Args>(args)...);
   } else if (baseType == ObsTypes::CHAR32) {
-    newStore = new VarAttrStore<char32_t>(numElements);
-  } else if (baseType == ObsTypes::STRING) {
-    newStore = new VarAttrStore<std::string>(numElements);
-  } else
-    throw Exception("Unrecognized data type encountered during "
-      "Attribute object construnction", ioda_Here());
+    newStore = new Store<char32_t>(std::forward<Args>(args)...);
+  }
+  return newStore;
+}
+}  // namespace
+
+//------------------------------------------------------------------------------
+VarAttrStore_Base *createVarAttrStore(const std::shared_ptr<Type> & dtype) {
+  ObsTypes baseType = getBaseObsType(dtype);
+
+  // Record the number of elements in the type. For fundamental types this would be 1,
+  // and for arrayed types this would be determined according to the dimension sizes.
+  std::size_t numElements = dtype->getNumElements();
+
+  // Use the baseType value to determine which templated version of the data store
+  // to instantiate.
+  VarAttrStore_Base *newStore = newFundamentalStore<VarAttrStore>(baseType, numElements);
+  if (newStore == nullptr) {
+    if (baseType == ObsTypes::STRING) {
+      newStore = new VarAttrStore<std::string>(numElements);
+    } else
+      throw Exception("Unrecognized data type encountered during "
+        "Attribute object construnction", ioda_Here());
+  }
 
   return newStore;
 }
 
+//------------------------------------------------------------------------------
+VarAttrStore_Base *createVarAttrStore(const std::shared_ptr<Type> & dtype,
+                                      const StorageSpec & storage) {
+  ObsTypes baseType = getBaseObsType(dtype);
+  VarAttrStore_Base *newStore = nullptr;
+  if (baseType == ObsTypes::STRING) {
+    // Strings are always kept in memory (std::string owns heap memory, so it cannot
+    // be placed in a mapped file), dictionary encoded while they have few distinct values.
+    newStore = new DictionaryVarAttrStore(dtype->getNumElements(), storage.charge);
+  } else if (storage.kind == Engines::ObsStore::StorageKind::MappedFile) {
+    newStore = newFundamentalStore<MappedVarAttrStore>(baseType, storage.directory,
+                                                       dtype->getNumElements(), storage.charge);
+  } else if (storage.kind == Engines::ObsStore::StorageKind::Compressed) {
+    newStore = newFundamentalStore<CompressedVarAttrStore>(baseType, dtype->getNumElements(),
+                                                           storage.hotLimit, storage.charge);
+  } else if (storage.kind == Engines::ObsStore::StorageKind::Chunked) {
+    newStore = newFundamentalStore<ChunkedVarAttrStore>(baseType, dtype->getNumElements(),
+                                                        storage.blockSize, storage.arena,
+                                                        storage.charge);
+  } else if (storage.arena || storage.charge) {
+    newStore = newFundamentalStore<VarAttrStore>(baseType, dtype->getNumElements(),
+                                                 storage.arena, storage.charge);
+  }
+  if (newStore != nullptr) return newStore;
+  return createVarAttrStore(dtype);
+}
+
 }  // namespace ObsStore
 }  // namespace ioda
 
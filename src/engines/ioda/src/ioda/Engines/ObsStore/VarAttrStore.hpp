@@ -12,13 +12,18 @@
  */
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "gsl/gsl-lite.hpp"
 
+#include "./Arena.hpp"
+#include "./MemoryAccount.hpp"
 #include "./Selection.hpp"
 #include "./Type.hpp"
+#include "ioda/Engines/ObsStore.h"
 #include "ioda/Exception.h"
 
 namespace ioda {
@@ -41,12 +46,23 @@ public:
   /// \param data contiguous block of data to transfer
   /// \param m_select Selection ojbect: how to select from data argument
   /// \param f_select Selection ojbect: how to select to storage vector
-  virtual void write(gsl::span<const char> data, Selection &m_select, Selection &f_select) = 0;
+  virtual void write(gsl::span<const char> data, const Selection &m_select,
+                     const Selection &f_select) = 0;
   /// \brief transfer data from data storage vector
   /// \param data contiguous block of data to transfer
   /// \param m_select Selection ojbect: how to select to data argument
   /// \param f_select Selection ojbect: how to select from storage vector
-  virtual void read(gsl::span<char> data, Selection &m_select, Selection &f_select) const = 0;
+  virtual void read(gsl::span<char> data, const Selection &m_select,
+                    const Selection &f_select) const = 0;
+  /// \brief signal that the values are not expected to be written for a while
+  /// \details Stores that keep settled values in a smaller form switch to it here.
+  virtual void compact() {}
+  /// \brief create a store holding the same values
+  /// \details Stores that can do so share their values with the clone until either of
+  ///          them is modified, which makes cloning cheap. The clone is independent of
+  ///          this store in every observable way.
+  /// \param charge charge for the memory allocated by the clone (nullptr: no accounting)
+  virtual VarAttrStore_Base *clone(const std::shared_ptr<MemoryCharge> &charge) const = 0;
 };
 
 // Templated versions for each data type
@@ -54,45 +70,78 @@ public:
 template <typename DataType>
 class VarAttrStore : public VarAttrStore_Base {
 private:
-  /// \brief data storage mechanism (vector)
-  std::vector<DataType> var_attr_data_;
+  typedef std::vector<DataType, ArenaAllocator<DataType>> Buffer;
+
+  /// \brief data storage mechanism (vector), shared with clones until modified
+  std::shared_ptr<Buffer> var_attr_data_;
 
   /// \brief number of elements in one data piece (for arrayed types)
   std::size_t num_elements_;
 
+  /// \brief allocator for the data storage vector (the one in use may come from the store
+  ///        this one was cloned from)
+  ArenaAllocator<DataType> allocator_;
+
+  /// \brief the data storage vector, copied first if it is shared with a clone
+  Buffer &modifiable() {
+    if (var_attr_data_.use_count() > 1) {
+      var_attr_data_ = std::make_shared<Buffer>(*var_attr_data_, allocator_);
+    } else {
+      // Pairs with the release in the other owner's reference drop, so that its
+      // last reads of the buffer happen before our writes.
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *var_attr_data_;
+  }
+
 public:
-  VarAttrStore() : num_elements_(1) {}
-  VarAttrStore(const std::size_t numElements) : num_elements_(numElements) {}
+  VarAttrStore() : var_attr_data_(std::make_shared<Buffer>()), num_elements_(1) {}
+  VarAttrStore(const std::size_t numElements)
+      : var_attr_data_(std::make_shared<Buffer>()), num_elements_(numElements) {}
+  /// \param numElements number of elements in one data piece
+  /// \param arena arena supplying the storage (nullptr: the heap)
+  /// \param charge charge for the storage (nullptr: no accounting)
+  VarAttrStore(const std::size_t numElements, const std::shared_ptr<Arena> &arena,
+               const std::shared_ptr<MemoryCharge> &charge = nullptr)
+      : num_elements_(numElements), allocator_(arena, charge) {
+    var_attr_data_ = std::make_shared<Buffer>(allocator_);
+  }
   ~VarAttrStore() {}
 
   /// \brief resizes memory allocated for data storage (vector)
   /// \param newSize new size for allocated memory in number of vector elements
-  void resize(std::size_t newSize) override { var_attr_data_.resize(newSize * num_elements_); }
+  void resize(std::size_t newSize) override {
+    if (var_attr_data_->size() == newSize * num_elements_) return;
+    modifiable().resize(newSize * num_elements_);
+  }
 
   /// \brief resizes memory allocated for data storage (vector)
   /// \param newSize new size for allocated memory in number of vector elements
   /// \param fillvalue new elements get initialized to fillValue
   void resize(std::size_t newSize, gsl::span<char> &fillValue) override {
+    if (var_attr_data_->size() == newSize * num_elements_) return;
     gsl::span<DataType> fv_span(reinterpret_cast<DataType *>(fillValue.data()), 1);
-    var_attr_data_.resize(newSize * num_elements_, fv_span[0]);
+    modifiable().resize(newSize * num_elements_, fv_span[0]);
   }
 
   /// \brief transfer data to data storage vector
   /// \param data contiguous block of data to transfer
   /// \param m_select Selection ojbect: how to select from data argument
   /// \param f_select Selection ojbect: how to select to storage vector
-  void write(gsl::span<const char> data, Selection &m_select, Selection &f_select) override {
+  void write(gsl::span<const char> data, const Selection &m_select,
+             const Selection &f_select) override {
     if (data.size() > 0) {
       std::size_t numObjects = data.size() / sizeof(DataType);
       gsl::span<const DataType> d_span(reinterpret_cast<const DataType *>(data.data()), numObjects);
+      Buffer &values = modifiable();
       // assumes m_select and f_select have same number of points
-      m_select.init_lin_indx();
-      f_select.init_lin_indx();
-      while (!m_select.end_lin_indx()) {
-        std::size_t m_indx     = m_select.next_lin_indx() * num_elements_;
-        std::size_t f_indx     = f_select.next_lin_indx() * num_elements_;
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx     = m_iter.next_lin_indx() * num_elements_;
+        std::size_t f_indx     = f_iter.next_lin_indx() * num_elements_;
         for (std::size_t i = 0; i < num_elements_; ++i) {
-          var_attr_data_[f_indx + i] = d_span[m_indx + i];
+          values[f_indx + i] = d_span[m_indx + i];
         }
       }
     }
@@ -102,24 +151,33 @@ public:
   /// \param data contiguous block of data to transfer
   /// \param m_select Selection ojbect: how to select to data argument
   /// \param f_select Selection ojbect: how to select from storage vector
-  void read(gsl::span<char> data, Selection &m_select, Selection &f_select) const override {
+  void read(gsl::span<char> data, const Selection &m_select,
+            const Selection &f_select) const override {
     if (data.size() > 0) {
-      std::size_t numChars = var_attr_data_.size() * sizeof(DataType);
+      const Buffer &values = *var_attr_data_;
+      std::size_t numChars = values.size() * sizeof(DataType);
       gsl::span<char> c_span(
-        const_cast<char *>(reinterpret_cast<const char *>(var_attr_data_.data())), numChars);
+        const_cast<char *>(reinterpret_cast<const char *>(values.data())), numChars);
       // assumes m_select and f_select have same number of points
       std::size_t datumLen = num_elements_ * sizeof(DataType);
-      m_select.init_lin_indx();
-      f_select.init_lin_indx();
-      while (!m_select.end_lin_indx()) {
-        std::size_t m_indx = m_select.next_lin_indx() * datumLen;
-        std::size_t f_indx = f_select.next_lin_indx() * datumLen;
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx = m_iter.next_lin_indx() * datumLen;
+        std::size_t f_indx = f_iter.next_lin_indx() * datumLen;
         for (std::size_t i = 0; i < datumLen; ++i) {
           data[m_indx + i] = c_span[f_indx + i];
         }
       }
     }
   }
+
+  /// \brief create a store sharing the values of this one until either is modified
+  VarAttrStore_Base *clone(const std::shared_ptr<MemoryCharge> &charge) const override {
+    VarAttrStore<DataType> *store = new VarAttrStore<DataType>(*this);
+    store->allocator_ = ArenaAllocator<DataType>(allocator_.arena(), charge);
+    return store;
+  }
 };
 
 // Specialization for std::string data type
@@ -156,7 +214,8 @@ public:
   /// \param data contiguous block of data to transfer
   /// \param m_select Selection object: how to select from data argument
   /// \param f_select Selection object: how to select to storage vector
-  void write(gsl::span<const char> data, Selection &m_select, Selection &f_select) override {
+  void write(gsl::span<const char> data, const Selection &m_select,
+             const Selection &f_select) override {
     // data is a series of char * pointing to null terminated strings
     // first place the char * values in a vector
     if (data.size() > 0) {
@@ -168,11 +227,11 @@ public:
       }
 
       // assumes m_select and f_select have same number of points
-      m_select.init_lin_indx();
-      f_select.init_lin_indx();
-      while (!m_select.end_lin_indx()) {
-        std::size_t m_indx     = m_select.next_lin_indx() * num_elements_;
-        std::size_t f_indx     = f_select.next_lin_indx() * num_elements_;
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx     = m_iter.next_lin_indx() * num_elements_;
+        std::size_t f_indx     = f_iter.next_lin_indx() * num_elements_;
         for (std::size_t i = 0; i < num_elements_; ++i) {
           var_attr_data_[f_indx + i] = inStrings[m_indx + i];
         }
@@ -184,7 +243,8 @@ public:
   /// \param data contiguous block of data to transfer
   /// \param m_select Selection ojbect: how to select to data argument
   /// \param f_select Selection ojbect: how to select from storage vector
-  void read(gsl::span<char> data, Selection &m_select, Selection &f_select) const override {
+  void read(gsl::span<char> data, const Selection &m_select,
+            const Selection &f_select) const override {
     // First create a vector of char * pointers to each item in var_attr_data_.
     if (data.size() > 0) {
       std::size_t numObjects = var_attr_data_.size();
@@ -197,23 +257,63 @@ public:
       gsl::span<char> c_span(reinterpret_cast<char *>(outStrings.data()), numChars);
       // assumes m_select and f_select have same number of points
       std::size_t datumLen = num_elements_ * sizeof(char *);
-      m_select.init_lin_indx();
-      f_select.init_lin_indx();
-      while (!m_select.end_lin_indx()) {
-        std::size_t m_indx = m_select.next_lin_indx() * datumLen;
-        std::size_t f_indx = f_select.next_lin_indx() * datumLen;
+      SelectIterator m_iter(m_select);
+      SelectIterator f_iter(f_select);
+      while (!m_iter.end_lin_indx()) {
+        std::size_t m_indx = m_iter.next_lin_indx() * datumLen;
+        std::size_t f_indx = f_iter.next_lin_indx() * datumLen;
         for (std::size_t i = 0; i < datumLen; ++i) {
           data[m_indx + i] = c_span[f_indx + i];
         }
       }
     }
   }
+
+  /// \brief heap memory owned by the stored strings
+  std::size_t heapBytes() const {
+    std::size_t bytes = 0;
+    for (const std::string &value : var_attr_data_) bytes += stringHeapBytes(value);
+    return bytes;
+  }
+
+  /// \brief create a store holding a copy of the values
+  /// \details Only attributes use this store, and Attribute does their accounting.
+  VarAttrStore_Base *clone(const std::shared_ptr<MemoryCharge> &) const override {
+    return new VarAttrStore<std::string>(*this);
+  }
+};
+
+/// \brief where the data of a new variable should be kept
+/// \ingroup ioda_internals_engines_obsstore
+struct StorageSpec {
+  /// \brief kind of backing store
+  Engines::ObsStore::StorageKind kind = Engines::ObsStore::StorageKind::Memory;
+  /// \brief scratch directory (used by StorageKind::MappedFile)
+  std::string directory;
+  /// \brief accesses before a compressed variable is kept raw (used by StorageKind::Compressed)
+  std::size_t hotLimit = 0;
+  /// \brief number of data pieces in a block (used by StorageKind::Chunked)
+  std::size_t blockSize = 0;
+  /// \brief arena for the data (used by StorageKind::Memory and StorageKind::Chunked;
+  ///        nullptr: the heap)
+  std::shared_ptr<Arena> arena;
+  /// \brief charge for the memory of the variable (nullptr: no accounting)
+  std::shared_ptr<MemoryCharge> charge;
 };
 
 /// \brief factory style function to create a new templated object
 /// \ingroup ioda_internals_engines_obsstore
 VarAttrStore_Base *createVarAttrStore(const std::shared_ptr<Type> & dtype);
 
+/// \brief factory style function to create a new templated object
+/// \ingroup ioda_internals_engines_obsstore
+/// \details This is the factory for variable data. String variables always get a
+///          DictionaryVarAttrStore.
+/// \param dtype data type of the stored values
+/// \param storage backing store to use, where the data type allows it
+VarAttrStore_Base *createVarAttrStore(const std::shared_ptr<Type> & dtype,
+                                      const StorageSpec & storage);
+
 }  // namespace ObsStore
 }  // namespace ioda
 
@@ -13,6 +13,7 @@
 
 #include "./Variables.hpp"
 
+#include <algorithm>
 #include <exception>
 #include <functional>
 #include <numeric>
@@ -34,17 +35,15 @@ Variable::Variable(const std::vector<Dimensions_t>& dimensions,
       dtype_(std::move(dtype)),
       var_data_(),
       is_scale_(false),
+      charge_(params.storage.charge),
       atts(std::make_shared<Has_Attributes>()),
       impl_atts(std::make_shared<Has_Attributes>()) {
   // Get a typed storage object based on dtype
-  var_data_.reset(createVarAttrStore(dtype_));
+  var_data_.reset(createVarAttrStore(dtype_, params.storage));
+  atts->setCharge(charge_);
 
-  // If have a fill value, save in an attribute. Do this before resizing
-  // because resize() will check for the fill value.
+  // Record the fill value before resizing because resize() uses it.
   if (params.fvdata.set_) {
-    auto fv = impl_atts->create("_fillValue", dtype_, {1});
-    fv->write(params.fill_value, *dtype_);
-
     this->fvdata_ = params.fvdata;
   }
 
@@ -83,10 +82,11 @@ void Variable::resize(const std::vector<Dimensions_t>& new_dim_sizes) {
       std::accumulate(new_dim_sizes.begin(), new_dim_sizes.end(), (std::size_t)1,
                                             std::multiplies<std::size_t>());
 
-  if (impl_atts->exists("_fillValue")) {
-    std::vector<char> fvalue(dtype_->getSize());
-    gsl::span<char> fillValue(fvalue.data(), dtype_->getSize());
-    impl_atts->open("_fillValue")->read(fillValue, *dtype_);
+  if (fvdata_.set_) {
+    // fvdata_ already holds the decoded fill value, so no attribute lookup or
+    // temporary buffer is needed. For strings, finalize() points into fvdata_.
+    detail::FillValueData_t::FillValueUnion_t fvalue = fvdata_.finalize();
+    gsl::span<char> fillValue(reinterpret_cast<char*>(&fvalue), sizeof(fvalue));
     var_data_->resize(numElements, fillValue);
   } else {
     var_data_->resize(numElements);
@@ -129,7 +129,8 @@ bool Variable::isDimensionScaleAttached(const std::size_t dim_number,
 }
 
 std::shared_ptr<Variable> Variable::write(gsl::span<const char> data, const Type & dtype,
-                                          Selection & m_select, Selection & f_select) {
+                                          const Selection & m_select,
+                                          const Selection & f_select) {
   if (dtype != *dtype_)
     throw Exception("Requested data type not equal to storage datatype", ioda_Here());
 
@@ -138,7 +139,7 @@ std::shared_ptr<Variable> Variable::write(gsl::span<const char> data, const Type
 }
 
 std::shared_ptr<Variable> Variable::read(gsl::span<char> data, const Type & dtype,
-                                         Selection& m_select, Selection& f_select) {
+                                         const Selection& m_select, const Selection& f_select) {
   if (dtype != *dtype_)
     throw Exception("Requested data type not equal to storage datatype.", ioda_Here());
 
@@ -146,6 +147,43 @@ std::shared_ptr<Variable> Variable::read(gsl::span<char> data, const Type & dtyp
   return shared_from_this();
 }
 
+bool Variable::readCodes(std::vector<DictionaryVarAttrStore::Code> & codes,
+                         std::vector<std::string> & dictionary,
+                         const Selection & f_select) const {
+  const DictionaryVarAttrStore * store =
+    dynamic_cast<const DictionaryVarAttrStore *>(var_data_.get());
+  if ((store == nullptr) || !store->readCodes(codes, f_select)) return false;
+  dictionary = store->dictionary();
+  return true;
+}
+
+void Variable::compact() { var_data_->compact(); }
+
+std::shared_ptr<Variable> Variable::clone(const std::shared_ptr<MemoryCharge>& charge) const {
+  auto var = std::make_shared<Variable>();
+  var->dimensions_     = dimensions_;
+  var->max_dimensions_ = max_dimensions_;
+  var->dtype_          = dtype_;
+  var->fvdata_         = fvdata_;
+  var->var_data_.reset(var_data_->clone(charge));
+  var->dim_scales_     = dim_scales_;
+  var->is_scale_       = is_scale_;
+  var->scale_name_     = scale_name_;
+  var->charge_         = charge;
+  var->atts            = atts->clone(charge);
+  var->impl_atts       = impl_atts ? impl_atts->clone(nullptr) : nullptr;
+  return var;
+}
+
+void Variable::remapDimensionScales(
+  const std::map<const Variable*, std::shared_ptr<Variable>>& scaleMap) {
+  for (auto& scale : dim_scales_) {
+    if (scale == nullptr) continue;
+    auto iscale = scaleMap.find(scale.get());
+    if (iscale != scaleMap.end()) scale = iscale->second;
+  }
+}
+
 //***************************************************************************
 // Has_Variable methods
 //****************************************************************************
@@ -166,42 +204,36 @@ std::shared_ptr<Variable> Has_Variables::create(const std::string& name,
     std::shared_ptr<Group> group       = parentGroup->create(splitPaths[0]);
     var = group->vars->create(splitPaths[1], dtype, dims, max_dims, params);
   } else {
-    // No intermediate groups, create variable here
-    var = std::make_shared<Variable>(dims, max_dims, dtype, params);
-    variables_.insert(std::pair<std::string, std::shared_ptr<Variable>>(name, var));
+    // No intermediate groups, create variable here. The tree's storage policies
+    // decide where the data goes.
+    VarCreateParams varParams = params;
+    varParams.storage.charge  = newCharge(name);
+    if (storage_) {
+      varParams.storage.kind      = storage_->lookup(path_prefix_ + name);
+      varParams.storage.directory = storage_->scratchPath();
+      varParams.storage.hotLimit  = storage_->compressedHotAccesses;
+      varParams.storage.arena     = arena_;
+      // A block holds chunkLocations entries of the leading dimension.
+      std::size_t rowSize = 1;
+      for (std::size_t i = 1; i < dims.size(); ++i)
+        rowSize *= static_cast<std::size_t>(std::max<Dimensions_t>(dims[i], 1));
+      varParams.storage.blockSize = storage_->chunkLocations * rowSize;
+    }
+    var = std::make_shared<Variable>(dims, max_dims, dtype, varParams);
+    insert(name, var);
   }
   return var;
 }
 
 std::shared_ptr<Variable> Has_Variables::open(const std::string& name) const {
-  std::shared_ptr<Variable> var;
-  std::vector<std::string> splitPaths = splitGroupVar(name);
-  if (splitPaths.size() > 1) {
-    std::shared_ptr<Group> parentGroup = parent_group_.lock();
-    std::shared_ptr<Group> group       = parentGroup->open(splitPaths[0]);
-    var                                = group->vars->open(splitPaths[1]);
-  } else {
-    auto ivar = variables_.find(name);
-    if (ivar == variables_.end())
-      throw Exception("Variable not found.", ioda_Here()).add("name", name);
-    var = ivar->second;
-  }
-  return var;
+  auto ivar = path_index_->variables.find(path_prefix_ + name);
+  if (ivar == path_index_->variables.end())
+    throw Exception("Variable not found.", ioda_Here()).add("name", name);
+  return ivar->second;
 }
 
 bool Has_Variables::exists(const std::string& name) const {
-  bool varExists                      = false;
-  std::vector<std::string> splitPaths = splitGroupVar(name);
-  if (splitPaths.size() > 1) {
-    std::shared_ptr<Group> parentGroup = parent_group_.lock();
-    if (parentGroup->exists(splitPaths[0])) {
-      std::shared_ptr<Group> group = parentGroup->open(splitPaths[0]);
-      varExists                    = group->vars->exists(splitPaths[1]);
-    }
-  } else {
-    varExists = (variables_.find(name) != variables_.end());
-  }
-  return varExists;
+  return (path_index_->variables.find(path_prefix_ + name) != path_index_->variables.end());
 }
 
 void Has_Variables::remove(const std::string& name) {
@@ -212,6 +244,7 @@ void Has_Variables::remove(const std::string& name) {
     group->vars->remove(splitPaths[1]);
   } else {
     variables_.erase(name);
+    path_index_->variables.erase(path_prefix_ + name);
   }
 }
 
@@ -223,8 +256,12 @@ void Has_Variables::rename(const std::string& oldName, const std::string& newNam
     group->vars->rename(splitPaths[1], newName);
   } else {
     std::shared_ptr<Variable> var = open(oldName);
+    if (var->charge()) var->charge()->rename(path_prefix_ + newName);
     variables_.erase(oldName);
     variables_.insert(std::pair<std::string, std::shared_ptr<Variable>>(newName, var));
+    path_index_->variables.erase(path_prefix_ + oldName);
+    path_index_->variables.insert(
+      std::pair<std::string, std::shared_ptr<Variable>>(path_prefix_ + newName, var));
   }
 }
 
@@ -236,10 +273,42 @@ std::vector<std::string> Has_Variables::list() const {
   return varList;
 }
 
+void Has_Variables::insert(const std::string& name, const std::shared_ptr<Variable>& var) {
+  variables_.insert(std::pair<std::string, std::shared_ptr<Variable>>(name, var));
+  path_index_->variables.insert(
+    std::pair<std::string, std::shared_ptr<Variable>>(path_prefix_ + name, var));
+}
+
+void Has_Variables::forEach(
+  const std::function<void(const std::string&, const std::shared_ptr<Variable>&)>& func) const {
+  for (const auto& ivar : variables_) func(ivar.first, ivar.second);
+}
+
 void Has_Variables::setParentGroup(const std::shared_ptr<Group>& parentGroup) {
   parent_group_ = parentGroup;
 }
 
+void Has_Variables::setPathIndex(const std::shared_ptr<PathIndex>& pathIndex,
+                                 const std::string& pathPrefix) {
+  path_index_  = pathIndex;
+  path_prefix_ = pathPrefix;
+}
+
+void Has_Variables::setStorage(
+  const std::shared_ptr<const Engines::ObsStore::StorageParameters>& storage,
+  const std::shared_ptr<Arena>& arena, const std::shared_ptr<MemoryAccount>& account) {
+  storage_ = storage;
+  arena_   = arena;
+  account_ = account;
+}
+
+std::shared_ptr<MemoryCharge> Has_Variables::newCharge(const std::string& name) const {
+  if (!account_) return nullptr;
+  std::string groupPath = path_prefix_.empty() ? path_prefix_
+                                               : path_prefix_.substr(0, path_prefix_.size() - 1);
+  return std::make_shared<MemoryCharge>(account_, groupPath, path_prefix_ + name);
+}
+
 // private methods
 std::vector<std::string> Has_Variables::splitGroupVar(const std::string& path) {
   std::vector<std::string> splitPath;
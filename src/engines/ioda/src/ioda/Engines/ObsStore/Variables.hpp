@@ -12,6 +12,7 @@
  */
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -19,6 +20,9 @@
 #include <vector>
 
 #include "./Attributes.hpp"
+#include "./DictionaryVarAttrStore.hpp"
+#include "./MemoryAccount.hpp"
+#include "./PathIndex.hpp"
 #include "./Selection.hpp"
 #include "./Type.hpp"
 #include "./VarAttrStore.hpp"
@@ -39,7 +43,8 @@ struct VarCreateParams {
 public:
   // Fill value
   detail::FillValueData_t fvdata;
-  gsl::span<char> fill_value;
+  // Backing store for the variable data
+  StorageSpec storage;
 };
 
 /// \ingroup ioda_internals_engines_obsstore
@@ -53,6 +58,8 @@ private:
   std::shared_ptr<Type> dtype_;
 
   /// \brief Fill value information
+  /// \details This is the only copy of the fill value. It is decoded once, at creation,
+  ///          and is used directly by resize() and the fill value queries.
   detail::FillValueData_t fvdata_;
 
   /// \brief container for variable data values
@@ -67,6 +74,9 @@ private:
   /// \brief alias for this variable when it is serving as a dimension scale
   std::string scale_name_;
 
+  /// \brief charge for the memory of this variable (nullptr: no accounting)
+  std::shared_ptr<MemoryCharge> charge_;
+
 public:
   Variable() : atts(std::make_shared<Has_Attributes>()) {}
   Variable(const std::vector<Dimensions_t>& dimensions,
@@ -77,7 +87,7 @@ public:
 
   /// \brief container for variable attributes
   std::shared_ptr<Has_Attributes> atts;
-  /// \brief implementation-specific attribute storage. Fill values, chunking,
+  /// \brief implementation-specific attribute storage. Chunking,
   ///   compression settings, etc. Stuff that shouldn't be directly visible
   ///   to the client without using a dedicated function.
   std::shared_ptr<Has_Attributes> impl_atts;
@@ -132,13 +142,39 @@ public:
   /// \param m_select Selection ojbect: how to select from data argument
   /// \param f_select Selection ojbect: how to select to variable storage
   std::shared_ptr<Variable> write(gsl::span<const char> data, const Type & dtype,
-                                  Selection & m_select, Selection & f_select);
+                                  const Selection & m_select, const Selection & f_select);
   /// \brief transfer data from variable storage
   /// \param data contiguous block of data to transfer
   /// \param m_select Selection ojbect: how to select to data argument
   /// \param f_select Selection ojbect: how to select from variable storage
   std::shared_ptr<Variable> read(gsl::span<char> data, const Type & dtype,
-                                 Selection & m_select, Selection & f_select);
+                                 const Selection & m_select, const Selection & f_select);
+  /// \brief transfer dictionary codes from the storage of a string variable
+  /// \param codes receives one code per selected element, in selection order
+  /// \param dictionary receives the distinct values, indexed by code
+  /// \param f_select Selection ojbect: how to select from variable storage
+  /// \returns false if the variable is not dictionary encoded
+  bool readCodes(std::vector<DictionaryVarAttrStore::Code> & codes,
+                 std::vector<std::string> & dictionary, const Selection & f_select) const;
+
+  /// \brief signal that the values are not expected to be written for a while
+  /// \details See VarAttrStore_Base::compact.
+  void compact();
+
+  /// \brief create a variable with the same shape, type, fill value, attributes and values
+  /// \details The values are shared with the clone until either variable is modified (see
+  ///          VarAttrStore_Base::clone). Attached dimension scales still refer to the
+  ///          scales of this variable; see remapDimensionScales.
+  /// \param charge charge for the memory of the clone (nullptr: no accounting)
+  std::shared_ptr<Variable> clone(const std::shared_ptr<MemoryCharge>& charge) const;
+
+  /// \brief the charge for the memory of this variable (nullptr: no accounting)
+  const std::shared_ptr<MemoryCharge>& charge() const { return charge_; }
+
+  /// \brief point the attached dimension scales at other variables
+  /// \param scaleMap replacement for each scale (scales not in the map are kept)
+  void remapDimensionScales(
+    const std::map<const Variable*, std::shared_ptr<Variable>>& scaleMap);
 };
 
 class Group;
@@ -151,12 +187,24 @@ private:
   /// \brief pointer to parent group
   std::weak_ptr<Group> parent_group_;
 
+  /// \brief full-path index shared by all groups in this tree
+  std::shared_ptr<PathIndex> path_index_;
+  /// \brief full path of the parent group, with a trailing '/' (empty for the root group)
+  std::string path_prefix_;
+
+  /// \brief storage policies of the tree (nullptr: everything in memory)
+  std::shared_ptr<const Engines::ObsStore::StorageParameters> storage_;
+  /// \brief allocator of the tree (nullptr: the heap)
+  std::shared_ptr<Arena> arena_;
+  /// \brief memory account of the tree (nullptr: no accounting)
+  std::shared_ptr<MemoryAccount> account_;
+
   /// \brief split a path into groups and variable pieces
   /// \param path Hierarchical path
   static std::vector<std::string> splitGroupVar(const std::string& path);
 
 public:
-  Has_Variables() {}
+  Has_Variables() : path_index_(std::make_shared<PathIndex>()) {}
   ~Has_Variables() {}
 
   /// \brief create a new variable
@@ -172,10 +220,12 @@ public:
                                    const VarCreateParams& params);
 
   /// \brief open an existing variable (throws exception if not found)
+  /// \details This is a single lookup in the tree's path index.
   std::shared_ptr<Variable> open(const std::string& name) const;
 
   /// \brief returns true if variable exists in the container
   /// \param name name of variable to check
+  /// \details This is a single lookup in the tree's path index.
   bool exists(const std::string& name) const;
 
   /// \brief remove variable
@@ -190,9 +240,37 @@ public:
   /// \brief returns a list of names of the variables in the container
   std::vector<std::string> list() const;
 
+  /// \brief add an existing variable to the container
+  /// \param name name of the variable (no intermediate groups)
+  /// \param var the variable
+  void insert(const std::string& name, const std::shared_ptr<Variable>& var);
+
+  /// \brief iterate over the variables in the container
+  /// \param func called with the name and the variable of each variable
+  void forEach(
+    const std::function<void(const std::string&, const std::shared_ptr<Variable>&)>& func) const;
+
   /// \brief set parent group pointer
   /// \param parentGroup pointer to group that owns this Has_Variables object
   void setParentGroup(const std::shared_ptr<Group>& parentGroup);
+
+  /// \brief set the path index and the full path of the parent group
+  /// \param pathIndex index shared by the tree
+  /// \param pathPrefix full path of the parent group, with a trailing '/'
+  void setPathIndex(const std::shared_ptr<PathIndex>& pathIndex, const std::string& pathPrefix);
+
+  /// \brief set the storage policies used for new variables
+  /// \param storage storage policies of the tree (nullptr: everything in memory)
+  /// \param arena allocator of the tree (nullptr: the heap)
+  /// \param account memory account of the tree (nullptr: no accounting)
+  void setStorage(const std::shared_ptr<const Engines::ObsStore::StorageParameters>& storage,
+                  const std::shared_ptr<Arena>& arena,
+                  const std::shared_ptr<MemoryAccount>& account);
+
+  /// \brief create the charge for the memory of a variable of this container
+  /// \param name name of the variable (no intermediate groups)
+  /// \returns nullptr if the tree has no memory account
+  std::shared_ptr<MemoryCharge> newCharge(const std::string& name) const;
 };
 #if defined(__INTEL_COMPILER)
 #  pragma warning(pop)
@@ -5,9 +5,20 @@
  * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0. 
  */
 
+#include <glob.h>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+
+#include "oops/mpi/mpi.h"
 #include "oops/util/Logger.h"
 
+#include "ioda/Engines/HH.h"
 #include "ioda/Engines/ReadH5File.h"
+#include "ioda/Exception.h"
+#include "ioda/Io/BlockStatistics.h"
 
 namespace ioda {
 namespace Engines {
@@ -18,6 +29,39 @@ namespace Engines {
 
 static ReaderMaker<ReadH5File> maker("H5File");
 
+namespace {
+
+// Expand a file name that holds glob wildcards into the (sorted) names of the matching
+// files. Other file names are passed through as is.
+void expandFileName(const std::string & fileName, std::vector<std::string> & fileNames) {
+    if (fileName.find_first_of("*?[") == std::string::npos) {
+        fileNames.push_back(fileName);
+        return;
+    }
+    glob_t matches;
+    const int rc = glob(fileName.c_str(), 0, nullptr, &matches);
+    if (rc == 0) {
+        fileNames.insert(fileNames.end(), matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+    }
+    globfree(&matches);
+    if (rc != 0) {
+        throw Exception("No input files match the obsfile pattern", ioda_Here())
+            .add("pattern", fileName);
+    }
+}
+
+// Sorted list of the variables in a file, leaving out the block statistics which
+// describe each file on its own.
+std::vector<std::string> listFileVariables(const Group & file) {
+    std::vector<std::string> varNames = file.listObjects<ObjectType::Variable>(true);
+    varNames.erase(std::remove_if(varNames.begin(), varNames.end(), isBlockStatisticsVariable),
+                   varNames.end());
+    std::sort(varNames.begin(), varNames.end());
+    return varNames;
+}
+
+}  // namespace
+
 // Parameters
 
 // Classes
@@ -26,21 +70,66 @@ ReadH5File::ReadH5File(const Parameters_ & params, const util::DateTime & winSta
                        const util::DateTime & winEnd, const eckit::mpi::Comm & comm,
                        const eckit::mpi::Comm & timeComm,
                        const std::vector<std::string> & obsVarNames)
-                           : ReaderBase(winStart, winEnd, comm, timeComm, obsVarNames),
-                             fileName_(params.fileName) {
+                           : ReaderBase(winStart, winEnd, comm, timeComm, obsVarNames) {
     oops::Log::trace() << "ioda::Engines::ReadH5File start constructor" << std::endl;
-    // Record the file name for reporting
-    fileName_ = params.fileName;
-
-    // Create a backend backed by an existing read-only hdf5 file
-    Engines::BackendNames backendName = BackendNames::Hdf5File;
-    Engines::BackendCreationParameters backendParams;
-    backendParams.fileName = fileName_;
-    backendParams.action = BackendFileActions::Open;
-    backendParams.openMode = BackendOpenModes::Read_Only;
-
-    Group backend = constructBackend(backendName, backendParams);
-    obs_group_ = ObsGroup(backend);
+    if (params.fileName.value() == boost::none && params.fileNames.value() == boost::none) {
+        throw Exception("The H5File reader needs one of obsfile or obsfiles", ioda_Here());
+    }
+    if (params.fileName.value() != boost::none && params.fileNames.value() != boost::none) {
+        throw Exception("The H5File reader takes only one of obsfile and obsfiles",
+                        ioda_Here());
+    }
+
+    // The setting is process wide, so it is only changed when asked for.
+    if (params.chunkThreads.value() != boost::none) {
+        HH::setChunkThreads(*params.chunkThreads.value());
+    }
+
+    // Record the file name(s) for reporting
+    if (params.fileName.value() != boost::none) {
+        fileName_ = *params.fileName.value();
+        expandFileName(fileName_, fileNames_);
+    } else {
+        for (const std::string & fileName : *params.fileNames.value()) {
+            expandFileName(fileName, fileNames_);
+        }
+        if (fileNames_.empty()) {
+            throw Exception("The obsfiles list is empty", ioda_Here());
+        }
+        fileName_ = fileNames_[0];
+        if (fileNames_.size() > 1) {
+            fileName_ += " and " + std::to_string(fileNames_.size() - 1) + " more files";
+        }
+    }
+
+    std::vector<std::string> readFileNames = fileNames_;
+    if (fileNames_.size() > 1) {
+        const std::vector<Dimensions_t> fileNlocs = checkFileSet();
+        if (params.distributeFiles && (comm_.size() > 1)) {
+            readFileNames = assignFiles(fileNlocs);
+            separateObs_ = true;
+        }
+    }
+
+    if (readFileNames.size() == 1) {
+        // Create a backend backed by an existing read-only hdf5 file
+        Engines::BackendNames backendName = BackendNames::Hdf5File;
+        Engines::BackendCreationParameters backendParams;
+        backendParams.fileName = readFileNames[0];
+        backendParams.action = BackendFileActions::Open;
+        backendParams.openMode = BackendOpenModes::Read_Only;
+
+        Group backend = constructBackend(backendName, backendParams);
+        obs_group_ = ObsGroup(backend);
+    } else if (readFileNames.empty()) {
+        // A task given none of the files still needs their variables.
+        obs_group_ = ObsGroup(HH::openEmptyVirtualFile(fileNames_[0],
+                                                       { blockStatisticsGroupName }));
+    } else {
+        // Present the files as one, stacked along nlocs. No data are copied: HDF5 reads
+        // each piece from its own file on demand.
+        obs_group_ = ObsGroup(HH::openVirtualFile(readFileNames, { blockStatisticsGroupName }));
+    }
     oops::Log::trace() << "ioda::Engines::ReadH5File end constructor" << std::endl;
 }
 
@@ -48,5 +137,93 @@ void ReadH5File::print(std::ostream & os) const {
   os << fileName_;
 }
 
+std::vector<Dimensions_t> ReadH5File::checkFileSet() {
+    // The first task lists the variables of the first file for the others to compare
+    // against. Beyond that, task i opens files i, i + ntasks, ...
+    auto numLocations = [](const Group & file) -> Dimensions_t {
+        return file.vars.exists("nlocs") ? file.vars.open("nlocs").getDimensions().dimsCur[0]
+                                         : 0;
+    };
+    std::vector<std::string> refVarNames;
+    std::vector<Dimensions_t> fileNlocs(fileNames_.size(), 0);
+    if (comm_.rank() == 0) {
+        const Group file = HH::openFile(fileNames_[0], BackendOpenModes::Read_Only);
+        refVarNames = listFileVariables(file);
+        fileNlocs[0] = numLocations(file);
+    }
+    oops::mpi::allGatherv(comm_, refVarNames);
+
+    std::vector<std::string> mismatches;
+    for (std::size_t i = comm_.rank(); i < fileNames_.size(); i += comm_.size()) {
+        if (i == 0) continue;
+        const Group file = HH::openFile(fileNames_[i], BackendOpenModes::Read_Only);
+        const std::vector<std::string> varNames = listFileVariables(file);
+        std::vector<std::string> missing;
+        std::vector<std::string> extra;
+        std::set_difference(refVarNames.begin(), refVarNames.end(), varNames.begin(),
+                            varNames.end(), std::back_inserter(missing));
+        std::set_difference(varNames.begin(), varNames.end(), refVarNames.begin(),
+                            refVarNames.end(), std::back_inserter(extra));
+        if (!missing.empty() || !extra.empty()) {
+            std::ostringstream report;
+            report << "ERROR: input file " << fileNames_[i]
+                   << " does not hold the same variables as " << fileNames_[0];
+            for (const std::string & varName : missing) {
+                report << "\nERROR:     missing: " << varName;
+            }
+            for (const std::string & varName : extra) {
+                report << "\nERROR:     extra: " << varName;
+            }
+            mismatches.push_back(report.str());
+        }
+        fileNlocs[i] = numLocations(file);
+    }
+
+    // Every task reports and throws for the mismatches found by any of them.
+    oops::mpi::allGatherv(comm_, mismatches);
+    if (!mismatches.empty()) {
+        for (const std::string & report : mismatches) {
+            oops::Log::error() << report << std::endl;
+        }
+        throw Exception("Input files hold different sets of variables", ioda_Here())
+            .add("number of files that differ from the first", mismatches.size())
+            .add("first file", fileNames_[0]);
+    }
+
+    comm_.allReduceInPlace(fileNlocs.begin(), fileNlocs.end(), eckit::mpi::sum());
+    return fileNlocs;
+}
+
+std::vector<std::string> ReadH5File::assignFiles(const std::vector<Dimensions_t> & fileNlocs) {
+    // Global location index: file i holds locations [fileStart[i], fileStart[i] + nlocs_i).
+    std::vector<Dimensions_t> fileStart(fileNlocs.size() + 1, 0);
+    std::partial_sum(fileNlocs.begin(), fileNlocs.end(), fileStart.begin() + 1);
+    const Dimensions_t totalNlocs = fileStart.back();
+
+    // Task r is given the locations [r * total / ntasks, (r + 1) * total / ntasks), rounded
+    // to whole files: each file goes to the task whose share holds its middle location.
+    // That keeps the files of a task contiguous, so its locations are too.
+    const Dimensions_t numTasks = comm_.size();
+    const Dimensions_t myTask = comm_.rank();
+    std::vector<std::string> myFileNames;
+    for (std::size_t i = 0; i < fileNames_.size(); ++i) {
+        const Dimensions_t middle = fileStart[i] + fileNlocs[i] / 2;
+        const Dimensions_t task =
+            (totalNlocs == 0) ? 0 : std::min(numTasks - 1, middle * numTasks / totalNlocs);
+        if (task < myTask) {
+            locationOffset_ = fileStart[i + 1];
+        } else if (task == myTask) {
+            myFileNames.push_back(fileNames_[i]);
+        }
+    }
+
+    oops::Log::info() << "ReadH5File: reading " << totalNlocs << " locations from "
+                      << fileNames_.size() << " files, shared out between " << numTasks
+                      << " tasks" << std::endl;
+    oops::Log::debug() << "ReadH5File: task " << myTask << " reads " << myFileNames.size()
+                       << " files, from location " << locationOffset_ << std::endl;
+    return myFileNames;
+}
+
 }  // namespace Engines
 }  // namespace ioda
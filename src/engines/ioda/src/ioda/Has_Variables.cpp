@@ -13,6 +13,9 @@
 #include "ioda/Misc/StringFuncs.h"
 #include "ioda/Misc/UnitConversions.h"
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include <stdexcept>
 
 namespace ioda {
@@ -475,6 +478,30 @@ void Has_Variables_Base::createWithScales(const NewVariables_t& newvars) {
 
 }  // namespace detail
 
+namespace chunking {
+std::vector<Dimensions_t> sizeTargetedChunks(const std::vector<Dimensions_t>& shape,
+                                             std::size_t elementSize, std::size_t targetBytes) {
+  if (shape.empty() || (targetBytes == 0)) return shape;
+  for (const auto s : shape)
+    if (s <= 0) return shape;
+  const std::size_t valueBytes = std::max<std::size_t>(elementSize, 1);
+  const Dimensions_t targetValues
+    = std::max<Dimensions_t>(1, gsl::narrow<Dimensions_t>(targetBytes / valueBytes));
+
+  std::vector<Dimensions_t> chunks = shape;
+  const auto rowValues = [&chunks]() {
+    return std::accumulate(chunks.begin() + 1, chunks.end(), static_cast<Dimensions_t>(1),
+                           std::multiplies<Dimensions_t>());
+  };
+  while (rowValues() > targetValues) {
+    auto largest = std::max_element(chunks.begin() + 1, chunks.end());
+    *largest     = (*largest + 1) / 2;
+  }
+  chunks[0] = std::min(shape[0], std::max<Dimensions_t>(1, targetValues / rowValues()));
+  return chunks;
+}
+}  // namespace chunking
+
 Has_Variables::~Has_Variables() = default;
 Has_Variables::Has_Variables() : Has_Variables_Base(nullptr) {}
 Has_Variables::Has_Variables(std::shared_ptr<detail::Has_Variables_Backend> b,
@@ -486,11 +513,14 @@ VariableCreationParameters::VariableCreationParameters(const VariableCreationPar
     : fillValue_{r.fillValue_},
       chunk{r.chunk},
       chunks{r.chunks},
+      chunkTargetBytes{r.chunkTargetBytes},
       gzip_{r.gzip_},
       szip_{r.szip_},
       gzip_level_{r.gzip_level_},
       szip_PixelsPerBlock_{r.szip_PixelsPerBlock_},
       szip_options_{r.szip_options_},
+      shuffle_{r.shuffle_},
+      keepMantissaBits_{r.keepMantissaBits_},
       atts{r.atts},
       _py_setFillValue{this} {}
 
@@ -500,11 +530,14 @@ VariableCreationParameters& VariableCreationParameters::operator=(
   fillValue_           = r.fillValue_;
   chunk                = r.chunk;
   chunks               = r.chunks;
+  chunkTargetBytes     = r.chunkTargetBytes;
   gzip_                = r.gzip_;
   szip_                = r.szip_;
   gzip_level_          = r.gzip_level_;
   szip_PixelsPerBlock_ = r.szip_PixelsPerBlock_;
   szip_options_        = r.szip_options_;
+  shuffle_             = r.shuffle_;
+  keepMantissaBits_    = r.keepMantissaBits_;
   atts                 = r.atts;
   _py_setFillValue     = decltype(_py_setFillValue){this};
   return *this;
@@ -512,8 +545,9 @@ VariableCreationParameters& VariableCreationParameters::operator=(
 
 
 void VariableCreationParameters::noCompress() {
-  szip_ = false;
-  gzip_ = false;
+  szip_    = false;
+  gzip_    = false;
+  shuffle_ = false;
 }
 void VariableCreationParameters::compressWithGZIP(int level) {
   szip_       = false;
@@ -526,6 +560,10 @@ void VariableCreationParameters::compressWithSZIP(unsigned PixelsPerBlock, unsig
   szip_PixelsPerBlock_ = PixelsPerBlock;
   szip_options_        = options;
 }
+void VariableCreationParameters::setShuffle(bool shuffle) { shuffle_ = shuffle; }
+void VariableCreationParameters::keepMantissaBits(int keepBits) {
+  keepMantissaBits_ = keepBits;
+}
 
 Variable VariableCreationParameters::applyImmediatelyAfterVariableCreation(Variable h) const {
   try {
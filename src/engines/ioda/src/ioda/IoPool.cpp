@@ -10,6 +10,8 @@
 #include <mpi.h>
 #include <numeric>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "eckit/config/LocalConfiguration.h"
 
@@ -17,6 +19,7 @@
 #include "ioda/Engines/EngineUtils.h"
 #include "ioda/Engines/HH.h"
 #include "ioda/Exception.h"
+#include "ioda/Io/BlockStatistics.h"
 #include "ioda/Io/IoPool.h"
 #include "ioda/Io/IoPoolUtils.h"
 #include "ioda/Io/WriterUtils.h"
@@ -26,6 +29,9 @@
 
 namespace ioda {
 
+constexpr char OutputCodecParameterTraitsHelper::enumTypeName[];
+constexpr util::NamedEnumerator<OutputCodec> OutputCodecParameterTraitsHelper::namedValues[];
+
 constexpr int defaultMaxPoolSize = 10;
 
 // These next two constants are the "color" values used for the MPI split comm command.
@@ -250,10 +256,12 @@ void IoPool::collectSingleFileInfo() {
 IoPool::IoPool(const oops::Parameter<IoPoolParameters> & ioPoolParams,
                const oops::RequiredPolymorphicParameter
                    <Engines::WriterParametersBase, Engines::WriterFactory> & writerParams,
+               const oops::Parameter<OutputCompressionParameters> & compressionParams,
                const eckit::mpi::Comm & commAll, const eckit::mpi::Comm & commTime,
                const util::DateTime & winStart, const util::DateTime & winEnd,
                std::size_t nlocs)
                    : params_(ioPoolParams), writer_params_(writerParams),
+                     compression_params_(compressionParams),
                      comm_all_(commAll), rank_all_(commAll.rank()), size_all_(commAll.size()),
                      comm_time_(commTime), rank_time_(commTime.rank()),
                      size_time_(commTime.size()), win_start_(winStart), win_end_(winEnd),
@@ -312,11 +320,21 @@ IoPool::IoPool(const oops::Parameter<IoPoolParameters> & ioPoolParams,
 IoPool::~IoPool() = default;
 
 //--------------------------------------------------------------------------------------
+std::size_t IoPool::chunk_target_bytes() const {
+    if (params_.value().chunkSize.value() != boost::none) {
+        return *params_.value().chunkSize.value();
+    }
+    return chunking::defaultChunkBytes;
+}
 
 //--------------------------------------------------------------------------------------
 void IoPool::save(const Group & srcGroup) {
     Group fileGroup;
     if (comm_pool_ != nullptr) {
+        // The setting is process wide, so it is only changed when asked for.
+        if (params_.value().chunkThreads.value() != boost::none) {
+            Engines::HH::setChunkThreads(*params_.value().chunkThreads.value());
+        }
         Engines::WriterCreationParameters createParams(*comm_pool_, comm_time_,
                                           create_multiple_files_, is_parallel_io_);
         std::unique_ptr<Engines::WriterBase> writerEngine =
@@ -429,6 +447,43 @@ void IoPool::workaroundFixToVarLenStrings(const std::string & finalFileName,
     }
 }
 
+//--------------------------------------------------------------------------------------
+void IoPool::saveBlockStatistics(const std::string & fileName) {
+    // The file is complete at this point, so the statistics can be taken from what
+    // is in it. Each block is one chunk of MetaData/dateTime.
+    Group fileGroup = Engines::HH::openFile(fileName, Engines::BackendOpenModes::Read_Write);
+    if (!writeBlockStatistics(fileGroup)) {
+        oops::Log::info() << "WARNING: block statistics not written to " << fileName
+                          << " since it has no epoch style MetaData/dateTime, "
+                          << "MetaData/latitude or MetaData/longitude" << std::endl;
+    }
+}
+
+//--------------------------------------------------------------------------------------
+void IoPool::saveMasterFile() {
+    int mpiTimeRank = -1;
+    std::string masterFileName = writer_params_.value().fileName;
+    if (comm_time_.size() > 1) {
+        // Keep the master files of the time bins apart, the same way as the pool files.
+        mpiTimeRank = comm_time_.rank();
+        std::size_t found = masterFileName.find_last_of(".");
+        if (found == std::string::npos)
+            found = masterFileName.length();
+        masterFileName.insert(found, "_" + std::to_string(mpiTimeRank));
+    }
+    std::vector<std::string> fileNames;
+    for (int i = 0; i < size_pool_; ++i) {
+        fileNames.push_back(uniquifyFileName(writer_params_.value().fileName, i, mpiTimeRank));
+    }
+    oops::Log::debug() << "IoPool::finalize: writing master file: " << masterFileName
+                       << std::endl;
+
+    // The block statistics of the pool files describe their own locations only, so they
+    // are left out and worked out again for the whole set.
+    Engines::HH::createVirtualFile(masterFileName, fileNames, { blockStatisticsGroupName });
+    if (params_.value().writeBlockStatistics) saveBlockStatistics(masterFileName);
+}
+
 //--------------------------------------------------------------------------------------
 void IoPool::finalize() {
     // TODO(srh) Workaround until we get fixed length string support in the netcdf-c
@@ -449,9 +504,17 @@ void IoPool::finalize() {
         if (is_parallel_io_) {
             if (comm_pool_->rank() == 0) {
                 workaroundFixToVarLenStrings(finalFileName, tempFileName);
+                if (params_.value().writeBlockStatistics) saveBlockStatistics(finalFileName);
             }
         } else {
             workaroundFixToVarLenStrings(finalFileName, tempFileName);
+            if (params_.value().writeBlockStatistics) saveBlockStatistics(finalFileName);
+        }
+
+        // The master file refers to all of the pool's files, so wait for them to be done.
+        if (create_multiple_files_ && params_.value().writeMasterFile) {
+            comm_pool_->barrier();
+            if (comm_pool_->rank() == 0) saveMasterFile();
         }
     }
 
@@ -7,6 +7,7 @@
 #include "ioda/ObsGroup.h"
 
 #include "ioda/Engines/HH.h"
+#include "ioda/Engines/ObsStore.h"
 #include "ioda/Exception.h"
 #include "ioda/Layout.h"
 
@@ -98,6 +99,15 @@ void ObsGroup::resize(const std::vector<std::pair<Variable, ioda::Dimensions_t>>
   }
 }
 
+ObsGroup ObsGroup::clone() const {
+  try {
+    return ObsGroup(Engines::ObsStore::cloneGroup(*this), layout_);
+  } catch (...) {
+    std::throw_with_nested(Exception(
+      "An exception occurred inside ioda while cloning an ObsGroup.", ioda_Here()));
+  }
+}
+
 void ObsGroup::resizeVars(Group& g,
                           const std::vector<std::pair<Variable, ioda::Dimensions_t>>& newDims)
 {
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "ioda/Exception.h"
@@ -24,6 +25,21 @@ namespace ioda {
 namespace udunits {
 
 namespace detail {
+namespace {
+/// UDUNITS-2 is not thread-safe: its parser keeps global scanner state, and units and unit
+/// systems are shared between threads. Every call into the library holds this lock. It is
+/// recursive since a unit may be freed while it is held.
+std::recursive_mutex& udunitsMutex() {
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+void freeUnit(ut_unit* unit) {
+  std::lock_guard<std::recursive_mutex> lock(udunitsMutex());
+  ut_free(unit);
+}
+}  // namespace
+
 class Converter_impl : public Converter {
   std::shared_ptr<cv_converter> converter_;
 
@@ -75,15 +91,18 @@ Units::Units(const std::string& units_str) { *this = UnitsInterface::instance().
 
 bool Units::operator==(const Units& rhs) const {
   if (!isValid() || !rhs.isValid()) return false;
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   return ut_compare(impl_->unit.get(), rhs.impl_->unit.get()) == 0 ? true : false;
 }
 
 bool Units::isConvertibleWith(const Units& rhs) const {
   if (!isValid() || !rhs.isValid()) return false;
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   return ut_are_convertible(impl_->unit.get(), rhs.impl_->unit.get()) ? true : false;
 }
 
 std::shared_ptr<Converter> Units::getConverterTo(const Units& to) const {
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   std::shared_ptr<cv_converter> cnv(ut_get_converter(impl_->unit.get(), to.impl_->unit.get()),
                                     cv_free);
   return std::make_shared<detail::Converter_impl>(cnv);
@@ -94,7 +113,11 @@ bool Units::isValid() const { return impl_->unit.get() ? true : false; }
 void Units::print(std::ostream& out) const {
   char buf[256];
   unsigned opts = UT_UTF8 | UT_DEFINITION;
-  int len       = ut_format(impl_->unit.get(), buf, sizeof(buf), opts);
+  int len       = 0;
+  {
+    std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
+    len = ut_format(impl_->unit.get(), buf, sizeof(buf), opts);
+  }
   if (len == -1) {
     out << "Error: couldn't get units string. ";
   } else if (len == sizeof(buf)) {
@@ -105,20 +128,28 @@ void Units::print(std::ostream& out) const {
 }
 
 Units Units::operator*(const Units& rhs) const {
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   return Units{std::make_shared<detail::udunits_units_impl>(
-    std::shared_ptr<ut_unit>(ut_multiply(impl_->unit.get(), rhs.impl_->unit.get()), ut_free))};
+    std::shared_ptr<ut_unit>(ut_multiply(impl_->unit.get(), rhs.impl_->unit.get()),
+                             detail::freeUnit))};
 }
 Units Units::operator/(const Units& rhs) const {
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   return Units{std::make_shared<detail::udunits_units_impl>(
-    std::shared_ptr<ut_unit>(ut_divide(impl_->unit.get(), rhs.impl_->unit.get()), ut_free))};
+    std::shared_ptr<ut_unit>(ut_divide(impl_->unit.get(), rhs.impl_->unit.get()),
+                             detail::freeUnit))};
 }
 Units Units::raise(int power) const {
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   return Units{std::make_shared<detail::udunits_units_impl>(
-    std::shared_ptr<ut_unit>(ut_raise(impl_->unit.get(), power), ut_free))};
+    std::shared_ptr<ut_unit>(ut_raise(impl_->unit.get(), power),
+                             detail::freeUnit))};
 }
 Units Units::root(int power) const {
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   return Units{std::make_shared<detail::udunits_units_impl>(
-    std::shared_ptr<ut_unit>(ut_root(impl_->unit.get(), power), ut_free))};
+    std::shared_ptr<ut_unit>(ut_root(impl_->unit.get(), power),
+                             detail::freeUnit))};
 }
 
 UnitsInterface::UnitsInterface(const std::string& xmlpath) {
@@ -131,6 +162,7 @@ UnitsInterface::UnitsInterface(const std::string& xmlpath) {
 UnitsInterface::~UnitsInterface() = default;
 
 const UnitsInterface& UnitsInterface::instance(const std::string& xmlpath) {
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   static std::map<std::string, std::shared_ptr<const UnitsInterface> > instances;
   if (!instances.count(xmlpath))
     instances[xmlpath] = std::shared_ptr<const UnitsInterface>(new UnitsInterface(xmlpath));
@@ -139,8 +171,9 @@ const UnitsInterface& UnitsInterface::instance(const std::string& xmlpath) {
 }
 
 Units UnitsInterface::units(const std::string& units_str) const {
+  std::lock_guard<std::recursive_mutex> lock(detail::udunitsMutex());
   std::shared_ptr<ut_unit> inunit(ut_parse(impl_->utsys_.get(), units_str.c_str(), UT_UTF8),
-                                  ut_free);
+                                  detail::freeUnit);
   return Units{std::make_shared<detail::udunits_units_impl>(inunit)};
 }
 
@@ -425,6 +425,21 @@ Variable Variable_Base<>::read(gsl::span<char> data, const Type& in_memory_dataT
   }
 }
 
+template <>
+bool Variable_Base<>::readDictionaryEncoded(std::vector<int>& codes,
+                                            std::vector<std::string>& dictionary,
+                                            const Selection& file_selection) const {
+  try {
+    // Backends that do not override this function do not dictionary encode.
+    if (backend_ == nullptr) return false;
+    return backend_->readDictionaryEncoded(codes, dictionary, file_selection);
+  } catch (...) {
+    std::throw_with_nested(Exception(
+      "An exception occurred inside ioda while reading dictionary codes from a variable.",
+      ioda_Here()));
+  }
+}
+
 template <>
 Selections::SelectionBackend_t Variable_Base<>::instantiateSelection(const Selection& sel) const {
   try {
@@ -10,7 +10,10 @@
 #include "ioda/Io/WriterUtils.h"
 
 #include <functional>
+#include <algorithm>
 #include <numeric>
+#include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "eckit/mpi/Comm.h"
@@ -160,7 +163,84 @@ void transferVarDataMPI(const IoPool & ioPool, const Variable & srcVar,
     }
 }
 
+// Dictionary encode strings: codes index into dictionary.
+void dictionaryEncodeStrings(const std::vector<std::string> & strings,
+                             std::vector<int> & codes,
+                             std::vector<std::string> & dictionary) {
+    std::unordered_map<std::string, int> codesByValue;
+    codes.resize(strings.size());
+    dictionary.clear();
+    for (std::size_t i = 0; i < strings.size(); ++i) {
+        auto icode = codesByValue.find(strings[i]);
+        if (icode == codesByValue.end()) {
+            icode = codesByValue.emplace(strings[i], static_cast<int>(dictionary.size())).first;
+            dictionary.push_back(strings[i]);
+        }
+        codes[i] = icode->second;
+    }
+}
+
+// Send codes[start, start+count) plus the dictionary entries they refer to. The entries
+// are renumbered so that only referenced values are sent.
+void sendDictionaryEncoded(const IoPool & ioPool, const std::vector<int> & codes,
+                           const std::vector<std::string> & dictionary,
+                           const std::size_t start, const std::size_t count,
+                           const int toRank, const int tag) {
+    std::vector<int> newCodes(dictionary.size(), -1);
+    std::vector<int> sendCodes(count);
+    std::vector<char> dictBuffer;
+    int numValues = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        int code = codes[start + i];
+        if (newCodes[code] < 0) {
+            newCodes[code] = numValues++;
+            dictBuffer.insert(dictBuffer.end(), dictionary[code].begin(), dictionary[code].end());
+            dictBuffer.push_back('\0');
+        }
+        sendCodes[i] = newCodes[code];
+    }
+    long dictSize = static_cast<long>(dictBuffer.size());
+    ioPool.comm_all().send(&dictSize, 1, toRank, tag);
+    ioPool.comm_all().send(dictBuffer.data(), dictBuffer.size(), toRank, tag);
+    ioPool.comm_all().send(sendCodes.data(), sendCodes.size(), toRank, tag);
+}
+
+// Receive what sendDictionaryEncoded sent, and decode it into strings[start, start+count).
+void receiveDictionaryEncoded(const IoPool & ioPool, std::vector<std::string> & strings,
+                              const std::size_t start, const std::size_t count,
+                              const int fromRank, const int tag) {
+    long dictSize;
+    ioPool.comm_all().receive(&dictSize, 1, fromRank, tag);
+    std::vector<char> dictBuffer(dictSize);
+    ioPool.comm_all().receive(dictBuffer.data(), dictBuffer.size(), fromRank, tag);
+    std::vector<int> recvCodes(count);
+    ioPool.comm_all().receive(recvCodes.data(), recvCodes.size(), fromRank, tag);
+
+    std::vector<std::string> dictionary;
+    auto strStart = dictBuffer.begin();
+    while (strStart != dictBuffer.end()) {
+        auto strEnd = std::find(strStart, dictBuffer.end(), '\0');
+        if (strEnd == dictBuffer.end()) {
+            throw Exception("End of string not found during MPI transfer", ioda_Here());
+        }
+        dictionary.emplace_back(strStart, strEnd);
+        strStart = strEnd + 1;
+    }
+    for (std::size_t j = 0; j < count; ++j) {
+        if ((recvCodes[j] < 0) ||
+            (static_cast<std::size_t>(recvCodes[j]) >= dictionary.size())) {
+            throw Exception("Bad string code received during MPI transfer", ioda_Here())
+                .add("code", recvCodes[j]).add("dictionary size", dictionary.size());
+        }
+        strings[start + j] = dictionary[recvCodes[j]];
+    }
+}
+
 // template specialization for std::string
+//
+// Strings are sent as dictionary codes plus the table of distinct values they refer to,
+// which for typical (low cardinality) string variables is far smaller than the strings
+// themselves. The strLen argument is not needed by this transfer.
 template <>
 void transferVarDataMPI<std::string>(const IoPool & ioPool, const Variable & srcVar,
                         const std::string & varName, const int varNumber,
@@ -168,11 +248,10 @@ void transferVarDataMPI<std::string>(const IoPool & ioPool, const Variable & src
                         const std::vector<std::size_t> & varCounts,
                         const Dimensions_t dimFactor, Group & dest,
                         const bool isParallelIo, const std::size_t strLen) {
-    int maxStringLength = strLen + 1;
-
-    std::vector<std::string> varData;
-    srcVar.read<std::string>(varData);
     if (ioPool.rank_pool() >= 0) {
+        std::vector<std::string> varData;
+        srcVar.read<std::string>(varData);
+
         // Resize varData according to total nlocs.
         Dimensions_t numElements = ioPool.total_nlocs() * dimFactor;
         varData.resize(numElements);
@@ -181,17 +260,8 @@ void transferVarDataMPI<std::string>(const IoPool & ioPool, const Variable & src
         for (std::size_t i = 0; i < ioPool.rank_assignment().size(); ++i) {
             int fromRank = ioPool.rank_assignment()[i].first;
             int tag = mpiTagBase + (varNumber * varNumTagFactor) + fromRank;
-            std::vector<char> strBuffer(varCounts[i] * maxStringLength, '\0');
-            ioPool.comm_all().receive(strBuffer.data(), strBuffer.size(), fromRank, tag);
-            for (std::size_t j = 0; j < varCounts[i]; ++j) {
-                std::size_t offset = j * maxStringLength;
-                auto strEnd = std::find(strBuffer.begin() + offset, strBuffer.end(), '\0');
-                if (strEnd == strBuffer.end()) {
-                    throw Exception("End of string not found during MPI transfer", ioda_Here());
-                }
-                std::string str(strBuffer.begin() + offset, strEnd);
-                varData[varStarts[i] + j] = str;
-            }
+            receiveDictionaryEncoded(ioPool, varData, varStarts[i], varCounts[i],
+                                     fromRank, tag);
         }
         Variable destVar = dest.vars.open(varName);
         if (isParallelIo) {
@@ -204,29 +274,112 @@ void transferVarDataMPI<std::string>(const IoPool & ioPool, const Variable & src
             destVar.write<std::string>(varData);
         }
     } else {
-        // Non io pool ranks. These ranks will always read their data from src, and send it as
-        // is to their assigned io pool rank.
+        // Non io pool ranks. These ranks will always read their data from src, and send it
+        // to their assigned io pool rank. Use the backend's own dictionary encoding when it
+        // has one, so that no strings are created here.
+        std::vector<int> codes;
+        std::vector<std::string> dictionary;
+        if (!srcVar.readDictionaryEncoded(codes, dictionary)) {
+            std::vector<std::string> varData;
+            srcVar.read<std::string>(varData);
+            dictionaryEncodeStrings(varData, codes, dictionary);
+        }
         for (std::size_t i = 0; i < ioPool.rank_assignment().size(); ++i) {
             int toRank = ioPool.rank_assignment()[i].first;
             int tag = mpiTagBase + (varNumber * varNumTagFactor) + ioPool.rank_all();
-            std::vector<char> strBuffer(varCounts[i] * maxStringLength, '\0');
-            for (std::size_t i = 0; i < varData.size(); ++i) {
-                for (std::size_t j = 0; j < varData[i].size(); ++j) {
-                    std::size_t bufIndx = (i * maxStringLength) + j;
-                    strBuffer[(i * maxStringLength) + j] = varData[i][j];
-                }
-            }
-            ioPool.comm_all().send(strBuffer.data(), strBuffer.size(), toRank, tag);
+            sendDictionaryEncoded(ioPool, codes, dictionary, varStarts[i], varCounts[i],
+                                  toRank, tag);
+        }
+    }
+}
+
+bool matchesPattern(const std::string & pattern, const std::string & name) {
+    // Glob style match: '*' matches any sequence, '?' matches any single character.
+    std::size_t p = 0;
+    std::size_t n = 0;
+    std::size_t starPos = std::string::npos;
+    std::size_t starMatch = 0;
+    while (n < name.size()) {
+        if ((p < pattern.size()) && ((pattern[p] == '?') || (pattern[p] == name[n]))) {
+            ++p;
+            ++n;
+        } else if ((p < pattern.size()) && (pattern[p] == '*')) {
+            starPos = p++;
+            starMatch = n;
+        } else if (starPos != std::string::npos) {
+            p = starPos + 1;
+            n = ++starMatch;
+        } else {
+            return false;
+        }
+    }
+    while ((p < pattern.size()) && (pattern[p] == '*')) ++p;
+    return (p == pattern.size());
+}
+
+void applyCompressionSpec(const OutputCompressionSpecParameters & spec,
+                          const bool isString, const bool isFloat,
+                          VariableCreationParameters & params) {
+    params.noCompress();
+    if (isFloat && (spec.keepMantissaBits.value() != boost::none)) {
+        params.keepMantissaBits(*spec.keepMantissaBits.value());
+    }
+    // szip only handles numeric data
+    if ((spec.codec.value() == OutputCodec::None) ||
+        (isString && (spec.codec.value() == OutputCodec::Szip))) {
+        return;
+    }
+    if (spec.codec.value() == OutputCodec::Deflate) {
+        params.compressWithGZIP(spec.level.value());
+    } else {
+        params.compressWithSZIP(spec.pixelsPerBlock.value());
+    }
+    params.setShuffle(spec.shuffle.value());
+    // Filters require chunked storage. Without explicit chunk sizes the chunking
+    // strategy picks them from the variable dimensions.
+    params.chunk = true;
+}
+
+void applyOutputCompression(const IoPool & ioPool, const std::string & varName,
+                            const Dimensions & varDims, const bool isString,
+                            const bool isFloat, VariableCreationParameters & params) {
+    // Scalars cannot be chunked, so they cannot be compressed either.
+    if (varDims.dimensionality == 0) return;
+    const OutputCompressionParameters & compression = ioPool.compression_params();
+    const std::size_t sepPos = varName.find_last_of('/');
+    const std::string groupName =
+        (sepPos == std::string::npos) ? std::string() : varName.substr(0, sepPos);
+    for (const auto & policy : compression.policies.value()) {
+        const std::string & pattern = policy.name.value();
+        if (matchesPattern(pattern, varName) ||
+            (!groupName.empty() && matchesPattern(pattern, groupName))) {
+            applyCompressionSpec(policy, isString, isFloat, params);
+            return;
         }
     }
+    if (compression.defaultSpec.value() != boost::none) {
+        applyCompressionSpec(*compression.defaultSpec.value(), isString, isFloat, params);
+    }
+}
+
+void setOutputChunks(const IoPool & ioPool, const Dimensions & varDims,
+                     const std::size_t elementSize, VariableCreationParameters & params) {
+    // The chunks of the source variable were sized for the memory backend (eg, one frame
+    // of locations); size them for the whole output variable instead.
+    if (!params.chunk || (varDims.dimensionality == 0)) return;
+    params.chunkTargetBytes = ioPool.chunk_target_bytes();
+    params.chunks = chunking::sizeTargetedChunks(varDims.dimsCur, elementSize,
+                                                 params.chunkTargetBytes);
 }
 
 template <typename VarType>
-void createVariable(const std::string & varName, const Variable & srcVar,
-                    const int adjustNlocs, Has_Variables & destVars,
+void createVariable(const IoPool & ioPool, const std::string & varName,
+                    const Variable & srcVar, const int adjustNlocs, Has_Variables & destVars,
                     const std::size_t strLen) {
     VariableCreationParameters params = srcVar.getCreationParameters(false, false);
     Dimensions varDims = srcVar.getDimensions();
+    applyOutputCompression(ioPool, varName, varDims, false,
+                           std::is_floating_point<VarType>::value, params);
     // If adjust Nlocs is >= 0, this means that this is a variable that needs
     // to be created with the total number of locations from the MPI tasks in the pool.
     if (adjustNlocs >= 0) {
@@ -235,15 +388,16 @@ void createVariable(const std::string & varName, const Variable & srcVar,
             varDims.dimsMax[0] = adjustNlocs;
         }
     }
+    setOutputChunks(ioPool, varDims, sizeof(VarType), params);
     Variable destVar = destVars.create<VarType>(varName, varDims, params);
     copyAttributes(srcVar.atts, destVar.atts);
 }
 
 // createVariable specialization for string
 template <>
-void createVariable<std::string>(const std::string & varName, const Variable & srcVar,
-                                 const int adjustNlocs, Has_Variables & destVars,
-                                 const std::size_t strLen) {
+void createVariable<std::string>(const IoPool & ioPool, const std::string & varName,
+                                 const Variable & srcVar, const int adjustNlocs,
+                                 Has_Variables & destVars, const std::size_t strLen) {
     // Since the fill value is coming from a variable length string, and we are
     // writing out a fixed length string, the fill value might be a longer length
     // than the string length. For now, record the fill value in an attribute
@@ -255,6 +409,7 @@ void createVariable<std::string>(const std::string & varName, const Variable & s
     std::string origFillValue = detail::getFillValue<std::string>(fv);
     params.unsetFillValue();
     Dimensions varDims = srcVar.getDimensions();
+    applyOutputCompression(ioPool, varName, varDims, true, false, params);
     // If adjust Nlocs is >= 0, this means that this is a variable that needs
     // to be created with the total number of locations from the MPI tasks in the pool.
     if (adjustNlocs >= 0) {
@@ -266,6 +421,7 @@ void createVariable<std::string>(const std::string & varName, const Variable & s
     // Set the string length in a specialized type.
     Type fixedStrType =
         destVars.getTypeProvider()->makeStringType(typeid(std::string), strLen);
+    setOutputChunks(ioPool, varDims, strLen, params);
 
     Variable destVar = destVars.create(varName, fixedStrType, varDims, params);
     copyAttributes(srcVar.atts, destVar.atts);
@@ -351,15 +507,28 @@ void calcMaxStringLengths(const ioda::IoPool & ioPool,
         std::string varName = namedVar.name;
         Variable var = namedVar.var;
         if (var.isA<std::string>()) {
-            // Variable is a string type. Read in the values and find the maximum
-            // string length. Then do an allReduce to send the maximum of all ranks
-            // to every rank.
-            std::vector<std::string> varData;
-            var.read(varData);
+            // Variable is a string type. Find the maximum string length, then do an
+            // allReduce to send the maximum of all ranks to every rank. When the
+            // backend keeps the variable dictionary encoded, only the distinct values
+            // that are in use need to be examined.
             std::size_t maxStringLen = 0;
-            for (std::size_t i = 0; i < varData.size(); ++i) {
-                if (varData[i].size() > maxStringLen) {
-                    maxStringLen = varData[i].size();
+            std::vector<int> codes;
+            std::vector<std::string> dictionary;
+            if (var.readDictionaryEncoded(codes, dictionary)) {
+                std::vector<bool> inUse(dictionary.size(), false);
+                for (const int code : codes) inUse[code] = true;
+                for (std::size_t i = 0; i < dictionary.size(); ++i) {
+                    if (inUse[i] && (dictionary[i].size() > maxStringLen)) {
+                        maxStringLen = dictionary[i].size();
+                    }
+                }
+            } else {
+                std::vector<std::string> varData;
+                var.read(varData);
+                for (std::size_t i = 0; i < varData.size(); ++i) {
+                    if (varData[i].size() > maxStringLen) {
+                        maxStringLen = varData[i].size();
+                    }
                 }
             }
             std::size_t globalMaxStringLen;
@@ -457,7 +626,8 @@ void ioWriteGroup(const ioda::IoPool & ioPool, const ioda::Group& memGroup,
           old_var,
           [&](auto typeDiscriminator) {
               typedef decltype(typeDiscriminator) T;
-              createVariable<T>(var_name, old_var, adjustNlocs, fileGroup.vars, strLen);
+              createVariable<T>(ioPool, var_name, old_var, adjustNlocs, fileGroup.vars,
+                                strLen);
           },
           VarUtils::ThrowIfVariableIsOfUnsupportedType(var_name));
     }
@@ -25,6 +25,7 @@
 #include "ioda/Engines/HH.h"
 #include "ioda/Exception.h"
 #include "ioda/Group.h"
+#include "ioda/Io/BlockStatistics.h"
 #include "ioda/ObsGroup.h"
 #include "ioda/Misc/DimensionScales.h"
 #include "ioda/Misc/StringFuncs.h"
@@ -368,6 +369,7 @@ void copyAttributes(const ioda::Has_Attributes& src, ioda::Has_Attributes& dest)
 
 struct UpgradeParameters {
   bool groupSimilarVariables = true;
+  bool writeBlockStatistics = false;
 };
 
 bool upgradeFile(const std::string& inputName, const std::string& outputName, const UpgradeParameters &params) {
@@ -382,6 +384,14 @@ bool upgradeFile(const std::string& inputName, const std::string& outputName, co
 
   collectVarDimInfo(in, varList, dimVarList, dimsAttachedToVars, maxVarSize0);
 
+  // Block statistics describe the input file. Drop them; they are regenerated on request.
+  auto isBlockStatsVar = [](const Named_Variable& v) { return isBlockStatisticsVariable(v.name); };
+  varList.erase(remove_if(varList.begin(), varList.end(), isBlockStatsVar), varList.end());
+  dimVarList.erase(remove_if(dimVarList.begin(), dimVarList.end(), isBlockStatsVar),
+                   dimVarList.end());
+  for (auto it = dimsAttachedToVars.begin(); it != dimsAttachedToVars.end();)
+    it = isBlockStatsVar(it->first) ? dimsAttachedToVars.erase(it) : next(it);
+
   // Figure out which variables can be combined
   Vec_Named_Variable ungrouped_varList;
   VarDimMap old_grouped_vars;
@@ -515,23 +525,9 @@ bool upgradeFile(const std::string& inputName, const std::string& outputName, co
       // TODO(ryan): turn on chunking and compression everywhere relevant.
       VariableCreationParameters adjustedParams = params;
       adjustedParams.chunk                      = true;
-      {
-        // Ideal chunking is a bit complicated.
-        // Start with using all dimensions. If this is greater than 6400,
-        // reduce the rightmost dimension. If rightmost dimension equals 1,
-        // then target the second-to-last dimension, and so on.
-        adjustedParams.chunks = dims.dimsCur;  // Initial suggestion.
-        auto& c               = adjustedParams.chunks;
-        const Dimensions_t max_chunk_size = 6400;
-        while (accumulate(c.begin(), c.end(),
-          static_cast<Dimensions_t>(1), multiplies<Dimensions_t>())> max_chunk_size)
-        {
-          auto dim = c.rbegin();
-          while (*dim == 1) dim++;
-          *dim /= 2;
-        }
-
-      }
+      // Chunks of about chunking::defaultChunkBytes, in whole rows of locations.
+      adjustedParams.chunks = chunking::sizeTargetedChunks(
+        dims.dimsCur, oldVar.var.getType().getSize(), adjustedParams.chunkTargetBytes);
 
       // make sure we are not specifying zero chunk sizes
       checkAdjustChunkSizes(adjustedParams, defaultChunkSize);
@@ -649,6 +645,12 @@ bool upgradeFile(const std::string& inputName, const std::string& outputName, co
     }
   }
 
+  if (params.writeBlockStatistics) {
+    cout << "\n Writing block statistics.\n";
+    if (!writeBlockStatistics(out))
+      cout << "  Skipped: the file has no epoch style MetaData/dateTime, MetaData/latitude"
+           << " or MetaData/longitude.\n";
+  }
 
   return true;
 }
@@ -658,32 +660,33 @@ int main(int argc, char** argv) {
   try {
     // Program options
     auto doHelp = []() {
-      cerr << "Usage: ioda-upgrade.x [-n] input_file output_file\n"
-           << "       -n: do not group similar variables into one 2D varible\n";
+      cerr << "Usage: ioda-upgrade.x [-n] [-s] input_file output_file\n"
+           << "       -n: do not group similar variables into one 2D varible\n"
+           << "       -s: write block statistics of the location metadata\n";
       exit(1);
     };
     // quick and dirty argument parsing meant to hold us over until the YAML
     // configuration is implemented
     string sInputFile;
     string sOutputFile;
-    bool groupVariables = true;
-    if (argc == 3) {
-      sInputFile = argv[1];
-      sOutputFile = argv[2];
-    } else if ((argc == 4) && (strcmp(argv[1],"-n") == 0)) {
-      sInputFile = argv[2];
-      sOutputFile = argv[3];
-      groupVariables = false;
-    } else {
-      doHelp();
+    UpgradeParameters params;
+    int iarg = 1;
+    for (; (iarg < argc) && (argv[iarg][0] == '-'); ++iarg) {
+      if (strcmp(argv[iarg], "-n") == 0)
+        params.groupSimilarVariables = false;
+      else if (strcmp(argv[iarg], "-s") == 0)
+        params.writeBlockStatistics = true;
+      else
+        doHelp();
     }
+    if (argc - iarg != 2) doHelp();
+    sInputFile = argv[iarg];
+    sOutputFile = argv[iarg + 1];
 
     // Parse YAML file here
     // Unimplemented
 
     cout << "Input: " << sInputFile << "\nOutput: " << sOutputFile << endl;
-    UpgradeParameters params;
-    params.groupSimilarVariables = groupVariables;
     upgradeFile(sInputFile, sOutputFile, params);
     cout << " Success!\n";
 
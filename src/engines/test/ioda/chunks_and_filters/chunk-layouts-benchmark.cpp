@@ -0,0 +1,141 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/// \file chunk-layouts-benchmark.cpp
+/// \brief Compare read and write times of a compressed (locations, channels) variable
+///   stored with different chunk layouts.
+/// \details Usage: ioda-chunk-layouts-benchmark [nlocs [nchans [file]]]
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ioda/Engines/HH.h"
+#include "ioda/Exception.h"
+#include "ioda/Group.h"
+
+namespace {
+struct Layout {
+  std::string name;
+  std::function<std::vector<ioda::Dimensions_t>(const std::vector<ioda::Dimensions_t>&)> chunks;
+};
+
+double seconds(const std::function<void()>& f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double fileMegabytes(const std::string& name) {
+  struct stat st;
+  return (stat(name.c_str(), &st) == 0) ? st.st_size / (1024.0 * 1024.0) : 0;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  using namespace ioda;
+  try {
+    const Dimensions_t nlocs  = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    const Dimensions_t nchans = (argc > 2) ? std::atol(argv[2]) : 16;
+    const std::string file    = (argc > 3) ? argv[3] : "chunk-layouts-benchmark.h5";
+    const Dimensions_t frame  = 10000;  // locations per frame read
+    const std::vector<Dimensions_t> dims{nlocs, nchans};
+
+    std::vector<float> values(static_cast<std::size_t>(nlocs * nchans));
+    for (std::size_t i = 0; i < values.size(); ++i)
+      values[i] = 250.0f + 30.0f * static_cast<float>(std::sin(0.001 * i));
+
+    const std::vector<Layout> layouts{
+      {"one chunk", [](const std::vector<Dimensions_t>& d) { return d; }},
+      {"6400 values",  // the former ioda-upgrade default
+       [](const std::vector<Dimensions_t>& d) {
+         return chunking::sizeTargetedChunks(d, sizeof(float), 6400 * sizeof(float));
+       }},
+      {"256 KiB",
+       [](const std::vector<Dimensions_t>& d) {
+         return chunking::sizeTargetedChunks(d, sizeof(float), 256 * 1024);
+       }},
+      {"1 MiB (default)",
+       [](const std::vector<Dimensions_t>& d) {
+         return chunking::sizeTargetedChunks(d, sizeof(float));
+       }},
+      {"4 MiB",
+       [](const std::vector<Dimensions_t>& d) {
+         return chunking::sizeTargetedChunks(d, sizeof(float), 4 * 1024 * 1024);
+       }},
+    };
+
+    std::cout << "nlocs = " << nlocs << ", nchans = " << nchans
+              << ", deflate level 6 with shuffle\n";
+    std::printf("%-16s %-14s %9s %9s %9s %9s %9s\n", "layout", "chunks", "MB", "write s",
+                "read s", "frames s", "chan s");
+    for (const auto& layout : layouts) {
+      const std::vector<Dimensions_t> chunks = layout.chunks(dims);
+      double writeTime = 0;
+      {
+        Group f = Engines::HH::createFile(file, Engines::BackendCreateModes::Truncate_If_Exists);
+        VariableCreationParameters params;
+        params.chunk            = true;
+        params.chunks           = chunks;
+        params.chunkTargetBytes = 0;
+        params.compressWithGZIP(6);
+        params.setShuffle();
+        Variable var = f.vars.create<float>("brightnessTemperature", dims, dims, params);
+        writeTime    = seconds([&]() { var.write(values); });
+      }
+
+      Group f = Engines::HH::openFile(file, Engines::BackendOpenModes::Read_Only);
+      Variable var = f.vars.open("brightnessTemperature");
+      std::vector<float> all;
+      const double readTime = seconds([&]() { var.read(all); });
+
+      // Location frames, as read by ObsFrameRead.
+      const double frameTime = seconds([&]() {
+        std::vector<float> buf;
+        for (Dimensions_t start = 0; start < nlocs; start += frame) {
+          const Dimensions_t count = std::min(frame, nlocs - start);
+          buf.resize(static_cast<std::size_t>(count * nchans));
+          // Named starts and counts: a braced {0} would pick the dimension-index overload.
+          const std::vector<Dimensions_t> memStart{0}, memCount{count * nchans};
+          const std::vector<Dimensions_t> fileStart{start, 0}, fileCount{count, nchans};
+          var.read<float>(gsl::make_span(buf),
+                          Selection().extent({count * nchans})
+                            .select({SelectionOperator::SET, memStart, memCount}),
+                          Selection().select({SelectionOperator::SET, fileStart, fileCount}));
+        }
+      });
+
+      // One channel of every location.
+      const double chanTime = seconds([&]() {
+        std::vector<float> buf(static_cast<std::size_t>(nlocs));
+        const std::vector<Dimensions_t> memStart{0}, memCount{nlocs};
+        var.read<float>(gsl::make_span(buf),
+                        Selection().extent({nlocs}).select({SelectionOperator::SET, memStart,
+                                                            memCount}),
+                        Selection().select({SelectionOperator::SET, {0, nchans / 2}, {nlocs, 1}}));
+      });
+
+      if (all != values) throw Exception("Values read back differ.", ioda_Here());
+      const std::string chunkStr = std::to_string(chunks[0]) + "x" + std::to_string(chunks[1]);
+      std::printf("%-16s %-14s %9.1f %9.3f %9.3f %9.3f %9.3f\n", layout.name.c_str(),
+                  chunkStr.c_str(), fileMegabytes(file), writeTime, readTime, frameTime,
+                  chanTime);
+    }
+    std::remove(file.c_str());
+  } catch (const std::exception& e) {
+    ioda::unwind_exception_stack(e);
+    return 1;
+  }
+  return 0;
+}
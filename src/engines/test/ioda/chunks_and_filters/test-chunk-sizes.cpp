@@ -0,0 +1,65 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "ioda/Engines/HH.h"
+#include "ioda/Group.h"
+
+using namespace eckit::testing;
+
+namespace ioda {
+namespace test {
+
+typedef std::vector<Dimensions_t> Dims;
+
+CASE("Size-targeted chunks keep whole rows of locations") {
+  // Small variables are a single chunk.
+  EXPECT(chunking::sizeTargetedChunks({1000}, 4, 1024 * 1024) == Dims({1000}));
+  EXPECT(chunking::sizeTargetedChunks({1000, 16}, 4, 1024 * 1024) == Dims({1000, 16}));
+
+  // Large ones are cut along the locations only.
+  EXPECT(chunking::sizeTargetedChunks({10000000}, 4, 1024 * 1024) == Dims({262144}));
+  EXPECT(chunking::sizeTargetedChunks({10000000, 16}, 8, 1024 * 1024) == Dims({8192, 16}));
+
+  // Rows over the target have their largest trailing dimension halved.
+  EXPECT(chunking::sizeTargetedChunks({100, 3000, 10}, 8, 64 * 1024) == Dims({1, 750, 10}));
+
+  // Unknown sizes and a zero target are left alone.
+  EXPECT(chunking::sizeTargetedChunks({0, 16}, 4) == Dims({0, 16}));
+  EXPECT(chunking::sizeTargetedChunks({10000000}, 4, 0) == Dims({10000000}));
+}
+
+CASE("HDF5 variables get size-targeted chunks by default") {
+  Group f = Engines::HH::createMemoryFile(Engines::HH::genUniqueName(),
+                                          Engines::BackendCreateModes::Truncate_If_Exists);
+  VariableCreationParameters params;
+  params.chunk = true;
+
+  // Chunks from the dimensions are shrunk to the target size.
+  params.chunkTargetBytes = 64 * 1024;
+  Variable big = f.vars.create<double>("big", {100000, 4}, {Unlimited, 4}, params);
+  EXPECT(big.getChunkSizes() == Dims({2048, 4}));
+
+  // Small chunks set by the caller are kept.
+  params.chunks = {64, 2};
+  EXPECT(f.vars.create<double>("small", {100000, 4}, {100000, 4}, params).getChunkSizes()
+         == Dims({64, 2}));
+
+  // A zero target gives the old behavior.
+  params.chunks.clear();
+  params.chunkTargetBytes = 0;
+  EXPECT(f.vars.create<double>("whole", {100000, 4}, {100000, 4}, params).getChunkSizes()
+         == Dims({100000, 4}));
+}
+
+}  // namespace test
+}  // namespace ioda
+
+int main(int argc, char **argv) { return run_tests(argc, argv); }
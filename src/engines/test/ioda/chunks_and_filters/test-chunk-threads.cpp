@@ -0,0 +1,194 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include <hdf5.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "ioda/Engines/HH.h"
+#include "ioda/Group.h"
+
+using namespace eckit::testing;
+
+namespace ioda {
+namespace test {
+
+std::vector<double> testValues(std::size_t n) {
+  std::vector<double> values(n);
+  for (std::size_t i = 0; i < n; ++i) values[i] = 100.0 * std::sin(0.01 * i);
+  return values;
+}
+
+/// Write values with the given chunking and compression, then read them back.
+std::vector<double> roundTrip(Group &f, const std::string &name, const std::vector<double> &values,
+                              const std::vector<Dimensions_t> &dims,
+                              const std::vector<Dimensions_t> &chunks, bool shuffle) {
+  VariableCreationParameters params;
+  params.chunk  = true;
+  params.chunks = chunks;
+  params.compressWithGZIP(6);
+  params.setShuffle(shuffle);
+  params.setFillValue<double>(-999);
+  Variable var = f.vars.create<double>(name, dims, dims, params);
+  var.write(values);
+
+  std::vector<double> result;
+  f.vars.open(name).read(result);
+  return result;
+}
+
+#if H5_VERSION_GE(1, 10, 5)
+/// The chunks of a dataset as stored in the file (after the filters), by chunk offset.
+std::map<std::vector<hsize_t>, std::vector<char>> storedChunks(hid_t file,
+                                                               const std::string &name) {
+  std::map<std::vector<hsize_t>, std::vector<char>> chunks;
+  hid_t dset  = H5Dopen2(file, name.c_str(), H5P_DEFAULT);
+  hid_t space = H5Dget_space(dset);
+  const int rank = H5Sget_simple_extent_ndims(space);
+  hsize_t numChunks = 0;
+  EXPECT(H5Dget_num_chunks(dset, space, &numChunks) >= 0);
+  for (hsize_t i = 0; i < numChunks; ++i) {
+    std::vector<hsize_t> offset(rank);
+    unsigned filterMask = 0;
+    haddr_t address     = 0;
+    hsize_t size        = 0;
+    EXPECT(H5Dget_chunk_info(dset, space, i, offset.data(), &filterMask, &address, &size) >= 0);
+    std::vector<char> &chunk = chunks[offset];
+    chunk.resize(size);
+    uint32_t filters = 0;
+    EXPECT(H5Dread_chunk(dset, H5P_DEFAULT, offset.data(), &filters, chunk.data()) >= 0);
+  }
+  H5Sclose(space);
+  H5Dclose(dset);
+  return chunks;
+}
+#endif
+
+CASE("Chunks compressed on several threads read back unchanged") {
+  const std::string fileName = "test-chunk-threads.hdf5";
+  {
+    Group f = Engines::HH::createFile(fileName, Engines::BackendCreateModes::Truncate_If_Exists);
+    for (std::size_t numThreads : {1, 4}) {
+      Engines::HH::setChunkThreads(numThreads);
+      const std::string suffix = std::to_string(numThreads);
+      const std::size_t chunksBefore = Engines::HH::getChunkThreadStatistics().chunksWritten;
+
+      // One dimension, with a partial last chunk.
+      const std::vector<double> v1 = testValues(1000);
+      EXPECT(roundTrip(f, "v1_" + suffix, v1, {1000}, {64}, true) == v1);
+
+      // Several dimensions, with partial chunks along each of them.
+      const std::vector<double> v3 = testValues(10 * 7 * 9);
+      EXPECT(roundTrip(f, "v3_" + suffix, v3, {10, 7, 9}, {3, 4, 2}, false) == v3);
+
+      // Only the multithreaded setting takes the direct path: 16 + 4 * 2 * 5 chunks.
+      const std::size_t chunksWritten =
+        Engines::HH::getChunkThreadStatistics().chunksWritten - chunksBefore;
+      EXPECT_EQUAL(chunksWritten, (numThreads == 1) ? 0 : 16 + 4 * 2 * 5);
+    }
+    Engines::HH::setChunkThreads(1);
+    EXPECT(f.vars.open("v1_4").getGZIPCompression() == f.vars.open("v1_1").getGZIPCompression());
+    EXPECT(f.vars.open("v1_4").getCreationParameters(false, false).shuffle_);
+  }
+
+#if H5_VERSION_GE(1, 10, 5)
+  // Both paths store the same chunks, including the fill value padding of partial chunks.
+  hid_t file = H5Fopen(fileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  EXPECT(file >= 0);
+  for (const std::string name : {"v1", "v3"}) {
+    const auto serial   = storedChunks(file, name + "_1");
+    const auto threaded = storedChunks(file, name + "_4");
+    EXPECT(!serial.empty());
+    EXPECT(serial == threaded);
+  }
+  H5Fclose(file);
+#endif
+}
+
+CASE("Chunks decompressed on several threads match the serial read") {
+  Group f = Engines::HH::createMemoryFile(Engines::HH::genUniqueName(),
+                                          Engines::BackendCreateModes::Truncate_If_Exists);
+  const std::vector<double> v2 = testValues(37 * 13);
+  for (std::size_t numThreads : {1, 4}) {
+    // Written with one setting, read with the other.
+    Engines::HH::setChunkThreads(numThreads);
+    const std::string name = "v2_" + std::to_string(numThreads);
+    VariableCreationParameters params;
+    params.chunk  = true;
+    params.chunks = {8, 5};
+    params.compressWithGZIP(6);
+    params.setShuffle();
+    f.vars.create<double>(name, {37, 13}, {37, 13}, params).write(v2);
+
+    const std::size_t readThreads = 5 - numThreads;
+    Engines::HH::setChunkThreads(readThreads);
+    Variable var = f.vars.open(name);
+    std::size_t chunksBefore = Engines::HH::getChunkThreadStatistics().chunksRead;
+    std::vector<double> all;
+    var.read(all);
+    EXPECT(all == v2);
+    EXPECT_EQUAL(Engines::HH::getChunkThreadStatistics().chunksRead - chunksBefore,
+                 (readThreads == 1) ? 0 : 5 * 3);
+
+    // Rows 3 to 22: a contiguous block that starts and ends inside chunks (rows 0 to 23).
+    std::vector<double> rows(20 * 13);
+    const std::vector<Dimensions_t> memStart{0}, memCount{20 * 13};
+    const std::vector<Dimensions_t> rowsStart{3, 0}, rowsCount{20, 13};
+    chunksBefore = Engines::HH::getChunkThreadStatistics().chunksRead;
+    var.read<double>(gsl::make_span(rows),
+                     Selection().extent({20 * 13}).select({SelectionOperator::SET, memStart,
+                                                           memCount}),
+                     Selection().select({SelectionOperator::SET, rowsStart, rowsCount}));
+    EXPECT(std::equal(rows.begin(), rows.end(), v2.begin() + 3 * 13));
+    EXPECT_EQUAL(Engines::HH::getChunkThreadStatistics().chunksRead - chunksBefore,
+                 (readThreads == 1) ? 0 : 3 * 3);
+
+    // Column 6 of every other row does not fill its bounding box, so it goes through the
+    // library.
+    std::vector<double> col(19);
+    const std::vector<Dimensions_t> colMemStart{0}, colMemCount{19};
+    const std::vector<Dimensions_t> colStart{0, 6}, colCount{19, 1}, colStride{2, 1};
+    chunksBefore = Engines::HH::getChunkThreadStatistics().chunksRead;
+    var.read<double>(gsl::make_span(col),
+                     Selection().extent({19}).select({SelectionOperator::SET, colMemStart,
+                                                      colMemCount}),
+                     Selection().select({SelectionOperator::SET, colStart, colCount, colStride}));
+    for (std::size_t i = 0; i < col.size(); ++i) EXPECT(col[i] == v2[2 * i * 13 + 6]);
+    EXPECT_EQUAL(Engines::HH::getChunkThreadStatistics().chunksRead, chunksBefore);
+  }
+
+  // Chunks that were never written read as the fill value.
+  Engines::HH::setChunkThreads(4);
+  VariableCreationParameters params;
+  params.chunk  = true;
+  params.chunks = {64};
+  params.compressWithGZIP(6);
+  params.setFillValue<double>(-999);
+  Variable sparse = f.vars.create<double>("sparse", {1000}, {1000}, params);
+  const std::vector<Dimensions_t> memStart{0}, fileStart{128}, count{64};
+  sparse.write<double>(gsl::make_span(v2.data(), 64),
+                       Selection().extent({64}).select({SelectionOperator::SET, memStart, count}),
+                       Selection().select({SelectionOperator::SET, fileStart, count}));
+  const std::size_t chunksBefore = Engines::HH::getChunkThreadStatistics().chunksRead;
+  std::vector<double> check;
+  sparse.read(check);
+  for (std::size_t i = 0; i < check.size(); ++i)
+    EXPECT(check[i] == (((i >= 128) && (i < 192)) ? v2[i - 128] : -999));
+  EXPECT_EQUAL(Engines::HH::getChunkThreadStatistics().chunksRead - chunksBefore, 16);
+  Engines::HH::setChunkThreads(1);
+}
+
+}  // namespace test
+}  // namespace ioda
+
+int main(int argc, char **argv) { return run_tests(argc, argv); }
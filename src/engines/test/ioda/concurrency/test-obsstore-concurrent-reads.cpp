@@ -0,0 +1,89 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/// This program checks that concurrent reads of ObsStore variables, as done by
+/// multithreaded filters, give the same results as serial reads.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ioda/Engines/EngineUtils.h"
+#include "ioda/Engines/ObsStore.h"
+#include "ioda/Exception.h"
+#include "ioda/Group.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit::testing;
+
+namespace ioda {
+namespace test {
+
+const int numLocs  = 2000;
+const int numChans = 16;
+const int numThreads = 8;
+const int numRepeats = 20;
+
+CASE("Concurrent reads of shared ObsStore variables and selections") {
+  Group g = Engines::ObsStore::createRootGroup();
+
+  VariableCreationParameters params;
+  params.setFillValue<float>(-999.0f);
+  Variable radiance = g.vars.create<float>("ObsValue/radiance", {numLocs, numChans},
+                                           {numLocs, numChans}, params);
+  std::vector<float> values(numLocs * numChans);
+  for (std::size_t i = 0; i < values.size(); ++i) values[i] = static_cast<float>(i);
+  radiance.write<float>(values);
+
+  Variable station = g.vars.create<std::string>("MetaData/stationIdentification", {numLocs});
+  std::vector<std::string> stations(numLocs);
+  for (int i = 0; i < numLocs; ++i) stations[i] = "station_" + std::to_string(i % 37);
+  station.write<std::string>(stations);
+
+  // Per-channel selections, shared by all threads.
+  std::vector<Selection> memSelects(numChans);
+  std::vector<Selection> fileSelects(numChans);
+  for (int c = 0; c < numChans; ++c) {
+    memSelects[c].extent({numLocs}).select({SelectionOperator::SET, 0, {0}, {numLocs}});
+    fileSelects[c].extent({numLocs, numChans})
+      .select({SelectionOperator::SET, 0, {0}, {numLocs}})
+      .select({SelectionOperator::AND, 1, {c}});
+  }
+
+  std::vector<int> failures(numThreads, 0);
+  auto reader = [&](int ithread) {
+    for (int r = 0; r < numRepeats; ++r) {
+      for (int c = ithread % numChans; c < numChans; c += 2) {
+        // Open by path and read one channel through the shared selections.
+        Variable var = g.vars.open("ObsValue/radiance");
+        std::vector<float> chan(numLocs);
+        var.read<float>(gsl::make_span(chan), memSelects[c], fileSelects[c]);
+        for (int i = 0; i < numLocs; ++i)
+          if (chan[i] != values[i * numChans + c]) ++failures[ithread];
+
+        if (!g.vars.exists("MetaData/stationIdentification")) ++failures[ithread];
+        if (!var.hasFillValue()) ++failures[ithread];
+      }
+      std::vector<std::string> strs;
+      g.vars.open("MetaData/stationIdentification").read<std::string>(strs);
+      if (strs != stations) ++failures[ithread];
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t) threads.emplace_back(reader, t);
+  for (auto & t : threads) t.join();
+
+  for (int t = 0; t < numThreads; ++t) EXPECT_EQUAL(failures[t], 0);
+}
+
+}  // namespace test
+}  // namespace ioda
+
+int main(int argc, char** argv) {
+  return run_tests(argc, argv);
+}
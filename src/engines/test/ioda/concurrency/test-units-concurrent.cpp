@@ -0,0 +1,90 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/// This program checks that the units attributes of several files can be parsed and
+/// compared on several threads at once, as ioda-validate does in batch mode.
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ioda/Engines/ObsStore.h"
+#include "ioda/Group.h"
+#include "ioda/Units.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit::testing;
+
+namespace ioda {
+namespace test {
+
+const int numFiles   = 16;
+const int numThreads = 8;
+const int numRepeats = 20;
+
+// Variable name, units in the file and units expected by a validation spec.
+struct UnitsCase {
+  const char * varName;
+  const char * fileUnits;
+  const char * specUnits;
+  bool convertible;
+  bool exact;
+};
+
+const UnitsCase unitsCases[] = {
+  { "MetaData/latitude",        "degrees_north", "degrees_north", true,  true  },
+  { "MetaData/height",          "km",            "m",             true,  false },
+  { "ObsValue/airTemperature",  "K",             "K",             true,  true  },
+  { "ObsValue/windSpeed",       "m s-1",         "m/s",           true,  true  },
+  { "ObsValue/pressure",        "hPa",           "Pa",            true,  false },
+  { "ObsValue/specificHumidity", "kg kg-1",      "K",             false, false },
+};
+
+CASE("Concurrent parsing of the units attributes of several files") {
+  // One in-memory file per entry, each holding a variable for every case.
+  std::vector<Group> files;
+  for (int f = 0; f < numFiles; ++f) {
+    Group g = Engines::ObsStore::createRootGroup();
+    for (const UnitsCase & c : unitsCases) {
+      Variable var = g.vars.create<float>(c.varName, {10});
+      var.atts.add<std::string>("units", std::string(c.fileUnits));
+    }
+    files.push_back(g);
+  }
+
+  std::vector<int> failures(numThreads, 0);
+  auto checker = [&](int ithread) {
+    for (int r = 0; r < numRepeats; ++r) {
+      for (int f = ithread; f < numFiles; f += numThreads) {
+        for (const UnitsCase & c : unitsCases) {
+          const std::string fileUnits =
+            files[f].vars.open(c.varName).atts.read<std::string>("units");
+          const udunits::Units varUnits(fileUnits);
+          const udunits::Units specUnits(c.specUnits);
+          if (!varUnits.isValid() || !specUnits.isValid() ||
+              (varUnits.isConvertibleWith(specUnits) != c.convertible) ||
+              ((varUnits == specUnits) != c.exact)) {
+            ++failures[ithread];
+          }
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t) threads.emplace_back(checker, t);
+  for (auto & t : threads) t.join();
+
+  for (int t = 0; t < numThreads; ++t) EXPECT_EQUAL(failures[t], 0);
+}
+
+}  // namespace test
+}  // namespace ioda
+
+int main(int argc, char** argv) {
+  return run_tests(argc, argv);
+}
@@ -85,6 +85,25 @@ void test_group_backend_engine(ioda::Group g) {
   bool r2 = check2.isApprox(reference2);
   if (!r2)
     throw;  // jedi_throw.add("Reason", "Test 2 result for file_test_data1 do not match expected results");
+
+  // Try selecting index runs (starts plus counts) combined on the same dimension.
+  // Rows {0, 1} OR row {3}, and columns {1, 2}:
+  // 18  3
+  //  6  7
+  // 14 15
+  std::vector<int> check3(6);
+  file_test_data1.read<int>(gsl::make_span(check3),
+                            ioda::Selection().extent({3, 2}),
+                            ioda::Selection()
+                              .select({ioda::SelectionOperator::SET, 0, {0}, {2}})
+                              .select({ioda::SelectionOperator::OR, 0, {3}})
+                              .select({ioda::SelectionOperator::AND, 1, {1}, {2}}));
+
+  const std::vector<int> reference3{18, 3, 6, 7, 14, 15};
+
+  bool r3 = (check3 == reference3);
+  if (!r3)
+    throw;  // jedi_throw.add("Reason", "Test 3 result for file_test_data1 do not match expected results");
 }
 
 int main(int argc, char** argv) {
@@ -0,0 +1,136 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#include "ioda/Misc/BitRounding.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "ioda/Engines/HH.h"
+#include "ioda/Group.h"
+
+using namespace eckit::testing;
+
+namespace ioda {
+namespace test {
+
+template <typename T>
+std::vector<T> randomValues(std::size_t n) {
+  // Values spanning many orders of magnitude, of both signs.
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<T> mantissa(-1, 1);
+  std::uniform_int_distribution<int> exponent(-30, 30);
+  std::vector<T> values(n);
+  for (auto &value : values) value = std::ldexp(mantissa(gen), exponent(gen));
+  return values;
+}
+
+template <typename T>
+void checkErrorBound(int mantissaBits) {
+  const std::vector<T> orig = randomValues<T>(10000);
+  for (int keepBits = 0; keepBits <= mantissaBits; ++keepBits) {
+    std::vector<T> rounded = orig;
+    bitRoundMantissa(gsl::make_span(rounded), keepBits);
+    const T bound = std::ldexp(T(1), -(keepBits + 1));
+    for (std::size_t i = 0; i < orig.size(); ++i) {
+      EXPECT(std::abs(rounded[i] - orig[i]) <= bound * std::abs(orig[i]));
+    }
+    // Rounding again changes nothing.
+    std::vector<T> twice = rounded;
+    bitRoundMantissa(gsl::make_span(twice), keepBits);
+    EXPECT(twice == rounded);
+  }
+}
+
+CASE("Relative error is bounded by half a unit in the last kept bit") {
+  checkErrorBound<float>(23);
+  checkErrorBound<double>(52);
+}
+
+CASE("Trailing mantissa bits are cleared") {
+  std::vector<float> values = randomValues<float>(1000);
+  bitRoundMantissa(gsl::make_span(values), 7);
+  for (const float value : values) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    EXPECT((bits & ((1u << 16) - 1)) == 0);
+  }
+}
+
+CASE("Ties round to even") {
+  // 1 + 2^-3 is halfway between 1 and 1 + 2^-2 when keeping 2 bits: rounds down to 1.
+  // 1 + 3 * 2^-3 is halfway between 1 + 2^-2 and 1 + 2^-1: rounds up to 1 + 2^-1.
+  std::vector<double> values{1.125, 1.375, -1.125};
+  bitRoundMantissa(gsl::make_span(values), 2);
+  EXPECT(values[0] == 1.0);
+  EXPECT(values[1] == 1.5);
+  EXPECT(values[2] == -1.0);
+}
+
+CASE("Special values are preserved") {
+  const float fill = -3.3687953e+38f;
+  std::vector<float> values{fill, std::numeric_limits<float>::quiet_NaN(),
+                            std::numeric_limits<float>::infinity(), 0.0f, -0.0f, 3.14159f};
+  bitRoundMantissa(gsl::make_span(values), 3, &fill);
+  EXPECT(values[0] == fill);
+  EXPECT(std::isnan(values[1]));
+  EXPECT(values[2] == std::numeric_limits<float>::infinity());
+  EXPECT(values[3] == 0.0f);
+  EXPECT(values[4] == 0.0f);
+  EXPECT(values[5] == 3.25f);
+
+  std::vector<float> exact{3.14159f};
+  bitRoundMantissa(gsl::make_span(exact), 23);
+  EXPECT(exact[0] == 3.14159f);
+  EXPECT_THROWS(bitRoundMantissa(gsl::make_span(exact), -1));
+}
+
+CASE("HDF5 variables are rounded when written") {
+  Group f = Engines::HH::createMemoryFile(Engines::HH::genUniqueName(),
+                                          Engines::BackendCreateModes::Truncate_If_Exists);
+  const std::vector<float> orig = randomValues<float>(1000);
+  const float fill = -3.3687953e+38f;
+  std::vector<float> data = orig;
+  data[10] = fill;
+
+  VariableCreationParameters params;
+  params.chunk = true;
+  params.compressWithGZIP();
+  params.setFillValue<float>(fill);
+  params.keepMantissaBits(10);
+  Variable var = f.vars.create<float>("hofx", {1000}, {1000}, params);
+  var.write(data);
+
+  EXPECT(var.atts.read<int>(bitRoundingAttrName) == 10);
+  EXPECT(var.getCreationParameters(false, false).keepMantissaBits_ == 10);
+  std::vector<float> result;
+  f.vars.open("hofx").read(result);
+  EXPECT(result.size() == orig.size());
+  EXPECT(result[10] == fill);
+  for (std::size_t i = 0; i < orig.size(); ++i) {
+    if (i == 10) continue;
+    EXPECT(std::abs(result[i] - orig[i]) <= std::ldexp(1.0f, -11) * std::abs(orig[i]));
+  }
+
+  // Variables without the setting are written exactly.
+  Variable exact = f.vars.create<float>("exact", {1000}, {1000}, VariableCreationParameters());
+  exact.write(orig);
+  EXPECT(!exact.atts.exists(bitRoundingAttrName));
+  f.vars.open("exact").read(result);
+  EXPECT(result == orig);
+}
+
+}  // namespace test
+}  // namespace ioda
+
+int main(int argc, char **argv) { return run_tests(argc, argv); }
@@ -0,0 +1,537 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/// This program checks that ObsStore variables placed in memory-mapped scratch files,
+/// compressed or chunked storage by a storage policy, or allocated from an arena, behave
+/// exactly like in-memory variables.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ioda/Engines/ObsStore.h"
+#include "ioda/Exception.h"
+#include "ioda/Group.h"
+#include "ioda/Misc/DimensionScales.h"
+#include "ioda/config.h"  // Auto-generated. Defines *_FOUND.
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit::testing;
+
+namespace ioda {
+namespace test {
+
+CASE("Storage policy lookup") {
+  Engines::ObsStore::StorageParameters storage;
+  storage.policies["ObsValue"] = Engines::ObsStore::StorageKind::MappedFile;
+  storage.policies["ObsValue/airTemperature"] = Engines::ObsStore::StorageKind::Memory;
+  storage.policies["a/b"] = Engines::ObsStore::StorageKind::MappedFile;
+
+  EXPECT(storage.lookup("ObsValue/brightnessTemperature") ==
+         Engines::ObsStore::StorageKind::MappedFile);
+  EXPECT(storage.lookup("ObsValue/airTemperature") == Engines::ObsStore::StorageKind::Memory);
+  EXPECT(storage.lookup("a/b/c/x") == Engines::ObsStore::StorageKind::MappedFile);
+  EXPECT(storage.lookup("a/x") == Engines::ObsStore::StorageKind::Memory);
+  EXPECT(storage.lookup("MetaData/latitude") == Engines::ObsStore::StorageKind::Memory);
+
+  storage.defaultKind = Engines::ObsStore::StorageKind::MappedFile;
+  EXPECT(storage.lookup("MetaData/latitude") == Engines::ObsStore::StorageKind::MappedFile);
+  EXPECT(!storage.scratchPath().empty());
+}
+
+CASE("Mapped variables round trip") {
+  const int numLocs  = 1000;
+  const int numChans = 4;
+
+  Engines::ObsStore::StorageParameters storage;
+  storage.policies["ObsValue"] = Engines::ObsStore::StorageKind::MappedFile;
+  storage.policies["MetaData"] = Engines::ObsStore::StorageKind::MappedFile;
+  Group g = Engines::ObsStore::createRootGroup(storage);
+
+  // Numeric variable with an unlimited dimension, so that resizing is exercised.
+  VariableCreationParameters params;
+  params.setFillValue<float>(-999.0f);
+  Variable radiance = g.vars.create<float>("ObsValue/radiance", {numLocs, numChans},
+                                           {Unlimited, numChans}, params);
+  std::vector<float> values(numLocs * numChans);
+  for (std::size_t i = 0; i < values.size(); ++i) values[i] = static_cast<float>(i);
+  radiance.write<float>(values);
+
+  std::vector<float> check;
+  radiance.read<float>(check);
+  EXPECT(check == values);
+
+  // Growing the variable keeps the old values and fills the new ones.
+  radiance.resize({2 * numLocs, numChans});
+  radiance.read<float>(check);
+  EXPECT(check.size() == static_cast<std::size_t>(2 * numLocs * numChans));
+  for (std::size_t i = 0; i < values.size(); ++i) EXPECT(check[i] == values[i]);
+  for (std::size_t i = values.size(); i < check.size(); ++i) EXPECT(check[i] == -999.0f);
+
+  // Growing one location at a time, as when appending frames, and shrinking back.
+  Variable index = g.vars.create<int>("MetaData/index", {0}, {Unlimited});
+  for (int i = 0; i < numLocs; ++i) {
+    index.resize({i + 1});
+    std::vector<int> one{i};
+    index.write<int>(gsl::make_span(one), Selection().extent({1}).select({SelectionOperator::SET,
+                                                                         0, {0}, {1}}),
+                     Selection().select({SelectionOperator::SET, 0, {i}, {1}}));
+  }
+  std::vector<int> indices;
+  index.read<int>(indices);
+  EXPECT(indices.size() == static_cast<std::size_t>(numLocs));
+  for (int i = 0; i < numLocs; ++i) EXPECT(indices[i] == i);
+  index.resize({10});
+  index.resize({20});
+  index.read<int>(indices);
+  for (int i = 0; i < 10; ++i) EXPECT(indices[i] == i);
+  for (int i = 10; i < 20; ++i) EXPECT(indices[i] == 0);
+
+  // Selections behave as for in-memory storage: read channel 2 only.
+  std::vector<float> chan(numLocs);
+  radiance.read<float>(gsl::make_span(chan),
+                       Selection().extent({numLocs}).select({SelectionOperator::SET, 0, {0},
+                                                             {numLocs}}),
+                       Selection()
+                         .select({SelectionOperator::SET, 0, {0}, {numLocs}})
+                         .select({SelectionOperator::AND, 1, {2}}));
+  for (int i = 0; i < numLocs; ++i) EXPECT(chan[i] == values[i * numChans + 2]);
+
+  // Strings cannot be mapped and stay in memory; they still work under a mapped policy.
+  Variable station = g.vars.create<std::string>("MetaData/stationIdentification", {numLocs});
+  std::vector<std::string> stations(numLocs);
+  for (int i = 0; i < numLocs; ++i) stations[i] = "station_" + std::to_string(i % 37);
+  station.write<std::string>(stations);
+  std::vector<std::string> stationCheck;
+  station.read<std::string>(stationCheck);
+  EXPECT(stationCheck == stations);
+
+  // Attributes on mapped variables are unaffected.
+  radiance.atts.add<std::string>("units", std::string("W m-2 sr-1"));
+  EXPECT(radiance.atts.read<std::string>("units") == "W m-2 sr-1");
+}
+
+CASE("Compressed variables round trip") {
+  const int numLocs = 1000;
+
+  Engines::ObsStore::StorageParameters storage;
+  storage.policies["PreQC"]    = Engines::ObsStore::StorageKind::Compressed;
+  storage.policies["MetaData"] = Engines::ObsStore::StorageKind::Compressed;
+  storage.compressedHotAccesses = 3;
+  Group g = Engines::ObsStore::createRootGroup(storage);
+
+  VariableCreationParameters params;
+  params.setFillValue<int>(-1);
+  Variable preqc = g.vars.create<int>("PreQC/airTemperature", {numLocs}, {Unlimited}, params);
+  std::vector<int> flags(numLocs);
+  for (int i = 0; i < numLocs; ++i) flags[i] = (i % 100 == 0) ? 1 : 0;
+  preqc.write<int>(flags);
+
+  // Reads before and after the variable turns hot, with a write in between.
+  std::vector<int> check;
+  for (int r = 0; r < 6; ++r) {
+    preqc.read<int>(check);
+    EXPECT(check == flags);
+    if (r == 1) {
+      flags[7] = 12;
+      preqc.write<int>(flags);
+    }
+  }
+
+  preqc.resize({numLocs + 10});
+  preqc.read<int>(check);
+  EXPECT(check.size() == static_cast<std::size_t>(numLocs + 10));
+  EXPECT(check[7] == 12);
+  EXPECT(check[numLocs + 5] == -1);
+
+  // Strings are dictionary encoded.
+  VariableCreationParameters strParams;
+  strParams.setFillValue<std::string>("missing");
+  Variable station = g.vars.create<std::string>("MetaData/stationIdentification", {numLocs},
+                                                {Unlimited}, strParams);
+  std::vector<std::string> stations(numLocs);
+  for (int i = 0; i < numLocs; ++i) stations[i] = "station_" + std::to_string(i % 37);
+  station.write<std::string>(stations);
+  station.resize({numLocs + 2});
+  std::vector<std::string> stationCheck;
+  station.read<std::string>(stationCheck);
+  EXPECT(stationCheck.size() == static_cast<std::size_t>(numLocs + 2));
+  for (int i = 0; i < numLocs; ++i) EXPECT(stationCheck[i] == stations[i]);
+  EXPECT(stationCheck[numLocs + 1] == "missing");
+}
+
+// Without zlib compressed variables store their values as they are.
+#if ZLIB_FOUND
+CASE("Compressed variables release their raw values") {
+  const int numLocs = 100000;
+
+  Engines::ObsStore::StorageParameters storage;
+  storage.policies["PreQC"]     = Engines::ObsStore::StorageKind::Compressed;
+  storage.compressedHotAccesses = 0;
+  Group g = Engines::ObsStore::createRootGroup(storage);
+
+  Variable preqc = g.vars.create<int>("PreQC/airTemperature", {numLocs});
+  std::vector<int> flags(numLocs);
+  for (int i = 0; i < numLocs; ++i) flags[i] = (i % 1000 == 0) ? i / 1000 : 0;
+
+  // Written in two halves, as frames are: the values stay raw until the tree is compacted.
+  const int half = numLocs / 2;
+  for (int first : {0, half}) {
+    preqc.write<int>(gsl::make_span(flags.data() + first, half),
+                     Selection().extent({half}).select({SelectionOperator::SET, 0, {0}, {half}}),
+                     Selection().select({SelectionOperator::SET, 0, {first}, {half}}));
+  }
+  Engines::ObsStore::MemoryStatistics stats;
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  const std::size_t rawBytes = stats.variableBytes["PreQC/airTemperature"];
+  EXPECT(rawBytes >= numLocs * sizeof(int));
+
+  // Compacting packs the values without any read; only the packed blocks stay resident.
+  EXPECT(Engines::ObsStore::compactGroup(g));
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  EXPECT(stats.variableBytes["PreQC/airTemperature"] < rawBytes / 10);
+  std::vector<int> check;
+  preqc.read<int>(check);
+  EXPECT(check == flags);
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  EXPECT(stats.variableBytes["PreQC/airTemperature"] < rawBytes / 10);
+
+  // A write of the whole variable packs it straight away.
+  Variable qcflags = g.vars.create<int>("PreQC/windSpeed", {numLocs});
+  qcflags.write<int>(flags);
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  EXPECT(stats.variableBytes["PreQC/windSpeed"] < rawBytes / 10);
+
+  // A selection within one block reads correctly without unpacking the variable.
+  std::vector<int> part(20);
+  preqc.read<int>(gsl::make_span(part),
+                  Selection().extent({20}).select({SelectionOperator::SET, 0, {0}, {20}}),
+                  Selection().select({SelectionOperator::SET, 0, {69990}, {20}}));
+  for (int i = 0; i < 20; ++i) EXPECT(part[i] == flags[69990 + i]);
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  EXPECT(stats.variableBytes["PreQC/airTemperature"] < rawBytes / 10);
+}
+#endif
+
+CASE("Chunked variables round trip") {
+  const int numLocs  = 250;
+  const int numChans = 3;
+
+  Engines::ObsStore::StorageParameters storage;
+  storage.policies["ObsValue"] = Engines::ObsStore::StorageKind::Chunked;
+  storage.chunkLocations = 64;
+  Group g = Engines::ObsStore::createRootGroup(storage);
+
+  VariableCreationParameters params;
+  params.setFillValue<int>(-1);
+  Variable v = g.vars.create<int>("ObsValue/counts", {numLocs, numChans},
+                                  {Unlimited, numChans}, params);
+  std::vector<int> values(numLocs * numChans);
+  for (std::size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>(i);
+  v.write<int>(values);
+  std::vector<int> check;
+  v.read<int>(check);
+  EXPECT(check == values);
+
+  // Append locations, shrink, and grow again across block boundaries.
+  v.resize({3 * numLocs, numChans});
+  v.read<int>(check);
+  for (std::size_t i = 0; i < values.size(); ++i) EXPECT(check[i] == values[i]);
+  for (std::size_t i = values.size(); i < check.size(); ++i) EXPECT(check[i] == -1);
+  v.resize({100, numChans});
+  v.resize({130, numChans});
+  v.read<int>(check);
+  EXPECT(check.size() == static_cast<std::size_t>(130 * numChans));
+  for (std::size_t i = 0; i < 100 * numChans; ++i) EXPECT(check[i] == values[i]);
+  for (std::size_t i = 100 * numChans; i < check.size(); ++i) EXPECT(check[i] == -1);
+
+  // A selection spanning blocks: channel 1 of every location.
+  std::vector<int> chan(130);
+  v.read<int>(gsl::make_span(chan),
+              Selection().extent({130}).select({SelectionOperator::SET, 0, {0}, {130}}),
+              Selection()
+                .select({SelectionOperator::SET, 0, {0}, {130}})
+                .select({SelectionOperator::AND, 1, {1}}));
+  for (int i = 0; i < 100; ++i) EXPECT(chan[i] == values[i * numChans + 1]);
+
+  // Only the touched block of a clone is copied; the original is unchanged.
+  Group c = Engines::ObsStore::cloneGroup(g);
+  c.vars["ObsValue/counts"].write<int>(
+    gsl::make_span(std::vector<int>{7}),
+    Selection().extent({1}).select({SelectionOperator::SET, 0, {0}, {1}}),
+    Selection()
+      .select({SelectionOperator::SET, 0, {70}, {1}})
+      .select({SelectionOperator::AND, 1, {0}}));
+  Engines::ObsStore::MemoryStatistics cloneStats;
+  EXPECT(Engines::ObsStore::getMemoryStatistics(c, cloneStats));
+  EXPECT(cloneStats.valueBytes == storage.chunkLocations * numChans * sizeof(int));
+  v.read<int>(check);
+  EXPECT(check[70 * numChans] == values[70 * numChans]);
+  c.vars["ObsValue/counts"].read<int>(check);
+  EXPECT(check[70 * numChans] == 7);
+}
+
+CASE("Dictionary encoded strings") {
+  const int numLocs = 500;
+  Group g = Engines::ObsStore::createRootGroup();
+
+  VariableCreationParameters params;
+  params.setFillValue<std::string>("missing");
+  Variable station = g.vars.create<std::string>("MetaData/stationIdentification", {numLocs},
+                                                {numLocs}, params);
+  std::vector<std::string> stations(numLocs);
+  for (int i = 0; i < numLocs; ++i) stations[i] = "station_" + std::to_string(i % 7);
+  station.write<std::string>(stations);
+
+  std::vector<int> codes;
+  std::vector<std::string> dictionary;
+  EXPECT(station.readDictionaryEncoded(codes, dictionary));
+  EXPECT(codes.size() == static_cast<std::size_t>(numLocs));
+  for (int i = 0; i < numLocs; ++i) {
+    EXPECT(dictionary[codes[i]] == stations[i]);
+    EXPECT(codes[i] == codes[i % 7]);
+  }
+
+  // With a selection
+  EXPECT(station.readDictionaryEncoded(codes, dictionary,
+                                       Selection().select({SelectionOperator::SET, 0, {10},
+                                                           {5}})));
+  EXPECT(codes.size() == 5);
+  for (int i = 0; i < 5; ++i) EXPECT(dictionary[codes[i]] == stations[10 + i]);
+
+  // Values no longer referenced after a rewrite are dropped from the dictionary.
+  for (int i = 0; i < numLocs; ++i) stations[i] = "platform_" + std::to_string(i % 3);
+  station.write<std::string>(stations);
+  EXPECT(station.readDictionaryEncoded(codes, dictionary));
+  EXPECT(dictionary.size() <= 4);
+  for (int i = 0; i < numLocs; ++i) EXPECT(dictionary[codes[i]] == stations[i]);
+
+  // Mostly distinct values are stored one string per element.
+  const int numIds = 4000;
+  Variable id = g.vars.create<std::string>("MetaData/sequenceNumber", {numIds}, {Unlimited},
+                                           params);
+  std::vector<std::string> ids(numIds);
+  for (int i = 0; i < numIds; ++i) ids[i] = "sequence_number_" + std::to_string(i);
+  id.write<std::string>(ids);
+  EXPECT(!id.readDictionaryEncoded(codes, dictionary));
+  std::vector<std::string> idCheck;
+  id.read<std::string>(idCheck);
+  EXPECT(idCheck == ids);
+  id.resize({numIds + 1});
+  id.read<std::string>(idCheck);
+  EXPECT(idCheck.back() == "missing");
+
+  // Numeric variables are not dictionary encoded.
+  Variable index = g.vars.create<int>("MetaData/index", {numLocs});
+  EXPECT(!index.readDictionaryEncoded(codes, dictionary));
+}
+
+CASE("Arena backed variables") {
+  const int numLocs = 1 << 20;
+
+  Engines::ObsStore::StorageParameters storage;
+  storage.arena.enabled = true;
+  Group g = Engines::ObsStore::createRootGroup(storage);
+
+  Engines::ObsStore::ArenaStatistics stats;
+  EXPECT(Engines::ObsStore::getArenaStatistics(g, stats));
+  EXPECT(stats.liveAllocations == 0);
+
+  // One buffer large enough to be mapped, one small enough for the heap.
+  std::vector<double> values(numLocs);
+  for (std::size_t i = 0; i < values.size(); ++i) values[i] = 0.5 * static_cast<double>(i);
+  Variable big = g.vars.create<double>("ObsValue/big", {numLocs});
+  big.write<double>(values);
+  Variable small = g.vars.create<int>("MetaData/small", {4});
+  small.write<int>(std::vector<int>{1, 2, 3, 4});
+
+  std::vector<double> check;
+  big.read<double>(check);
+  EXPECT(check == values);
+
+  EXPECT(Engines::ObsStore::getArenaStatistics(g.open("ObsValue"), stats));
+  EXPECT(stats.liveAllocations == 2);
+  EXPECT(stats.bytesInUse == numLocs * sizeof(double) + 4 * sizeof(int));
+  EXPECT(stats.heapBytes == 4 * sizeof(int));
+  EXPECT(stats.mappedBytes >= numLocs * sizeof(double));
+  EXPECT(stats.peakMappedBytes >= stats.mappedBytes);
+  EXPECT(stats.hugePageBytes <= stats.mappedBytes);
+
+  // A released mapping is cached and handed out again.
+  g.vars.remove("ObsValue/big");
+  big = Variable();
+  EXPECT(Engines::ObsStore::getArenaStatistics(g, stats));
+  EXPECT(stats.liveAllocations == 1);
+  EXPECT(stats.cachedBytes == stats.mappedBytes);
+  Variable again = g.vars.create<double>("ObsValue/again", {numLocs});
+  EXPECT(Engines::ObsStore::getArenaStatistics(g, stats));
+  EXPECT(stats.cacheHits == 1);
+  EXPECT(stats.cachedBytes == 0);
+
+  // Unmapping a block takes back only what was counted for it, whether or not the
+  // kernel took the huge page advice.
+  Engines::ObsStore::StorageParameters uncached;
+  uncached.arena.enabled = true;
+  uncached.arena.cacheBytes = 0;
+  Group u = Engines::ObsStore::createRootGroup(uncached);
+  Variable mapped = u.vars.create<double>("ObsValue/mapped", {numLocs});
+  EXPECT(Engines::ObsStore::getArenaStatistics(u, stats));
+  EXPECT(stats.hugePageBytes <= stats.mappedBytes);
+  u.vars.remove("ObsValue/mapped");
+  mapped = Variable();
+  EXPECT(Engines::ObsStore::getArenaStatistics(u, stats));
+  EXPECT(stats.mappedBytes == 0);
+  EXPECT(stats.hugePageBytes == 0);
+
+  // Trees without an arena report nothing.
+  Group plain = Engines::ObsStore::createRootGroup();
+  EXPECT(!Engines::ObsStore::getArenaStatistics(plain, stats));
+}
+
+CASE("Cloned groups") {
+  const int numLocs = 100;
+
+  Engines::ObsStore::StorageParameters storage;
+  storage.policies["MetaData"] = Engines::ObsStore::StorageKind::MappedFile;
+  Group g = Engines::ObsStore::createRootGroup(storage);
+  Variable nlocs = g.vars.create<int>("nlocs", {numLocs});
+  nlocs.setIsDimensionScale("nlocs");
+  VariableCreationParameters params;
+  params.setFillValue<float>(-999.0f);
+  Variable obs = g.vars.createWithScales<float>("ObsValue/t", {nlocs}, params);
+  Variable lat = g.vars.createWithScales<float>("MetaData/latitude", {nlocs}, params);
+  Variable sid = g.vars.createWithScales<std::string>("MetaData/stationId", {nlocs});
+  obs.atts.add<std::string>("units", "K");
+
+  std::vector<float> values(numLocs);
+  std::vector<std::string> ids(numLocs);
+  for (int i = 0; i < numLocs; ++i) {
+    values[i] = static_cast<float>(i);
+    ids[i] = std::to_string(i % 7);
+  }
+  obs.write<float>(values);
+  lat.write<float>(values);
+  sid.write<std::string>(ids);
+
+  Group c = Engines::ObsStore::cloneGroup(g);
+  EXPECT(c.vars.exists("ObsValue/t"));
+  EXPECT(c.open("ObsValue").vars["t"].atts.open("units").read<std::string>() == "K");
+  EXPECT(c.vars["ObsValue/t"].isDimensionScaleAttached(0, c.vars["nlocs"]));
+
+  // Modifying either copy leaves the other one alone.
+  std::vector<float> changed(numLocs, 1.0f);
+  c.vars["ObsValue/t"].write<float>(changed);
+  g.vars["MetaData/latitude"].write<float>(changed);
+  std::vector<std::string> newIds(numLocs, "x");
+  c.vars["MetaData/stationId"].write<std::string>(newIds);
+  std::vector<float> check;
+  std::vector<std::string> checkIds;
+  g.vars["ObsValue/t"].read<float>(check);
+  EXPECT(check == values);
+  c.vars["ObsValue/t"].read<float>(check);
+  EXPECT(check == changed);
+  c.vars["MetaData/latitude"].read<float>(check);
+  EXPECT(check == values);
+  g.vars["MetaData/latitude"].read<float>(check);
+  EXPECT(check == changed);
+  g.vars["MetaData/stationId"].read<std::string>(checkIds);
+  EXPECT(checkIds == ids);
+  c.vars["MetaData/stationId"].read<std::string>(checkIds);
+  EXPECT(checkIds == newIds);
+
+  // New objects only appear in the tree they were created in.
+  c.vars.create<int>("ObsValue/extra", {numLocs});
+  EXPECT(!g.vars.exists("ObsValue/extra"));
+}
+
+CASE("Memory accounting") {
+  const int numLocs = 1000;
+
+  Engines::ObsStore::StorageParameters storage;
+  storage.policies["MappedValue"] = Engines::ObsStore::StorageKind::MappedFile;
+  Group g = Engines::ObsStore::createRootGroup(storage);
+  Engines::ObsStore::MemoryStatistics stats;
+  EXPECT(Engines::ObsStore::getMemoryStatistics(g, stats));
+  EXPECT(stats.bytes == 0);
+
+  Variable obs = g.vars.create<float>("ObsValue/t", {numLocs});
+  Variable sid = g.vars.create<std::string>("MetaData/stationId", {numLocs});
+  std::vector<std::string> ids(numLocs);
+  for (int i = 0; i < numLocs; ++i) ids[i] = "a long station identifier " + std::to_string(i % 3);
+  sid.write<std::string>(ids);
+  obs.atts.add<std::string>("units", "K");
+  g.atts.add<int>("count", 3);
+
+  // Any group of the tree gives the statistics of the whole tree.
+  EXPECT(Engines::ObsStore::getMemoryStatistics(g.open("ObsValue"), stats));
+  EXPECT(stats.valueBytes >= numLocs * sizeof(float));
+  EXPECT(stats.stringBytes >= numLocs * sizeof(std::uint32_t));
+  EXPECT(stats.stringBytes < numLocs * sizeof(std::string));
+  EXPECT(stats.attributeBytes >= sizeof(int) + sizeof(std::string));
+  EXPECT(stats.bytes == stats.valueBytes + stats.stringBytes + stats.attributeBytes);
+  EXPECT(stats.variableBytes.at("ObsValue/t") >= numLocs * sizeof(float));
+  EXPECT(stats.groupBytes.at("ObsValue") == stats.variableBytes.at("ObsValue/t"));
+  EXPECT(stats.groupBytes.at("MetaData") == stats.variableBytes.at("MetaData/stationId"));
+  EXPECT(stats.groupBytes.at("") == sizeof(int));
+
+  // Removing a variable releases its memory; the high-water mark stays.
+  const std::size_t peak = stats.bytes;
+  g.vars.remove("ObsValue/t");
+  obs = Variable();
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  EXPECT(stats.variableBytes.count("ObsValue/t") == 0);
+  EXPECT(stats.bytes < peak);
+  EXPECT(stats.peakBytes == peak);
+
+  // External memory counts towards the total until it is removed.
+  const std::size_t before = stats.bytes;
+  EXPECT(Engines::ObsStore::setExternalBytes(g, "index", 100));
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  EXPECT(stats.externalBytes == 100);
+  EXPECT(stats.externalBytesByName.at("index") == 100);
+  EXPECT(stats.bytes == before + 100);
+  Engines::ObsStore::setExternalBytes(g, "index", 0);
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  EXPECT(stats.externalBytesByName.empty());
+  EXPECT(stats.bytes == before);
+
+  // Mapped values are reported apart from process memory.
+  Variable mapped = g.vars.create<float>("MappedValue/t", {numLocs});
+  Engines::ObsStore::getMemoryStatistics(g, stats);
+  EXPECT(stats.mappedBytes >= numLocs * sizeof(float));
+  EXPECT(stats.bytes == before);
+
+  // A clone shares the values of its source until they are modified.
+  Variable values = g.vars.create<float>("ObsValue/u", {numLocs});
+  values.write<float>(std::vector<float>(numLocs, 1.0f));
+  Group c = Engines::ObsStore::cloneGroup(g);
+  Engines::ObsStore::MemoryStatistics cloneStats;
+  EXPECT(Engines::ObsStore::getMemoryStatistics(c, cloneStats));
+  EXPECT(cloneStats.valueBytes == 0);
+  c.vars["ObsValue/u"].write<float>(std::vector<float>(numLocs, 2.0f));
+  Engines::ObsStore::getMemoryStatistics(c, cloneStats);
+  EXPECT(cloneStats.variableBytes.at("ObsValue/u") >= numLocs * sizeof(float));
+}
+
+CASE("Unusable scratch directory") {
+  Engines::ObsStore::StorageParameters storage;
+  storage.defaultKind = Engines::ObsStore::StorageKind::MappedFile;
+  storage.scratchDirectory = "/nonexistent/ioda/scratch";
+  EXPECT_THROWS(Engines::ObsStore::createRootGroup(storage));
+
+  // The directory is only checked when a policy maps variables.
+  storage.defaultKind = Engines::ObsStore::StorageKind::Memory;
+  Group g = Engines::ObsStore::createRootGroup(storage);
+  g.vars.create<int>("MetaData/index", {10});
+}
+
+}  // namespace test
+}  // namespace ioda
+
+int main(int argc, char** argv) {
+  return run_tests(argc, argv);
+}
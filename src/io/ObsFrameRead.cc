@@ -9,6 +9,7 @@
 #include <cmath>
 
 #include "oops/util/Logger.h"
+#include "oops/util/missingValues.h"
 
 #include "ioda/distribution/DistributionFactory.h"
 #include "ioda/Exception.h"
@@ -93,6 +94,25 @@ ObsFrameRead::ObsFrameRead(const ObsSpaceParameters & params) :
     VarUtils::collectVarDimInfo(og, backend_var_list_, backend_dim_var_list_,
                                 backend_dims_attached_to_vars_, backend_max_var_size_);
 
+    // The block statistics describe the input file, not the obs space, so keep them
+    // out of the frames.
+    auto isBlockStatsVar = [](const Named_Variable & v) {
+        return isBlockStatisticsVariable(v.name);
+    };
+    backend_var_list_.erase(std::remove_if(backend_var_list_.begin(), backend_var_list_.end(),
+                                           isBlockStatsVar), backend_var_list_.end());
+    backend_dim_var_list_.erase(std::remove_if(backend_dim_var_list_.begin(),
+                                               backend_dim_var_list_.end(), isBlockStatsVar),
+                                backend_dim_var_list_.end());
+    for (auto ivar = backend_dims_attached_to_vars_.begin();
+              ivar != backend_dims_attached_to_vars_.end(); ) {
+        if (isBlockStatsVar(ivar->first)) {
+            ivar = backend_dims_attached_to_vars_.erase(ivar);
+        } else {
+            ++ivar;
+        }
+    }
+
     // record number of locations from backend
     backend_nlocs_ = og.vars.open("nlocs").getDimensions().dimsCur[0];
     if (backend_nlocs_ == 0) {
@@ -108,8 +128,38 @@ ObsFrameRead::ObsFrameRead(const ObsSpaceParameters & params) :
     distname_ = distParams.name;
     dist_ = DistributionFactory::create(params.comm(), distParams);
 
+    // A backend that gives each process its own observations relies on the round-robin
+    // distribution keeping them there (see frameInit).
+    each_process_reads_separate_obs_ = obs_data_in_->eachProcessReadsSeparateObs();
+    if (each_process_reads_separate_obs_ && (distname_ != "RoundRobin")) {
+        throw Exception("Each process reads separate observations from the obs source, "
+                        "which needs the RoundRobin distribution", ioda_Here())
+            .add("distribution", distname_)
+            .add("obs source", obs_data_in_->fileName());
+    }
+
     max_frame_size_ = params.top_level_.obsDataIn.value().maxFrameSize;
     oops::Log::debug() << "ObsFrameRead: maximum frame size: " << max_frame_size_ << std::endl;
+
+    // Block statistics let whole blocks of locations outside the timing window go
+    // unread. They are only of use when locations are checked against the window, and
+    // they hold ranges of the epoch style datetime.
+    use_block_stats_ = false;
+    window_start_offset_ = 0;
+    window_end_offset_ = 0;
+    if (params.top_level_.obsDataIn.value().useBlockStatistics && use_epoch_datetime_ &&
+        obs_data_in_->applyLocationsCheck() && readBlockStatistics(og, block_stats_)) {
+        Variable dtVar = og.vars.open("MetaData/dateTime");
+        if (dtVar.atts.exists("units") &&
+            (dtVar.atts.open("units").read<std::string>() == block_stats_.dateTimeUnits)) {
+            const util::DateTime epochDt = getEpochAsDtime(dtVar);
+            window_start_offset_ = (params.windowStart() - epochDt).toSeconds();
+            window_end_offset_ = (params.windowEnd() - epochDt).toSeconds();
+            use_block_stats_ = true;
+            oops::Log::debug() << "ObsFrameRead: using block statistics, block size: "
+                               << block_stats_.blockSize << std::endl;
+        }
+    }
 }
 
 ObsFrameRead::~ObsFrameRead() {}
@@ -118,13 +168,21 @@ ObsFrameRead::~ObsFrameRead() {}
 void ObsFrameRead::frameInit(Has_Attributes & destAttrs) {
     // reset counters, etc.
     frame_start_ = 0;
-    next_rec_num_ = 0;
-    rec_num_increment_ = 1;
+    if (each_process_reads_separate_obs_) {
+        // Record numbers r, r + nprocs, ... are all assigned to process r by the
+        // round-robin distribution.
+        next_rec_num_ = params_.comm().rank();
+        rec_num_increment_ = params_.comm().size();
+    } else {
+        next_rec_num_ = 0;
+        rec_num_increment_ = 1;
+    }
     unique_rec_nums_.clear();
     // It's important to grab maximum var size from the backend since it is being used to
     // determine when there are no more frames from the backend.
     max_var_size_ = backend_max_var_size_;
     nlocs_ = 0;
+    nlocs_skipped_ = 0;
     adjusted_nlocs_frame_start_ = 0;
     gnlocs_ = 0;
     nrecs_ = 0;
@@ -161,6 +219,10 @@ bool ObsFrameRead::frameAvailable() {
         obs_frame_.resize(
             { std::pair<Variable, Dimensions_t>(nlocsVar, frameCount("nlocs")) });
 
+        // Work out which locations of this frame can go unread
+        genFrameReadRuns();
+        const bool skipLocations = !frame_skipped_locs_.empty();
+
         // Transfer all variable data
         Dimensions_t frameStart = this->frameStart();
         for (auto & varNameObject : backend_var_list_) {
@@ -170,25 +232,38 @@ bool ObsFrameRead::frameAvailable() {
             if (frameCount > 0) {
                 // Transfer the variable data for this frame. Do this in two steps:
                 //    ObsIo --> memory buffer --> frame storage
-
-                // Selection objects for transfer;
+                // Variables dimensioned by nlocs are transferred one run of locations
+                // at a time when some of the frame locations are skipped.
+                std::vector<std::pair<Dimensions_t, Dimensions_t>> runs(
+                    1, std::make_pair(0, frameCount));
+                if (skipLocations &&
+                    isVarDimByNlocs_Impl(varName, backend_dims_attached_to_vars_)) {
+                    runs = frame_read_runs_;
+                }
                 std::vector<Dimensions_t> varShape = sourceVar.getDimensions().dimsCur;
-                Selection obsIoSelect = createObsIoSelection(varShape, frameStart, frameCount);
-                Selection memBufferSelect = createMemSelection(varShape, frameCount);
-                Selection obsFrameSelect = createEntireFrameSelection(varShape, frameCount);
+                std::vector<Dimensions_t> frameShape = varShape;
+                frameShape[0] = frameCount;
 
-                // Transfer the data
                 Variable destVar = obs_frame_.vars.open(varName);
-
-                VarUtils::forAnySupportedVariableType(
-                      destVar,
-                      [&](auto typeDiscriminator) {
-                          typedef decltype(typeDiscriminator) T;
-                          std::vector<T> varValues;
-                          sourceVar.read<T>(varValues, memBufferSelect, obsIoSelect);
-                          destVar.write<T>(varValues, memBufferSelect, obsFrameSelect);
-                      },
-                      VarUtils::ThrowIfVariableIsOfUnsupportedType(varName));
+                for (const auto & run : runs) {
+                    // Selection objects for transfer;
+                    Selection obsIoSelect =
+                        createObsIoSelection(varShape, frameStart + run.first, run.second);
+                    Selection memBufferSelect = createMemSelection(varShape, run.second);
+                    Selection obsFrameSelect =
+                        createVarSelection(frameShape, run.first, run.second);
+
+                    // Transfer the data
+                    VarUtils::forAnySupportedVariableType(
+                          destVar,
+                          [&](auto typeDiscriminator) {
+                              typedef decltype(typeDiscriminator) T;
+                              std::vector<T> varValues;
+                              sourceVar.read<T>(varValues, memBufferSelect, obsIoSelect);
+                              destVar.write<T>(varValues, memBufferSelect, obsFrameSelect);
+                          },
+                          VarUtils::ThrowIfVariableIsOfUnsupportedType(varName));
+                }
             }
         }
 
@@ -232,6 +307,17 @@ bool ObsFrameRead::frameAvailable() {
     } else {
       // assign each record to the patch of a unique PE
       dist_->computePatchLocs();
+      if (use_block_stats_) {
+        oops::Log::debug() << "ObsFrameRead: block statistics skipped reading "
+                           << nlocs_skipped_ << " out of " << backend_nlocs_
+                           << " locations" << std::endl;
+      }
+      if (each_process_reads_separate_obs_) {
+        // The counts so far only cover the part of the obs source read on this process.
+        params_.comm().allReduceInPlace(gnlocs_, eckit::mpi::sum());
+        params_.comm().allReduceInPlace(gnlocs_outside_timewindow_, eckit::mpi::sum());
+        params_.comm().allReduceInPlace(nlocs_skipped_, eckit::mpi::sum());
+      }
     }
     return (haveAnotherFrame);
 }
@@ -304,6 +390,44 @@ Dimensions_t ObsFrameRead::basicFrameCount(const Variable & var) {
     return count;
 }
 
+//------------------------------------------------------------------------------------
+void ObsFrameRead::genFrameReadRuns() {
+    const Dimensions_t frameStart = this->frameStart();
+    const Dimensions_t frameCount = this->frameCount("nlocs");
+    frame_read_runs_.assign(1, std::make_pair(0, frameCount));
+    frame_skipped_locs_.clear();
+    if (!use_block_stats_ || (frameCount == 0)) {
+        return;
+    }
+
+    // A location is inside the window when windowStart < dateTime <= windowEnd, so a
+    // block whose whole dateTime range falls on one side of that interval can be skipped.
+    frame_read_runs_.clear();
+    const std::size_t firstBlock = frameStart / block_stats_.blockSize;
+    const std::size_t lastBlock = (frameStart + frameCount - 1) / block_stats_.blockSize;
+    for (std::size_t iblock = firstBlock; iblock <= lastBlock; ++iblock) {
+        const Dimensions_t blockStart = block_stats_.blockStart(iblock);
+        const Dimensions_t runStart = std::max(blockStart, frameStart) - frameStart;
+        const Dimensions_t runEnd =
+            std::min(blockStart + block_stats_.blockCount(iblock), frameStart + frameCount) -
+            frameStart;
+        const bool outsideWindow = (block_stats_.dateTimeMax[iblock] <= window_start_offset_) ||
+                                   (block_stats_.dateTimeMin[iblock] > window_end_offset_);
+        if (outsideWindow) {
+            frame_skipped_locs_.resize(frameCount, false);
+            std::fill(frame_skipped_locs_.begin() + runStart,
+                      frame_skipped_locs_.begin() + runEnd, true);
+            nlocs_skipped_ += runEnd - runStart;
+        } else if (!frame_read_runs_.empty() &&
+                   (frame_read_runs_.back().first + frame_read_runs_.back().second ==
+                    runStart)) {
+            frame_read_runs_.back().second += runEnd - runStart;
+        } else {
+            frame_read_runs_.push_back(std::make_pair(runStart, runEnd - runStart));
+        }
+    }
+}
+
 //------------------------------------------------------------------------------------
 Selection ObsFrameRead::createIndexedFrameSelection(const std::vector<Dimensions_t> & varShape) {
     // frame_loc_index_ contains the indices for the first dimension. Subsequent
@@ -388,6 +512,14 @@ void ObsFrameRead::genFrameLocationsWithQcheck(std::vector<Dimensions_t> & locIn
     // convert ref, offset time to datetime objects
     std::vector<int64_t> timeOffsets;
     dtVar.read<int64_t>(timeOffsets);
+    if (!frame_skipped_locs_.empty()) {
+        // Skipped locations were never read. Mark them missing, which puts them
+        // outside the timing window as their block statistics say they are.
+        const int64_t missingInt64 = util::missingValue(missingInt64);
+        for (std::size_t i = 0; i < frame_skipped_locs_.size(); ++i) {
+            if (frame_skipped_locs_[i]) timeOffsets[i] = missingInt64;
+        }
+    }
     util::DateTime epochDt = getEpochAsDtime(dtVar);
     std::vector<util::DateTime> dtimeVals = convertEpochDtToDtime(epochDt, timeOffsets);
 
@@ -471,19 +603,60 @@ void ObsFrameRead::genRecordNumbersGrouping(const std::vector<std::string> & obs
     // frame data for the grouping variables.
     std::size_t locSize = frameIndex.size();
     records.assign(locSize, 0);
-    std::vector<std::string> obsGroupingKeys(locSize);
-    buildObsGroupingKeys(obsGroupVarList, frameIndex, obsGroupingKeys);
 
-    for (std::size_t i = 0; i < locSize; ++i) {
-      if (obs_grouping_.find(obsGroupingKeys[i]) == obs_grouping_.end()) {
-        // key is not present in the map
-        // assign current record number to the current key, and move to the next record number
-        obs_grouping_.insert(
-            std::pair<std::string, std::size_t>(obsGroupingKeys[i], next_rec_num_));
+    // Look up the record number of a key, giving a new key the next record number.
+    auto recordOfKey = [&](const std::string & key) {
+      auto ikey = obs_grouping_.find(key);
+      if (ikey == obs_grouping_.end()) {
+        ikey = obs_grouping_.insert(std::pair<std::string, std::size_t>(key, next_rec_num_)).first;
         next_rec_num_ += rec_num_increment_;
       }
-      records[i] = obs_grouping_.at(obsGroupingKeys[i]);
+      return ikey->second;
+    };
+
+    // A single dictionary encoded grouping variable is grouped on its codes: each distinct
+    // value in the frame is looked up once, and no key string is formed per location.
+    std::vector<int> groupVarCodes;
+    std::vector<std::string> groupVarDictionary;
+    if ((obsGroupVarList.size() == 1) &&
+        readObsGroupingCodes(obsGroupVarList[0], groupVarCodes, groupVarDictionary)) {
+      const std::size_t noRecord = static_cast<std::size_t>(-1);
+      std::vector<std::size_t> codeRecords(groupVarDictionary.size(), noRecord);
+      for (std::size_t i = 0; i < locSize; ++i) {
+        const int code = groupVarCodes[frameIndex[i]];
+        if (codeRecords[code] == noRecord) {
+          codeRecords[code] = recordOfKey(groupVarDictionary[code]);
+        }
+        records[i] = codeRecords[code];
+      }
+      return;
     }
+
+    std::vector<std::string> obsGroupingKeys(locSize);
+    buildObsGroupingKeys(obsGroupVarList, frameIndex, obsGroupingKeys);
+    for (std::size_t i = 0; i < locSize; ++i) {
+      records[i] = recordOfKey(obsGroupingKeys[i]);
+    }
+}
+
+//------------------------------------------------------------------------------------
+bool ObsFrameRead::readObsGroupingCodes(const std::string & obsGroupVarName,
+                                        std::vector<int> & codes,
+                                        std::vector<std::string> & dictionary) {
+    const std::string varName = std::string("MetaData/") + obsGroupVarName;
+    Variable groupVar = obs_frame_.vars.open(varName);
+    if (!groupVar.isA<std::string>()) return false;
+
+    const Dimensions_t frameCount = this->frameCount("nlocs");
+    const std::vector<Dimensions_t> varShape = groupVar.getDimensions().dimsCur;
+    const Selection frameSelect = createEntireFrameSelection(varShape, frameCount);
+    if (!groupVar.readDictionaryEncoded(codes, dictionary, frameSelect)) return false;
+    if (codes.size() != static_cast<std::size_t>(frameCount)) {
+        throw Exception("Obs grouping variable does not hold one value per location",
+                        ioda_Here())
+            .add("variable", varName).add("values", codes.size()).add("locations", frameCount);
+    }
+    return true;
 }
 
 //------------------------------------------------------------------------------------
@@ -514,6 +687,23 @@ void ObsFrameRead::buildObsGroupingKeys(const std::vector<std::string> & obsGrou
         Selection memSelect = createMemSelection(varShape, frameCount);
         Selection frameSelect = createEntireFrameSelection(varShape, frameCount);
 
+        // String variables held dictionary encoded can supply their key segments straight
+        // from the dictionary, without creating a string for every location.
+        std::vector<int> groupVarCodes;
+        std::vector<std::string> groupVarDictionary;
+        if (readObsGroupingCodes(obsGroupVarName, groupVarCodes, groupVarDictionary)) {
+            for (std::size_t j = 0; j < frameIndex.size(); ++j) {
+                const std::string & keySegment = groupVarDictionary[groupVarCodes[frameIndex[j]]];
+                if (i == 0) {
+                    groupingKeys[j] = keySegment;
+                } else {
+                    groupingKeys[j] += ":";
+                    groupingKeys[j] += keySegment;
+                }
+            }
+            continue;
+        }
+
         VarUtils::forAnySupportedVariableType(
               groupVar,
               [&](auto typeDiscriminator) {
@@ -584,7 +774,7 @@ void ObsFrameRead::applyMpiDistribution(const std::shared_ptr<Distribution> & di
 
         eckit::geometry::Point2 point(lons[frameIndex], lats[frameIndex]);
 
-        std::size_t globalLocIndex = rowNum;
+        std::size_t globalLocIndex = rowNum + obs_data_in_->globalLocationOffset();
         dist_->assignRecord(recNum, globalLocIndex, point);
 
         if (dist->isMyRecord(recNum)) {
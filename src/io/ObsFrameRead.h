@@ -8,12 +8,14 @@
 #ifndef IO_OBSFRAMEREAD_H_
 #define IO_OBSFRAMEREAD_H_
 
+#include <utility>
 #include <vector>
 
 #include "eckit/config/LocalConfiguration.h"
 
 #include "ioda/core/IodaUtils.h"
 #include "ioda/distribution/Distribution.h"
+#include "ioda/Io/BlockStatistics.h"
 #include "ioda/io/ObsFrame.h"
 #include "ioda/ObsSpaceParameters.h"
 #include "ioda/Variables/VarUtils.h"
@@ -99,6 +101,10 @@ class ObsFrameRead : public ObsFrame, private util::ObjectCounter<ObsFrameRead>
     /// \brief return the MPI distribution
     std::shared_ptr<const Distribution> distribution() {return dist_;}
 
+    /// \brief return number of locations from the obs source that were not read since
+    /// the block statistics place them outside the time window
+    Dimensions_t numLocsSkipped() const {return nlocs_skipped_;}
+
  private:
     //------------------ private data members ------------------------------
 
@@ -153,6 +159,30 @@ class ObsFrameRead : public ObsFrame, private util::ObjectCounter<ObsFrameRead>
     /// \brief cache for memory buffer selection
     std::map<VarUtils::Vec_Named_Variable, Selection> known_mem_selections_;
 
+    /// \brief true if the block statistics of the obs source are used to skip
+    /// reading blocks of locations that lie outside the timing window
+    bool use_block_stats_;
+
+    /// \brief block statistics of the obs source
+    BlockStatistics block_stats_;
+
+    /// \brief timing window start as an offset in the units of MetaData/dateTime
+    int64_t window_start_offset_;
+
+    /// \brief timing window end as an offset in the units of MetaData/dateTime
+    int64_t window_end_offset_;
+
+    /// \brief (start, count) pairs, relative to the current frame, of the locations
+    /// to be read from the obs source
+    std::vector<std::pair<Dimensions_t, Dimensions_t>> frame_read_runs_;
+
+    /// \brief true for the locations of the current frame that were not read since
+    /// their block lies outside the timing window (empty when none were skipped)
+    std::vector<bool> frame_skipped_locs_;
+
+    /// \brief number of locations skipped by way of the block statistics
+    Dimensions_t nlocs_skipped_;
+
     //--------------------- private functions ------------------------------
     /// \brief print routine for oops::Printable base class
     /// \param ostream output stream
@@ -166,6 +196,12 @@ class ObsFrameRead : public ObsFrame, private util::ObjectCounter<ObsFrameRead>
     /// \param var variable
     Dimensions_t basicFrameCount(const Variable & var);
 
+    /// \brief work out which locations of the current frame need to be read
+    /// \details Fills in frame_read_runs_ and frame_skipped_locs_. Blocks whose
+    /// dateTime range cannot intersect the timing window are skipped when
+    /// use_block_stats_ is set.
+    void genFrameReadRuns();
+
     /// \brief set up frontend and backend selection objects for the given variable
     /// \param varShape dimension sizes for variable being transferred
     Selection createIndexedFrameSelection(const std::vector<Dimensions_t> & varShape);
@@ -220,6 +256,14 @@ class ObsFrameRead : public ObsFrame, private util::ObjectCounter<ObsFrameRead>
                               const std::vector<Dimensions_t> & frameIndex,
                               std::vector<std::string> & groupingKeys);
 
+    /// \brief read the codes and dictionary of a dictionary encoded grouping variable
+    /// \param obsGroupVarName name of the grouping variable (in the MetaData group)
+    /// \param codes one code per location of the current frame
+    /// \param dictionary the values, indexed by code
+    /// \return false if the variable is not held dictionary encoded
+    bool readObsGroupingCodes(const std::string & obsGroupVarName, std::vector<int> & codes,
+                              std::vector<std::string> & dictionary);
+
     /// \brief apply MPI distribution
     /// \param dist ioda::Distribution object
     /// \param records vector indexed by location containing the record numbers
@@ -9,6 +9,7 @@
 */
 
 #include <iostream>
+#include <sstream>
 #include "eckit/log/Colour.h"
 #include "./Log.h"
 
@@ -16,40 +17,51 @@ namespace Log {
 
 const ioda_validate::Severity LogThreshold = ioda_validate::Severity::Info;
 
-std::ostream &LogStream = std::clog;
-std::ostringstream junk;
+// Per thread, so that files can be validated concurrently.
+thread_local std::ostream *LogStream = &std::clog;
+thread_local std::ostringstream junk;
 
-size_t IndentLevel = 0;
+thread_local size_t IndentLevel = 0;
 
 LogContext::LogContext(const std::string &s) {
   if (!s.empty()) {
-    eckit::Colour::reset(LogStream);
-    LogStream << std::string(IndentLevel, ' ') << s << "\n";
+    eckit::Colour::reset(*LogStream);
+    *LogStream << std::string(IndentLevel, ' ') << s << "\n";
   }
   IndentLevel++;
 }
 
 LogContext::~LogContext() { IndentLevel--; }
 
+Redirect::Redirect(std::ostream &s) : previous_(LogStream), previousIndent_(IndentLevel) {
+  LogStream   = &s;
+  IndentLevel = 0;
+}
+
+Redirect::~Redirect() {
+  LogStream   = previous_;
+  IndentLevel = previousIndent_;
+}
+
 std::ostream &log(ioda_validate::Severity s) {
   std::string messagePrefix;
   if (s >= LogThreshold) {
-    eckit::Colour::reset(LogStream);
+    eckit::Colour::reset(*LogStream);
     switch (s) {
     case ioda_validate::Severity::Error:
-      eckit::Colour::bold(LogStream);
-      eckit::Colour::red(LogStream);
+      eckit::Colour::bold(*LogStream);
+      eckit::Colour::red(*LogStream);
       messagePrefix = "ERROR: ";
       break;
     case ioda_validate::Severity::Warn:
-      eckit::Colour::bold(LogStream);
-      eckit::Colour::blue(LogStream);
+      eckit::Colour::bold(*LogStream);
+      eckit::Colour::blue(*LogStream);
       messagePrefix = "Warning: ";
       break;
     default:
       break;
     }
-    return LogStream << std::string(IndentLevel, ' ') << messagePrefix;
+    return *LogStream << std::string(IndentLevel, ' ') << messagePrefix;
   }
   return junk;
 }
@@ -24,6 +24,18 @@ struct LogContext {
   ~LogContext();
 };
 
+/// Sends the log messages of the calling thread to another stream while in scope.
+/// Used to keep the output of files that are validated concurrently apart.
+struct Redirect {
+ public:
+  explicit Redirect(std::ostream &s);
+  ~Redirect();
+
+ private:
+  std::ostream *previous_;
+  size_t previousIndent_;
+};
+
 std::ostream &log(ioda_validate::Severity s);
 std::ostream &log(ioda_validate::Severity s, Results &res);
 
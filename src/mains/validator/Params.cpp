@@ -40,4 +40,11 @@ const util::NamedEnumerator<Type> TypeParameterTraitsHelper::namedValues[]
      {Type::Char, "Char"},
      {Type::SChar, "SChar"},
      {Type::Enum, "Enum"}};
+
+const char MonotonicityParameterTraitsHelper::enumTypeName[] = "Monotonicity";
+const util::NamedEnumerator<Monotonicity> MonotonicityParameterTraitsHelper::namedValues[]
+  = {{Monotonicity::Increasing, "Increasing"},
+     {Monotonicity::StrictlyIncreasing, "StrictlyIncreasing"},
+     {Monotonicity::Decreasing, "Decreasing"},
+     {Monotonicity::StrictlyDecreasing, "StrictlyDecreasing"}};
 }  // end namespace ioda_validate
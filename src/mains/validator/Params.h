@@ -74,6 +74,7 @@ class PolicyParameters : public oops::Parameters {
                                                        this};
   oops::Parameter<Severity> AttributeHasCorrectDims{"AttributeHasCorrectDims", Severity::Warn,
                                                     this};
+  oops::Parameter<Severity> VariableValueCheck{"VariableValueCheck", Severity::Error, this};
 };
 
 }  // end namespace ioda_validate
@@ -113,6 +114,22 @@ template <>
 struct oops::ParameterTraits<ioda_validate::Type>
     : public oops::EnumParameterTraits<ioda_validate::TypeParameterTraitsHelper> {};
 
+namespace ioda_validate {
+
+enum class Monotonicity { Increasing, StrictlyIncreasing, Decreasing, StrictlyDecreasing };
+
+struct MonotonicityParameterTraitsHelper {
+  typedef Monotonicity EnumType;
+  static const char enumTypeName[];
+  static const util::NamedEnumerator<Monotonicity> namedValues[4];
+};
+
+}  // end namespace ioda_validate
+
+template <>
+struct oops::ParameterTraits<ioda_validate::Monotonicity>
+    : public oops::EnumParameterTraits<ioda_validate::MonotonicityParameterTraitsHelper> {};
+
 namespace ioda_validate {
 class TypeParameters : public oops::Parameters {
   OOPS_CONCRETE_PARAMETERS(TypeParameters, Parameters)
@@ -191,6 +208,24 @@ class VariableOrDefaultVarParameters : public oops::Parameters {
   oops::OptionalParameter<AttributeListReqOptionalParameters> atts{"Valid Attributes", this};
 };
 
+/// Rules checked against the values of a variable. Fill values are exempt from all of them.
+class ValueCheckParameters : public oops::Parameters {
+  OOPS_CONCRETE_PARAMETERS(ValueCheckParameters, Parameters)
+ public:
+  oops::OptionalParameter<double> minimum{"Minimum", this};
+  oops::OptionalParameter<double> maximum{"Maximum", this};
+  /// No NaN or infinite values.
+  oops::Parameter<bool> finite{"Finite", false, this};
+  /// A fill value is set, and missing values use it (floating point variables hold no NaNs).
+  oops::Parameter<bool> fillValue{"Fill Value", false, this};
+  /// No value appears twice.
+  oops::Parameter<bool> unique{"Unique", false, this};
+  /// Values, in storage order, are sorted this way.
+  oops::OptionalParameter<Monotonicity> monotonic{"Monotonic", this};
+  /// Datetimes (in "seconds since" units) lie inside the file's datetimeRange attribute.
+  oops::Parameter<bool> inDatetimeRange{"In Datetime Range", false, this};
+};
+
 class VariableParameters : public oops::Parameters {
   OOPS_CONCRETE_PARAMETERS(VariableParameters, Parameters)
  public:
@@ -204,6 +239,7 @@ class VariableParameters : public oops::Parameters {
   // attributes contain units
   oops::Parameter<std::map<std::string, std::string>> attributes{
     "Attributes", std::map<std::string, std::string>(), this};
+  oops::OptionalParameter<ValueCheckParameters> valueChecks{"Value Checks", this};
 };
 
 class IODAvalidateParameters : public oops::Parameters {
@@ -220,6 +256,12 @@ class IODAvalidateParameters : public oops::Parameters {
     "Variable Defaults", VariableOrDefaultVarParameters{}, this};
   oops::Parameter<std::vector<VariableParameters>> variables{
     "Variables", std::vector<VariableParameters>{}, this};
+  /// Run the "Value Checks" of the variables. These read every value, so they take far
+  /// longer than the other checks.
+  oops::Parameter<bool> checkValues{"Check Values", true, this};
+  /// Number of values read at a time by the value checks.
+  oops::Parameter<std::size_t> valueBlockSize{"Value Check Block Size", 1048576, this,
+                                              {oops::minConstraint<std::size_t>(1)}};
 };
 
 }  // end namespace ioda_validate
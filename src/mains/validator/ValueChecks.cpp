@@ -0,0 +1,279 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! @file ValueChecks.cpp
+* @brief Variable value checks
+*/
+#include "ValueChecks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Log.h"
+#include "Params.h"
+#include "ioda/Exception.h"
+#include "ioda/Group.h"
+#include "ioda/Variables/Variable.h"
+#include "oops/util/DateTime.h"
+
+namespace ioda_validate {
+namespace {
+
+/// Values that broke one rule: how many, and the first of them.
+struct Violations {
+  std::size_t count      = 0;
+  std::size_t firstIndex = 0;
+  std::string firstValue;
+
+  template <class T>
+  void add(std::size_t index, const T &value) {
+    if (count++ == 0) {
+      std::ostringstream s;
+      s << value;
+      firstIndex = index;
+      firstValue = s.str();
+    }
+  }
+
+  void report(const std::string &varName, const std::string &what,
+              const IODAvalidateParameters &params, Results &res) const {
+    if (count == 0) return;
+    Log::log(params.policies.value().VariableValueCheck.value(), res)
+      << "Variable '" << varName << "' has " << count << " value(s) " << what
+      << ". The first is element " << firstIndex << " (" << firstValue << ").\n";
+  }
+};
+
+/// @brief Reads a variable in blocks of whole rows and passes each block to check.
+/// @details check gets the values and the (row-major) index of the first of them.
+template <class T>
+void forEachBlock(const ioda::Variable &var, std::size_t blockValues,
+                  const std::function<void(const std::vector<T> &, std::size_t)> &check) {
+  using ioda::Dimensions_t;
+  using ioda::Selection;
+  using ioda::SelectionOperator;
+  const ioda::Dimensions dims = var.getDimensions();
+  if (dims.numElements == 0) return;
+  std::vector<T> values;
+  if (dims.dimensionality == 0) {
+    var.read<T>(values);
+    check(values, 0);
+    return;
+  }
+
+  const Dimensions_t numRows   = dims.dimsCur[0];
+  const Dimensions_t rowValues = dims.numElements / numRows;
+  Dimensions_t rows
+    = std::max<Dimensions_t>(1, static_cast<Dimensions_t>(blockValues) / rowValues);
+  // Read whole chunks, so that no chunk is decompressed twice.
+  const std::vector<Dimensions_t> chunks = var.getChunkSizes();
+  if (!chunks.empty() && (chunks[0] > 0)) rows = std::max(chunks[0], rows - rows % chunks[0]);
+
+  std::vector<Dimensions_t> start(dims.dimensionality, 0);
+  std::vector<Dimensions_t> count = dims.dimsCur;
+  for (Dimensions_t row = 0; row < numRows; row += rows) {
+    start[0]                      = row;
+    count[0]                      = std::min(rows, numRows - row);
+    const Dimensions_t numInBlock = count[0] * rowValues;
+    values.resize(static_cast<std::size_t>(numInBlock));
+    // Named starts and counts: a braced {0} would pick the dimension-index overload.
+    const std::vector<Dimensions_t> memStart{0}, memCount{numInBlock};
+    const Selection memSelection
+      = Selection().extent({numInBlock}).select({SelectionOperator::SET, memStart, memCount});
+    var.read<T>(gsl::make_span(values), memSelection,
+                Selection().select({SelectionOperator::SET, start, count}));
+    check(values, static_cast<std::size_t>(row * rowValues));
+  }
+}
+
+/// @brief Gets the file's datetimeRange as offsets in the units of a datetime variable.
+/// @return false, with the reason in why, if this cannot be done.
+bool datetimeWindow(const ioda::Group &base, const ioda::Variable &var, double &begin,
+                    double &end, std::string &why) {
+  if (!var.atts.exists("units")) {
+    why = "the variable has no units";
+    return false;
+  }
+  const std::vector<std::string> range
+    = base.atts.open("datetimeRange").readAsVector<std::string>();
+  const std::string units  = var.atts.open("units").read<std::string>();
+  const std::string prefix = "seconds since ";
+  if (range.size() != 2) {
+    why = "datetimeRange does not hold two datetimes";
+    return false;
+  }
+  if (units.compare(0, prefix.size(), prefix) != 0) {
+    why = "the variable units are not of the 'seconds since' form";
+    return false;
+  }
+  try {
+    const util::DateTime epoch(units.substr(prefix.size()));
+    begin = static_cast<double>((util::DateTime(range[0]) - epoch).toSeconds());
+    end   = static_cast<double>((util::DateTime(range[1]) - epoch).toSeconds());
+  } catch (const std::exception &e) {
+    why = std::string("a datetime could not be parsed: ") + e.what();
+    return false;
+  }
+  return true;
+}
+
+template <class T>
+bool isNaN(const T &value) {
+  return std::isnan(static_cast<double>(value));
+}
+
+template <class T>
+void numericValueChecks(const std::string &varName, const ioda::Variable &var,
+                        const ValueCheckParameters &rules, const ioda::Group &base,
+                        const IODAvalidateParameters &params, Results &res) {
+  const bool hasFill = var.hasFillValue();
+  const T fill       = hasFill ? ioda::detail::getFillValue<T>(var.getFillValue()) : T();
+  if (rules.fillValue.value() && !hasFill)
+    Log::log(params.policies.value().VariableValueCheck.value(), res)
+      << "Variable '" << varName << "' has no fill value.\n";
+
+  const bool checkMin = (rules.minimum.value() != boost::none);
+  const bool checkMax = (rules.maximum.value() != boost::none);
+  const double minimum = checkMin ? *rules.minimum.value() : 0;
+  const double maximum = checkMax ? *rules.maximum.value() : 0;
+
+  bool checkWindow = rules.inDatetimeRange.value();
+  double windowBegin = 0, windowEnd = 0;
+  if (checkWindow && !base.atts.exists("datetimeRange")) {
+    // Many files do not record their window. That is not a fault of the variable.
+    Log::log(Severity::Info) << "The file has no datetimeRange attribute, so variable '"
+                             << varName << "' is not checked against it.\n";
+    checkWindow = false;
+  }
+  if (checkWindow) {
+    std::string why;
+    checkWindow = datetimeWindow(base, var, windowBegin, windowEnd, why);
+    if (!checkWindow)
+      Log::log(params.policies.value().VariableValueCheck.value(), res)
+        << "Cannot check that variable '" << varName
+        << "' lies inside the datetime range: " << why << ".\n";
+  }
+
+  const bool checkOrder = (rules.monotonic.value() != boost::none);
+  const Monotonicity order = checkOrder ? *rules.monotonic.value() : Monotonicity::Increasing;
+
+  Violations belowMin, aboveMax, notFinite, nanNotFill, duplicates, outOfOrder, outsideWindow;
+  std::unordered_set<T> seen;
+  bool havePrevious = false;
+  T previous        = T();
+
+  forEachBlock<T>(var, params.valueBlockSize.value(),
+                  [&](const std::vector<T> &values, std::size_t first) {
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      const T value           = values[i];
+      const std::size_t index = first + i;
+      if (hasFill && ((value == fill) || (isNaN(value) && isNaN(fill)))) continue;
+      if (rules.unique.value() && !isNaN(value) && !seen.insert(value).second)
+        duplicates.add(index, value);
+
+      const double d = static_cast<double>(value);
+      if (!std::isfinite(d)) {
+        if (rules.finite.value()) notFinite.add(index, value);
+        if (rules.fillValue.value() && std::isnan(d)) nanNotFill.add(index, value);
+        continue;
+      }
+      if (checkMin && (d < minimum)) belowMin.add(index, value);
+      if (checkMax && (d > maximum)) aboveMax.add(index, value);
+      if (checkWindow && ((d < windowBegin) || (d > windowEnd))) outsideWindow.add(index, value);
+      if (checkOrder && havePrevious) {
+        bool inOrder = true;
+        switch (order) {
+        case Monotonicity::Increasing:
+          inOrder = !(value < previous);
+          break;
+        case Monotonicity::StrictlyIncreasing:
+          inOrder = (previous < value);
+          break;
+        case Monotonicity::Decreasing:
+          inOrder = !(previous < value);
+          break;
+        case Monotonicity::StrictlyDecreasing:
+          inOrder = (value < previous);
+          break;
+        }
+        if (!inOrder) outOfOrder.add(index, value);
+      }
+      previous     = value;
+      havePrevious = true;
+    }
+  });
+
+  std::ostringstream belowWhat, aboveWhat;
+  belowWhat << "below the minimum of " << minimum;
+  aboveWhat << "above the maximum of " << maximum;
+  belowMin.report(varName, belowWhat.str(), params, res);
+  aboveMax.report(varName, aboveWhat.str(), params, res);
+  notFinite.report(varName, "that are not finite", params, res);
+  nanNotFill.report(varName, "that are NaN instead of the fill value", params, res);
+  duplicates.report(varName, "that repeat an earlier value", params, res);
+  outOfOrder.report(varName, "out of order", params, res);
+  outsideWindow.report(varName, "outside the datetimeRange attribute", params, res);
+}
+
+void stringValueChecks(const std::string &varName, const ioda::Variable &var,
+                       const ValueCheckParameters &rules, const IODAvalidateParameters &params,
+                       Results &res) {
+  if (rules.minimum.value() || rules.maximum.value() || rules.finite.value()
+      || rules.monotonic.value() || rules.inDatetimeRange.value())
+    Log::log(Severity::Warn, res) << "Only the 'Unique' and 'Fill Value' value checks apply to "
+                                  << "string variable '" << varName << "'.\n";
+  if (rules.fillValue.value() && !var.hasFillValue())
+    Log::log(params.policies.value().VariableValueCheck.value(), res)
+      << "Variable '" << varName << "' has no fill value.\n";
+  if (!rules.unique.value()) return;
+
+  const bool hasFill     = var.hasFillValue();
+  const std::string fill = hasFill ? ioda::detail::getFillValue<std::string>(var.getFillValue())
+                                   : std::string();
+  Violations duplicates;
+  std::unordered_set<std::string> seen;
+  forEachBlock<std::string>(var, params.valueBlockSize.value(),
+                            [&](const std::vector<std::string> &values, std::size_t first) {
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      if (hasFill && (values[i] == fill)) continue;
+      if (!seen.insert(values[i]).second) duplicates.add(first + i, values[i]);
+    }
+  });
+  duplicates.report(varName, "that repeat an earlier value", params, res);
+}
+
+}  // namespace
+
+void valueChecks(const std::string &varName, const ioda::Variable &var,
+                 const ValueCheckParameters &rules, const ioda::Group &base,
+                 const IODAvalidateParameters &params, Results &res) {
+  Log::LogContext lg("Checking values");
+  if (var.isA<float>())
+    numericValueChecks<float>(varName, var, rules, base, params, res);
+  else if (var.isA<double>())
+    numericValueChecks<double>(varName, var, rules, base, params, res);
+  else if (var.isA<int32_t>())
+    numericValueChecks<int32_t>(varName, var, rules, base, params, res);
+  else if (var.isA<int64_t>())
+    numericValueChecks<int64_t>(varName, var, rules, base, params, res);
+  else if (var.isA<int16_t>())
+    numericValueChecks<int16_t>(varName, var, rules, base, params, res);
+  else if (var.isA<uint32_t>())
+    numericValueChecks<uint32_t>(varName, var, rules, base, params, res);
+  else if (var.isA<std::string>())
+    stringValueChecks(varName, var, rules, params, res);
+  else
+    Log::log(Severity::Warn, res) << "Value checks do not support the type of variable '"
+                                  << varName << "', so its values are not checked.\n";
+}
+
+}  // end namespace ioda_validate
@@ -0,0 +1,46 @@
+#pragma once
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+/*! @file ValueChecks.h
+* @brief Variable value checks
+*/
+#include <string>
+
+#include "Log.h"
+#include "Params.h"
+#include "ioda/Group.h"
+#include "ioda/Variables/Variable.h"
+
+namespace ioda_validate {
+
+/// @brief Checks the values of a variable against its rules.
+/// @details
+///   Example YAML:
+///
+///   ```yaml
+///   - Variable: [ "latitude" ]
+///     Value Checks:
+///       Minimum: -90
+///       Maximum: 90
+///       Fill Value: true
+///   ```
+///
+///   The variable is read in blocks of whole rows along its first dimension, rounded to
+///   whole chunks, so memory use is set by "Value Check Block Size" rather than by the size
+///   of the variable. The one exception is the "Unique" rule, which keeps every distinct
+///   value it has seen.
+/// @param varName is the path of the variable in the file
+/// @param var is the variable
+/// @param rules are the checks to run, as specified in the YAML parameters
+/// @param base is the root group of the file (holds the datetimeRange attribute)
+/// @param params is the YAML parameters
+/// @param res is a running total of errors and warnings caught by the checks
+void valueChecks(const std::string &varName, const ioda::Variable &var,
+                 const ValueCheckParameters &rules, const ioda::Group &base,
+                 const IODAvalidateParameters &params, Results &res);
+
+}  // end namespace ioda_validate
@@ -7,21 +7,33 @@
 /*! @file validate.cpp
 * @brief A program to validate ioda file contents.
 * 
-* Call program as: ioda-validate.x yaml-file input-file
+* Call program as:
+*   ioda-validate.x [--threads N] [--summary file.json|file.yaml] yaml-file input...
+*
+* Each input is a file or a directory of netCDF / HDF5 files. Files are validated
+* concurrently (--threads 0, the default, uses one thread per hardware thread), and
+* --summary writes the error and warning counts of each file.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "./AttributeChecks.h"
 #include "./Log.h"
 #include "./Params.h"
+#include "./ValueChecks.h"
 #include "eckit/config/YAMLConfiguration.h"
+#include "eckit/filesystem/PathName.h"
 #include "eckit/log/Colour.h"
 #include "eckit/runtime/Main.h"
 #include "ioda/Engines/EngineUtils.h"
@@ -51,26 +63,49 @@ class Validator : public eckit::Main {
     using std::exception;
     using std::string;
     int ret = 0;
+    std::vector<FileResult> results;
     try {
-      if (argc() != 3) throw Exception("Usage: ioda-validate.x yaml-file input-file", ioda_Here());
+      const Arguments args = parseArguments();
 
-      eckit::PathName yamlfilename(argv(1));
-      std::string datafilename(argv(2));
+      cout << "Reading YAML from " << args.yamlFile << endl;
 
-      cout << "Reading YAML from " << yamlfilename << endl;
-
-      eckit::YAMLConfiguration yaml(yamlfilename);
+      eckit::YAMLConfiguration yaml(eckit::PathName(args.yamlFile));
       params_.validateAndDeserialize(yaml);
 
-      Log::LogContext lg(std::string("Processing data file: ").append(datafilename));
-      const ioda::Group base = ioda::Engines::HH::openMemoryFile(datafilename);
-      validate(base);
+      const std::vector<string> files = findInputFiles(args.inputs);
+      if (files.empty()) throw Exception("No input files were found.", ioda_Here());
+
+      std::size_t numThreads = args.numThreads;
+      if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+      numThreads = std::min(numThreads, files.size());
+      if ((numThreads > 1) && !ioda::Engines::HH::isThreadSafe()) {
+        cout << "The HDF5 library is not thread-safe, so files are validated one at a time."
+             << endl;
+        numThreads = 1;
+      }
+
+      results = validateFiles(files, numThreads);
+      for (const auto &r : results) {
+        res_.numErrors += r.res.numErrors;
+        res_.numWarnings += r.res.numWarnings;
+        if (!r.failure.empty()) ret = 1;
+      }
+      if (!args.summaryFile.empty()) writeSummary(args.summaryFile, results);
     } catch (const exception &e) {
       cerr << e.what() << endl;
       res_.numErrors++;
       ret = 1;
     }
     eckit::Colour::reset(cout);
+    if (results.size() > 1) {
+      eckit::Colour::underline(cout);
+      cout << "Results by file:";
+      eckit::Colour::reset(cout);
+      for (const auto &r : results)
+        cout << "\n  " << std::right << std::setw(4) << r.res.numErrors << " errors, "
+             << std::setw(4) << r.res.numWarnings << " warnings: " << r.filename;
+      cout << "\n";
+    }
     eckit::Colour::underline(cout);
     cout << "Final results:";
     eckit::Colour::reset(cout);
@@ -89,7 +124,188 @@ class Validator : public eckit::Main {
     return ret;
   }
 
-  void validate(const ioda::Group &base) {
+ private:
+  /// The command line.
+  struct Arguments {
+    std::string yamlFile;
+    std::vector<std::string> inputs;  ///< Files and directories
+    std::size_t numThreads = 0;       ///< Zero means one per hardware thread
+    std::string summaryFile;
+  };
+
+  /// The outcome of validating one file.
+  struct FileResult {
+    std::string filename;
+    Results res;
+    std::string failure;  ///< Why the file could not be validated, if it could not.
+  };
+
+  Arguments parseArguments() const {
+    using ioda::Exception;
+    const char usage[] = "Usage: ioda-validate.x [--threads N] [--summary file.json|file.yaml] "
+                         "yaml-file input-file-or-directory...";
+    Arguments args;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc(); ++i) {
+      const std::string arg = argv(i);
+      if ((arg == "--threads") || (arg == "--summary")) {
+        if (++i == argc()) throw Exception(usage, ioda_Here());
+        if (arg == "--summary") {
+          args.summaryFile = argv(i);
+        } else {
+          try {
+            args.numThreads = std::stoul(argv(i));
+          } catch (const std::exception &) {
+            throw Exception(usage, ioda_Here()).add("threads", argv(i));
+          }
+        }
+      } else {
+        positional.push_back(arg);
+      }
+    }
+    if (positional.size() < 2) throw Exception(usage, ioda_Here());
+    args.yamlFile = positional[0];
+    args.inputs.assign(positional.begin() + 1, positional.end());
+    return args;
+  }
+
+  /// Expands directories into the netCDF and HDF5 files under them, sorted by name.
+  static std::vector<std::string> findInputFiles(const std::vector<std::string> &inputs) {
+    static const std::set<std::string> extensions{".nc", ".nc4", ".h5", ".hdf5", ".hdf"};
+    std::vector<std::string> files;
+    for (const auto &input : inputs) {
+      const eckit::PathName path(input);
+      if (!path.isDir()) {
+        files.push_back(input);
+        continue;
+      }
+      std::vector<eckit::PathName> children, directories;
+      path.children(children, directories);
+      std::vector<std::string> found;
+      for (const auto &child : children)
+        if (extensions.count(child.extension())) found.push_back(child.asString());
+      std::sort(found.begin(), found.end());
+      files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+  }
+
+  /// @brief Validates files on a pool of threads.
+  /// @details With more than one thread, the log of each file is buffered and printed
+  ///   in one piece once the file is done.
+  std::vector<FileResult> validateFiles(const std::vector<std::string> &files,
+                                        std::size_t numThreads) const {
+    std::vector<FileResult> results(files.size());
+    std::atomic<std::size_t> next{0};
+    std::mutex outputMutex;
+    auto worker = [&]() {
+      for (std::size_t i = next++; i < files.size(); i = next++) {
+        results[i].filename = files[i];
+        if (numThreads == 1) {
+          validateFile(results[i]);
+          continue;
+        }
+        std::ostringstream buffer;
+        {
+          Log::Redirect redirect(buffer);
+          validateFile(results[i]);
+        }
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::clog << buffer.str() << std::flush;
+      }
+    };
+
+    if (numThreads == 1) {
+      worker();
+    } else {
+      std::vector<std::thread> threads;
+      for (std::size_t t = 0; t < numThreads; ++t) threads.emplace_back(worker);
+      for (auto &thread : threads) thread.join();
+    }
+    return results;
+  }
+
+  /// Opens a file read-only (its data are read only as the checks need them) and checks it.
+  void validateFile(FileResult &r) const {
+    Log::LogContext lg(std::string("Processing data file: ").append(r.filename));
+    try {
+      const ioda::Group base
+        = ioda::Engines::HH::openFile(r.filename, ioda::Engines::BackendOpenModes::Read_Only);
+      validate(base, r.res);
+    } catch (const std::exception &e) {
+      Log::log(ioda_validate::Severity::Error, r.res) << e.what() << "\n";
+      r.failure = e.what();
+    }
+  }
+
+  /// Quotes and escapes a string. The result is valid in both JSON and YAML.
+  static std::string quoted(const std::string &s) {
+    std::ostringstream out;
+    out << '"';
+    for (const char c : s) {
+      switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+              << std::dec << std::setfill(' ');
+        else
+          out << c;
+      }
+    }
+    out << '"';
+    return out.str();
+  }
+
+  /// Writes the per-file error and warning counts. The format (JSON or YAML) follows the
+  /// file extension.
+  void writeSummary(const std::string &filename, const std::vector<FileResult> &results) const {
+    using ioda::Exception;
+    const std::string ext = eckit::PathName(filename).extension();
+    const bool json       = (ext == ".json");
+    if (!json && (ext != ".yaml") && (ext != ".yml"))
+      throw Exception("The summary file name must end in .json, .yaml or .yml.", ioda_Here())
+        .add("filename", filename);
+
+    std::ofstream out(filename);
+    if (!out)
+      throw Exception("Cannot open the summary file.", ioda_Here()).add("filename", filename);
+    if (json) {
+      out << "{\n  \"errors\": " << res_.numErrors << ",\n  \"warnings\": " << res_.numWarnings
+          << ",\n  \"files\": [";
+      for (std::size_t i = 0; i < results.size(); ++i) {
+        const FileResult &r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"file\": " << quoted(r.filename)
+            << ", \"errors\": " << r.res.numErrors << ", \"warnings\": " << r.res.numWarnings;
+        if (!r.failure.empty()) out << ", \"failure\": " << quoted(r.failure);
+        out << "}";
+      }
+      out << "\n  ]\n}\n";
+    } else {
+      out << "errors: " << res_.numErrors << "\nwarnings: " << res_.numWarnings << "\nfiles:\n";
+      for (const auto &r : results) {
+        out << "- file: " << quoted(r.filename) << "\n  errors: " << r.res.numErrors
+            << "\n  warnings: " << r.res.numWarnings << "\n";
+        if (!r.failure.empty()) out << "  failure: " << quoted(r.failure) << "\n";
+      }
+    }
+    if (!out)
+      throw Exception("Cannot write the summary file.", ioda_Here()).add("filename", filename);
+  }
+
+  /// Runs every check on one file, adding to res.
+  void validate(const ioda::Group &base, Results &res) const {
     using ioda::ObjectType;
     using ioda::VarUtils::VarDimMap;
     using ioda::VarUtils::Vec_Named_Variable;
@@ -140,14 +356,14 @@ class Validator : public eckit::Main {
             // Check for old names
             for (const auto &oldname : yg.second.grpname.value()) {
               if (sGroupNames.count(oldname)) {
-                log(params_.policies.value().RequiredGroups.value(), res_)
+                log(params_.policies.value().RequiredGroups.value(), res)
                   << "Required group " << yg.first << " is using an older name: '" << oldname
                   << "'.\n";
                 hasoldname = true;
               }
             }
             if (!hasoldname)
-              log(params_.policies.value().RequiredGroups.value(), res_)
+              log(params_.policies.value().RequiredGroups.value(), res)
                 << "Required group " << yg.first << " is missing.\n";
           }
         }
@@ -160,7 +376,7 @@ class Validator : public eckit::Main {
         LogContext lg1(std::string("Verifying group ").append(gn));
         log(Severity::Debug) << "Group '" << gn << "' is described in the YAML file.\n";
         if (YAMLgroups.at(gn).remove.value()) {
-          log(params_.policies.value().GroupsKnown.value(), res_)
+          log(params_.policies.value().GroupsKnown.value(), res)
             << "Group " << gn << " is deprecated. " << *YAMLgroups.at(gn).remove.value() << "\n";
         }
 
@@ -175,9 +391,9 @@ class Validator : public eckit::Main {
         const set<string> sYAMLreqAtts(vYAMLreqAtts.begin(), vYAMLreqAtts.end());
         const set<string> sYAMLoptAtts(vYAMLoptAtts.begin(), vYAMLoptAtts.end());
 
-        requiredSymbolsCheck(vYAMLreqAtts, sGrpAttNames, params_, res_);
-        appropriateAttributesCheck(vGrpAttNames, sYAMLreqAtts, sYAMLoptAtts, params_, res_);
-        matchingAttributesCheck(YAMLattributes, vGrpAttNames, grp.atts, params_, res_);
+        requiredSymbolsCheck(vYAMLreqAtts, sGrpAttNames, params_, res);
+        appropriateAttributesCheck(vGrpAttNames, sYAMLreqAtts, sYAMLoptAtts, params_, res);
+        matchingAttributesCheck(YAMLattributes, vGrpAttNames, grp.atts, params_, res);
 
         // Check that each group's required variables exist (mostly for
         //  metadata. latitude, longitude, datetime)
@@ -186,11 +402,11 @@ class Validator : public eckit::Main {
         if (vYAMLreqVars) {
           const auto vGrpVarNames = grp.vars.list();
           const set<string> sGrpVarNames(vGrpVarNames.begin(), vGrpVarNames.end());
-          requiredSymbolsCheck(*vYAMLreqVars, sGrpVarNames, params_, res_);
+          requiredSymbolsCheck(*vYAMLreqVars, sGrpVarNames, params_, res);
         }
 
       } else {
-        log(params_.policies.value().GroupsKnown.value(), res_)
+        log(params_.policies.value().GroupsKnown.value(), res)
           << "Group " << gn << " is not described in the YAML file.\n";
       }
     }
@@ -241,7 +457,7 @@ class Validator : public eckit::Main {
               }
           }
           if (!found)
-            log(params_.policies.value().RequiredDimensions.value(), res_)
+            log(params_.policies.value().RequiredDimensions.value(), res)
               << "Dimension " << YAMLdimNames[0]
               << " (and all of this dimension's alternate names) is missing from the file.\n";
         }
@@ -253,7 +469,7 @@ class Validator : public eckit::Main {
 
           // Old dimension name check
           if (sOldNewDimNames.count(fileDim.name)) {
-            log(params_.policies.value().DimensionsUseNewName, res_)
+            log(params_.policies.value().DimensionsUseNewName, res)
               << "Dimension '" << fileDim.name
               << "' is from an old standard. "
                  "Prefer using the new name '"
@@ -263,13 +479,13 @@ class Validator : public eckit::Main {
           // Check the dimension's dimensionality.
           auto dims = fileDim.var.getDimensions();
           if (dims.dimensionality > 1)
-            log(params_.policies.value().GeneralDimensionsChecks, res_)
+            log(params_.policies.value().GeneralDimensionsChecks, res)
               << "Dimension '" << fileDim.name << "' has incorrect dimensionality.\n";
 
           // TODO(ryan): dimension type check needs another IODA PR
-          log(Severity::Trace, res_) << "TODO: Implement dimension type check.\n";
+          log(Severity::Trace, res) << "TODO: Implement dimension type check.\n";
         } else {
-          log(params_.policies.value().DimensionsKnown, res_)
+          log(params_.policies.value().DimensionsKnown, res)
             << "Dimension " << fileDim.name << " is not described in the YAML file.\n";
         }
       }
@@ -312,7 +528,7 @@ class Validator : public eckit::Main {
         //  group and name components.
         const vector<string> splitName = ioda::splitPaths(v.name);
         if (splitName.size() != 2) {
-          log(Severity::Error, res_)
+          log(Severity::Error, res)
             << "Skipping processing of '" << v.name << "'. Unsure how to parse this name.\n";
           continue;
         }
@@ -324,14 +540,14 @@ class Validator : public eckit::Main {
 
           // Is this name known to the conventions?
           if (mVarParams.count(name) == 0) {
-            log(params_.policies.value().KnownVariableNames, res_)
+            log(params_.policies.value().KnownVariableNames, res)
               << "Variable '" << v.name << "' is not listed in the YAML conventions file.\n";
             continue;
           }
 
           // Old vs new name check
           if (mOldNewVarNames.count(name)) {
-            log(params_.policies.value().VariableUseNewName, res_)
+            log(params_.policies.value().VariableUseNewName, res)
               << "Variable '" << v.name << "' uses a superseded name. Replace with '"
               << mOldNewVarNames.at(name) << "'\n";
           }
@@ -341,7 +557,7 @@ class Validator : public eckit::Main {
 
           // Variable should be removed check
           if (varparams.remove.value()) {
-            log(params_.policies.value().VariableUseNewName, res_)
+            log(params_.policies.value().VariableUseNewName, res)
               << "Variable '" << v.name << "' is deprecated and should be removed.\n";
             continue;
           }
@@ -353,7 +569,7 @@ class Validator : public eckit::Main {
 
             // Check that a regular variable is allowed within this group
             if (YAMLgroup.regularVariablesAllowed.value() == false)
-              log(params_.policies.value().GroupAllowsVariables, res_)
+              log(params_.policies.value().GroupAllowsVariables, res)
                 << "Variable '" << v.name << "' is in a group '" << group
                 << "' that disallows regular (non-dimension-scale) variables.\n";
 
@@ -364,13 +580,13 @@ class Validator : public eckit::Main {
             if (YAMLgroup.forceunits.value()) varparams.forceunits = YAMLgroup.forceunits;
             if (YAMLgroup.units.value()) sYAMLgroupUnits = *(YAMLgroup.units.value());
           } else {
-            log(params_.policies.value().GroupsKnown, res_)
+            log(params_.policies.value().GroupsKnown, res)
               << "Variable '" << v.name << "' is in unknown group '" << group << "'.\n";
           }
 
           // Can this variable be in the Metadata group?
           if (group == "MetaData" && (varparams.base.canBeMetadata.value() == false))
-            log(params_.policies.value().VariableCanBeMetadata, res_)
+            log(params_.policies.value().VariableCanBeMetadata, res)
               << "Variable '" << v.name << "' should not be in MetaData.\n";
 
           // Recommended dimension scales check
@@ -413,7 +629,7 @@ class Validator : public eckit::Main {
                 for (const auto &r : recDimsIt) outVarDims << " " << r;
                 outVarDims << " ]";
               }
-              log(params_.policies.value().VariableDimensionCheck, res_)
+              log(params_.policies.value().VariableDimensionCheck, res)
                 << "Variable '" << v.name
                 << "' does not have match any of the recommended dimensions. " << outVarDims.str()
                 << "\n";
@@ -427,7 +643,7 @@ class Validator : public eckit::Main {
             for (size_t i = 0; i < dims.size(); ++i) {
               if (static_cast<size_t>(dims[i])
                   != static_cast<size_t>(dimscales[i].var.getDimensions().numElements))
-                log(params_.policies.value().VariableDimensionCheck, res_)
+                log(params_.policies.value().VariableDimensionCheck, res)
                   << "Variable '" << v.name << "' dimension " << i
                   << " has a length that differs from its attached dimension scale, '"
                   << dimscales[i].name << "', which has a length of "
@@ -436,7 +652,7 @@ class Validator : public eckit::Main {
           }
 
           // Type check
-          log(Severity::Trace, res_) << "TODO: Implement type check.\n";
+          log(Severity::Trace, res) << "TODO: Implement type check.\n";
 
           // Attributes checks (required and optional attributes;
           //  attribute dimension and type checks)
@@ -464,10 +680,10 @@ class Validator : public eckit::Main {
 
               auto attNames = v.var.atts.list();
 
-              appropriateAttributesCheck(attNames, req, opt, params_, res_);
+              appropriateAttributesCheck(attNames, req, opt, params_, res);
             }
 
-            matchingAttributesCheck(YAMLattributes, v.var.atts.list(), v.var.atts, params_, res_);
+            matchingAttributesCheck(YAMLattributes, v.var.atts.list(), v.var.atts, params_, res);
           }
 
           // Units (check that units are set if needed, check compatible units, check exact units)
@@ -493,7 +709,7 @@ class Validator : public eckit::Main {
 
           if (unitsDisabled) {
             if (v.var.atts.exists("units"))
-              log(params_.policies.value().VariableHasConvertibleUnits, res_)
+              log(params_.policies.value().VariableHasConvertibleUnits, res)
                 << "File variable '" << v.name << "' has units of '"
                 << v.var.atts.read<string>("units")
                 << "', but the YAML spec prohibits units for this variable.\n";
@@ -504,14 +720,14 @@ class Validator : public eckit::Main {
             if (varparamsAtts.count("units") && !sYAMLunits.size())
               sYAMLunits = varparamsAtts.at("units");
             if (sYAMLunits.size() == 0)
-              log(params_.policies.value().VariableHasValidUnits, res_)
+              log(params_.policies.value().VariableHasValidUnits, res)
                 << "Variable '" << v.name
                 << "' needs units, but the 'units' attribute does not exist in the YAML.\n";
 
             if (v.var.atts.exists("units"))
               sVarUnits = v.var.atts.read<string>("units");
             else
-              log(params_.policies.value().VariableHasValidUnits, res_)
+              log(params_.policies.value().VariableHasValidUnits, res)
                 << "Variable '" << v.name
                 << "' needs units, but the 'units' attribute does not exist in the file.\n";
             if (sVarUnits.size() && sYAMLunits.size()) {
@@ -520,25 +736,25 @@ class Validator : public eckit::Main {
 
               // Check for valid units
               if (!varUnits.isValid())
-                log(params_.policies.value().VariableHasConvertibleUnits, res_)
+                log(params_.policies.value().VariableHasConvertibleUnits, res)
                   << "File variable '" << v.name << "' has units of '" << sVarUnits
                   << "', which are invalid.\n";
               if (!YAMLUnits.isValid())
-                log(params_.policies.value().VariableHasConvertibleUnits, res_)
+                log(params_.policies.value().VariableHasConvertibleUnits, res)
                   << "The YAML spec for variable '" << v.name << "' has units of '" << sYAMLunits
                   << "', which are invalid.\n";
 
               if (varUnits.isValid() && YAMLUnits.isValid()) {
                 // Check for convertible units
                 if (!varUnits.isConvertibleWith(YAMLUnits))
-                  log(params_.policies.value().VariableHasConvertibleUnits, res_)
+                  log(params_.policies.value().VariableHasConvertibleUnits, res)
                     << "Variable '" << v.name << "' has units of '" << varUnits
                     << "', which are not convertible to the YAML-specified units of '" << sYAMLunits
                     << "'.\n";
 
                 // Check for exact units
                 if (!(varUnits == YAMLUnits) && varparams.checkExactUnits.value())
-                  log(params_.policies.value().VariableHasExactUnits, res_)
+                  log(params_.policies.value().VariableHasExactUnits, res)
                     << "Variable '" << v.name << "' has units of '" << varUnits
                     << "'. The YAML-specified units are '" << sYAMLunits
                     << "'."
@@ -547,21 +763,18 @@ class Validator : public eckit::Main {
             }
           }
 
-          // These are not needed now, but they may be useful in the future
-          // Expected Variable range (check data range if set)
-          log(Severity::Trace, res_) << "TODO: Implement variable range (ExpectedRange) check.\n";
-
-          // Is a fill value set appropriately (both for HDF5 and NetCDF4)?
-          log(Severity::Trace, res_) << "TODO: Implement fill value check.\n";
+          // Value checks: ranges, fill values, uniqueness, ordering.
+          if (params_.checkValues.value() && varparams.valueChecks.value())
+            valueChecks(v.name, v.var, *varparams.valueChecks.value(), base, params_, res);
 
           // Is chunking enabled?
-          log(Severity::Trace, res_) << "TODO: Implement chunking check.\n";
+          log(Severity::Trace, res) << "TODO: Implement chunking check.\n";
 
           // Are the chunk sizes sensible?
-          log(Severity::Trace, res_) << "TODO: Implement chunk size check.\n";
+          log(Severity::Trace, res) << "TODO: Implement chunk size check.\n";
 
           // Is compression enabled?
-          log(Severity::Trace, res_) << "TODO: Implement compression check.\n";
+          log(Severity::Trace, res) << "TODO: Implement compression check.\n";
         }
       }
     }
@@ -28,6 +28,7 @@
 #include "ioda/distribution/Accumulator.h"
 #include "ioda/distribution/Distribution.h"
 #include "ioda/distribution/DistributionFactory.h"
+#include "ioda/distribution/ReductionBatch.h"
 
 namespace ioda {
 namespace test {
@@ -164,6 +165,87 @@ void testMinVector(const Distribution &TestDist, const std::vector<size_t> &myRe
   EXPECT_EQUAL(mins, expectedMins);
 }
 
+template <typename T>
+void testNonblockingReductions(const Distribution &TestDist, const std::vector<size_t> &myRecords) {
+  const T shift = 10;
+
+  // Local values
+  T min = bigNumber<T>();
+  T max = std::numeric_limits<T>::lowest();
+  std::vector<T> mins(2, bigNumber<T>());
+  std::vector<T> maxes(2, std::numeric_limits<T>::lowest());
+  auto accumulator = TestDist.createAccumulator<T>();
+  auto vectorAccumulator = TestDist.createAccumulator<T>(2);
+  for (size_t loc = 0; loc < myRecords.size(); ++loc) {
+    min = std::min<T>(min, myRecords[loc]);
+    max = std::max<T>(max, myRecords[loc]);
+    mins[0] = std::min<T>(mins[0], myRecords[loc]);
+    mins[1] = std::min<T>(mins[1], myRecords[loc] + shift);
+    maxes[0] = std::max<T>(maxes[0], myRecords[loc]);
+    maxes[1] = std::max<T>(maxes[1], myRecords[loc] + shift);
+    accumulator->addTerm(loc, myRecords[loc]);
+    vectorAccumulator->addTerm(loc, std::vector<T>{static_cast<T>(myRecords[loc]),
+                                                   static_cast<T>(myRecords[loc] + shift)});
+  }
+
+  // Blocking reductions
+  T expectedMin = min;
+  T expectedMax = max;
+  std::vector<T> expectedMins = mins;
+  std::vector<T> expectedMaxes = maxes;
+  TestDist.min(expectedMin);
+  TestDist.max(expectedMax);
+  TestDist.min(expectedMins);
+  TestDist.max(expectedMaxes);
+  const T expectedSum = accumulator->computeResult();
+  const std::vector<T> expectedSums = vectorAccumulator->computeResult();
+
+  // Part 1: one request per reduction
+  {
+    T min1 = min, max1 = max, sum1 = 0;
+    std::vector<T> mins1 = mins, maxes1 = maxes, sums1;
+    ReductionRequest minRequest = TestDist.iMin(min1);
+    ReductionRequest maxRequest = TestDist.iMax(max1);
+    ReductionRequest minsRequest = TestDist.iMin(mins1);
+    ReductionRequest maxesRequest = TestDist.iMax(maxes1);
+    ReductionRequest sumRequest = TestDist.iComputeResult(*accumulator, sum1);
+    ReductionRequest sumsRequest = TestDist.iComputeResult(*vectorAccumulator, sums1);
+    while (!minRequest.test()) {}
+    maxRequest.wait();
+    minsRequest.wait();
+    maxesRequest.wait();
+    sumRequest.wait();
+    sumsRequest.wait();
+    EXPECT(minRequest.completed());
+    EXPECT_EQUAL(min1, expectedMin);
+    EXPECT_EQUAL(max1, expectedMax);
+    EXPECT_EQUAL(mins1, expectedMins);
+    EXPECT_EQUAL(maxes1, expectedMaxes);
+    EXPECT_EQUAL(sum1, expectedSum);
+    EXPECT_EQUAL(sums1, expectedSums);
+  }
+
+  // Part 2: all reductions in one batch
+  {
+    T min2 = min, max2 = max, sum2 = 0;
+    std::vector<T> mins2 = mins, maxes2 = maxes, sums2;
+    ReductionBatch batch(TestDist);
+    batch.min(min2);
+    batch.max(max2);
+    batch.min(mins2);
+    batch.max(maxes2);
+    batch.sum(*accumulator, sum2);
+    batch.sum(*vectorAccumulator, sums2);
+    batch.execute();
+    EXPECT_EQUAL(min2, expectedMin);
+    EXPECT_EQUAL(max2, expectedMax);
+    EXPECT_EQUAL(mins2, expectedMins);
+    EXPECT_EQUAL(maxes2, expectedMaxes);
+    EXPECT_EQUAL(sum2, expectedSum);
+    EXPECT_EQUAL(sums2, expectedSums);
+  }
+}
+
 void testDistributionMethods() {
   eckit::LocalConfiguration conf(::test::TestEnvironment::config());
 
@@ -235,6 +317,11 @@ void testDistributionMethods() {
     testMinVector<float>(*TestDist, myRecords, expectedMin);
     testMinVector<int>(*TestDist, myRecords, expectedMin);
     testMinVector<size_t>(*TestDist, myRecords, expectedMin);
+
+    testNonblockingReductions<double>(*TestDist, myRecords);
+    testNonblockingReductions<float>(*TestDist, myRecords);
+    testNonblockingReductions<int>(*TestDist, myRecords);
+    testNonblockingReductions<size_t>(*TestDist, myRecords);
   }
 }
 
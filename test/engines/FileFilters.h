@@ -0,0 +1,82 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef TEST_ENGINES_FILEFILTERS_H_
+#define TEST_ENGINES_FILEFILTERS_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "ioda/Engines/HH.h"
+#include "ioda/Group.h"
+
+#include "oops/runs/Test.h"
+#include "oops/test/TestEnvironment.h"
+#include "oops/util/parameters/OptionalParameter.h"
+#include "oops/util/parameters/Parameter.h"
+#include "oops/util/parameters/Parameters.h"
+#include "oops/util/parameters/RequiredParameter.h"
+
+namespace ioda {
+namespace test {
+
+class VariableFiltersParameters : public oops::Parameters {
+  OOPS_CONCRETE_PARAMETERS(VariableFiltersParameters, Parameters)
+ public:
+  oops::RequiredParameter<std::string> name{"name", this};
+  /// deflate level; no deflate filter is expected when absent
+  oops::OptionalParameter<int> deflateLevel{"deflate level", this};
+  oops::Parameter<bool> shuffle{"shuffle", false, this};
+};
+
+class FileFiltersParameters : public oops::Parameters {
+  OOPS_CONCRETE_PARAMETERS(FileFiltersParameters, Parameters)
+ public:
+  oops::RequiredParameter<std::string> fileName{"file", this};
+  oops::RequiredParameter<std::vector<VariableFiltersParameters>> variables{"variables", this};
+};
+
+// Checks the compression filters stored with the variables of a file, for example one
+// written with per group compression settings.
+CASE("ioda/FileFilters") {
+  const eckit::Configuration &conf = ::test::TestEnvironment::config();
+  FileFiltersParameters params;
+  params.validateAndDeserialize(conf);
+
+  const Group file = Engines::HH::openFile(params.fileName, Engines::BackendOpenModes::Read_Only);
+  for (const VariableFiltersParameters &varParams : params.variables.value()) {
+    const Variable var = file.vars.open(varParams.name);
+    const std::pair<bool, int> gzip = var.getGZIPCompression();
+    if (varParams.deflateLevel.value() == boost::none) {
+      EXPECT(!gzip.first);
+    } else {
+      EXPECT(gzip.first);
+      EXPECT_EQUAL(gzip.second, *varParams.deflateLevel.value());
+    }
+    EXPECT_EQUAL(var.getCreationParameters(false, false).shuffle_, varParams.shuffle.value());
+  }
+}
+
+class FileFilters : public oops::Test {
+ private:
+  std::string testid() const override {return "test::ioda::FileFilters";}
+
+  void register_tests() const override {}
+
+  void clear() const override {}
+};
+
+// =============================================================================
+
+}  // namespace test
+}  // namespace ioda
+
+#endif  // TEST_ENGINES_FILEFILTERS_H_
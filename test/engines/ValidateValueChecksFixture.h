@@ -0,0 +1,100 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef TEST_ENGINES_VALIDATEVALUECHECKSFIXTURE_H_
+#define TEST_ENGINES_VALIDATEVALUECHECKSFIXTURE_H_
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "ioda/Engines/EngineUtils.h"
+#include "ioda/Group.h"
+#include "ioda/ObsGroup.h"
+
+#include "oops/runs/Test.h"
+#include "oops/test/TestEnvironment.h"
+#include "oops/util/parameters/Parameters.h"
+#include "oops/util/parameters/RequiredParameter.h"
+
+namespace ioda {
+namespace test {
+
+class ValidateValueChecksFixtureParameters : public oops::Parameters {
+  OOPS_CONCRETE_PARAMETERS(ValidateValueChecksFixtureParameters, Parameters)
+ public:
+  oops::RequiredParameter<std::string> outFile{"output file", this};
+};
+
+// Writes a file that breaks the value checks of testinput/iodatest_validate_value_checks.yaml
+// a known number of times. The ioda-validate run on it is compared against the expected
+// summary.
+CASE("ioda/ValidateValueChecksFixture") {
+  const eckit::Configuration &conf = ::test::TestEnvironment::config();
+  ValidateValueChecksFixtureParameters params;
+  params.validateAndDeserialize(conf);
+
+  Engines::BackendNames backendName = Engines::BackendNames::Hdf5File;
+  Engines::BackendCreationParameters backendParams;
+  backendParams.fileName = params.outFile;
+  backendParams.action = Engines::BackendFileActions::Create;
+  backendParams.createMode = Engines::BackendCreateModes::Truncate_If_Exists;
+
+  ioda::Group g = constructBackend(backendName, backendParams);
+
+  const int numLocs = 10;
+  ioda::NewDimensionScales_t newDims;
+  newDims.push_back(ioda::NewDimensionScale<int>("Location", numLocs, numLocs, numLocs));
+  ioda::ObsGroup og = ioda::ObsGroup::generate(g, newDims);
+  og.atts.add<std::string>("datetimeRange", {"2021-12-21T00:00:00Z", "2021-12-21T06:00:00Z"});
+  ioda::Variable locVar = og.vars["Location"];
+
+  // Fill values (-999) are exempt from every rule.
+  // Latitude: one value below the minimum and two above the maximum (two reports).
+  ioda::VariableCreationParameters floatParams;
+  floatParams.setFillValue<float>(-999);
+  og.vars.createWithScales<float>("MetaData/latitude", {locVar}, floatParams)
+    .write<float>({0, 10, 95, -91, -999, 45, 100, 20, 30, 40});
+
+  // Longitude: one value below the minimum and one NaN, which is neither finite nor the
+  // fill value (three reports).
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  og.vars.createWithScales<float>("MetaData/longitude", {locVar}, floatParams)
+    .write<float>({0, 10, nan, -200, -999, 45, 100, 20, 30, 40});
+
+  // Datetimes: two values outside datetimeRange, two out of order (two reports).
+  ioda::VariableCreationParameters int64Params;
+  int64Params.setFillValue<int64_t>(-999);
+  ioda::Variable dateTime
+    = og.vars.createWithScales<int64_t>("MetaData/dateTime", {locVar}, int64Params);
+  dateTime.atts.add<std::string>("units", std::string("seconds since 2021-12-21T00:00:00Z"));
+  dateTime.write<int64_t>({0, 600, 1200, -60, 1800, 2400, 30000, 3000, 3600, 4200});
+
+  // A type the value checks do not support (one warning).
+  og.vars.createWithScales<uint16_t>("MetaData/scanLineNumber", {locVar})
+    .write<uint16_t>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+}
+
+class ValidateValueChecksFixture : public oops::Test {
+ private:
+  std::string testid() const override {return "test::ioda::ValidateValueChecksFixture";}
+
+  void register_tests() const override {}
+
+  void clear() const override {}
+};
+
+// =============================================================================
+
+}  // namespace test
+}  // namespace ioda
+
+#endif  // TEST_ENGINES_VALIDATEVALUECHECKSFIXTURE_H_
@@ -8,6 +8,7 @@
 #ifndef TEST_IODA_OBSDATAVECTOR_H_
 #define TEST_IODA_OBSDATAVECTOR_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,6 +22,7 @@
 #include "oops/runs/Test.h"
 #include "oops/test/TestEnvironment.h"
 #include "oops/util/Expect.h"
+#include "oops/util/missingValues.h"
 
 #include "ioda/ObsDataVector.h"
 #include "ioda/ObsSpace.h"
@@ -177,6 +179,52 @@ CASE("ioda/ObsDataVector/readObsValue, skipDerived true") {
   testRead("ObsValue, skipDerived true");
 }
 
+CASE("ioda/ObsDataVector/contiguousStorage") {
+  ioda::ObsSpace & obspace = ObsDataVecTestFixture::obspace();
+  const oops::Variables vars(std::vector<std::string>{"a", "b"});
+  ioda::ObsDataVector<float> vec(obspace, vars);
+  const size_t nlocs = vec.nlocs();
+
+  // Rows are consecutive slices of one buffer.
+  EXPECT(vec["a"].data() == vec.data());
+  EXPECT(vec["b"].data() == vec.data() + nlocs);
+  EXPECT_EQUAL(vec[1].size(), nlocs);
+  EXPECT_THROWS(vec["c"]);
+
+  // Assigning to a row copies values.
+  std::vector<float> values(nlocs);
+  for (size_t jl = 0; jl < nlocs; ++jl) values[jl] = static_cast<float>(jl);
+  vec["a"] = values;
+  vec[1] = vec[0];
+  const std::vector<float> row1 = vec["b"];
+  EXPECT(row1 == values);
+  EXPECT(vec["b"] == values);
+  EXPECT(values == vec[0]);
+  EXPECT(vec[0] == vec[1]);
+
+  // Rows keep their length.
+  EXPECT_THROWS_AS(vec["a"] = std::vector<float>(nlocs + 1), eckit::BadParameter);
+
+  // Copies do not share storage.
+  ioda::ObsDataVector<float> copy(vec);
+  EXPECT(copy.data() != vec.data());
+  copy.zero();
+  EXPECT(std::equal(values.begin(), values.end(), vec[1].begin()));
+
+  if (nlocs > 0) {
+    ioda::ObsDataVector<int> flags(obspace, vars);
+    flags(1, 0) = 1;
+    vec.mask(flags);
+    EXPECT_EQUAL(vec(0, 0), values[0]);
+    EXPECT_EQUAL(vec(1, 0), util::missingValue(float()));
+
+    ioda::ObsDataVector<bool> bools(obspace, vars);
+    bools["b"][0] = true;
+    EXPECT(bools(1, 0));
+    EXPECT(!bools(0, 0));
+  }
+}
+
 class ObsDataVector : public oops::Test {
  private:
   std::string testid() const override {return "test::ObsDataVector<ioda::IodaTrait>";}
@@ -0,0 +1,122 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef TEST_IODA_OBSDATAVECTORBENCHMARK_H_
+#define TEST_IODA_OBSDATAVECTORBENCHMARK_H_
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/base/Variables.h"
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Test.h"
+#include "oops/test/TestEnvironment.h"
+#include "oops/util/DateTime.h"
+#include "oops/util/Logger.h"
+
+#include "ioda/ObsDataVector.h"
+#include "ioda/ObsSpace.h"
+
+namespace ioda {
+namespace test {
+
+namespace {
+double seconds(const std::function<void()> & f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const std::string & what, double time) {
+  oops::Log::info() << std::left << std::setw(28) << what << std::right << std::fixed
+                    << std::setprecision(4) << std::setw(10) << time << " s" << std::endl;
+}
+}  // namespace
+
+// Times the ObsDataVector methods used by UFO filters, on an ObsSpace of generated locations.
+CASE("ioda/ObsDataVector/benchmark") {
+  const eckit::Configuration &conf = ::test::TestEnvironment::config();
+  const util::DateTime bgn(conf.getString("window begin"));
+  const util::DateTime end(conf.getString("window end"));
+  eckit::LocalConfiguration obsconf(conf, "obs space");
+  ioda::ObsTopLevelParameters obsparams;
+  obsparams.validateAndDeserialize(obsconf);
+  ioda::ObsSpace obspace(obsparams, oops::mpi::world(), bgn, end, oops::mpi::myself());
+
+  const size_t nvars   = conf.getUnsigned("number of variables");
+  const size_t repeats = conf.getUnsigned("repeats");
+  std::vector<std::string> names(nvars);
+  for (size_t jv = 0; jv < nvars; ++jv) names[jv] = "brightnessTemperature_" + std::to_string(jv);
+  const oops::Variables vars(names);
+
+  ioda::ObsDataVector<float> values(obspace, vars);
+  ioda::ObsDataVector<int> flags(obspace, vars);
+  const size_t nlocs = values.nlocs();
+  for (size_t jv = 0; jv < nvars; ++jv)
+    for (size_t jl = jv % 7; jl < nlocs; jl += 7) flags(jv, jl) = 1;
+  oops::Log::info() << "nvars = " << nvars << ", nlocs = " << nlocs << ", repeats = "
+                    << repeats << std::endl;
+
+  report("zero", seconds([&]() {
+    for (size_t r = 0; r < repeats; ++r) values.zero();
+  }));
+  report("mask", seconds([&]() {
+    for (size_t r = 0; r < repeats; ++r) values.mask(flags);
+  }));
+
+  // A filter that looks its variable up by name at every location...
+  float sum = 0;
+  report("element access by name", seconds([&]() {
+    for (size_t r = 0; r < repeats; ++r)
+      for (size_t jv = 0; jv < nvars; ++jv)
+        for (size_t jl = 0; jl < nlocs; ++jl) sum += values[names[jv]][jl];
+  }));
+  // ... and one that looks it up once.
+  report("element access by row", seconds([&]() {
+    for (size_t r = 0; r < repeats; ++r)
+      for (size_t jv = 0; jv < nvars; ++jv) {
+        const ObsDataRow<const float> row = values[names[jv]];
+        for (size_t jl = 0; jl < nlocs; ++jl) sum += row[jl];
+      }
+  }));
+
+  report("copy", seconds([&]() {
+    for (size_t r = 0; r < repeats; ++r) {
+      ioda::ObsDataVector<float> copy(values);
+      if (nlocs > 0) sum += copy(nvars - 1, nlocs - 1);
+    }
+  }));
+  ioda::ObsDataVector<float> target(obspace, vars);
+  report("assignment", seconds([&]() {
+    for (size_t r = 0; r < repeats; ++r) target = values;
+  }));
+
+  // Printed so that the optimizer keeps the loops above.
+  oops::Log::info() << "checksum: " << sum << std::endl;
+}
+
+class ObsDataVectorBenchmark : public oops::Test {
+ private:
+  std::string testid() const override {return "test::ObsDataVectorBenchmark<ioda::IodaTrait>";}
+
+  void register_tests() const override {}
+
+  void clear() const override {}
+};
+
+// =============================================================================
+
+}  // namespace test
+}  // namespace ioda
+
+#endif  // TEST_IODA_OBSDATAVECTORBENCHMARK_H_
@@ -0,0 +1,160 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef TEST_IODA_OBSSPACEBLOCKSTATISTICS_H_
+#define TEST_IODA_OBSSPACEBLOCKSTATISTICS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/make_unique.hpp>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Test.h"
+#include "oops/test/TestEnvironment.h"
+#include "oops/util/DateTime.h"
+
+#include "ioda/Engines/HH.h"
+#include "ioda/Io/BlockStatistics.h"
+#include "ioda/Io/IoPoolUtils.h"
+#include "ioda/ObsSpace.h"
+
+namespace ioda {
+namespace test {
+
+// Read an obs space from the given configuration with block statistics switched on or off.
+std::unique_ptr<ObsSpace> readWithBlockStatistics(eckit::LocalConfiguration obsconf,
+                                                  const bool useBlockStatistics,
+                                                  const util::DateTime & bgn,
+                                                  const util::DateTime & end) {
+  eckit::LocalConfiguration inconf(obsconf, "obsdatain");
+  inconf.set("use block statistics", useBlockStatistics);
+  obsconf.set("obsdatain", inconf);
+  ioda::ObsTopLevelParameters obsparams;
+  obsparams.validateAndDeserialize(obsconf);
+  return boost::make_unique<ObsSpace>(obsparams, oops::mpi::world(), bgn, end,
+                                      oops::mpi::myself());
+}
+
+CASE("ioda/ObsSpace/testBlockStatistics") {
+  const auto &topLevelConf = ::test::TestEnvironment::config();
+
+  util::DateTime bgn(topLevelConf.getString("window begin"));
+  util::DateTime end(topLevelConf.getString("window end"));
+
+  std::vector<eckit::LocalConfiguration> confs;
+  topLevelConf.get("observations", confs);
+
+  for (const eckit::LocalConfiguration & conf : confs) {
+    // Write a file with block statistics.
+    eckit::LocalConfiguration obsconf(conf, "obs space");
+    ioda::ObsTopLevelParameters obsparams;
+    obsparams.validateAndDeserialize(obsconf);
+    {
+      ObsSpace obsspace(obsparams, oops::mpi::world(), bgn, end, oops::mpi::myself());
+      obsspace.save();
+    }
+
+    // The statistics must match the metadata of the file.
+    const std::string fileName = uniquifyFileName(
+        obsparams.obsDataOut.value()->engine.value().engineParameters.value().fileName, 0, -1);
+    {
+      const Group file = Engines::HH::openFile(fileName, Engines::BackendOpenModes::Read_Only);
+      BlockStatistics stats;
+      EXPECT(readBlockStatistics(file, stats));
+      BlockStatistics expected;
+      EXPECT(computeBlockStatistics(file, stats.blockSize, expected));
+      EXPECT(stats.blockSize > 0);
+      EXPECT_EQUAL(stats.nlocs, expected.nlocs);
+      EXPECT_EQUAL(stats.dateTimeUnits, expected.dateTimeUnits);
+      EXPECT(stats.dateTimeMin == expected.dateTimeMin);
+      EXPECT(stats.dateTimeMax == expected.dateTimeMax);
+      EXPECT(stats.dateTimeFirst == expected.dateTimeFirst);
+      EXPECT(stats.dateTimeLast == expected.dateTimeLast);
+      EXPECT(stats.latitudeMin == expected.latitudeMin);
+      EXPECT(stats.latitudeMax == expected.latitudeMax);
+      EXPECT(stats.longitudeMin == expected.longitudeMin);
+      EXPECT(stats.longitudeMax == expected.longitudeMax);
+
+      // The statistics themselves are not read into an obs space.
+      EXPECT(isBlockStatisticsVariable(std::string(blockStatisticsGroupName) + "/dateTime_min"));
+      EXPECT(!isBlockStatisticsVariable("MetaData/dateTime"));
+    }
+
+    // Reading the file over a narrower window must give the same obs space whether or
+    // not blocks outside the window are skipped.
+    eckit::LocalConfiguration testconf(conf, "test data");
+    util::DateTime readBgn(testconf.getString("read window begin"));
+    util::DateTime readEnd(testconf.getString("read window end"));
+    eckit::LocalConfiguration readconf(conf, "read obs space");
+    std::unique_ptr<ObsSpace> withStats = readWithBlockStatistics(readconf, true,
+                                                                  readBgn, readEnd);
+    std::unique_ptr<ObsSpace> withoutStats = readWithBlockStatistics(readconf, false,
+                                                                     readBgn, readEnd);
+
+    EXPECT_EQUAL(withStats->nlocs(), withoutStats->nlocs());
+    EXPECT_EQUAL(withStats->globalNumLocs(), withoutStats->globalNumLocs());
+    EXPECT_EQUAL(withStats->globalNumLocsOutsideTimeWindow(),
+                 withoutStats->globalNumLocsOutsideTimeWindow());
+
+    // Skipped locations are outside the window, and nothing is skipped without statistics.
+    EXPECT_EQUAL(withoutStats->globalNumLocsSkipped(), 0);
+    EXPECT(withStats->globalNumLocsSkipped() <= withStats->globalNumLocsOutsideTimeWindow());
+    if (testconf.has("expected skipped"))
+      EXPECT_EQUAL(withStats->globalNumLocsSkipped(), testconf.getUnsigned("expected skipped"));
+    EXPECT(withStats->index() == withoutStats->index());
+    EXPECT(withStats->recnum() == withoutStats->recnum());
+
+    const std::size_t nlocs = withStats->nlocs();
+    std::vector<util::DateTime> dtWith(nlocs), dtWithout(nlocs);
+    withStats->get_db("MetaData", "dateTime", dtWith);
+    withoutStats->get_db("MetaData", "dateTime", dtWithout);
+    EXPECT(dtWith == dtWithout);
+    for (const std::string & varName : testconf.getStringVector("compare variables")) {
+      const std::size_t slash = varName.find('/');
+      std::vector<float> valsWith(nlocs), valsWithout(nlocs);
+      withStats->get_db(varName.substr(0, slash), varName.substr(slash + 1), valsWith);
+      withoutStats->get_db(varName.substr(0, slash), varName.substr(slash + 1), valsWithout);
+      EXPECT(valsWith == valsWithout);
+    }
+
+    // Statistics gone stale through an edit of the dateTimes in place are not used.
+    {
+      Group file = Engines::HH::openFile(fileName, Engines::BackendOpenModes::Read_Write);
+      Variable dtVar = file.vars.open("MetaData/dateTime");
+      std::vector<int64_t> dateTimes;
+      dtVar.read<int64_t>(dateTimes);
+      for (int64_t & dateTime : dateTimes) dateTime += 1;
+      dtVar.write<int64_t>(dateTimes);
+      BlockStatistics stats;
+      EXPECT(!readBlockStatistics(file, stats));
+    }
+    std::unique_ptr<ObsSpace> stale = readWithBlockStatistics(readconf, true, readBgn, readEnd);
+    EXPECT_EQUAL(stale->globalNumLocsSkipped(), 0);
+  }
+}
+
+class ObsSpaceBlockStatistics : public oops::Test {
+ private:
+  std::string testid() const override {return "test::ObsSpaceBlockStatistics";}
+
+  void register_tests() const override {}
+
+  void clear() const override {}
+};
+
+// -----------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace ioda
+
+#endif  // TEST_IODA_OBSSPACEBLOCKSTATISTICS_H_
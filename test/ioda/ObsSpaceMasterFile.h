@@ -0,0 +1,130 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef TEST_IODA_OBSSPACEMASTERFILE_H_
+#define TEST_IODA_OBSSPACEMASTERFILE_H_
+
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Test.h"
+#include "oops/test/TestEnvironment.h"
+#include "oops/util/DateTime.h"
+
+#include "ioda/Engines/HH.h"
+#include "ioda/Io/BlockStatistics.h"
+#include "ioda/ObsSpace.h"
+
+namespace ioda {
+namespace test {
+
+CASE("ioda/ObsSpace/testMasterFile") {
+  const auto &topLevelConf = ::test::TestEnvironment::config();
+
+  util::DateTime bgn(topLevelConf.getString("window begin"));
+  util::DateTime end(topLevelConf.getString("window end"));
+
+  std::vector<eckit::LocalConfiguration> confs;
+  topLevelConf.get("observations", confs);
+
+  for (const eckit::LocalConfiguration & conf : confs) {
+    // Write one file per task, plus the master file.
+    eckit::LocalConfiguration obsconf(conf, "obs space");
+    ioda::ObsTopLevelParameters obsparams;
+    obsparams.validateAndDeserialize(obsconf);
+    ObsSpace obsspace(obsparams, oops::mpi::world(), bgn, end, oops::mpi::myself());
+    obsspace.save();
+    // The master file is written by one task once all the files are done.
+    oops::mpi::world().barrier();
+
+    eckit::LocalConfiguration testconf(conf, "test data");
+    const std::string fileName = testconf.getString("master file");
+    {
+      const Group file = Engines::HH::openFile(fileName, Engines::BackendOpenModes::Read_Only);
+      // The block statistics of the task files are replaced by ones for the whole set.
+      BlockStatistics stats;
+      EXPECT(readBlockStatistics(file, stats));
+      EXPECT_EQUAL(stats.nlocs, obsspace.globalNumLocs());
+    }
+
+    // Reading the master file on a single task must give the locations of all of the
+    // tasks, stacked in task order.
+    eckit::LocalConfiguration readconf(conf, "read obs space");
+    ioda::ObsTopLevelParameters readparams;
+    readparams.validateAndDeserialize(readconf);
+    ObsSpace master(readparams, oops::mpi::myself(), bgn, end, oops::mpi::myself());
+    EXPECT_EQUAL(master.nlocs(), obsspace.globalNumLocs());
+
+    for (const std::string & varName : testconf.getStringVector("compare variables")) {
+      const std::size_t slash = varName.find('/');
+      std::vector<float> expected(obsspace.nlocs());
+      obsspace.get_db(varName.substr(0, slash), varName.substr(slash + 1), expected);
+      obsspace.distribution()->allGatherv(expected);
+      std::vector<float> values(master.nlocs());
+      master.get_db(varName.substr(0, slash), varName.substr(slash + 1), values);
+      EXPECT(values == expected);
+    }
+
+    // Reading the task files as one obs source must give the same as the master file.
+    eckit::LocalConfiguration filesconf(conf, "read files obs space");
+    ioda::ObsTopLevelParameters filesparams;
+    filesparams.validateAndDeserialize(filesconf);
+    ObsSpace files(filesparams, oops::mpi::myself(), bgn, end, oops::mpi::myself());
+    EXPECT_EQUAL(files.nlocs(), master.nlocs());
+    for (const std::string & varName : testconf.getStringVector("compare variables")) {
+      const std::size_t slash = varName.find('/');
+      std::vector<float> expected(master.nlocs());
+      master.get_db(varName.substr(0, slash), varName.substr(slash + 1), expected);
+      std::vector<float> values(files.nlocs());
+      files.get_db(varName.substr(0, slash), varName.substr(slash + 1), values);
+      EXPECT(values == expected);
+    }
+
+    // Reading the task files on all of the tasks gives each task a file of its own. Task i
+    // wrote file i, so it must get back its own locations.
+    eckit::LocalConfiguration distconf(conf, "distributed files obs space");
+    ioda::ObsTopLevelParameters distparams;
+    distparams.validateAndDeserialize(distconf);
+    ObsSpace distributed(distparams, oops::mpi::world(), bgn, end, oops::mpi::myself());
+    EXPECT_EQUAL(distributed.globalNumLocs(), obsspace.globalNumLocs());
+    EXPECT_EQUAL(distributed.nlocs(), obsspace.nlocs());
+    for (const std::string & varName : testconf.getStringVector("compare variables")) {
+      const std::size_t slash = varName.find('/');
+      std::vector<float> expected(obsspace.nlocs());
+      obsspace.get_db(varName.substr(0, slash), varName.substr(slash + 1), expected);
+      std::vector<float> values(distributed.nlocs());
+      distributed.get_db(varName.substr(0, slash), varName.substr(slash + 1), values);
+      EXPECT(values == expected);
+    }
+
+    // Files that hold different variables cannot be read together.
+    eckit::LocalConfiguration mismatchconf(conf, "mismatched files obs space");
+    ioda::ObsTopLevelParameters mismatchparams;
+    mismatchparams.validateAndDeserialize(mismatchconf);
+    EXPECT_THROWS(ObsSpace(mismatchparams, oops::mpi::world(), bgn, end, oops::mpi::myself()));
+  }
+}
+
+class ObsSpaceMasterFile : public oops::Test {
+ private:
+  std::string testid() const override {return "test::ObsSpaceMasterFile";}
+
+  void register_tests() const override {}
+
+  void clear() const override {}
+};
+
+// -----------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace ioda
+
+#endif  // TEST_IODA_OBSSPACEMASTERFILE_H_
@@ -9,6 +9,7 @@
 #define TEST_IODA_OBSSPACEPUTDBCHANNELS_H_
 
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -21,6 +22,7 @@
 #include "oops/mpi/mpi.h"
 #include "oops/runs/Test.h"
 #include "oops/test/TestEnvironment.h"
+#include "oops/util/missingValues.h"
 
 #include "ioda/Engines/HH.h"
 #include "ioda/Io/IoPoolUtils.h"
@@ -175,6 +177,71 @@ CASE("ioda/ObsSpace/testPutDb") {
   }
 }
 
+CASE("ioda/ObsSpace/testChannelsInBulk") {
+  const auto &topLevelConf = ::test::TestEnvironment::config();
+
+  util::DateTime bgn(topLevelConf.getString("window begin"));
+  util::DateTime end(topLevelConf.getString("window end"));
+
+  std::vector<eckit::LocalConfiguration> confs;
+  topLevelConf.get("observations", confs);
+
+  for (const eckit::LocalConfiguration & conf : confs) {
+    eckit::LocalConfiguration testconf(conf, "test data");
+    if (!testconf.getBool("create file", true)) continue;
+
+    eckit::LocalConfiguration obsconf(conf, "obs space");
+    ioda::ObsTopLevelParameters obsparams;
+    obsparams.validateAndDeserialize(obsconf);
+    // Not saved, so the file checked by testPutDb is unaffected.
+    ObsSpace obsspace(obsparams, oops::mpi::world(), bgn, end, oops::mpi::myself());
+    const size_t nlocs = obsspace.nlocs();
+
+    std::vector<float> chan2(nlocs), chan4(nlocs);
+    std::iota(chan2.begin(), chan2.end(), 1.0f);
+    std::iota(chan4.begin(), chan4.end(), -100.0f);
+    if (nlocs > 0) chan4[0] = util::missingValue(float());
+
+    std::string varName;
+    int channel = 0;
+    if (obsspace.nchans() == 0) {
+      EXPECT(!obsspace.splitChannelName("DummyGroup", "bulk_var_2", varName, channel));
+      EXPECT(!obsspace.put_db_channels("DummyGroup", "bulk_var", {2, 4},
+                                       std::vector<const float *>{chan2.data(), chan4.data()}));
+      continue;
+    }
+
+    EXPECT(obsspace.splitChannelName("DummyGroup", "bulk_var_4", varName, channel));
+    EXPECT_EQUAL(varName, "bulk_var");
+    EXPECT_EQUAL(channel, 4);
+    EXPECT(!obsspace.splitChannelName("DummyGroup", "bulk_var_1000000", varName, channel));
+
+    // Written in one go, read back channel by channel.
+    EXPECT(obsspace.put_db_channels("DummyGroup", "bulk_var", {4, 2},
+                                    std::vector<const float *>{chan4.data(), chan2.data()}));
+    std::vector<float> values;
+    obsspace.get_db("DummyGroup", "bulk_var_2", values);
+    EXPECT_EQUAL(values, chan2);
+    obsspace.get_db("DummyGroup", "bulk_var_4", values);
+    EXPECT_EQUAL(values, chan4);
+
+    // Read back in one go, converting to double (and converting missing values).
+    std::vector<double> dchan2(nlocs), dchan4(nlocs);
+    EXPECT(obsspace.get_db_channels("DummyGroup", "bulk_var", {2, 4},
+                                    std::vector<double *>{dchan2.data(), dchan4.data()}));
+    for (size_t jl = 0; jl < nlocs; ++jl) {
+      EXPECT_EQUAL(dchan2[jl], static_cast<double>(chan2[jl]));
+      if (jl == 0)
+        EXPECT_EQUAL(dchan4[jl], util::missingValue(double()));
+      else
+        EXPECT_EQUAL(dchan4[jl], static_cast<double>(chan4[jl]));
+    }
+
+    // Variables without a channel dimension are left to get_db and put_db.
+    EXPECT(!obsspace.get_db_channels("MetaData", "latitude", {2, 4},
+                                     std::vector<float *>{nullptr, nullptr}));
+  }
+}
 
 class ObsSpacePutDbChannels : public oops::Test {
  private:
@@ -0,0 +1,198 @@
+/*
+ * (C) Copyright 2022 UCAR
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ */
+
+#ifndef TEST_IODA_OBSSPACESNAPSHOT_H_
+#define TEST_IODA_OBSSPACESNAPSHOT_H_
+
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/make_unique.hpp>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "oops/mpi/mpi.h"
+#include "oops/runs/Test.h"
+#include "oops/test/TestEnvironment.h"
+#include "oops/util/DateTime.h"
+#include "oops/util/Duration.h"
+
+#include "ioda/ObsSpace.h"
+#include "ioda/Variables/VarUtils.h"
+
+namespace ioda {
+namespace test {
+
+// Construct an obs space with the snapshot written or restored.
+std::unique_ptr<ObsSpace> makeSnapshotObsSpace(eckit::LocalConfiguration obsconf,
+                                               const bool write, const bool restore,
+                                               const util::DateTime & bgn,
+                                               const util::DateTime & end) {
+    eckit::LocalConfiguration snapconf(obsconf, "snapshot");
+    snapconf.set("write", write);
+    snapconf.set("restore", restore);
+    obsconf.set("snapshot", snapconf);
+    ioda::ObsTopLevelParameters obsparams;
+    obsparams.validateAndDeserialize(obsconf);
+    return boost::make_unique<ObsSpace>(obsparams, oops::mpi::world(), bgn, end,
+                                        oops::mpi::myself());
+}
+
+// Values compare bit for bit, so that e.g. missing values and NaNs compare equal.
+template <typename T>
+bool bitwiseEqual(const std::vector<T> & a, const std::vector<T> & b) {
+    return (a.size() == b.size()) &&
+           (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+bool bitwiseEqual(const std::vector<std::string> & a, const std::vector<std::string> & b) {
+    return a == b;
+}
+
+void expectIdenticalObsSpaces(const ObsSpace & original, const ObsSpace & restored) {
+    EXPECT_EQUAL(restored.nlocs(), original.nlocs());
+    EXPECT_EQUAL(restored.nrecs(), original.nrecs());
+    EXPECT_EQUAL(restored.nchans(), original.nchans());
+    EXPECT_EQUAL(restored.globalNumLocs(), original.globalNumLocs());
+    EXPECT_EQUAL(restored.globalNumLocsOutsideTimeWindow(),
+                 original.globalNumLocsOutsideTimeWindow());
+    EXPECT_EQUAL(restored.globalNumLocsSkipped(), original.globalNumLocsSkipped());
+    EXPECT(restored.obsvariables() == original.obsvariables());
+    EXPECT(restored.assimvariables() == original.assimvariables());
+
+    // Indices
+    EXPECT(restored.index() == original.index());
+    EXPECT(restored.recnum() == original.recnum());
+    EXPECT_EQUAL(restored.obsAreSorted(), original.obsAreSorted());
+    const std::vector<std::size_t> recNums = original.recidx_all_recnums();
+    EXPECT(restored.recidx_all_recnums() == recNums);
+    for (const std::size_t recNum : recNums) {
+        EXPECT(restored.recidx_vector(recNum) == original.recidx_vector(recNum));
+    }
+
+    // Distribution
+    EXPECT_EQUAL(restored.distname(), original.distname());
+    std::vector<bool> originalPatch(original.nlocs());
+    std::vector<bool> restoredPatch(restored.nlocs());
+    original.distribution()->patchObs(originalPatch);
+    restored.distribution()->patchObs(restoredPatch);
+    EXPECT(restoredPatch == originalPatch);
+
+    // Variables
+    const ObsGroup originalGroup = original.getObsGroup();
+    const ObsGroup restoredGroup = restored.getObsGroup();
+    const std::vector<std::string> varNames =
+        originalGroup.listObjects<ObjectType::Variable>(true);
+    EXPECT(restoredGroup.listObjects<ObjectType::Variable>(true) == varNames);
+    for (const std::string & varName : varNames) {
+        const Variable originalVar = originalGroup.vars.open(varName);
+        const Variable restoredVar = restoredGroup.vars.open(varName);
+        EXPECT(restoredVar.getDimensions().dimsCur == originalVar.getDimensions().dimsCur);
+        EXPECT_EQUAL(restoredVar.isDimensionScale(), originalVar.isDimensionScale());
+        EXPECT_EQUAL(restoredVar.hasFillValue(), originalVar.hasFillValue());
+        EXPECT(restoredVar.atts.list() == originalVar.atts.list());
+        VarUtils::forAnySupportedVariableType(
+              originalVar,
+              [&](auto typeDiscriminator) {
+                  typedef decltype(typeDiscriminator) T;
+                  EXPECT(restoredVar.isA<T>());
+                  std::vector<T> originalValues;
+                  std::vector<T> restoredValues;
+                  originalVar.read<T>(originalValues);
+                  restoredVar.read<T>(restoredValues);
+                  EXPECT(bitwiseEqual(restoredValues, originalValues));
+              },
+              VarUtils::ThrowIfVariableIsOfUnsupportedType(varName));
+    }
+}
+
+CASE("ioda/ObsSpace/testSnapshot") {
+    const auto &topLevelConf = ::test::TestEnvironment::config();
+
+    util::DateTime bgn(topLevelConf.getString("window begin"));
+    util::DateTime end(topLevelConf.getString("window end"));
+
+    std::vector<eckit::LocalConfiguration> confs;
+    topLevelConf.get("observations", confs);
+
+    for (const eckit::LocalConfiguration & conf : confs) {
+        eckit::LocalConfiguration obsconf(conf, "obs space");
+        eckit::LocalConfiguration testconf(conf, "test data");
+        const bool expectRestored = testconf.getBool("restored");
+
+        // Construct from the obs source and write the snapshot.
+        std::unique_ptr<ObsSpace> original = makeSnapshotObsSpace(obsconf, true, false,
+                                                                  bgn, end);
+        EXPECT(!original->restoredFromSnapshot());
+
+        // Construct again from the snapshot.
+        std::unique_ptr<ObsSpace> restored = makeSnapshotObsSpace(obsconf, false, true,
+                                                                  bgn, end);
+        EXPECT_EQUAL(restored->restoredFromSnapshot(), expectRestored);
+        expectIdenticalObsSpaces(*original, *restored);
+
+        // The snapshot is not used for another timing window.
+        std::unique_ptr<ObsSpace> otherWindow =
+            makeSnapshotObsSpace(obsconf, false, true, bgn, end - util::Duration("PT1H"));
+        EXPECT(!otherWindow->restoredFromSnapshot());
+
+        // Nor once the input file has been modified. A copy of the input file is
+        // restored from, then given another modification time.
+        eckit::LocalConfiguration inconf(obsconf, "obsdatain");
+        eckit::LocalConfiguration engineconf(inconf, "engine");
+        if (expectRestored && engineconf.has("obsfile")) {
+            const std::string copyName = obsconf.getString("snapshot.directory") + "/" +
+                obsconf.getString("name") + "_input_" +
+                std::to_string(oops::mpi::world().rank()) + ".nc4";
+            {
+                std::ifstream in(engineconf.getString("obsfile"), std::ios::binary);
+                std::ofstream out(copyName, std::ios::binary);
+                out << in.rdbuf();
+            }
+            engineconf.set("obsfile", copyName);
+            inconf.set("engine", engineconf);
+            eckit::LocalConfiguration copyconf(obsconf);
+            copyconf.set("obsdatain", inconf);
+
+            makeSnapshotObsSpace(copyconf, true, false, bgn, end);
+            EXPECT(makeSnapshotObsSpace(copyconf, false, true, bgn, end)
+                       ->restoredFromSnapshot());
+
+            struct stat copyStat;
+            EXPECT_EQUAL(stat(copyName.c_str(), &copyStat), 0);
+            struct utimbuf times;
+            times.actime = copyStat.st_atime;
+            times.modtime = copyStat.st_mtime - 60;
+            EXPECT_EQUAL(utime(copyName.c_str(), &times), 0);
+            EXPECT(!makeSnapshotObsSpace(copyconf, false, true, bgn, end)
+                        ->restoredFromSnapshot());
+        }
+    }
+}
+
+class ObsSpaceSnapshot : public oops::Test {
+ private:
+    std::string testid() const override {return "test::ObsSpaceSnapshot";}
+
+    void register_tests() const override {}
+
+    void clear() const override {}
+};
+
+// -----------------------------------------------------------------------------
+
+}  // namespace test
+}  // namespace ioda
+
+#endif  // TEST_IODA_OBSSPACESNAPSHOT_H_
@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# check the JSON summary written by ioda-validate --summary
+#
+# argument 1: the summary file
+# remaining arguments: the input files, in the order they were given to ioda-validate
+#
+# Each input must be listed, in order, with its error and warning counts, and the totals
+# must be the sums of the counts of the files.
+
+set -eu
+
+summary=$1
+shift
+
+[[ -f $summary ]] || { echo "ERROR: $summary does not exist"; exit 1; }
+
+entry_re='^ *\{"file": "(.*)", "errors": ([0-9]+), "warnings": ([0-9]+)'
+files=()
+sum_errors=0
+sum_warnings=0
+while IFS= read -r line; do
+  if [[ $line =~ $entry_re ]]; then
+    files+=("${BASH_REMATCH[1]}")
+    sum_errors=$((sum_errors + BASH_REMATCH[2]))
+    sum_warnings=$((sum_warnings + BASH_REMATCH[3]))
+  fi
+done < "$summary"
+
+rc=0
+if [[ ${#files[@]} != $# ]]; then
+  echo "ERROR: $summary lists ${#files[@]} files, expected $#"
+  rc=1
+fi
+i=0
+for input in "$@"; do
+  if [[ ${files[$i]:-} != "$input" ]]; then
+    echo "ERROR: entry $i of $summary is '${files[$i]:-}', expected '$input'"
+    rc=1
+  fi
+  i=$((i + 1))
+done
+
+total_errors=$(sed -n 's/^ *"errors": \([0-9]*\),$/\1/p' "$summary")
+total_warnings=$(sed -n 's/^ *"warnings": \([0-9]*\),$/\1/p' "$summary")
+if [[ $total_errors != "$sum_errors" || $total_warnings != "$sum_warnings" ]]; then
+  echo "ERROR: totals of $total_errors errors and $total_warnings warnings in $summary" \
+       "differ from the sums over the files ($sum_errors and $sum_warnings)"
+  rc=1
+fi
+
+[[ $rc != 0 ]] && cat "$summary"
+exit $rc